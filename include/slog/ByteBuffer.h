@@ -21,6 +21,7 @@
  */
 #pragma once
 #include "slog/Buffer.h"
+#include <string.h>
 
 namespace slog
 {
@@ -125,6 +126,31 @@ public:     virtual void setLength(int32_t len) throw(Exception) override;
              */
             void putLong(int64_t value) throw(Exception);
 
+            /*!
+             * 可変長整数（７ビット単位）取得
+             */
+            uint64_t getVarInt() throw(Exception);
+
+            /*!
+             * 可変長整数（７ビット単位）書き込み
+             */
+            void putVarInt(uint64_t value) throw(Exception);
+
+            /*!
+             * 可変長整数（７ビット単位）のバイト数取得
+             */
+            static int32_t getVarIntLength(uint64_t value);
+
+            /*!
+             * 符号付き整数を符号なし整数に変換（絶対値の小さい値ほど小さくなる）
+             */
+            static uint64_t toZigZag(int64_t value) {return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);}
+
+            /*!
+             * toZigZag() で変換した値を元に戻す
+             */
+            static int64_t fromZigZag(uint64_t value) {return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);}
+
             /*!
              * 一括取得
              */
@@ -141,6 +167,98 @@ public:     virtual void setLength(int32_t len) throw(Exception) override;
             void put(const char* buffer, int32_t len) throw(Exception);
 };
 
+/*!
+ *  \brief  バイトバッファ書き込みクラス
+ *
+ *  \note   コンストラクタで書き込む最大サイズの範囲を一度だけ調べ、以降の書き込みでは範囲を調べない。
+ *          書き込んだ後に commit() でバイトバッファの位置を進める。
+ */
+class SLOG_API ByteBufferWriter
+{
+            ByteBuffer* mBuffer;    //!< 書き込み先
+            uint8_t*    mBegin;     //!< 書き込み開始位置
+            uint8_t*    mP;         //!< 現在の書き込み位置
+
+            /*!
+             * コンストラクタ
+             */
+public:     ByteBufferWriter(ByteBuffer* buffer, int32_t maxLength) throw(Exception);
+
+            /*!
+             * 書き込んだサイズ取得
+             */
+            int32_t getLength() const {return (int32_t)(mP - mBegin);}
+
+            /*!
+             * 書き込み
+             */
+            void put(     char    value);
+            void putShort(short   value);
+            void putInt(  int32_t value);
+            void putLong( int64_t value);
+            void putVarInt(uint64_t value);
+            void put(const char* buffer, int32_t len);
+
+            /*!
+             * 指定位置（書き込み開始位置からのオフセット）にshort値を書き込む
+             */
+            void putShort(int32_t offset, short value);
+
+            /*!
+             * 書き込んだサイズだけバイトバッファの位置を進める
+             */
+            void commit() throw(Exception);
+};
+
+/*!
+ *  \brief  バイトバッファ読み込みクラス
+ *
+ *  \note   ByteBuffer の get 系と違い、範囲はポインタの比較だけで調べる。
+ *          読み込んだ後に commit() でバイトバッファの位置を進める。
+ */
+class SLOG_API ByteBufferReader
+{
+            ByteBuffer*     mBuffer;    //!< 読み込み元
+            const uint8_t*  mBegin;     //!< 読み込み開始位置
+            const uint8_t*  mP;         //!< 現在の読み込み位置
+            const uint8_t*  mEnd;       //!< 読み込み終了位置
+
+            /*!
+             * コンストラクタ
+             */
+public:     ByteBufferReader(ByteBuffer* buffer, int32_t length);
+
+            /*!
+             * 読み込んだサイズ取得
+             */
+            int32_t getLength() const {return (int32_t)(mP - mBegin);}
+
+            /*!
+             * 残りサイズ取得
+             */
+            int32_t getRemaining() const {return (int32_t)(mEnd - mP);}
+
+            /*!
+             * 読み込み
+             */
+            char        get() throw(Exception);
+            short       getShort() throw(Exception);
+            int32_t     getInt() throw(Exception);
+            int64_t     getLong() throw(Exception);
+            uint64_t    getVarInt() throw(Exception);
+            const char* get(int32_t len) throw(Exception);
+
+            /*!
+             * 読み込んだサイズだけバイトバッファの位置を進める
+             */
+            void commit() throw(Exception);
+
+            /*!
+             * 範囲外例外
+             */
+private:    void throwOverFlow(int32_t len) const throw(Exception);
+};
+
 /*!
  *  \brief  バッファアドレス取得
  */
@@ -184,4 +302,226 @@ inline void ByteBuffer::setLength(int32_t len) throw(Exception)
         setPosition(len);
 }
 
+/*!
+ *  \brief  コンストラクタ
+ */
+inline ByteBufferWriter::ByteBufferWriter(ByteBuffer* buffer, int32_t maxLength) throw(Exception)
+{
+    buffer->validateOverFlow(maxLength);
+
+    mBuffer = buffer;
+    mBegin = (uint8_t*)buffer->getBuffer() + buffer->getPosition();
+    mP = mBegin;
+}
+
+/*!
+ *  \brief  char値書き込み
+ */
+inline void ByteBufferWriter::put(char value)
+{
+    *mP++ = value;
+}
+
+/*!
+ *  \brief  short値書き込み
+ */
+inline void ByteBufferWriter::putShort(short value)
+{
+    mP[0] = (value >> 8) & 0xFF;
+    mP[1] = (value     ) & 0xFF;
+    mP += sizeof(value);
+}
+
+/*!
+ *  \brief  int32_t値書き込み
+ */
+inline void ByteBufferWriter::putInt(int32_t value)
+{
+    mP[0] = (value >> 24) & 0xFF;
+    mP[1] = (value >> 16) & 0xFF;
+    mP[2] = (value >>  8) & 0xFF;
+    mP[3] = (value      ) & 0xFF;
+    mP += sizeof(value);
+}
+
+/*!
+ *  \brief  int64_t値書き込み
+ */
+inline void ByteBufferWriter::putLong(int64_t value)
+{
+    putInt((int32_t)(value >> 32));
+    putInt((int32_t)(value      ));
+}
+
+/*!
+ *  \brief  可変長整数（７ビット単位）書き込み
+ */
+inline void ByteBufferWriter::putVarInt(uint64_t value)
+{
+    while (0x80 <= value)
+    {
+        *mP++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    *mP++ = (uint8_t)value;
+}
+
+/*!
+ *  \brief  一括書き込み
+ */
+inline void ByteBufferWriter::put(const char* buffer, int32_t len)
+{
+    memcpy(mP, buffer, len);
+    mP += len;
+}
+
+/*!
+ *  \brief  指定位置にshort値を書き込む
+ */
+inline void ByteBufferWriter::putShort(int32_t offset, short value)
+{
+    mBegin[offset + 0] = (value >> 8) & 0xFF;
+    mBegin[offset + 1] = (value     ) & 0xFF;
+}
+
+/*!
+ *  \brief  書き込んだサイズだけバイトバッファの位置を進める
+ */
+inline void ByteBufferWriter::commit() throw(Exception)
+{
+    mBuffer->setPosition(mBuffer->getPosition() + getLength());
+    mBegin = mP;
+}
+
+/*!
+ *  \brief  コンストラクタ
+ *
+ *  \param[in]  buffer  読み込み元
+ *  \param[in]  length  現在の位置から読み込めるサイズ（容量を超える場合は容量まで）
+ */
+inline ByteBufferReader::ByteBufferReader(ByteBuffer* buffer, int32_t length)
+{
+    int32_t remaining = buffer->getCapacity() - buffer->getPosition();
+
+    if (length < 0 || remaining < length)
+        length = remaining;
+
+    mBuffer = buffer;
+    mBegin = (const uint8_t*)buffer->getBuffer() + buffer->getPosition();
+    mP = mBegin;
+    mEnd = mBegin + length;
+}
+
+/*!
+ *  \brief  char値取得
+ */
+inline char ByteBufferReader::get() throw(Exception)
+{
+    if (mEnd <= mP)
+        throwOverFlow(sizeof(char));
+
+    return *mP++;
+}
+
+/*!
+ *  \brief  short値取得
+ */
+inline short ByteBufferReader::getShort() throw(Exception)
+{
+    if (mEnd - mP < (int32_t)sizeof(short))
+        throwOverFlow(sizeof(short));
+
+    short value =
+        ((uint16_t)mP[0] << 8) |
+        ((uint16_t)mP[1]     );
+
+    mP += sizeof(value);
+    return value;
+}
+
+/*!
+ *  \brief  int32_t値取得
+ */
+inline int32_t ByteBufferReader::getInt() throw(Exception)
+{
+    if (mEnd - mP < (int32_t)sizeof(int32_t))
+        throwOverFlow(sizeof(int32_t));
+
+    int32_t value =
+        ((uint32_t)mP[0] << 24) |
+        ((uint32_t)mP[1] << 16) |
+        ((uint32_t)mP[2] <<  8) |
+        ((uint32_t)mP[3]      );
+
+    mP += sizeof(value);
+    return value;
+}
+
+/*!
+ *  \brief  int64_t値取得
+ */
+inline int64_t ByteBufferReader::getLong() throw(Exception)
+{
+    if (mEnd - mP < (int32_t)sizeof(int64_t))
+        throwOverFlow(sizeof(int64_t));
+
+    uint64_t high = (uint32_t)getInt();
+    uint64_t low =  (uint32_t)getInt();
+
+    return (int64_t)((high << 32) | low);
+}
+
+/*!
+ *  \brief  可変長整数（７ビット単位）取得
+ */
+inline uint64_t ByteBufferReader::getVarInt() throw(Exception)
+{
+    // １バイトに収まる値が多いので先に調べる
+    if (mP < mEnd && (*mP & 0x80) == 0)
+        return *mP++;
+
+    uint64_t value = 0;
+    int32_t shift = 0;
+
+    while (true)
+    {
+        if (mEnd <= mP || 63 < shift)
+            throwOverFlow(1);
+
+        uint8_t c = *mP++;
+        value |= (uint64_t)(c & 0x7F) << shift;
+
+        if ((c & 0x80) == 0)
+            break;
+
+        shift += 7;
+    }
+
+    return value;
+}
+
+/*!
+ *  \brief  一括取得
+ */
+inline const char* ByteBufferReader::get(int32_t len) throw(Exception)
+{
+    if (len < 0 || mEnd - mP < len)
+        throwOverFlow(len);
+
+    const char* p = (const char*)mP;
+    mP += len;
+
+    return p;
+}
+
+/*!
+ *  \brief  読み込んだサイズだけバイトバッファの位置を進める
+ */
+inline void ByteBufferReader::commit() throw(Exception)
+{
+    mBuffer->setPosition(mBuffer->getPosition() + getLength());
+    mBegin = mP;
+}
+
 } // namespace slog
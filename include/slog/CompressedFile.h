@@ -0,0 +1,173 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    CompressedFile.h
+ * \brief   圧縮ファイルクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/File.h"
+
+namespace slog
+{
+class ByteBuffer;
+class SequenceLogArchive;
+
+/*!
+ * \brief   圧縮ファイルクラス
+ *
+ * \note    ファイルの先頭にシグネチャ、以降は固定長ブロック単位で
+ *          [元のサイズ(4)][圧縮後のサイズ(4)][フラグ(1)][データ] を並べる。
+ *          シーケンスログとして書き込んだブロックはシーケンス番号と日時を
+ *          前レコードとの差分に置き換えてからLZ圧縮する。
+ *          読み込み時はシーケンスログアーカイブ（.sloga）も同じように展開して読み込める。
+ */
+class SLOG_API CompressedFile
+{
+public:     enum
+            {
+                BLOCK_SIZE = 64 * 1024,     //!< ブロックサイズ
+            };
+
+            /*!
+             * ファイル
+             */
+private:    File mFile;
+
+            /*!
+             * ブロックバッファ（書き込み時は未圧縮データ、読み込み時は展開済みデータ）
+             */
+            ByteBuffer* mBlock;
+
+            /*!
+             * 圧縮作業用バッファ
+             */
+            ByteBuffer* mWork;
+
+            /*!
+             * ブロックバッファ内の読み込み位置
+             */
+            int32_t mBlockPosition;
+
+            /*!
+             * シーケンスログとして差分符号化するかどうか
+             */
+            bool mSequenceLog;
+
+            /*!
+             * シーケンスログアーカイブ（アーカイブを読み込む場合）
+             */
+            SequenceLogArchive* mArchive;
+
+            /*!
+             * 次に読み込むアーカイブのグループ番号
+             */
+            int32_t mArchiveGroup;
+
+            /*!
+             * コンストラクタ
+             */
+public:     CompressedFile();
+
+            /*!
+             * デストラクタ
+             */
+            ~CompressedFile();
+
+            /*!
+             * シーケンスログとして差分符号化するかどうか
+             */
+            void setSequenceLog(bool sequenceLog) {mSequenceLog = sequenceLog;}
+
+            bool isOpen() const;
+            void open(const CoreString* fileName, File::Mode mode) throw(Exception);
+            void close();
+
+            /*!
+             * 書き込み（レコード単位）
+             */
+            void write(const Buffer* buffer, int32_t count) throw(Exception);
+
+            /*!
+             * フラッシュ（未圧縮データをブロックとして書き込む）
+             */
+            void flush() throw(Exception);
+
+            /*!
+             * ブロックとして書き込んでいないデータのサイズ取得
+             */
+            int32_t getPendingSize() const;
+
+            /*!
+             * 読み込み（展開済みデータ）
+             */
+            int64_t read(Buffer* buffer, int64_t count) throw(Exception);
+            int64_t read(Buffer* buffer, int64_t position, int64_t count) throw(Exception);
+
+            /*!
+             * 読み込み位置設定（展開後の位置）
+             */
+            int64_t setRawPosition(int64_t position) throw(Exception);
+
+            /*!
+             * ファイルサイズ取得（圧縮後）
+             */
+            int64_t getSize() const;
+
+            /*!
+             * 展開後のサイズ取得
+             */
+            int64_t getRawSize() const throw(Exception);
+
+            /*!
+             * 圧縮ファイル名（.slogz、.sloga）かどうか調べる
+             */
+            static bool isCompressedFileName(const CoreString* fileName);
+
+            /*!
+             * 圧縮
+             */
+            static int32_t compress(  const char* src, int32_t srcLen, char* dst, int32_t dstCapacity);
+
+            /*!
+             * 展開
+             */
+            static int32_t decompress(const char* src, int32_t srcLen, char* dst, int32_t dstCapacity);
+
+            /*!
+             * 圧縮後の最大サイズ取得
+             */
+            static int32_t getCompressBound(int32_t srcLen);
+
+            /*!
+             * ブロック読み込み
+             */
+private:    bool readBlock() throw(Exception);
+
+            /*!
+             * アーカイブの読み込み位置設定（展開後の位置）
+             */
+            int64_t setArchiveRawPosition(int64_t position) throw(Exception);
+
+            /*!
+             * バッファ確保
+             */
+            static void reserve(ByteBuffer** buffer, int32_t capacity);
+};
+
+} // namespace slog
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "slog/Buffer.h"
+#include "slog/Format.h"
 #include <stdarg.h>
 #include <string>
 
@@ -115,7 +116,17 @@ public:     void copy(const char* text, int32_t len = -1) throw(Exception);
             /*!
              * フォーマット
              */
-            void format( const char* format, ...) throw(Exception);
+            template<typename... Args>
+            void format(const char* format, const Args&... args) throw(Exception)
+            {
+                const FormatArg list[] = {FormatArg(args)..., FormatArg()};
+                formatArgs(format, list, (int32_t)sizeof...(Args));
+            }
+
+            /*!
+             * フォーマット（型情報付きの引数）
+             */
+            void formatArgs(const char* format, const FormatArg* args, int32_t count) throw(Exception);
 
             /*!
              * フォーマット
@@ -33,9 +33,19 @@ namespace slog
 
 /*!
  * \brief   日付時間クラス
+ *
+ * \note    エポック（1970/01/01 00:00:00）からのナノ秒と暦の両方を保持し、どちらかを設定した時にもう一方も更新する。
+ *          getValue() などの const メンバーは値を読むだけなので、複数のスレッドから同時に呼び出してよい。
+ *          getValue() の値（年、月、日、時、分、秒を１バイトずつ、ミリ秒を２バイトで詰めたもの）は
+ *          ファイルに保存する形式なので変更しないこと。
  */
 class SLOG_API DateTime
 {
+            /*!
+             * エポックからのナノ秒
+             */
+            int64_t mTime;
+
             /*!
              * 日付時間
              */
@@ -76,27 +86,37 @@ public:     DateTime();
              */
             void setTime_t(time_t value, uint32_t milliSecond = 0);
 
+            /*!
+             * エポックからのナノ秒を取得
+             */
+            int64_t getEpochNanoSeconds() const {return mTime;}
+
+            /*!
+             * エポックからのナノ秒を設定
+             */
+            void setEpochNanoSeconds(int64_t time) {mTime = time; updateValue();}
+
 //          operator uint64_t() const;
 //          DateTime& operator=(uint64_t value);
 
-            uint32_t getYear()        const {return ((mValue >> 56) &   0xFF) + 1900;}
-            uint32_t getMonth()       const {return ((mValue >> 48) &   0xFF);}
-            uint32_t getDay()         const {return ((mValue >> 40) &   0xFF);}
-            uint32_t getHour()        const {return ((mValue >> 32) &   0xFF);}
-            uint32_t getMinute()      const {return ((mValue >> 24) &   0xFF);}
-            uint32_t getSecond()      const {return ((mValue >> 16) &   0xFF);}
-            uint32_t getMilliSecond() const {return ( mValue        & 0xFFFF);}
-
-            void setYear(       uint32_t year)        {mValue = (mValue & 0x00FFFFFFFFFFFFFFLL) | ((uint64_t)(year - 1900) << 56);} //!< 年設定
-            void setMonth(      uint32_t month)       {mValue = (mValue & 0xFF00FFFFFFFFFFFFLL) | ((uint64_t) month        << 48);} //!< 月設定
-            void setDay(        uint32_t day)         {mValue = (mValue & 0xFFFF00FFFFFFFFFFLL) | ((uint64_t) day          << 40);} //!< 日設定
-            void setHour(       uint32_t hour)        {mValue = (mValue & 0xFFFFFF00FFFFFFFFLL) | ((uint64_t) hour         << 32);} //!< 時設定
-            void setMinute(     uint32_t minute)      {mValue = (mValue & 0xFFFFFFFF00FFFFFFLL) | ((uint64_t) minute       << 24);} //!< 分設定
-            void setSecond(     uint32_t second)      {mValue = (mValue & 0xFFFFFFFFFF00FFFFLL) | ((uint64_t) second       << 16);} //!< 秒設定
-            void setMilliSecond(uint32_t milliSecond) {mValue = (mValue & 0xFFFFFFFFFFFF0000LL) | ((uint64_t) milliSecond       );} //!< ミリ秒設定
+            uint32_t getYear()        const {return ((getValue() >> 56) &   0xFF) + 1900;}
+            uint32_t getMonth()       const {return ((getValue() >> 48) &   0xFF);}
+            uint32_t getDay()         const {return ((getValue() >> 40) &   0xFF);}
+            uint32_t getHour()        const {return ((getValue() >> 32) &   0xFF);}
+            uint32_t getMinute()      const {return ((getValue() >> 24) &   0xFF);}
+            uint32_t getSecond()      const {return ((getValue() >> 16) &   0xFF);}
+            uint32_t getMilliSecond() const {return ( getValue()        & 0xFFFF);}
+
+            void setYear(       uint32_t year)        {setValue((getValue() & 0x00FFFFFFFFFFFFFFLL) | ((uint64_t)(year - 1900) << 56));} //!< 年設定
+            void setMonth(      uint32_t month)       {setValue((getValue() & 0xFF00FFFFFFFFFFFFLL) | ((uint64_t) month        << 48));} //!< 月設定
+            void setDay(        uint32_t day)         {setValue((getValue() & 0xFFFF00FFFFFFFFFFLL) | ((uint64_t) day          << 40));} //!< 日設定
+            void setHour(       uint32_t hour)        {setValue((getValue() & 0xFFFFFF00FFFFFFFFLL) | ((uint64_t) hour         << 32));} //!< 時設定
+            void setMinute(     uint32_t minute)      {setValue((getValue() & 0xFFFFFFFF00FFFFFFLL) | ((uint64_t) minute       << 24));} //!< 分設定
+            void setSecond(     uint32_t second)      {setValue((getValue() & 0xFFFFFFFFFF00FFFFLL) | ((uint64_t) second       << 16));} //!< 秒設定
+            void setMilliSecond(uint32_t milliSecond) {setValue((getValue() & 0xFFFFFFFFFFFF0000LL) | ((uint64_t) milliSecond       ));} //!< ミリ秒設定
 
             /*!
-             * 日付時間をミリ秒に変換
+             * 日付時間をミリ秒（エポックから）に変換
              */
             int64_t toMilliSeconds() const;
 
@@ -104,6 +124,19 @@ public:     DateTime();
              * 曜日を取得する
              */
             int32_t getWeekDay() const;
+
+            /*!
+             * 暦に変換する
+             */
+private:    void updateValue();
 };
 
+/*!
+ * \brief  日付時間をuint64_t値で取得
+ */
+inline uint64_t DateTime::getValue() const
+{
+    return mValue;
+}
+
 } // namespace slog
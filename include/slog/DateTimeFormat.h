@@ -30,7 +30,7 @@ namespace slog
 /*!
  *  \brief  日付時間フォーマットクラス
  */
-class DateTimeFormat
+class SLOG_API DateTimeFormat
 {
 public:     enum class Format : int32_t
             {
@@ -55,51 +55,4 @@ public:     enum class Format : int32_t
 public:     static void toString(CoreString* str, const DateTime& dateTime, Format format);
 };
 
-/*
- *  \brief  日付時間を文字列で取得
- */
-inline void DateTimeFormat::toString(
-    CoreString* str,            //!< ここに結果を返す
-    const DateTime& dateTime,   //!< 日付時間
-    Format format)              //!< フォーマット
-{
-    class FormatInfo
-    {
-    public:     const char* szFormat;
-                int32_t     indexes[7];
-    };
-
-    static const FormatInfo infoArray[] =
-    {
-        {"%04u/%02u/%02u %02u:%02u:%02u.%03u", {0, 1, 2, 3, 4, 5, 6}},
-        {"%04u/%02u/%02u %02u:%02u:%02u",      {0, 1, 2 ,3, 4, 5, 0}},
-        {"%04u/%02u/%02u %02u:%02u",           {0, 1, 2 ,3, 4, 0, 0}},
-        {"%04u/%02u/%02u",                     {0, 1, 2, 0, 0, 0, 0}},
-        {"%02u/%02u",                          {1, 2, 0, 0, 0, 0, 0}},
-        {"%02u:%02u",                          {3, 4, 0, 0, 0, 0, 0}},
-    };
-
-    const FormatInfo* info = &infoArray[(int32_t)format];
-    uint32_t values[] =
-    {
-        dateTime.getYear(),             // 0
-        dateTime.getMonth(),            // 1
-        dateTime.getDay(),              // 2
-        dateTime.getHour(),             // 3
-        dateTime.getMinute(),           // 4
-        dateTime.getSecond(),           // 5
-        dateTime.getMilliSecond()       // 6
-    };
-
-    str->format(
-        info->szFormat,
-        values[info->indexes[0]],
-        values[info->indexes[1]],
-        values[info->indexes[2]],
-        values[info->indexes[3]],
-        values[info->indexes[4]],
-        values[info->indexes[5]],
-        values[info->indexes[6]]);
-}
-
 } // namespace slog
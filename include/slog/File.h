@@ -42,6 +42,7 @@ public:     enum Mode
             {
                 READ,
                 WRITE,
+                APPEND,     //!< 末尾に追記（ファイルがなければ作成）
             };
 
             /*!
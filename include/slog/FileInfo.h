@@ -63,7 +63,7 @@ class SLOG_API FileInfo
             /*!
              * コンストラクタ
              */
-public:      FileInfo(const CoreString* path) throw(Exception);
+public:      FileInfo(const CoreString* path, bool aUpdate = true) throw(Exception);
 
             /*!
              * デストラクタ
@@ -101,6 +101,7 @@ public:      FileInfo(const CoreString* path) throw(Exception);
              * ファイルサイズ取得
              */
             uint64_t getSize() const;
+            void setSize(uint64_t size);
 
             /*!
              * 使用中かどうか調べる
@@ -158,4 +159,12 @@ inline uint64_t FileInfo::getSize() const
     return mSize;
 }
 
+/*!
+ * \brief   ファイルサイズ設定
+ */
+inline void FileInfo::setSize(uint64_t size)
+{
+    mSize = size;
+}
+
 } // namespace slog
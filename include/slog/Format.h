@@ -0,0 +1,122 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    Format.h
+ * \brief   フォーマットクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/Exception.h"
+#include <type_traits>
+
+namespace slog
+{
+class CoreString;
+
+/*!
+ * \brief   フォーマット引数
+ *
+ * \note    可変長引数テンプレートで受け取った引数を型情報と一緒に保持する。
+ *          printf と違い、変換指定子ではなく引数の型で値を読み出す。
+ */
+struct FormatArg
+{
+            /*!
+             * 引数の型
+             */
+            enum Type
+            {
+                NONE,
+                INT32,          //!< 32ビット以下の符号付き整数（char、bool を含む）
+                UINT32,         //!< 32ビット以下の符号なし整数
+                INT64,          //!< 64ビット符号付き整数
+                UINT64,         //!< 64ビット符号なし整数
+                DOUBLE,         //!< 浮動小数点数
+                TEXT,           //!< 文字列（'\0' 終端）
+                STRING,         //!< CoreString
+                POINTER,        //!< ポインタ
+            };
+
+            Type type;
+
+            union
+            {
+                int64_t             i;
+                uint64_t            u;
+                double              d;
+                const char*         text;
+                const CoreString*   str;
+                const void*         ptr;
+            };
+
+            FormatArg()                             : type(NONE)    {i = 0;}
+            FormatArg(bool               value)     : type(INT32)   {i = value;}
+            FormatArg(char               value)     : type(INT32)   {i = value;}
+            FormatArg(signed char        value)     : type(INT32)   {i = value;}
+            FormatArg(unsigned char      value)     : type(UINT32)  {u = value;}
+            FormatArg(short              value)     : type(INT32)   {i = value;}
+            FormatArg(unsigned short     value)     : type(UINT32)  {u = value;}
+            FormatArg(int                value)     : type(INT32)   {i = value;}
+            FormatArg(unsigned int       value)     : type(UINT32)  {u = value;}
+            FormatArg(long               value)     : type(sizeof(long) == 8 ? INT64  : INT32)  {i = value;}
+            FormatArg(unsigned long      value)     : type(sizeof(long) == 8 ? UINT64 : UINT32) {u = value;}
+            FormatArg(long long          value)     : type(INT64)   {i = value;}
+            FormatArg(unsigned long long value)     : type(UINT64)  {u = value;}
+            FormatArg(double             value)     : type(DOUBLE)  {d = value;}
+            FormatArg(long double        value)     : type(DOUBLE)  {d = (double)value;}
+            FormatArg(const char*        value)     : type(TEXT)    {text = value;}
+            FormatArg(const CoreString&  value)     : type(STRING)  {str = &value;}
+
+            /*!
+             * ポインタ（CoreStringの派生クラスへのポインタは文字列として扱う）
+             */
+            template<typename T>
+            FormatArg(const T* value)
+            {
+                init(value, std::is_base_of<CoreString, T>());
+            }
+
+private:    template<typename T>
+            void init(const T* value, std::true_type)   {type = STRING;  str = value;}
+
+            template<typename T>
+            void init(const T* value, std::false_type)  {type = POINTER; ptr = value;}
+};
+
+/*!
+ * \brief   フォーマットクラス
+ *
+ * \note    printf 互換の書式（フラグ、幅、精度、'*'、長さ修飾子は無視）を解釈する。
+ *          容量が足りない場合も結果の正確な長さが分かるため、書き込み先の確保は１回で済む。
+ *          引数が足りない場合や、数値に文字列を指定するなど型が合わない場合は例外を投げる。
+ *          整数を浮動小数点数の変換指定子で出力する場合は double に変換する。
+ */
+class SLOG_API Format
+{
+            /*!
+             * 結果の長さ取得
+             */
+public:     static int32_t getLength(const char* format, const FormatArg* args, int32_t count) throw(Exception);
+
+            /*!
+             * 書き込み（容量が足りない場合は書き込まずに必要な長さを返す）
+             */
+            static int32_t write(char* dest, int32_t capacity, const char* format, const FormatArg* args, int32_t count) throw(Exception);
+};
+
+} // namespace slog
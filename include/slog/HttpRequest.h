@@ -153,6 +153,26 @@ private:    Socket* mSocket;
              */
             String mConnection;
 
+            /*!
+             * Range
+             */
+            String mRange;
+
+            /*!
+             * If-Range
+             */
+            String mIfRange;
+
+            /*!
+             * If-Modified-Since
+             */
+            String mIfModifiedSince;
+
+            /*!
+             * If-None-Match
+             */
+            String mIfNoneMatch;
+
             /*!
              * デフォルトリスナー
              */
@@ -283,6 +303,26 @@ public:     Socket* getSocket() const;
              */
             const CoreString* getConnection() const;
 
+            /*!
+             * Range取得
+             */
+            const CoreString* getRange() const;
+
+            /*!
+             * If-Range取得
+             */
+            const CoreString* getIfRange() const;
+
+            /*!
+             * If-Modified-Since取得
+             */
+            const CoreString* getIfModifiedSince() const;
+
+            /*!
+             * If-None-Match取得
+             */
+            const CoreString* getIfNoneMatch() const;
+
             /*!
              * リセット
              */
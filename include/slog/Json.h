@@ -103,6 +103,11 @@ public:     virtual ~Json() override;
              */
             void add(const char* name, int32_t value);
 
+            /*!
+             * JSONオブジェクト追加
+             */
+            void add(const char* name, int64_t value);
+
             /*!
              * JSONオブジェクト追加
              */
@@ -39,9 +39,16 @@
 ******************************************************************************/
 #if defined(__SLOG__) || defined(PHP_SLOG_H)
     #if defined(__cplusplus)
-        #define SLOG     slog::SequenceLog _slog
+        #define SLOG(className, funcName)                   static slog::SequenceLogSite _slogSite = {className, funcName}; \
+                                                            slog::SequenceLog _slog(&_slogSite)
         #define SMSG    _slog.message
         #define SASSERT _slog.assert
+
+        #define SLOG_STEPIN_SITE(className, funcName)       static slog::SequenceLogSite _slogSite = {className, funcName}; \
+                                                            void* _slog = _slog_stepInSite(&_slogSite)
+    #else
+        #define SLOG_STEPIN_SITE(className, funcName)       static SequenceLogSite _slogSite = {className, funcName}; \
+                                                            void* _slog = _slog_stepInSite(&_slogSite)
     #endif
 
     #define SLOG_STEPIN( className, funcName)               void* _slog = _slog_stepIn( className, funcName)
@@ -60,6 +67,7 @@
     #endif
 
     #define SLOG_STEPIN( className, funcName)               void* _slog = 0
+    #define SLOG_STEPIN_SITE(className, funcName)           void* _slog = 0
 //  #define SLOG_STEPIN2(classID,   funcName)               void* _slog = 0
 //  #define SLOG_STEPIN3(classID,   funcID)                 void* _slog = 0
     #define SLOG_STEPOUT
@@ -90,6 +98,26 @@ enum SequenceLogLevel
     ERROR,                  //!< エラー
 };
 
+/*!
+ * \brief   呼び出し箇所
+ *
+ * \note    SLOG / SLOG_STEPIN_SITE 毎に静的に確保し、最初の呼び出しで登録して呼び出し箇所IDを採番する。
+ *          level はフィルターと無効フラグから決まり、登録時とシーケンスログサービスからの変更時に更新する。
+ *          level が ERROR + 1 の呼び出し箇所は level を読むだけで何も送信しない。
+ *          クラス名と関数名は最初の呼び出しのものに固定されるため、SLOG / SLOG_STEPIN_SITE には呼び出し毎に変わらない名前を指定すること
+ *          （C言語の SLOG_STEPIN_SITE は静的変数の初期化子になるので文字列リテラルのみ）。
+ *          実行時に決まる名前は、呼び出し毎に名前を送る SLOG_STEPIN を使うこと。
+ */
+typedef struct SequenceLogSite
+{
+    const char*         className;  //!< クラス名
+    const char*         funcName;   //!< 関数名
+    volatile int32_t    level;      //!< ログレベル（登録前は0）
+    volatile int32_t    disabled;   //!< 無効フラグ（シーケンスログサービスから変更される）
+    volatile uint32_t   id;         //!< 呼び出し箇所ID（0は未登録）
+}
+SequenceLogSite;
+
 #if defined(__cplusplus)
 } // namespace slog
 #endif
@@ -107,6 +135,11 @@ typedef int32_t bool;
 
 SLOG_API void* _slog_stepIn( const char*   className, const char*    funcName);
 SLOG_API void*  slog_stepIn(const wchar_t* className, const wchar_t* funcName);
+#if defined(__cplusplus)
+SLOG_API void* _slog_stepInSite(slog::SequenceLogSite* site);
+#else
+SLOG_API void* _slog_stepInSite(SequenceLogSite* site);
+#endif
 //OG_API void* _slog_stepIn3(uint32_t      classID,   uint32_t       funcID);
 SLOG_API void  _slog_stepOut( void* p);
 SLOG_API void   slog_stepOut( void* p);
@@ -117,6 +150,14 @@ SLOG_API void   slog_message( void* p, int32_t          level, const wchar_t* me
 SLOG_API void  _slog_assert(  void* p, const char*    assertName, bool result);
 SLOG_API void   slog_assert(  void* p, const wchar_t* assertName, bool result);
 
+/*
+ * ハンドルなし（現在のスレッドのフレームスタックを使う。ステップイン／アウトは同じスレッドで対にすること）
+ */
+SLOG_API void  _slog_stepInCurrent( const char* className, const char* funcName);
+SLOG_API void  _slog_stepOutCurrent(void);
+SLOG_API void  _slog_messageCurrent(int32_t level, const char* format, ...);
+SLOG_API void  _slog_assertCurrent( const char* assertName, bool result);
+
 SLOG_API void loadSequenceLogConfig(const char*    fileName);
 SLOG_API void slog_loadConfig(      const wchar_t* fileName);
 
@@ -136,6 +177,8 @@ jint slog_JNI_OnLoad(JavaVM* vm, void* reserved);
 *
 ******************************************************************************/
 #if defined(__cplusplus)
+#include "slog/Format.h"
+
 namespace slog
 {
 
@@ -149,27 +192,56 @@ class SLOG_API SequenceLog
              */
             uint32_t mSeqNo;
 
+            /*!
+             * \brief   ログレベル（シーケンスログサービスから変更されたフィルターで決まる）
+             */
+            int32_t mLogLevel;
+
             /*!
              * コンストラクタ
              */
 public:      SequenceLog(const char* className, const char* funcName);
+             SequenceLog(SequenceLogSite* site);
 //           SequenceLog(uint32_t    classID,   uint32_t    funcID);
 
             /*!
              * デストラクタ
              */
-            ~SequenceLog();
+            ~SequenceLog() {if (mSeqNo) stepOut();}
 
             /*!
              * 初期化
              */
 private:    void init();
 
+            /*!
+             * ステップイン／アウト
+             */
+            void stepIn(SequenceLogSite* site);
+            void stepIn(const char* className, const char* funcName);
+            void stepOut();
+
             /*!
              * メッセージ出力
              */
-public:     void message( SequenceLogLevel level, const char* format, ...);
-            void messageV(SequenceLogLevel level, const char* format, va_list arg);
+public:     template<typename... Args>
+            void message(SequenceLogLevel level, const char* format, const Args&... args)
+            {
+                // 出力しないメッセージは引数をまとめる前に捨てる
+                if ((int32_t)level < mLogLevel)
+                    return;
+
+                const FormatArg list[] = {FormatArg(args)..., FormatArg()};
+                messageArgs(level, format, list, (int32_t)sizeof...(Args));
+            }
+
+            void messageArgs(SequenceLogLevel level, const char* format, const FormatArg* args, int32_t count);
+            void messageV(   SequenceLogLevel level, const char* format, va_list arg);
+
+            /*!
+             * メッセージを出力するかどうか（メッセージを作る前に調べる場合）
+             */
+            bool isOutput(SequenceLogLevel level) const {return (mLogLevel <= (int32_t)level);}
 //          void message( SequenceLogLevel level, uint32_t messageID);
 
             /*!
@@ -178,6 +250,22 @@ public:     void message( SequenceLogLevel level, const char* format, ...);
             void assert(const char* assertName, bool result);
 };
 
+/*!
+ * \brief   コンストラクタ
+ *
+ * \param[in]   site    呼び出し箇所
+ *
+ * \note    無効な呼び出し箇所では level を読んで比較するだけで、以降のメッセージも送信しない。
+ */
+inline SequenceLog::SequenceLog(SequenceLogSite* site)
+{
+    mSeqNo = 0;
+    mLogLevel = site->level;
+
+    if (mLogLevel != ERROR + 1/*NONE*/)
+        stepIn(site);
+}
+
 } // namespace slog
 #endif // defined(__cplusplus)
 #endif // defined(__SLOG__) || defined(PHP_SLOG_H)
@@ -198,6 +198,16 @@ public:     Socket();
              */
             virtual void send(const char* buffer, int32_t len) const throw(Exception);
 
+            /*!
+             * 送信
+             */
+            void send(const int64_t* value) const throw(Exception);
+
+            /*!
+             * ファイル送信
+             */
+            int64_t sendFile(const CoreString* path, int64_t position, int64_t count) const throw(Exception);
+
             /*!
              * 受信
              */
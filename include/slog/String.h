@@ -27,19 +27,32 @@ namespace slog
 
 /*!
  * \brief   可変長文字列クラス
+ *
+ * \note    INLINE_CAPACITY 以下の文字列はオブジェクト内のバッファに格納し、メモリを確保しない。
+ *          getCapacity() は格納場所に関係なく、これまでと同じく確保を要求された容量を返す。
  */
 class SLOG_API String : public CoreString
 {
+public:     enum
+            {
+                INLINE_CAPACITY = 31,   //!< オブジェクト内のバッファに格納できる最大の長さ
+            };
+
             /*!
-             * \brief   バッファ
+             * \brief   バッファ（mInline、またはヒープに確保したバッファ）
              */
-            char* mBuffer;
+private:    char* mBuffer;
 
             /*!
              * \brief   バッファ容量
              */
             int32_t mCapacity;
 
+            /*!
+             * \brief   オブジェクト内のバッファ
+             */
+            char mInline[INLINE_CAPACITY + 1];
+
             /*!
              * 代入
              */
@@ -50,6 +63,11 @@ private:    const String& operator=(const char*) = delete;
              */
 public:     const String& operator=(const String&);
 
+            /*!
+             * 代入（ヒープに確保したバッファは移動する）
+             */
+            const String& operator=(String&&);
+
             /*!
              * コンストラクタ
              */
@@ -60,6 +78,11 @@ public:     String();
              */
             String(const String& str);
 
+            /*!
+             * コンストラクタ（ヒープに確保したバッファは移動する）
+             */
+            String(String&& str);
+
             /*!
              * コンストラクタ
              */
@@ -68,7 +91,7 @@ public:     String();
             /*!
              * コンストラクタ
              */
-            String(const char* text, int16_t len);
+            String(const char* text, int32_t len);
 
             /*!
              * デストラクタ
@@ -78,7 +101,22 @@ public:     String();
             /*!
              * 初期化
              */
-private:    void init(const char* text, int16_t len);
+private:    void init(const char* text, int32_t len);
+
+            /*!
+             * バッファ解放
+             */
+            void release();
+
+            /*!
+             * 移動
+             */
+            void move(String* str);
+
+            /*!
+             * オブジェクト内のバッファに格納しているかどうか
+             */
+public:     bool isInline() const {return (mBuffer == mInline);}
 
             /*!
              * バッファアドレス取得
@@ -103,9 +141,7 @@ inline const String& String::operator=(const String& str)
 {
     if (this != &str)
     {
-        CoreString::operator=(str);
-
-        delete [] mBuffer;
+        release();
 //      init(str.getBuffer(), str.getCapacity());
         init(str.getBuffer(), str.getLength());
     }
@@ -113,6 +149,20 @@ inline const String& String::operator=(const String& str)
     return *this;
 }
 
+/*!
+ * \brief   代入
+ */
+inline const String& String::operator=(String&& str)
+{
+    if (this != &str)
+    {
+        release();
+        move(&str);
+    }
+
+    return *this;
+}
+
 /*!
  * \brief   コンストラクタ
  */
@@ -133,9 +183,17 @@ inline String::String(const String& str) : CoreString(str)
 /*!
  * \brief   コンストラクタ
  */
-inline String::String(const char* text, int16_t len)
+inline String::String(String&& str) : CoreString()
 {
-    for (int16_t i = 0; i < len; i++)
+    move(&str);
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+inline String::String(const char* text, int32_t len)
+{
+    for (int32_t i = 0; i < len; i++)
     {
         if (text[i] == '\0')
         {
@@ -148,11 +206,20 @@ inline String::String(const char* text, int16_t len)
 }
 
 /*!
- * \brief   コンストラクタ
+ * \brief   デストラクタ
  */
 inline String::~String()
 {
-    delete [] mBuffer;
+    release();
+}
+
+/*!
+ * \brief   バッファ解放
+ */
+inline void String::release()
+{
+    if (isInline() == false)
+        delete [] mBuffer;
 }
 
 /*!
@@ -117,10 +117,26 @@ protected:  virtual void initVariables() {}
              */
             void sendBinary(HtmlGenerator* generator, const CoreString* path) const;
 
+            /*!
+             * 圧縮ファイルを展開しながら送信
+             */
+            void sendCompressedBinary(const CoreString* path) const throw(Exception);
+
+            /*!
+             * バイナリ用HTTPヘッダー送信（Range、条件付きGET対応）
+             */
+            bool sendBinaryHeader(const DateTime* lastModified, int64_t size, int64_t* position, int64_t* count) const;
+
+            /*!
+             * バイナリ用HTTPヘッダー取得（Range、条件付きGET対応）
+             */
+            bool getBinaryHeader(const DateTime* lastModified, int64_t size, int64_t* position, int64_t* count, const char** status, CoreString* headers) const;
+
             /*!
              * HTTPヘッダー送信（＆切断）
              */
-            void sendHttpHeader(const DateTime* lastModified, int32_t contentLen) const;
+            void sendHttpHeader(const DateTime* lastModified, int64_t contentLen) const;
+            void sendHttpHeader(const char* status, const DateTime* lastModified, int64_t contentLen, const CoreString* extraHeaders) const;
 
             /*!
              * 応答内容送信＆切断
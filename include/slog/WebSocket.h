@@ -38,6 +38,9 @@ class SLOG_API WebSocket : public Socket
             bool                mIsText;        //!< 送信データがテキストかどうか
             Mutex*              mMutex;         //!< ミューテックス
             WebSocketReceiver*  mReceiver;      //!< Web Socket 受信
+            uint64_t            mMaskSeed;      //!< マスキングキー生成用の乱数の状態
+            char                mMaskKey[4];    //!< 送信中のフレームのマスキングキー
+            uint64_t            mMaskOffset;    //!< 送信中のフレームのマスク済みバイト数
 
             /*!
              * コンストラクタ／デストラクタ
@@ -64,7 +67,18 @@ public:     virtual int close() override;
              * Web Socket ヘッダー送信
              */
 public:            void sendHeader(                uint64_t payloadLen, bool isText = true)                       throw(Exception);
-            static void sendHeader(Socket* socket, uint64_t payloadLen, bool isText = true, bool toClient = true) throw(Exception);
+            static void sendHeader(Socket* socket, uint64_t payloadLen, bool isText = true, bool toClient = true, const char* maskingKey = nullptr) throw(Exception);
+
+            /*!
+             * マスキングキー生成
+             */
+private:    void nextMaskKey();
+
+            /*!
+             * ペイロード送信（クライアントの場合はマスクする）
+             */
+            void sendPayload(const char* buffer, int32_t len) throw(Exception);
+            void sendPayloadInPlace(char* buffer, int32_t len) throw(Exception);
 
             /*!
              * 送信前チェック
@@ -79,6 +93,11 @@ public:     virtual void send(const  int32_t* value) const throw(Exception) over
             virtual void send(const Buffer* buffer, int32_t len) const throw(Exception) override;
             virtual void send(const char*   buffer, int32_t len) const throw(Exception) override;
 
+            /*!
+             * バイナリ送信（クライアントの場合はバッファ上でマスクして送信し、送信後に元に戻す）
+             */
+            void send(ByteBuffer* buffer, int32_t len) const throw(Exception);
+
             /*!
              * テキスト送信
              */
@@ -56,6 +56,12 @@
     #pragma warning(disable : 4793)
 #endif
 
+#if defined(_MSC_VER)
+    #define SLOG_THREAD_LOCAL   __declspec(thread)
+#else
+    #define SLOG_THREAD_LOCAL   __thread
+#endif
+
 #if defined(_WINDOWS)
     #define PATH_DELIMITER  '\\'
 #else
@@ -0,0 +1,914 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogAnalyzer.cpp
+ * \brief   シーケンスログ解析クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogAnalyzer.h"
+#include "SequenceLogFileReader.h"
+
+#include "slog/Thread.h"
+#include "slog/ByteBuffer.h"
+
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+
+/*!
+ * バッチのサイズ（最大サイズのレコードが必ず入る大きさ）
+ */
+static const int32_t BATCH_SIZE = 1024 * 1024;
+
+/*!
+ * スレッド毎に処理中にしておけるバッチの最大数
+ */
+static const int32_t MAX_BATCHES_PER_THREAD = 4;
+
+/*!
+ * レコードの最小サイズ（レコード長、シーケンス番号、日時、種別、スレッドID）
+ */
+static const int32_t MIN_RECORD_SIZE = 2 + 4 + 8 + 1 + 4;
+
+/*!
+ * \brief   レコード長取得
+ */
+static inline int32_t getRecordSize(const char* record)
+{
+    const uint8_t* p = (const uint8_t*)record;
+    return (p[0] << 8) | p[1];
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+AnalyzerBatch::AnalyzerBatch()
+{
+    seq = 0;
+    records = nullptr;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+AnalyzerBatch::~AnalyzerBatch()
+{
+    delete records;
+
+    for (auto i = names.begin(); i != names.end(); i++)
+        delete *i;
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+AnalyzerFunction::AnalyzerFunction() : histogram(BUCKET_COUNT)
+{
+    count = 0;
+    inclusive = 0;
+    exclusive = 0;
+    max = 0;
+}
+
+/*!
+ * \brief   所要時間を追加
+ */
+void AnalyzerFunction::add(int64_t inclusiveTime, int64_t exclusiveTime)
+{
+    count++;
+    inclusive += inclusiveTime;
+    exclusive += exclusiveTime;
+
+    if (max < inclusiveTime)
+        max = inclusiveTime;
+
+    histogram[getBucket(inclusiveTime)]++;
+}
+
+/*!
+ * \brief   集計を合算
+ */
+void AnalyzerFunction::merge(const AnalyzerFunction* other)
+{
+    count +=     other->count;
+    inclusive += other->inclusive;
+    exclusive += other->exclusive;
+
+    if (max < other->max)
+        max = other->max;
+
+    for (int32_t i = 0; i < BUCKET_COUNT; i++)
+        histogram[i] += other->histogram[i];
+}
+
+/*!
+ * \brief   パーセンタイル取得
+ *
+ * \param[in]   percentile  パーセンタイル（0〜100）
+ *
+ * \return  パーセンタイル値（バケット内の最大値、ただし最大値を超えない）
+ */
+int64_t AnalyzerFunction::getPercentile(int32_t percentile) const
+{
+    int64_t target = (count * percentile + 99) / 100;
+    int64_t sum = 0;
+
+    if (target == 0)
+        target = 1;
+
+    for (int32_t i = 0; i < BUCKET_COUNT; i++)
+    {
+        sum += histogram[i];
+
+        if (target <= sum)
+        {
+            int64_t value = (i + 1 < BUCKET_COUNT ? getBucketValue(i + 1) - 1 : max);
+            return std::min(value, max);
+        }
+    }
+
+    return max;
+}
+
+/*!
+ * \brief   バケット番号取得
+ *
+ * \note    LINEAR_COUNT未満の値はそのまま、それ以上は２のべき乗の区間をSUB_BUCKET_COUNTに分割したバケットに割り当てる。
+ */
+int32_t AnalyzerFunction::getBucket(int64_t value)
+{
+    if (value < LINEAR_COUNT)
+        return (int32_t)(value < 0 ? 0 : value);
+
+    if (((int64_t)1 << (MAX_EXPONENT + 1)) <= value)
+        return BUCKET_COUNT - 1;
+
+    int32_t exponent = SUB_BUCKET_BITS + 1;
+
+    while (((int64_t)1 << (exponent + 1)) <= value)
+        exponent++;
+
+    int32_t sub = (int32_t)(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return LINEAR_COUNT + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT + sub;
+}
+
+/*!
+ * \brief   バケットの下限値取得
+ */
+int64_t AnalyzerFunction::getBucketValue(int32_t bucket)
+{
+    if (bucket < LINEAR_COUNT)
+        return bucket;
+
+    int32_t exponent = (bucket - LINEAR_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS + 1;
+    int32_t sub =      (bucket - LINEAR_COUNT) % SUB_BUCKET_COUNT;
+
+    return (int64_t)(SUB_BUCKET_COUNT + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+/*!
+ * \brief   読み込みスレッド
+ *
+ * \note    ストリームのシーケンスログファイルを順に読み込み、レコードをバッチに詰めて渡す。
+ */
+class AnalyzerReader : public Thread
+{
+            SequenceLogAnalyzer* mAnalyzer;
+
+            /*!
+             * コンストラクタ
+             */
+public:     AnalyzerReader(SequenceLogAnalyzer* analyzer) {mAnalyzer = analyzer;}
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override
+            {
+                AnalyzerStream* stream;
+
+                while ((stream = mAnalyzer->popStream()) != nullptr)
+                    read(stream);
+            }
+
+            /*!
+             * ストリーム読み込み
+             */
+            void read(AnalyzerStream* stream);
+};
+
+/*!
+ * \brief   ストリーム読み込み
+ */
+void AnalyzerReader::read(AnalyzerStream* stream)
+{
+    AnalyzerBatch* batch = nullptr;
+    int32_t seq = 0;
+
+    for (auto i = stream->mPaths.begin(); i != stream->mPaths.end(); i++)
+    {
+        try
+        {
+            SequenceLogFileReader reader;
+            reader.open(*i);
+
+            SequenceLogByteBuffer* record;
+
+            while ((record = reader.readRecord()) != nullptr)
+            {
+                int32_t size = getRecordSize(record->getBuffer());
+
+                if (batch && BATCH_SIZE < batch->records->getPosition() + size)
+                {
+                    mAnalyzer->pushBatch(stream, batch);
+                    batch = nullptr;
+                }
+
+                if (batch == nullptr)
+                {
+                    batch = new AnalyzerBatch;
+                    batch->seq = seq++;
+                    batch->records = new ByteBuffer(BATCH_SIZE);
+                }
+
+                batch->records->put(record, size);
+            }
+        }
+        catch (Exception& e)
+        {
+            fprintf(stderr, "%s: %s\n", (*i)->getBuffer(), e.getMessage());
+        }
+    }
+
+    if (batch)
+        mAnalyzer->pushBatch(stream, batch);
+}
+
+/*!
+ * \brief   デコードスレッド
+ *
+ * \note    バッチのレコードをデコードし、ストリームに渡す。
+ */
+class AnalyzerDecoder : public Thread
+{
+            SequenceLogAnalyzer* mAnalyzer;
+
+            /*!
+             * コンストラクタ
+             */
+public:     AnalyzerDecoder(SequenceLogAnalyzer* analyzer) {mAnalyzer = analyzer;}
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override
+            {
+                AnalyzerStream* stream;
+                AnalyzerBatch* batch;
+
+                while (mAnalyzer->popBatch(&stream, &batch))
+                {
+                    decode(batch);
+                    stream->complete(batch, mAnalyzer);
+                }
+            }
+
+            /*!
+             * バッチのデコード
+             */
+            void decode(AnalyzerBatch* batch);
+};
+
+/*!
+ * \brief   バッチのデコード
+ *
+ * \note    関数名は "クラス名::関数名" としてバッチ内で番号を振る。名前ではなくIDで出力された関数は "#ID" を名前とする。
+ */
+void AnalyzerDecoder::decode(AnalyzerBatch* batch)
+{
+    SequenceLogByteBuffer record(0xFFFF);
+    SequenceLogItem item;
+    std::map<String, int32_t> names;
+
+    String className;
+    String funcName;
+    String key;
+
+    const char* p = batch->records->getBuffer();
+    int32_t length = batch->records->getPosition();
+    int32_t offset = 0;
+
+    try
+    {
+        while (offset < length)
+        {
+            // レコード長が不正な場合は先に進めないので、バッチの残りは読まない
+            int32_t size = (2 <= length - offset ? getRecordSize(p + offset) : 0);
+
+            if (size < MIN_RECORD_SIZE || length - offset < size)
+            {
+                Exception e;
+                e.setMessage("AnalyzerDecoder::decode() size=%d / illegal record", size);
+
+                throw e;
+            }
+
+            memcpy(record.getBuffer(), p + offset, size);
+            offset += size;
+
+            record.getSequenceLogItem(&item, true);
+
+            AnalyzerEvent event;
+            event.dateTime = item.mDateTime.toMilliSeconds();
+            event.threadId = item.mThreadId;
+            event.seqNo =    item.mSeqNo;
+            event.name =     -1;
+            event.type =     (uint8_t)item.mType;
+
+            if (item.mType == SequenceLogItem::STEP_IN)
+            {
+                if (item.mClassId)
+                    className.format("#%u", item.mClassId);
+                else
+                    className.copy(item.getClassName());
+
+                if (item.mFuncId)
+                    funcName.format("#%u", item.mFuncId);
+                else
+                    funcName.copy(item.getFuncName());
+
+                key.copy(&className);
+                key.append("::");
+                key.append(&funcName);
+
+                auto i = names.find(key);
+
+                if (i == names.end())
+                {
+                    String* name = new String;
+                    name->copy(&key);
+
+                    event.name = (int32_t)batch->names.size();
+                    batch->names.push_back(name);
+                    names[key] = event.name;
+                }
+                else
+                {
+                    event.name = i->second;
+                }
+            }
+
+            batch->events.push_back(event);
+        }
+    }
+    catch (Exception& e)
+    {
+        fprintf(stderr, "%s\n", e.getMessage());
+    }
+
+    delete batch->records;
+    batch->records = nullptr;
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+AnalyzerStream::AnalyzerStream()
+{
+    mNext = 0;
+    mStitching = false;
+    mLastDateTime = 0;
+
+    // ルート
+    AnalyzerNode root;
+    root.parent = -1;
+    root.function = -1;
+    root.exclusive = 0;
+
+    mNodes.push_back(root);
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+AnalyzerStream::~AnalyzerStream()
+{
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        delete *i;
+
+    for (auto i = mFunctions.begin(); i != mFunctions.end(); i++)
+        delete *i;
+
+    for (auto i = mPending.begin(); i != mPending.end(); i++)
+        delete i->second;
+}
+
+/*!
+ * \brief   デコード済みのバッチを渡す
+ *
+ * \param[in]   batch       デコード済みのバッチ
+ * \param[in]   analyzer    シーケンスログ解析
+ *
+ * \return  なし
+ *
+ * \note    順番が来たバッチから復元する。他のスレッドが復元中であれば、そのスレッドに任せる。
+ */
+void AnalyzerStream::complete(AnalyzerBatch* batch, SequenceLogAnalyzer* analyzer)
+{
+    {
+        ScopedLock lock(&mMutex);
+        mPending[batch->seq] = batch;
+
+        if (mStitching)
+            return;
+
+        mStitching = true;
+    }
+
+    while (true)
+    {
+        AnalyzerBatch* next;
+
+        {
+            ScopedLock lock(&mMutex);
+            auto i = mPending.find(mNext);
+
+            if (i == mPending.end())
+            {
+                mStitching = false;
+                return;
+            }
+
+            next = i->second;
+            mPending.erase(i);
+            mNext++;
+        }
+
+        stitch(next);
+        delete next;
+
+        analyzer->releaseBatch();
+    }
+}
+
+/*!
+ * \brief   バッチから呼び出しを復元
+ *
+ * \note    STEP_OUTがないまま別の関数のアイテムが来た場合は、そのアイテムの日時で呼び出し中の関数を終了する。
+ */
+void AnalyzerStream::stitch(const AnalyzerBatch* batch)
+{
+    // バッチ内の関数名の番号をストリーム内の番号に変換
+    std::vector<int32_t> functions(batch->names.size());
+
+    for (int32_t i = 0; i < (int32_t)batch->names.size(); i++)
+    {
+        const String* name = batch->names[i];
+        auto j = mFunctionIds.find(*name);
+
+        if (j == mFunctionIds.end())
+        {
+            AnalyzerFunction* function = new AnalyzerFunction;
+            function->name.copy(name);
+
+            functions[i] = (int32_t)mFunctions.size();
+            mFunctions.push_back(function);
+            mFunctionIds[*name] = functions[i];
+        }
+        else
+        {
+            functions[i] = j->second;
+        }
+    }
+
+    for (auto i = batch->events.begin(); i != batch->events.end(); i++)
+    {
+        const AnalyzerEvent* event = &(*i);
+        std::vector<AnalyzerFrame>* stack = &mStacks[event->threadId];
+
+        if (mLastDateTime < event->dateTime)
+            mLastDateTime = event->dateTime;
+
+        if (event->type == SequenceLogItem::STEP_IN)
+        {
+            int32_t parent = (stack->empty() ? 0 : stack->back().node);
+            int32_t function = functions[event->name];
+
+            auto child = mNodes[parent].children.find(function);
+            int32_t node;
+
+            if (child == mNodes[parent].children.end())
+            {
+                AnalyzerNode newNode;
+                newNode.parent = parent;
+                newNode.function = function;
+                newNode.exclusive = 0;
+
+                node = (int32_t)mNodes.size();
+                mNodes.push_back(newNode);
+                mNodes[parent].children[function] = node;
+            }
+            else
+            {
+                node = child->second;
+            }
+
+            AnalyzerFrame frame;
+            frame.seqNo =    event->seqNo;
+            frame.node =     node;
+            frame.start =    event->dateTime;
+            frame.children = 0;
+
+            stack->push_back(frame);
+            continue;
+        }
+
+        while (stack->size() && stack->back().seqNo != event->seqNo)
+            pop(stack, event->dateTime);
+
+        if (event->type == SequenceLogItem::STEP_OUT && stack->size())
+            pop(stack, event->dateTime);
+    }
+}
+
+/*!
+ * \brief   関数終了
+ */
+void AnalyzerStream::pop(std::vector<AnalyzerFrame>* stack, int64_t end)
+{
+    AnalyzerFrame frame = stack->back();
+    stack->pop_back();
+
+    int64_t inclusiveTime = std::max(end - frame.start, (int64_t)0);
+    int64_t exclusiveTime = std::max(inclusiveTime - frame.children, (int64_t)0);
+
+    AnalyzerNode* node = &mNodes[frame.node];
+    node->exclusive += exclusiveTime;
+    mFunctions[node->function]->add(inclusiveTime, exclusiveTime);
+
+    if (stack->size())
+        stack->back().children += inclusiveTime;
+}
+
+/*!
+ * \brief   呼び出し中の関数を全て終了
+ *
+ * \note    最後のアイテムの日時で終了する。
+ */
+void AnalyzerStream::close()
+{
+    for (auto i = mStacks.begin(); i != mStacks.end(); i++)
+    {
+        std::vector<AnalyzerFrame>* stack = &i->second;
+
+        while (stack->size())
+            pop(stack, mLastDateTime);
+    }
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogAnalyzer::SequenceLogAnalyzer()
+{
+    mThreadCount = 4;
+    mInFlight = 0;
+    mReadEnd = false;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogAnalyzer::~SequenceLogAnalyzer()
+{
+    for (auto i = mStreams.begin(); i != mStreams.end(); i++)
+        delete *i;
+
+    for (auto i = mFunctions.begin(); i != mFunctions.end(); i++)
+        delete i->second;
+}
+
+/*!
+ * \brief   シーケンスログファイル追加
+ *
+ * \param[in]   path    シーケンスログファイルのパス
+ *
+ * \return  なし
+ *
+ * \note    ファイル名は "名前-プロセスID-日付-時刻-ミリ秒.拡張子" の形式で、"名前-プロセスID" が同じファイルを同じストリームにする。
+ */
+void SequenceLogAnalyzer::add(const CoreString* path)
+{
+    const char* p = path->getBuffer();
+    const char* fileName = strrchr(p, PATH_DELIMITER);
+    fileName = (fileName ? fileName + 1 : p);
+
+    // 後ろから３つ目の '-' までをキーにする
+    String key;
+    key.copy(path);
+
+    int32_t len = (int32_t)strlen(fileName);
+    int32_t hyphens = 0;
+
+    for (int32_t i = len - 1; 0 <= i; i--)
+    {
+        if (fileName[i] != '-')
+            continue;
+
+        if (++hyphens == 3)
+        {
+            key.copy(fileName, i);
+            break;
+        }
+    }
+
+    AnalyzerStream* stream = nullptr;
+
+    for (auto i = mStreams.begin(); i != mStreams.end(); i++)
+    {
+        if ((*i)->mKey.equals(&key))
+        {
+            stream = *i;
+            break;
+        }
+    }
+
+    if (stream == nullptr)
+    {
+        stream = new AnalyzerStream;
+        stream->mKey.copy(&key);
+        mStreams.push_back(stream);
+    }
+
+    String* str = new String;
+    str->copy(path);
+
+    stream->mPaths.push_back(str);
+}
+
+/*!
+ * \brief   ファイル名の比較（日時順）
+ */
+static bool comparePath(const String* path1, const String* path2)
+{
+    const char* fileName1 = strrchr(path1->getBuffer(), PATH_DELIMITER);
+    const char* fileName2 = strrchr(path2->getBuffer(), PATH_DELIMITER);
+
+    fileName1 = (fileName1 ? fileName1 + 1 : path1->getBuffer());
+    fileName2 = (fileName2 ? fileName2 + 1 : path2->getBuffer());
+
+    return (strcmp(fileName1, fileName2) < 0);
+}
+
+/*!
+ * \brief   解析
+ */
+void SequenceLogAnalyzer::analyze()
+{
+    for (auto i = mStreams.begin(); i != mStreams.end(); i++)
+    {
+        std::sort((*i)->mPaths.begin(), (*i)->mPaths.end(), comparePath);
+        mUnread.push_back(*i);
+    }
+
+    // ストリーム毎に読み込み、バッチ毎にデコードする
+    std::list<Thread*> readers;
+    std::list<Thread*> decoders;
+
+    int32_t readerCount = std::min(mThreadCount, (int32_t)mStreams.size());
+
+    for (int32_t i = 0; i < readerCount; i++)
+    {
+        Thread* thread = new AnalyzerReader(this);
+        thread->start();
+        readers.push_back(thread);
+    }
+
+    for (int32_t i = 0; i < mThreadCount; i++)
+    {
+        Thread* thread = new AnalyzerDecoder(this);
+        thread->start();
+        decoders.push_back(thread);
+    }
+
+    for (auto i = readers.begin(); i != readers.end(); i++)
+    {
+        (*i)->join();
+        delete *i;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mReadEnd = true;
+        mCondition.notify_all();
+    }
+
+    for (auto i = decoders.begin(); i != decoders.end(); i++)
+    {
+        (*i)->join();
+        delete *i;
+    }
+
+    // ストリーム毎の結果を集計
+    for (auto i = mStreams.begin(); i != mStreams.end(); i++)
+    {
+        (*i)->close();
+        merge(*i);
+    }
+}
+
+/*!
+ * \brief   ストリームの結果を集計
+ */
+void SequenceLogAnalyzer::merge(const AnalyzerStream* stream)
+{
+    for (auto i = stream->mFunctions.begin(); i != stream->mFunctions.end(); i++)
+    {
+        const AnalyzerFunction* function = *i;
+        AnalyzerFunction*& total = mFunctions[function->name];
+
+        if (total == nullptr)
+        {
+            total = new AnalyzerFunction;
+            total->name.copy(&function->name);
+        }
+
+        total->merge(function);
+    }
+
+    // 呼び出しツリーを折り畳んだスタックに変換
+    std::vector<const String*> names;
+    std::string folded;
+
+    for (int32_t i = 1; i < (int32_t)stream->mNodes.size(); i++)
+    {
+        const AnalyzerNode* node = &stream->mNodes[i];
+
+        if (node->exclusive == 0)
+            continue;
+
+        names.clear();
+
+        for (int32_t j = i; 0 < j; j = stream->mNodes[j].parent)
+            names.push_back(&stream->mFunctions[stream->mNodes[j].function]->name);
+
+        folded.clear();
+
+        for (auto j = names.rbegin(); j != names.rend(); j++)
+        {
+            if (folded.size())
+                folded.append(";");
+
+            folded.append((*j)->getBuffer(), (*j)->getLength());
+        }
+
+        mFoldedStacks[folded] += node->exclusive;
+    }
+}
+
+/*!
+ * \brief   所要時間の合計の比較（大きい順）
+ */
+static bool compareFunction(const AnalyzerFunction* function1, const AnalyzerFunction* function2)
+{
+    return (function1->inclusive > function2->inclusive);
+}
+
+/*!
+ * \brief   関数毎の所要時間を出力
+ *
+ * \param[in]   fp      出力先
+ * \param[in]   limit   関数の最大数（所要時間の合計が大きい順、負の値は制限なし）
+ *
+ * \return  なし
+ */
+void SequenceLogAnalyzer::printFunctions(FILE* fp, int32_t limit) const
+{
+    std::vector<const AnalyzerFunction*> functions;
+
+    for (auto i = mFunctions.begin(); i != mFunctions.end(); i++)
+        functions.push_back(i->second);
+
+    std::sort(functions.begin(), functions.end(), compareFunction);
+
+    if (0 <= limit && limit < (int32_t)functions.size())
+        functions.resize(limit);
+
+    fprintf(fp, "%10s %12s %12s %10s %8s %8s %8s %8s  %s\n",
+        "count", "total(ms)", "self(ms)", "mean(ms)", "p50", "p90", "p99", "max", "function");
+
+    for (auto i = functions.begin(); i != functions.end(); i++)
+    {
+        const AnalyzerFunction* function = *i;
+        double mean = (function->count ? (double)function->inclusive / function->count : 0);
+
+        fprintf(fp, "%10lld %12lld %12lld %10.2f %8lld %8lld %8lld %8lld  %s\n",
+            (long long)function->count,
+            (long long)function->inclusive,
+            (long long)function->exclusive,
+            mean,
+            (long long)function->getPercentile(50),
+            (long long)function->getPercentile(90),
+            (long long)function->getPercentile(99),
+            (long long)function->max,
+            function->name.getBuffer());
+    }
+}
+
+/*!
+ * \brief   折り畳んだスタックを出力
+ *
+ * \note    "関数;関数;… 所要時間（ミリ秒、呼び出した関数を除く）" の形式で、flamegraph.pl などにそのまま渡せる。
+ */
+void SequenceLogAnalyzer::printFoldedStacks(FILE* fp) const
+{
+    for (auto i = mFoldedStacks.begin(); i != mFoldedStacks.end(); i++)
+        fprintf(fp, "%s %lld\n", i->first.c_str(), (long long)i->second);
+}
+
+/*!
+ * \brief   読み込むストリーム取得
+ *
+ * \return  ストリーム（全て読み込み済みの場合はnullptr）
+ */
+AnalyzerStream* SequenceLogAnalyzer::popStream()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mUnread.empty())
+        return nullptr;
+
+    AnalyzerStream* stream = mUnread.front();
+    mUnread.pop_front();
+
+    return stream;
+}
+
+/*!
+ * \brief   読み込んだバッチを渡す
+ *
+ * \note    処理中のバッチが上限に達している場合は、減るまで待つ。
+ */
+void SequenceLogAnalyzer::pushBatch(AnalyzerStream* stream, AnalyzerBatch* batch)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (mThreadCount * MAX_BATCHES_PER_THREAD <= mInFlight)
+        mCondition.wait(lock);
+
+    mQueue.push_back(std::make_pair(stream, batch));
+    mInFlight++;
+    mCondition.notify_all();
+}
+
+/*!
+ * \brief   デコードするバッチ取得
+ *
+ * \return  バッチを取得した場合はtrue、全て処理した場合はfalseを返す
+ */
+bool SequenceLogAnalyzer::popBatch(AnalyzerStream** stream, AnalyzerBatch** batch)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (mQueue.empty() && mReadEnd == false)
+        mCondition.wait(lock);
+
+    if (mQueue.empty())
+        return false;
+
+    *stream = mQueue.front().first;
+    *batch =  mQueue.front().second;
+    mQueue.pop_front();
+    return true;
+}
+
+/*!
+ * \brief   処理を終えたバッチを解放
+ */
+void SequenceLogAnalyzer::releaseBatch()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mInFlight--;
+    mCondition.notify_all();
+}
+
+} // namespace slog
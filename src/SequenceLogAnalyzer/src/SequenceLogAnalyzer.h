@@ -0,0 +1,334 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogAnalyzer.h
+ * \brief   シーケンスログ解析クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/String.h"
+#include "slog/Mutex.h"
+
+#include <stdio.h>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace slog
+{
+class ByteBuffer;
+class SequenceLogAnalyzer;
+
+/*!
+ * \brief   デコード済みのシーケンスログアイテム
+ */
+struct AnalyzerEvent
+{
+            int64_t     dateTime;       //!< 日時（ミリ秒）
+            uint32_t    threadId;       //!< スレッドID
+            uint32_t    seqNo;          //!< シーケンス番号
+            int32_t     name;           //!< 関数名（バッチ内の番号、STEP_IN以外は-1）
+            uint8_t     type;           //!< シーケンスログアイテム種別
+};
+
+/*!
+ * \brief   バッチ（ファイルから読み込んだレコードの塊）
+ */
+struct AnalyzerBatch
+{
+            int32_t                     seq;        //!< ストリーム内の順番
+            ByteBuffer*                 records;    //!< レコード（デコード後に削除）
+            std::vector<AnalyzerEvent>  events;     //!< デコード済みのアイテム
+            std::vector<String*>        names;      //!< 関数名（"クラス名::関数名"）
+
+            AnalyzerBatch();
+            ~AnalyzerBatch();
+};
+
+/*!
+ * \brief   関数毎の集計
+ */
+struct AnalyzerFunction
+{
+            enum
+            {
+                SUB_BUCKET_BITS =   5,                                  //!< ２のべき乗の区間を分割する数（ビット数）
+                SUB_BUCKET_COUNT =  1 << SUB_BUCKET_BITS,
+                LINEAR_COUNT =      SUB_BUCKET_COUNT * 2,               //!< 値をそのままバケット番号にする範囲
+                MAX_EXPONENT =      40,                                 //!< 最大の指数（約35年）
+                BUCKET_COUNT =      LINEAR_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT,
+            };
+
+            String                  name;           //!< 関数名（"クラス名::関数名"）
+            int64_t                 count;          //!< 呼び出し回数
+            int64_t                 inclusive;      //!< 所要時間の合計（ミリ秒、呼び出した関数を含む）
+            int64_t                 exclusive;      //!< 所要時間の合計（ミリ秒、呼び出した関数を除く）
+            int64_t                 max;            //!< 最大所要時間（ミリ秒）
+            std::vector<int64_t>    histogram;      //!< 所要時間のヒストグラム
+
+            AnalyzerFunction();
+
+            void add(int64_t inclusiveTime, int64_t exclusiveTime);
+            void merge(const AnalyzerFunction* other);
+            int64_t getPercentile(int32_t percentile) const;
+
+            static int32_t getBucket(int64_t value);
+            static int64_t getBucketValue(int32_t bucket);
+};
+
+/*!
+ * \brief   呼び出しツリーのノード
+ */
+struct AnalyzerNode
+{
+            int32_t                     parent;     //!< 親ノード
+            int32_t                     function;   //!< 関数（ストリーム内の番号）
+            int64_t                     exclusive;  //!< 所要時間の合計（ミリ秒、呼び出した関数を除く）
+            std::map<int32_t, int32_t>  children;   //!< 子ノード（キーは関数）
+};
+
+/*!
+ * \brief   呼び出し中の関数
+ */
+struct AnalyzerFrame
+{
+            uint32_t    seqNo;          //!< シーケンス番号
+            int32_t     node;           //!< 呼び出しツリーのノード
+            int64_t     start;          //!< 開始日時（ミリ秒）
+            int64_t     children;       //!< 呼び出した関数の所要時間（ミリ秒）
+};
+
+/*!
+ * \brief   ストリーム（同じプロセスが出力したシーケンスログファイルの並び）
+ *
+ * \note    バッチは並列にデコードし、呼び出しの復元はストリーム内の順番どおりに一つずつ行う。
+ */
+class AnalyzerStream
+{
+            /*!
+             * ストリームのキー（"名前-プロセスID"）
+             */
+public:     String mKey;
+
+            /*!
+             * シーケンスログファイル（日時順）
+             */
+            std::vector<String*> mPaths;
+
+            /*!
+             * ミューテックス（復元待ちのバッチ、次に復元するバッチ、復元中かどうか）
+             */
+private:    Mutex mMutex;
+
+            /*!
+             * 復元待ちのバッチ
+             */
+            std::map<int32_t, AnalyzerBatch*> mPending;
+
+            /*!
+             * 次に復元するバッチの順番
+             */
+            int32_t mNext;
+
+            /*!
+             * 復元中かどうか
+             */
+            bool mStitching;
+
+            /*!
+             * 関数名から関数の番号へのマップ
+             */
+            std::map<String, int32_t> mFunctionIds;
+
+            /*!
+             * 関数毎の集計
+             */
+public:     std::vector<AnalyzerFunction*> mFunctions;
+
+            /*!
+             * 呼び出しツリー（先頭はルート）
+             */
+            std::vector<AnalyzerNode> mNodes;
+
+            /*!
+             * 呼び出し中の関数（キーはスレッドID）
+             */
+private:    std::map<uint32_t, std::vector<AnalyzerFrame> > mStacks;
+
+            /*!
+             * 最後のアイテムの日時（ミリ秒）
+             */
+            int64_t mLastDateTime;
+
+            /*!
+             * コンストラクタ
+             */
+public:     AnalyzerStream();
+
+            /*!
+             * デストラクタ
+             */
+            ~AnalyzerStream();
+
+            /*!
+             * デコード済みのバッチを渡す
+             */
+            void complete(AnalyzerBatch* batch, SequenceLogAnalyzer* analyzer);
+
+            /*!
+             * 呼び出し中の関数を全て終了
+             */
+            void close();
+
+            /*!
+             * バッチから呼び出しを復元
+             */
+private:    void stitch(const AnalyzerBatch* batch);
+
+            /*!
+             * 関数終了
+             */
+            void pop(std::vector<AnalyzerFrame>* stack, int64_t end);
+};
+
+/*!
+ * \brief   シーケンスログ解析クラス
+ *
+ * \note    バイナリ形式のシーケンスログファイルを読み込み、スレッド毎に呼び出しを復元して、
+ *          関数毎の所要時間（パーセンタイル）と、フレームグラフ用の折り畳んだスタックを出力する。
+ *          ファイル名が "名前-プロセスID-" まで同じファイルは一つのストリームとして日時順に続けて復元する。
+ *          ストリーム毎の読み込みスレッドがレコードを約1MBのバッチに分け、デコードスレッドが並列にデコードする。
+ *          処理中のバッチの数を制限するので、メモリ使用量はファイルサイズによらない。
+ */
+class SequenceLogAnalyzer
+{
+            /*!
+             * ストリーム
+             */
+            std::vector<AnalyzerStream*> mStreams;
+
+            /*!
+             * スレッド数
+             */
+            int32_t mThreadCount;
+
+            /*!
+             * ミューテックス（未読み込みのストリーム、デコード待ちのバッチ、処理中のバッチ数、読み込み終了）
+             */
+            std::mutex mMutex;
+
+            /*!
+             * デコード待ちのバッチ、処理中のバッチ数、読み込み終了が変わったことの通知
+             */
+            std::condition_variable mCondition;
+
+            /*!
+             * 未読み込みのストリーム
+             */
+            std::list<AnalyzerStream*> mUnread;
+
+            /*!
+             * デコード待ちのバッチ
+             */
+            std::list<std::pair<AnalyzerStream*, AnalyzerBatch*> > mQueue;
+
+            /*!
+             * 処理中のバッチ数
+             */
+            int32_t mInFlight;
+
+            /*!
+             * 全てのストリームを読み込み終えたかどうか
+             */
+            bool mReadEnd;
+
+            /*!
+             * 関数毎の集計（全ストリーム、キーは関数名）
+             */
+            std::map<String, AnalyzerFunction*> mFunctions;
+
+            /*!
+             * 折り畳んだスタック毎の所要時間（全ストリーム、呼び出しが深いと長くなるのでstd::stringで持つ）
+             */
+            std::map<std::string, int64_t> mFoldedStacks;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogAnalyzer();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogAnalyzer();
+
+            /*!
+             * スレッド数設定
+             */
+            void setThreadCount(int32_t count) {mThreadCount = (0 < count ? count : 1);}
+
+            /*!
+             * シーケンスログファイル追加
+             */
+            void add(const CoreString* path);
+
+            /*!
+             * 解析
+             */
+            void analyze();
+
+            /*!
+             * 関数毎の所要時間を出力
+             */
+            void printFunctions(FILE* fp, int32_t limit) const;
+
+            /*!
+             * 折り畳んだスタックを出力
+             */
+            void printFoldedStacks(FILE* fp) const;
+
+            /*!
+             * 読み込むストリーム取得
+             */
+            AnalyzerStream* popStream();
+
+            /*!
+             * 読み込んだバッチを渡す
+             */
+            void pushBatch(AnalyzerStream* stream, AnalyzerBatch* batch);
+
+            /*!
+             * デコードするバッチ取得
+             */
+            bool popBatch(AnalyzerStream** stream, AnalyzerBatch** batch);
+
+            /*!
+             * 処理を終えたバッチを解放
+             */
+            void releaseBatch();
+
+            /*!
+             * ストリームの結果を集計
+             */
+private:    void merge(const AnalyzerStream* stream);
+};
+
+} // namespace slog
@@ -0,0 +1,124 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    main.cpp
+ * \brief   シーケンスログ解析
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogAnalyzer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <string.h>
+#endif
+
+using namespace slog;
+
+/*!
+ * \brief   使い方を表示
+ */
+static void usage()
+{
+    printf(
+        "usage: sloganalyze [-j threads] [-n count] [-f folded] file...\n"
+        "  -j threads   number of decoding threads (default 4)\n"
+        "  -n count     number of functions to print, -1 for all (default 50)\n"
+        "  -f folded    write folded stacks for flame graphs to the file ('-' for stdout)\n");
+}
+
+/*!
+ * \brief   メイン
+ */
+int main(int argc, char** argv)
+{
+    SequenceLogAnalyzer analyzer;
+    const char* foldedPath = nullptr;
+    int32_t limit = 50;
+    int32_t fileCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+
+        if (strcmp(arg, "-j") == 0 || strcmp(arg, "-n") == 0 || strcmp(arg, "-f") == 0)
+        {
+            if (argc <= i + 1)
+            {
+                printf("option requires an argument: '%s'\n", arg);
+                return 1;
+            }
+
+            const char* value = argv[++i];
+
+            switch (arg[1])
+            {
+            case 'j': analyzer.setThreadCount(atoi(value)); break;
+            case 'n': limit = atoi(value);                  break;
+            case 'f': foldedPath = value;                   break;
+            }
+
+            continue;
+        }
+
+        if (arg[0] == '-')
+        {
+            printf("invalid option: '%s'\n", arg);
+            usage();
+            return 1;
+        }
+
+        String path(arg);
+        analyzer.add(&path);
+        fileCount++;
+    }
+
+    if (fileCount == 0)
+    {
+        usage();
+        return 1;
+    }
+
+    analyzer.analyze();
+
+    FILE* folded = nullptr;
+
+    if (foldedPath)
+    {
+        folded = (strcmp(foldedPath, "-") == 0 ? stdout : fopen(foldedPath, "w"));
+
+        if (folded == nullptr)
+        {
+            printf("cannot open '%s'\n", foldedPath);
+            return 1;
+        }
+    }
+
+    if (folded != stdout)
+        analyzer.printFunctions(stdout, limit);
+
+    if (folded)
+    {
+        analyzer.printFoldedStacks(folded);
+
+        if (folded != stdout)
+            fclose(folded);
+    }
+
+    return 0;
+}
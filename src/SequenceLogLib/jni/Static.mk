@@ -42,7 +42,16 @@ LOCAL_SRC_FILES := \
     ../src/SequenceLog.cpp \
     ../src/jp_printf_slog_Log.cpp \
     ../src/SHA1.cpp \
-    ../src/SHA256.cpp
+    ../src/SHA256.cpp \
+    ../src/CompressedFile.cpp \
+    ../src/SequenceLogFileReader.cpp \
+    ../src/SequenceLogFileIndex.cpp \
+    ../src/SequenceLogArchive.cpp \
+    ../src/SequenceLogMerger.cpp \
+    ../src/SequenceLogTraceConverter.cpp \
+    ../src/StringKernel.cpp \
+    ../src/Format.cpp \
+    ../src/DateTimeFormat.cpp
 
 LOCAL_C_INCLUDES += \
     . \
@@ -15,6 +15,8 @@
  */
 package jp.printf.slog;
 
+import java.util.concurrent.ConcurrentHashMap;
+
 public final class Log
 {
     // ログレベル
@@ -28,10 +30,57 @@ public final class Log
      */
     public native static void loadConfig(String fileName);
 
+    // 呼び出し箇所ID（クラス名、関数名毎）
+    private static final ConcurrentHashMap<String, ConcurrentHashMap<String, Integer>> sSiteIds =
+        new ConcurrentHashMap<String, ConcurrentHashMap<String, Integer>>();
+
+    /**
+     * ステップイン
+     *
+     * 呼び出し箇所IDをキャッシュし、２回目からは文字列を変換せずにプリミティブだけでネイティブを呼び出す。
+     */
+    public static long stepIn(String className, String funcName)
+    {
+        int siteId = getSiteId(className, funcName);
+        return (0 <= siteId ? stepIn(siteId) : stepInByName(className, funcName));
+    }
+
+    /**
+     * 呼び出し箇所ID取得（static final に保持しておけば stepIn(int) を直接呼び出せる）
+     */
+    public static int getSiteId(String className, String funcName)
+    {
+        if (className == null || funcName == null)
+            return -1;
+
+        ConcurrentHashMap<String, Integer> funcs = sSiteIds.get(className);
+
+        if (funcs == null)
+        {
+            ConcurrentHashMap<String, Integer> newFuncs = new ConcurrentHashMap<String, Integer>();
+            funcs = sSiteIds.putIfAbsent(className, newFuncs);
+
+            if (funcs == null)
+                funcs = newFuncs;
+        }
+
+        Integer siteId = funcs.get(funcName);
+
+        if (siteId == null)
+        {
+            siteId = registerSite(className, funcName);
+            funcs.putIfAbsent(funcName, siteId);
+        }
+
+        return siteId;
+    }
+
     /**
      * ステップイン
      */
-    public  native static long stepIn(String className, String funcName);
+    public  native static long stepIn(int siteId);
+    private native static long stepInByName(String className, String funcName);
+    private native static int  registerSite(String className, String funcName);
 //  public  native static long stepIn(int classID,      String funcName);
 //  public  native static long stepIn(int classID,      int    funcID);
 
@@ -40,6 +89,16 @@ public final class Log
      */
     public native static void stepOut(long slog);
 
+    /**
+     * ハンドルなしのステップイン／アウト
+     *
+     * スレッド毎のフレームスタックを使う。stepInCurrent() から stepOutCurrent() までの
+     * v() などのメッセージ出力も含めて、すべて同じスレッドで呼び出すこと。
+     * 別のスレッドに処理を引き継ぐ場合はハンドルを返す stepIn() を使う。
+     */
+    public native static void stepInCurrent(String className, String funcName);
+    public native static void stepOutCurrent();
+
     /**
      * メッセージ出力
      */
@@ -48,6 +107,8 @@ public final class Log
 
     private native static void message(int level, String message,   String tag);
 
+    private native static void messageCurrent(int level, String message);
+
     public static void v(long slog/*tag*/, String message)              {message(DEBUG, message,   slog);}
     public static void d(long slog/*tag*/, String message)              {message(DEBUG, message,   slog);}
     public static void i(long slog/*tag*/, String message)              {message(INFO,  message,   slog);}
@@ -74,5 +135,12 @@ public final class Log
     public static void w(String tag,       String message, Throwable e) {message(WARN,  message,   tag);}
     public static void e(String tag,       String message, Throwable e) {message(ERROR, message,   tag);}
 
+    // stepInCurrent() したスレッドで呼び出すこと
+    public static void v(String message)                                {messageCurrent(DEBUG, message);}
+    public static void d(String message)                                {messageCurrent(DEBUG, message);}
+    public static void i(String message)                                {messageCurrent(INFO,  message);}
+    public static void w(String message)                                {messageCurrent(WARN,  message);}
+    public static void e(String message)                                {messageCurrent(ERROR, message);}
+
     public native static void assertThat(long slog/*tag*/, String assertName, boolean result);
 }
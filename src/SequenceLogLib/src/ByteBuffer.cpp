@@ -217,6 +217,45 @@ void ByteBuffer::putLong(int64_t value) throw(Exception)
     addPosition(len);
 }
 
+/*!
+ * \brief   可変長整数（７ビット単位）取得
+ */
+uint64_t ByteBuffer::getVarInt() throw(Exception)
+{
+    ByteBufferReader reader(this, getCapacity() - getPosition());
+    uint64_t value = reader.getVarInt();
+
+    reader.commit();
+    return value;
+}
+
+/*!
+ * \brief   可変長整数（７ビット単位）書き込み
+ */
+void ByteBuffer::putVarInt(uint64_t value) throw(Exception)
+{
+    ByteBufferWriter writer(this, getVarIntLength(value));
+
+    writer.putVarInt(value);
+    writer.commit();
+}
+
+/*!
+ * \brief   可変長整数（７ビット単位）のバイト数取得
+ */
+int32_t ByteBuffer::getVarIntLength(uint64_t value)
+{
+    int32_t len = 1;
+
+    while (0x80 <= value)
+    {
+        value >>= 7;
+        len++;
+    }
+
+    return len;
+}
+
 /*!
  * \brief   一括取得
  */
@@ -250,4 +289,18 @@ void ByteBuffer::put(const char* buffer, int32_t len) throw(Exception)
     addPosition(len);
 }
 
+/*!
+ * \brief   範囲外例外
+ */
+void ByteBufferReader::throwOverFlow(int32_t len) const throw(Exception)
+{
+    Exception e;
+
+    e.setMessage(
+        "ByteBufferReader capacity=%d, position=%d, len=%d / buffer overflow",
+        mBuffer->getCapacity(), mBuffer->getPosition() + getLength(), len);
+
+    throw e;
+}
+
 } // namespace slog
@@ -0,0 +1,865 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    CompressedFile.cpp
+ * \brief   圧縮ファイルクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "slog/CompressedFile.h"
+#include "slog/ByteBuffer.h"
+
+#include "SequenceLogArchive.h"
+
+#include <string.h>
+
+namespace slog
+{
+
+static const char    SIGNATURE[] =          "SLZ1";     //!< シグネチャ
+static const int32_t SIGNATURE_SIZE =       4;          //!< シグネチャのサイズ
+static const int32_t BLOCK_HEADER_SIZE =    4 + 4 + 1;  //!< ブロックヘッダーのサイズ
+static const int32_t MAX_RAW_BLOCK_SIZE =   16 * 1024 * 1024;
+
+static const uint8_t FLAG_LZ =              0x01;       //!< LZ圧縮
+static const uint8_t FLAG_DELTA =           0x02;       //!< シーケンス番号、日時を差分符号化
+
+static const int32_t MIN_MATCH =            4;          //!< 最小一致長
+static const int32_t MAX_OFFSET =           0xFFFF;     //!< 最大参照距離
+static const int32_t HASH_BITS =            13;
+
+/*!
+ * \brief   シーケンスログレコードヘッダーのサイズ（レコード長、シーケンス番号、日時）
+ */
+static const int32_t RECORD_HEADER_SIZE =   2 + 4 + 8;
+
+/*!
+ * \brief   圧縮ファイルの拡張子
+ */
+static const char COMPRESSED_EXT[] = ".slogz";
+
+static inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t getBE32(const uint8_t* p)
+{
+    return
+        ((uint32_t)p[0] << 24) |
+        ((uint32_t)p[1] << 16) |
+        ((uint32_t)p[2] <<  8) |
+        ((uint32_t)p[3]      );
+}
+
+static inline void putBE32(uint8_t* p, uint32_t value)
+{
+    p[0] = (value >> 24) & 0xFF;
+    p[1] = (value >> 16) & 0xFF;
+    p[2] = (value >>  8) & 0xFF;
+    p[3] = (value      ) & 0xFF;
+}
+
+static inline uint64_t getBE64(const uint8_t* p)
+{
+    return ((uint64_t)getBE32(p) << 32) | getBE32(p + 4);
+}
+
+static inline void putBE64(uint8_t* p, uint64_t value)
+{
+    putBE32(p,     (uint32_t)(value >> 32));
+    putBE32(p + 4, (uint32_t)(value      ));
+}
+
+/*!
+ * \brief   シーケンスログのシーケンス番号と日時を差分符号化する
+ *
+ * \param[in,out]   p       ブロック
+ * \param[in]       len     ブロックの長さ
+ * \param[in]       encode  符号化する場合はtrue、復号する場合はfalse
+ *
+ * \note    レコード長は書き換えないので、符号化・復号とも同じレコード境界を辿る
+ */
+static void deltaSequenceLog(uint8_t* p, int32_t len, bool encode)
+{
+    uint32_t prevSeqNo = 0;
+    uint64_t prevDateTime = 0;
+    int32_t pos = 0;
+
+    while (pos + RECORD_HEADER_SIZE <= len)
+    {
+        int32_t recordLen = ((int32_t)p[pos] << 8) | p[pos + 1];
+
+        if (recordLen < RECORD_HEADER_SIZE || len < pos + recordLen)
+            break;
+
+        uint8_t* seqNo =    p + pos + 2;
+        uint8_t* dateTime = p + pos + 6;
+
+        if (encode)
+        {
+            uint32_t value1 = getBE32(seqNo);
+            uint64_t value2 = getBE64(dateTime);
+
+            putBE32(seqNo,    value1 - prevSeqNo);
+            putBE64(dateTime, value2 - prevDateTime);
+
+            prevSeqNo = value1;
+            prevDateTime = value2;
+        }
+        else
+        {
+            prevSeqNo +=    getBE32(seqNo);
+            prevDateTime += getBE64(dateTime);
+
+            putBE32(seqNo,    prevSeqNo);
+            putBE64(dateTime, prevDateTime);
+        }
+
+        pos += recordLen;
+    }
+}
+
+/*!
+ * \brief   長さを書き込む（15以上の場合の追加バイト）
+ */
+static inline int32_t putLength(uint8_t* d, int32_t op, int32_t len)
+{
+    len -= 15;
+
+    while (255 <= len)
+    {
+        d[op++] = 255;
+        len -= 255;
+    }
+
+    d[op++] = (uint8_t)len;
+    return op;
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+CompressedFile::CompressedFile()
+{
+    mBlock = nullptr;
+    mWork = nullptr;
+    mBlockPosition = 0;
+    mSequenceLog = false;
+    mArchive = nullptr;
+    mArchiveGroup = 0;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+CompressedFile::~CompressedFile()
+{
+    close();
+
+    delete mBlock;
+    delete mWork;
+    delete mArchive;
+}
+
+/*!
+ * \brief   オープンしているか調べる
+ */
+bool CompressedFile::isOpen() const
+{
+    return (mFile.isOpen() || (mArchive && mArchive->isOpen()));
+}
+
+/*!
+ * \brief   オープン
+ *
+ * \param[in]   fileName    ファイル名
+ * \param[in]   mode        オープンモード
+ */
+void CompressedFile::open(const CoreString* fileName, File::Mode mode) throw(Exception)
+{
+    close();
+
+    reserve(&mBlock, BLOCK_SIZE);
+    mBlock->setPosition(0);
+    mBlock->setLength(0);
+    mBlockPosition = 0;
+
+    if (mode == File::READ && SequenceLogArchive::isArchiveFileName(fileName))
+    {
+        if (mArchive == nullptr)
+            mArchive = new SequenceLogArchive;
+
+        mArchive->open(fileName);
+        mArchiveGroup = 0;
+        return;
+    }
+
+    mFile.open(fileName, mode);
+
+    ByteBuffer signature(SIGNATURE_SIZE);
+
+    if (mode == File::WRITE)
+    {
+        signature.put(SIGNATURE, SIGNATURE_SIZE);
+        mFile.write(&signature, SIGNATURE_SIZE);
+        return;
+    }
+
+    if (mFile.read(&signature, SIGNATURE_SIZE) != SIGNATURE_SIZE ||
+        memcmp(signature.getBuffer(), SIGNATURE, SIGNATURE_SIZE) != 0)
+    {
+        mFile.close();
+
+        Exception e;
+        e.setMessage("CompressedFile::open(\"%s\") / illegal signature", fileName->getBuffer());
+
+        throw e;
+    }
+}
+
+/*!
+ * \brief   クローズ
+ */
+void CompressedFile::close()
+{
+    if (mArchive)
+        mArchive->close();
+
+    if (mFile.isOpen() == false)
+        return;
+
+    try
+    {
+        flush();
+    }
+    catch (Exception)
+    {
+    }
+
+    mFile.close();
+}
+
+/*!
+ * \brief   書き込み
+ *
+ * \param[in]   buffer  バッファ
+ * \param[in]   count   書き込むバイト数
+ *
+ * \note    シーケンスログの場合、レコードがブロックをまたがないように1レコードずつ書き込むこと
+ */
+void CompressedFile::write(const Buffer* buffer, int32_t count) throw(Exception)
+{
+    if (mFile.isOpen() == false)
+        return;
+
+    int32_t position = mBlock->getPosition();
+
+    if (BLOCK_SIZE < position + count && 0 < position)
+    {
+        flush();
+        position = 0;
+    }
+
+    reserve(&mBlock, position + count);
+    mBlock->put(buffer, count);
+
+    if (BLOCK_SIZE <= mBlock->getPosition())
+        flush();
+}
+
+/*!
+ * \brief   フラッシュ
+ */
+void CompressedFile::flush() throw(Exception)
+{
+    int32_t len = mBlock->getPosition();
+
+    if (len == 0)
+        return;
+
+    uint8_t* raw = (uint8_t*)mBlock->getBuffer();
+    uint8_t flags = 0;
+
+    if (mSequenceLog)
+    {
+        deltaSequenceLog(raw, len, true);
+        flags |= FLAG_DELTA;
+    }
+
+    reserve(&mWork, BLOCK_HEADER_SIZE + getCompressBound(len));
+    char* data = mWork->getBuffer() + BLOCK_HEADER_SIZE;
+
+    int32_t compressedLen = compress((const char*)raw, len, data, mWork->getCapacity() - BLOCK_HEADER_SIZE);
+
+    if (0 < compressedLen && compressedLen < len)
+    {
+        flags |= FLAG_LZ;
+    }
+    else
+    {
+        memcpy(data, raw, len);
+        compressedLen = len;
+    }
+
+    mWork->setPosition(0);
+    mWork->putInt(len);
+    mWork->putInt(compressedLen);
+    mWork->put((char)flags);
+
+    mBlock->setPosition(0);
+    mBlock->setLength(0);
+
+    // 追跡・検索・ダウンロードから読めるようにブロック単位でファイルに反映する
+    mFile.write(mWork, BLOCK_HEADER_SIZE + compressedLen);
+    mFile.flush();
+}
+
+/*!
+ * \brief   ブロックとして書き込んでいないデータのサイズ取得
+ */
+int32_t CompressedFile::getPendingSize() const
+{
+    return mBlock->getPosition();
+}
+
+/*!
+ * \brief   ブロック読み込み
+ *
+ * \return  ブロックを読み込めた場合はtrue、ファイルの終端（書き込み途中のブロックを含む）に達した場合はfalseを返す
+ */
+bool CompressedFile::readBlock() throw(Exception)
+{
+    if (mArchive && mArchive->isOpen())
+    {
+        // アーカイブはグループ単位で展開する
+        if (mArchive->getGroupCount() <= mArchiveGroup)
+            return false;
+
+        int32_t len = mArchive->getGroup(mArchiveGroup)->rawSize;
+        reserve(&mBlock, len);
+
+        mArchive->readGroup(mArchiveGroup, mBlock);
+        mArchiveGroup++;
+
+        mBlock->setPosition(0);
+        mBlock->setLength(len);
+        mBlockPosition = 0;
+
+        return true;
+    }
+
+    int64_t blockPosition = mFile.getPosition();
+    reserve(&mWork, BLOCK_HEADER_SIZE);
+
+    if (mFile.read(mWork, BLOCK_HEADER_SIZE) != BLOCK_HEADER_SIZE)
+    {
+        mFile.setPosition(blockPosition);
+        return false;
+    }
+
+    mWork->setPosition(0);
+    int32_t len =           mWork->getInt();
+    int32_t compressedLen = mWork->getInt();
+    uint8_t flags =         mWork->get();
+
+    if (len < 0 || MAX_RAW_BLOCK_SIZE < len || compressedLen < 0 || getCompressBound(len) < compressedLen)
+    {
+        Exception e;
+        e.setMessage("CompressedFile::readBlock() len=%d, compressedLen=%d / illegal block", len, compressedLen);
+
+        throw e;
+    }
+
+    reserve(&mWork, compressedLen);
+
+    if (mFile.read(mWork, compressedLen) != compressedLen)
+    {
+        mFile.setPosition(blockPosition);
+        return false;
+    }
+
+    reserve(&mBlock, len);
+    char* raw = mBlock->getBuffer();
+
+    if (flags & FLAG_LZ)
+    {
+        if (decompress(mWork->getBuffer(), compressedLen, raw, len) != len)
+        {
+            Exception e;
+            e.setMessage("CompressedFile::readBlock() / decompress failed");
+
+            throw e;
+        }
+    }
+    else
+    {
+        memcpy(raw, mWork->getBuffer(), len);
+    }
+
+    if (flags & FLAG_DELTA)
+        deltaSequenceLog((uint8_t*)raw, len, false);
+
+    mBlock->setPosition(0);
+    mBlock->setLength(len);
+    mBlockPosition = 0;
+
+    return true;
+}
+
+/*!
+ * \brief   読み込み
+ *
+ * \param[out]  buffer  読み込んだデータを受け取るバッファ
+ * \param[in]   count   読み込むバイト数
+ *
+ * \return  読み込んだバイト数
+ */
+int64_t CompressedFile::read(Buffer* buffer, int64_t count) throw(Exception)
+{
+    return read(buffer, 0, count);
+}
+
+/*!
+ * \brief   読み込み
+ *
+ * \param[out]  buffer      読み込んだデータを受け取るバッファ
+ * \param[in]   position    バッファの書き込み位置
+ * \param[in]   count       読み込むバイト数
+ *
+ * \return  読み込んだバイト数
+ */
+int64_t CompressedFile::read(Buffer* buffer, int64_t position, int64_t count) throw(Exception)
+{
+    if (isOpen() == false)
+        return 0;
+
+    buffer->validateOverFlow((int32_t)position, (int32_t)count);
+
+    char* p = buffer->getBuffer() + position;
+    int64_t total = 0;
+
+    while (total < count)
+    {
+        if (mBlock->getLength() <= mBlockPosition && readBlock() == false)
+            break;
+
+        int64_t len = mBlock->getLength() - mBlockPosition;
+
+        if (count - total < len)
+            len = count - total;
+
+        memcpy(p + total, mBlock->getBuffer() + mBlockPosition, (size_t)len);
+
+        mBlockPosition += (int32_t)len;
+        total += len;
+    }
+
+    return total;
+}
+
+/*!
+ * \brief   読み込み位置設定（展開後の位置）
+ *
+ * \param[in]   position    展開後の位置
+ *
+ * \return  設定した位置（ファイルが短い場合はpositionより小さい）
+ *
+ * \note    読み飛ばすブロックはヘッダーだけを辿り、展開しない
+ */
+int64_t CompressedFile::setRawPosition(int64_t position) throw(Exception)
+{
+    if (mArchive && mArchive->isOpen())
+        return setArchiveRawPosition(position);
+
+    int64_t size = mFile.getSize();
+    int64_t current = 0;
+
+    mFile.setPosition(SIGNATURE_SIZE);
+    mBlock->setPosition(0);
+    mBlock->setLength(0);
+    mBlockPosition = 0;
+
+    ByteBuffer header(BLOCK_HEADER_SIZE);
+
+    while (current < position)
+    {
+        int64_t blockPosition = mFile.getPosition();
+
+        if (mFile.read(&header, BLOCK_HEADER_SIZE) != BLOCK_HEADER_SIZE)
+        {
+            mFile.setPosition(blockPosition);
+            break;
+        }
+
+        header.setPosition(0);
+        int32_t len =           header.getInt();
+        int32_t compressedLen = header.getInt();
+
+        if (size < blockPosition + BLOCK_HEADER_SIZE + compressedLen)
+        {
+            mFile.setPosition(blockPosition);
+            break;
+        }
+
+        if (position < current + len)
+        {
+            // 該当ブロックを展開して途中から読めるようにする
+            mFile.setPosition(blockPosition);
+
+            if (readBlock())
+            {
+                mBlockPosition = (int32_t)(position - current);
+                current = position;
+            }
+
+            break;
+        }
+
+        current += len;
+        mFile.movePosition(compressedLen);
+    }
+
+    return current;
+}
+
+/*!
+ * \brief   アーカイブの読み込み位置設定（展開後の位置）
+ *
+ * \param[in]   position    展開後の位置
+ *
+ * \return  設定した位置
+ *
+ * \note    該当するグループだけを展開する
+ */
+int64_t CompressedFile::setArchiveRawPosition(int64_t position) throw(Exception)
+{
+    int32_t groupCount = mArchive->getGroupCount();
+
+    mBlock->setPosition(0);
+    mBlock->setLength(0);
+    mBlockPosition = 0;
+    mArchiveGroup = groupCount;
+
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        const SequenceLogArchiveGroup* group = mArchive->getGroup(i);
+
+        if (position < group->rawPosition + group->rawSize)
+        {
+            mArchiveGroup = i;
+
+            if (readBlock() == false)
+                return group->rawPosition;
+
+            mBlockPosition = (int32_t)(position < group->rawPosition ? 0 : position - group->rawPosition);
+            return group->rawPosition + mBlockPosition;
+        }
+    }
+
+    return mArchive->getRawSize();
+}
+
+/*!
+ * \brief   ファイルサイズ取得（圧縮後）
+ */
+int64_t CompressedFile::getSize() const
+{
+    if (mArchive && mArchive->isOpen())
+        return mArchive->getSize();
+
+    return mFile.getSize();
+}
+
+/*!
+ * \brief   展開後のサイズ取得
+ *
+ * \note    ブロックヘッダーだけを辿るので、データの展開はしない
+ */
+int64_t CompressedFile::getRawSize() const throw(Exception)
+{
+    if (mArchive && mArchive->isOpen())
+        return mArchive->getRawSize();
+
+    int64_t position = mFile.getPosition();
+    int64_t size = mFile.getSize();
+    int64_t rawSize = 0;
+    int64_t blockPosition = SIGNATURE_SIZE;
+
+    ByteBuffer header(BLOCK_HEADER_SIZE);
+
+    while (blockPosition + BLOCK_HEADER_SIZE <= size)
+    {
+        mFile.setPosition(blockPosition);
+
+        if (mFile.read(&header, BLOCK_HEADER_SIZE) != BLOCK_HEADER_SIZE)
+            break;
+
+        header.setPosition(0);
+        int32_t len =           header.getInt();
+        int32_t compressedLen = header.getInt();
+
+        if (size < blockPosition + BLOCK_HEADER_SIZE + compressedLen)
+            break;
+
+        rawSize += len;
+        blockPosition += BLOCK_HEADER_SIZE + compressedLen;
+    }
+
+    mFile.setPosition(position);
+    return rawSize;
+}
+
+/*!
+ * \brief   圧縮ファイル名かどうか調べる
+ */
+bool CompressedFile::isCompressedFileName(const CoreString* fileName)
+{
+    int32_t extLen = sizeof(COMPRESSED_EXT) - 1;
+    int32_t len = fileName->getLength();
+
+    if (len < extLen)
+        return SequenceLogArchive::isArchiveFileName(fileName);
+
+    if (strcmp(fileName->getBuffer() + len - extLen, COMPRESSED_EXT) == 0)
+        return true;
+
+    return SequenceLogArchive::isArchiveFileName(fileName);
+}
+
+/*!
+ * \brief   圧縮後の最大サイズ取得
+ */
+int32_t CompressedFile::getCompressBound(int32_t srcLen)
+{
+    return srcLen + (srcLen / 255) + 16;
+}
+
+/*!
+ * \brief   圧縮
+ *
+ * \param[in]   src         圧縮するデータ
+ * \param[in]   srcLen      圧縮するデータの長さ
+ * \param[out]  dst         圧縮したデータを受け取るバッファ
+ * \param[in]   dstCapacity dstのサイズ（getCompressBound(srcLen)以上）
+ *
+ * \return  圧縮後の長さ。失敗した場合は-1を返す
+ *
+ * \note    [トークン(リテラル長4bit|一致長4bit)][リテラル長の追加バイト][リテラル][参照距離(2)][一致長の追加バイト] の繰り返し。
+ *          最後のシーケンスはリテラルのみで、参照距離以降を持たない。
+ */
+int32_t CompressedFile::compress(const char* src, int32_t srcLen, char* dst, int32_t dstCapacity)
+{
+    if (dstCapacity < getCompressBound(srcLen))
+        return -1;
+
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+
+    int32_t table[1 << HASH_BITS];
+
+    for (int32_t i = 0; i < (1 << HASH_BITS); i++)
+        table[i] = -1;
+
+    int32_t ip = 0;
+    int32_t op = 0;
+    int32_t anchor = 0;
+    int32_t limit = srcLen - MIN_MATCH;
+
+    while (ip <= limit)
+    {
+        uint32_t sequence = read32(s + ip);
+        uint32_t hash = (sequence * 2654435761U) >> (32 - HASH_BITS);
+
+        int32_t ref = table[hash];
+        table[hash] = ip;
+
+        if (ref < 0 || MAX_OFFSET < ip - ref || read32(s + ref) != sequence)
+        {
+            ip++;
+            continue;
+        }
+
+        int32_t matchLen = MIN_MATCH;
+
+        while (ip + matchLen < srcLen && s[ref + matchLen] == s[ip + matchLen])
+            matchLen++;
+
+        int32_t literalLen = ip - anchor;
+        int32_t ml = matchLen - MIN_MATCH;
+        int32_t token = op++;
+
+        d[token] = (uint8_t)(((literalLen < 15 ? literalLen : 15) << 4) | (ml < 15 ? ml : 15));
+
+        if (15 <= literalLen)
+            op = putLength(d, op, literalLen);
+
+        memcpy(d + op, s + anchor, literalLen);
+        op += literalLen;
+
+        int32_t offset = ip - ref;
+        d[op++] = (offset >> 8) & 0xFF;
+        d[op++] = (offset     ) & 0xFF;
+
+        if (15 <= ml)
+            op = putLength(d, op, ml);
+
+        ip += matchLen;
+        anchor = ip;
+    }
+
+    // 最後のリテラル
+    int32_t literalLen = srcLen - anchor;
+    d[op++] = (uint8_t)((literalLen < 15 ? literalLen : 15) << 4);
+
+    if (15 <= literalLen)
+        op = putLength(d, op, literalLen);
+
+    memcpy(d + op, s + anchor, literalLen);
+    op += literalLen;
+
+    return op;
+}
+
+/*!
+ * \brief   展開
+ *
+ * \param[in]   src         展開するデータ
+ * \param[in]   srcLen      展開するデータの長さ
+ * \param[out]  dst         展開したデータを受け取るバッファ
+ * \param[in]   dstCapacity dstのサイズ
+ *
+ * \return  展開後の長さ。データが不正な場合は-1を返す
+ */
+int32_t CompressedFile::decompress(const char* src, int32_t srcLen, char* dst, int32_t dstCapacity)
+{
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* d = (uint8_t*)dst;
+
+    int32_t ip = 0;
+    int32_t op = 0;
+
+    while (true)
+    {
+        if (srcLen <= ip)
+            return -1;
+
+        uint8_t token = s[ip++];
+        int32_t len = (token >> 4);
+        uint8_t b;
+
+        if (len == 15)
+        {
+            do
+            {
+                if (srcLen <= ip)
+                    return -1;
+
+                b = s[ip++];
+                len += b;
+            }
+            while (b == 255);
+        }
+
+        if (srcLen - ip < len || dstCapacity - op < len)
+            return -1;
+
+        memcpy(d + op, s + ip, len);
+        ip += len;
+        op += len;
+
+        if (ip == srcLen)
+            break;
+
+        if (srcLen - ip < 2)
+            return -1;
+
+        int32_t offset = ((int32_t)s[ip] << 8) | s[ip + 1];
+        ip += 2;
+
+        if (offset == 0 || op < offset)
+            return -1;
+
+        len = (token & 0x0F);
+
+        if (len == 15)
+        {
+            do
+            {
+                if (srcLen <= ip)
+                    return -1;
+
+                b = s[ip++];
+                len += b;
+            }
+            while (b == 255);
+        }
+
+        len += MIN_MATCH;
+
+        if (dstCapacity - op < len)
+            return -1;
+
+        const uint8_t* ref = d + op - offset;
+
+        if (len <= offset)
+        {
+            memcpy(d + op, ref, len);
+            op += len;
+        }
+        else
+        {
+            // 重なりがある場合は1バイトずつコピー
+            for (int32_t i = 0; i < len; i++)
+                d[op++] = ref[i];
+        }
+    }
+
+    return op;
+}
+
+/*!
+ * \brief   バッファ確保
+ *
+ * \param[in,out]   buffer      バッファ
+ * \param[in]       capacity    必要な容量
+ *
+ * \note    容量が足りない場合は書き込み位置までのデータを引き継いで再確保する
+ */
+void CompressedFile::reserve(ByteBuffer** buffer, int32_t capacity)
+{
+    ByteBuffer* oldBuffer = *buffer;
+
+    if (oldBuffer && capacity <= oldBuffer->getCapacity())
+        return;
+
+    if (capacity < BLOCK_SIZE)
+        capacity = BLOCK_SIZE;
+
+    ByteBuffer* newBuffer = new ByteBuffer(capacity);
+
+    if (oldBuffer)
+    {
+        newBuffer->put(oldBuffer->getBuffer(), oldBuffer->getPosition());
+        delete oldBuffer;
+    }
+
+    *buffer = newBuffer;
+}
+
+} // namespace slog
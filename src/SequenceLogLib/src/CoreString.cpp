@@ -21,6 +21,7 @@
  */
 #include "slog/CoreString.h"
 #include "slog/Util.h"
+#include "StringKernel.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -168,15 +169,25 @@ void CoreString::deleteLast()
 }
 
 /*!
- * \brief   フォーマット
+ * \brief   フォーマット（型情報付きの引数）
+ *
+ * \param[in]   format  書式
+ * \param[in]   args    引数
+ * \param[in]   count   引数の数
  */
-void CoreString::format(const char* format, ...) throw(Exception)
+void CoreString::formatArgs(const char* format, const FormatArg* args, int32_t count) throw(Exception)
 {
-    va_list arg;
-    va_start(arg, format);
+    int32_t capacity = getCapacity();
+    int32_t len = Format::write(getBuffer(), capacity, format, args, count);
+
+    if (capacity < len)
+    {
+        // 容量が足りなければ正確な長さで確保し直して書き込む
+        setCapacity(len);
+        Format::write(getBuffer(), len, format, args, count);
+    }
 
-    formatV(format, arg);
-    va_end(arg);
+    setLength(len);
 }
 
 /*!
@@ -290,18 +301,12 @@ int32_t CoreString::indexOf(const char* find, int32_t startIndex, int32_t count)
 
     const char* buffer = getBuffer();
     const char* p1 = buffer + startIndex;
-    const char* p2 = p1 + (count - findLen);
+    const char* p = StringKernel::find(p1, p1 + count, find, findLen);
 
-    do
-    {
-        if (strncmp(p1, find, findLen) == 0)
-            return (int32_t)(p1 - buffer);
-
-        p1++;
-    }
-    while (p1 <= p2);
+    if (p == nullptr)
+        return -1;
 
-    return -1;
+    return (int32_t)(p - buffer);
 }
 
 /*!
@@ -321,16 +326,19 @@ int32_t CoreString::lastIndexOf(const char* find, int32_t index) const
         return -1;
 
     const char* buffer = getBuffer();
+    const char* end = buffer + getLength();
+    int32_t findLen = GetLength(find);
 
-    for (; 0 <= index; index--)
-    {
-        const char* p = strstr(buffer + index, find);
+    // 検索開始位置以降に見つかればその位置、なければ最後に見つかった位置（検索開始位置より前）を返す
+    const char* p = StringKernel::find(buffer + index, end, find, findLen);
 
-        if (p)
-            return (int32_t)(p - buffer);
-    }
+    if (p == nullptr)
+        p = StringKernel::findLast(buffer, end, find, findLen);
+
+    if (p == nullptr)
+        return -1;
 
-    return -1;
+    return (int32_t)(p - buffer);
 }
 
 /*!
@@ -339,15 +347,7 @@ int32_t CoreString::lastIndexOf(const char* find, int32_t index) const
 int32_t CoreString::getCharacters() const
 {
     const char* text = getBuffer();
-    int32_t num = 0;
-
-    while (*text)
-    {
-        text += slog::getNextCharBytes(text);
-        num++;
-    }
-
-    return num;
+    return StringKernel::countCharacters(text, text + getLength());
 }
 
 /*!
@@ -33,32 +33,94 @@
 namespace slog
 {
 
+static const int64_t NANO_SECONDS_PER_SECOND = 1000 * 1000 * 1000;
+static const int64_t SECONDS_PER_DAY = 24 * 60 * 60;
+static const int64_t NANO_SECONDS_PER_MILLI_SECOND = 1000 * 1000;
+
+/*!
+ * \brief  setValue(0) と同じエポックからのナノ秒（1900/00/00 を前月末に繰り下げた 1899/11/30 00:00:00）
+ */
+static const int64_t ZERO_VALUE_NANO_SECONDS = -25599LL * SECONDS_PER_DAY * NANO_SECONDS_PER_SECOND;
+
+static const uint64_t INVALID_VALUE = 0xFFFFFFFFFFFFFFFFULL;             //!< 暦に変換していないことを表す値
+
+/*!
+ * \brief  最後に暦に変換した秒（スレッド毎）
+ */
+static SLOG_THREAD_LOCAL int64_t  sCachedSecond = 0;
+static SLOG_THREAD_LOCAL uint64_t sCachedValue =  INVALID_VALUE;           //!< ミリ秒を除いた日付時間
+
+/*!
+ * \brief  切り捨ての除算（負の値でも小さい方に丸める）
+ */
+inline int64_t floorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+
+    if ((a % b) != 0 && ((a < 0) != (b < 0)))
+        q--;
+
+    return q;
+}
+
+/*!
+ * \brief  年月日からエポックからの日数を求める
+ *
+ * \note    月と日が範囲外の場合も前後の月日として計算する。
+ */
+static int64_t daysFromCivil(int64_t y, uint32_t m, uint32_t d)
+{
+    y -= (m <= 2);
+
+    int64_t  era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);                                   // [0, 399]
+    uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;             // [0, 365]
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                       // [0, 146096]
+
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+/*!
+ * \brief  エポックからの日数から年月日を求める
+ */
+static void civilFromDays(int64_t z, int64_t* y, uint32_t* m, uint32_t* d)
+{
+    z += 719468;
+
+    int64_t  era = (z >= 0 ? z : z - 146096) / 146097;
+    uint32_t doe = (uint32_t)(z - era * 146097);                                // [0, 146096]
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;       // [0, 399]
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                     // [0, 365]
+    uint32_t mp = (5 * doy + 2) / 153;                                          // [0, 11]
+
+    *d = doy - (153 * mp + 2) / 5 + 1;
+    *m = (mp < 10 ? mp + 3 : mp - 9);
+    *y = (int64_t)yoe + era * 400 + (*m <= 2);
+}
+
 /*!
  * \brief  コンストラクタ
  */
 DateTime::DateTime()
 {
+    mTime = ZERO_VALUE_NANO_SECONDS;
     mValue = 0;
 }
 
 /*!
  * \brief  現在日時設定
+ *
+ * \note    暦への変換は同じ秒の間はスレッド毎に保持している変換結果を使う。
  */
 void DateTime::setCurrent()
 {
 #if defined(_WINDOWS)
-    SYSTEMTIME now;
-//  GetLocalTime( &now);
-    GetSystemTime(&now);
-
-    mValue =
-        ((uint64_t)(now.wYear - 1900) << 56) |
-        ((uint64_t) now.wMonth        << 48) |
-        ((uint64_t) now.wDay          << 40) |
-        ((uint64_t) now.wHour         << 32) |
-        ((uint64_t) now.wMinute       << 24) |
-        ((uint64_t) now.wSecond       << 16) |
-        ((uint64_t) now.wMilliseconds      );
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+
+    // 1601/01/01からの100ナノ秒単位
+    uint64_t value = ((uint64_t)now.dwHighDateTime << 32) | now.dwLowDateTime;
+    setEpochNanoSeconds((int64_t)(value - 116444736000000000ULL) * 100);
 #else
 #if 0
     timeval tv;
@@ -80,7 +142,7 @@ void DateTime::setCurrent()
         clock_gettime(CLOCK_REALTIME, &tv);
     #endif
 
-    setTime_t(tv.tv_sec, (uint64_t)tv.tv_nsec / (1000 * 1000));
+    setEpochNanoSeconds((int64_t)tv.tv_sec * NANO_SECONDS_PER_SECOND + tv.tv_nsec);
 #endif
 #endif // defined(_WINDOWS)
 }
@@ -125,11 +187,36 @@ void DateTime::toLocal()
 }
 
 /*!
- * \brief  日付時間をuint64_t値で取得
+ * \brief  暦に変換する
+ *
+ * \note    同じ秒の間はスレッド毎に保持している変換結果のミリ秒だけを書き換える。
  */
-uint64_t DateTime::getValue() const
+void DateTime::updateValue()
 {
-    return mValue;
+    int64_t second = floorDiv(mTime, NANO_SECONDS_PER_SECOND);
+    uint32_t milliSecond = (uint32_t)((mTime - second * NANO_SECONDS_PER_SECOND) / NANO_SECONDS_PER_MILLI_SECOND);
+
+    if (second != sCachedSecond || sCachedValue == INVALID_VALUE)
+    {
+        int64_t days = floorDiv(second, SECONDS_PER_DAY);
+        uint32_t secondOfDay = (uint32_t)(second - days * SECONDS_PER_DAY);
+
+        int64_t y;
+        uint32_t m, d;
+        civilFromDays(days, &y, &m, &d);
+
+        sCachedValue =
+            ((uint64_t)((y - 1900) & 0xFF)   << 56) |
+            ((uint64_t) m                     << 48) |
+            ((uint64_t) d                     << 40) |
+            ((uint64_t)(secondOfDay / 3600)   << 32) |
+            ((uint64_t)(secondOfDay / 60 % 60) << 24) |
+            ((uint64_t)(secondOfDay % 60)     << 16);
+
+        sCachedSecond = second;
+    }
+
+    mValue = sCachedValue | milliSecond;
 }
 
 /*!
@@ -138,6 +225,19 @@ uint64_t DateTime::getValue() const
 void DateTime::setValue(uint64_t value)
 {
     mValue = value;
+
+    int64_t days = daysFromCivil(
+        ((value >> 56) & 0xFF) + 1900,
+        ((value >> 48) & 0xFF),
+        ((value >> 40) & 0xFF));
+
+    int64_t second =
+        days * SECONDS_PER_DAY +
+        ((value >> 32) & 0xFF) * 60 * 60 +
+        ((value >> 24) & 0xFF) * 60 +
+        ((value >> 16) & 0xFF);
+
+    mTime = (second * 1000 + (value & 0xFFFF)) * NANO_SECONDS_PER_MILLI_SECOND;
 }
 
 /*!
@@ -148,14 +248,14 @@ void DateTime::toValue(tm* tm, uint32_t milliSecond)
     if (tm == nullptr)
         return;
 
-    mValue =
+    setValue(
         ((uint64_t) tm->tm_year     << 56) |
         ((uint64_t)(tm->tm_mon + 1) << 48) |
         ((uint64_t) tm->tm_mday     << 40) |
         ((uint64_t) tm->tm_hour     << 32) |
         ((uint64_t) tm->tm_min      << 24) |
         ((uint64_t) tm->tm_sec      << 16) |
-        milliSecond;
+        milliSecond);
 }
 
 /*!
@@ -163,66 +263,17 @@ void DateTime::toValue(tm* tm, uint32_t milliSecond)
  */
 void DateTime::setTime_t(time_t value, uint32_t milliSecond)
 {
-//  tm* tm = localtime(&value);
-    tm* tm = gmtime(&value);
-
-    toValue(tm, milliSecond);
+    setEpochNanoSeconds(((int64_t)value * 1000 + milliSecond) * 1000 * 1000);
 }
 
 /*!
  * \brief  日付時間をミリ秒に変換
+ *
+ * \return  エポックからのミリ秒
  */
 int64_t DateTime::toMilliSeconds() const
 {
-    enum
-    {
-        January =                0,
-        February =  January +   31,
-        March =     February +  28,
-        April =     March +     31,
-        May =       April +     30,
-        June =      May +       31,
-        July =      June +      30,
-        August =    July +      31,
-        September = August +    31,
-        October =   September + 30,
-        November =  October +   31,
-        December =  November +  30,
-    };
-
-    static const int64_t daySpan[] =
-    {
-        January,
-        February,
-        March,
-        April,
-        May,
-        June,
-        July,
-        August,
-        September,
-        October,
-        November,
-        December,
-    };
-
-    int64_t y = getYear();
-    int64_t m = getMonth();
-    int64_t d = getDay();
-
-    int64_t dy = (y - 1) * 365;                     // 年数分の日数
-    int64_t dl = (y / 4) - (y / 100) + (y / 400);   // 閏年分の日数
-    int64_t dm = daySpan[m - 1];                    // 1月1日からm月1日までの日数
-    int64_t result = dy + dl + dm + d - 1;
-
-    result =
-        (result * 24 * 60 * 60 * 1000) +
-        (getHour()   * 60 * 60 * 1000) +
-        (getMinute()      * 60 * 1000) +
-        (getSecond()           * 1000) +
-         getMilliSecond();
-
-    return result;
+    return floorDiv(mTime, NANO_SECONDS_PER_MILLI_SECOND);
 }
 
 /*!
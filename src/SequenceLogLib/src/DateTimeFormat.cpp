@@ -0,0 +1,154 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    DateTimeFormat.cpp
+ * \brief   日付時間フォーマットクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "slog/DateTimeFormat.h"
+#include <string.h>
+
+namespace slog
+{
+
+/*!
+ * \brief  最後に文字列にした日付時間（ミリ秒を除く、スレッド毎）
+ */
+static SLOG_THREAD_LOCAL uint64_t sCachedKey = 0;
+static SLOG_THREAD_LOCAL bool     sCachedValid = false;
+static SLOG_THREAD_LOCAL char     sCachedText[sizeof("YYYY/MM/DD HH:MI:SS")];  //!< "YYYY/MM/DD HH:MI:SS"
+
+/*!
+ * \brief  ２桁の数字を書き込む
+ */
+inline void putDigits2(char* p, uint32_t value)
+{
+    p[0] = (char)('0' + value / 10);
+    p[1] = (char)('0' + value % 10);
+}
+
+/*!
+ * \brief  日付時間を文字列で取得
+ *
+ * \note    ミリ秒を除いた部分はスレッド毎に保持しておき、同じ秒の間は再利用する。
+ */
+void DateTimeFormat::toString(
+    CoreString* str,            //!< ここに結果を返す
+    const DateTime& dateTime,   //!< 日付時間
+    Format format)              //!< フォーマット
+{
+    uint64_t value = dateTime.getValue();
+    uint32_t year =        (uint32_t)((value >> 56) &   0xFF) + 1900;
+    uint32_t month =       (uint32_t)((value >> 48) &   0xFF);
+    uint32_t day =         (uint32_t)((value >> 40) &   0xFF);
+    uint32_t hour =        (uint32_t)((value >> 32) &   0xFF);
+    uint32_t minute =      (uint32_t)((value >> 24) &   0xFF);
+    uint32_t second =      (uint32_t)((value >> 16) &   0xFF);
+    uint32_t milliSecond = (uint32_t)( value        & 0xFFFF);
+
+    if (99 < month || 99 < day || 99 < hour || 99 < minute || 99 < second || 999 < milliSecond)
+    {
+        // 桁があふれる値は書式で処理する
+        static const char* formats[] =
+        {
+            "%04u/%02u/%02u %02u:%02u:%02u.%03u",
+            "%04u/%02u/%02u %02u:%02u:%02u",
+            "%04u/%02u/%02u %02u:%02u",
+            "%04u/%02u/%02u",
+        };
+
+        switch (format)
+        {
+        case Format::MMDD:
+            str->format("%02u/%02u", month, day);
+            break;
+
+        case Format::HHMI:
+            str->format("%02u:%02u", hour, minute);
+            break;
+
+        default:
+            str->format(formats[(int32_t)format], year, month, day, hour, minute, second, milliSecond);
+            break;
+        }
+
+        return;
+    }
+
+    uint64_t key = (value >> 16);
+
+    if (sCachedValid == false || sCachedKey != key)
+    {
+        char* p = sCachedText;
+
+        putDigits2(p +  0, year / 100);
+        putDigits2(p +  2, year % 100);
+        p[4] = '/';
+        putDigits2(p +  5, month);
+        p[7] = '/';
+        putDigits2(p +  8, day);
+        p[10] = ' ';
+        putDigits2(p + 11, hour);
+        p[13] = ':';
+        putDigits2(p + 14, minute);
+        p[16] = ':';
+        putDigits2(p + 17, second);
+        p[19] = '\0';
+
+        sCachedKey = key;
+        sCachedValid = true;
+    }
+
+    switch (format)
+    {
+    case Format::YYYYMMDDHHMISSMS:
+    {
+        char buffer[sizeof("YYYY/MM/DD HH:MI:SS.999")];
+        memcpy(buffer, sCachedText, (int32_t)Length::YYYYMMDDHHMISS);
+
+        char* p = buffer + (int32_t)Length::YYYYMMDDHHMISS;
+        p[0] = '.';
+        p[1] = (char)('0' + milliSecond / 100);
+        putDigits2(p + 2, milliSecond % 100);
+
+        str->copy(buffer, (int32_t)Length::YYYYMMDDHHMISSMS);
+        break;
+    }
+
+    case Format::YYYYMMDDHHMISS:
+        str->copy(sCachedText, (int32_t)Length::YYYYMMDDHHMISS);
+        break;
+
+    case Format::YYYYMMDDHHMI:
+        str->copy(sCachedText, (int32_t)Length::YYYYMMDDHHMI);
+        break;
+
+    case Format::YYYYMMDD:
+        str->copy(sCachedText, (int32_t)Length::YYYYMMDD);
+        break;
+
+    case Format::MMDD:
+        str->copy(sCachedText + 5, (int32_t)Length::MMDD);
+        break;
+
+    case Format::HHMI:
+        str->copy(sCachedText + 11, (int32_t)Length::HHMI);
+        break;
+    }
+}
+
+} // namespace slog
@@ -298,6 +298,10 @@ bool File::FileIO::open(const CoreString* fileName, File::Mode mode)
 //      handle = CreateFileW(p, GENERIC_READ,  FILE_SHARE_READ,                    nullptr, OPEN_EXISTING, 0, nullptr);
         handle = CreateFileW(p, GENERIC_READ,  FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
     }
+    else if (mode == File::APPEND)
+    {
+        handle = CreateFileW(p, FILE_APPEND_DATA, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, 0, nullptr);
+    }
     else
     {
 //      handle = CreateFileW(p, GENERIC_WRITE, 0,               nullptr, CREATE_ALWAYS, 0, nullptr);
@@ -310,7 +314,7 @@ bool File::FileIO::open(const CoreString* fileName, File::Mode mode)
     mHandle = handle;
 #else
     const char* p =  fileName->getBuffer();
-    const char* _mode = (mode == READ ? "r" : "w");
+    const char* _mode = (mode == READ ? "r" : (mode == APPEND ? "a" : "w"));
     FILE* handle = fopen(p, _mode);
 
     if (handle == nullptr)
@@ -637,7 +641,7 @@ void File::open(const CoreString* fileName, Mode mode) throw(Exception)
 
     *mLastWriteTime = info->getLastWriteTime();
 
-    if (fileCache == nullptr || mode == Mode::WRITE)
+    if (fileCache == nullptr || mode != Mode::READ)
     {
         Exception e;
 
@@ -928,8 +932,7 @@ bool File::move(const CoreString* aSrc, const CoreString* aDst)
 
     return (MoveFileExW(src.getBuffer(), dst.getBuffer(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_COPY_ALLOWED) == TRUE);
 #else
-    noticeLog("*** File::move() no implement.");
-    return true;
+    return (rename(aSrc->getBuffer(), aDst->getBuffer()) == 0);
 #endif
 }
 
@@ -72,8 +72,9 @@ static void appendPath(CoreString* path, const CoreString& name)
  * \brief   コンストラクタ
  *
  * \param[in]   path    パス（ディレクトリは末尾に'\'、または'/'が必要）
+ * \param[in]   aUpdate ファイル情報を更新するかどうか（falseの場合、ファイルにはアクセスしない）
  */
-FileInfo::FileInfo(const CoreString* path)
+FileInfo::FileInfo(const CoreString* path, bool aUpdate)
 
     throw(Exception)
 {
@@ -165,7 +166,18 @@ FileInfo::FileInfo(const CoreString* path)
         appendPath(&mData->mCanonicalPath, *i);
 
     // ファイル情報更新
-    update();
+    if (aUpdate)
+    {
+        update();
+    }
+    else
+    {
+        mCreationTime. setValue(0);
+        mLastWriteTime.setValue(0);
+        mMode = S_IFREG;
+        mSize = 0;
+        mUsing = false;
+    }
 }
 
 /*!
@@ -0,0 +1,715 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    Format.cpp
+ * \brief   フォーマットクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "slog/Format.h"
+#include "slog/CoreString.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <vector>
+
+#if defined(_WINDOWS)
+    #define snprintf _snprintf
+#endif
+
+namespace slog
+{
+
+/*!
+ * \brief   ２桁の10進数字の表
+ */
+static const char sDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*!
+ * \brief   10のべき乗（高速な小数点数の変換で使う桁数まで）
+ */
+static const uint64_t sPow10[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+};
+
+/*!
+ * \brief   変換指定
+ */
+struct FormatSpec
+{
+    bool    left;           //!< '-' 左寄せ
+    bool    zero;           //!< '0' ゼロ埋め
+    bool    alt;            //!< '#' 代替形式
+    char    sign;           //!< '+' または ' '（指定なしの場合は '\0'）
+    int32_t width;          //!< 最小フィールド幅（指定なしの場合は0）
+    int32_t precision;      //!< 精度（指定なしの場合は-1）
+    char    conv;           //!< 変換指定子
+};
+
+/*!
+ * \brief   フォーマットの出力先
+ *
+ * \note    容量を超えた分は書き込まずに長さだけを数える。
+ */
+class FormatOutput
+{
+            char*   mDest;
+            int32_t mCapacity;
+            int32_t mLen;
+
+public:     FormatOutput(char* dest, int32_t capacity) : mDest(dest), mCapacity(capacity), mLen(0) {}
+
+            int32_t getLength() const {return mLen;}
+
+            void put(const char* p, int32_t len)
+            {
+                if (len <= 0)
+                    return;
+
+                if (mLen + len <= mCapacity)
+                    memcpy(mDest + mLen, p, len);
+
+                mLen += len;
+            }
+
+            void fill(char c, int32_t count)
+            {
+                if (count <= 0)
+                    return;
+
+                if (mLen + count <= mCapacity)
+                    memset(mDest + mLen, c, count);
+
+                mLen += count;
+            }
+
+            /*!
+             * 幅に合わせて前置詞、ゼロ埋め、本体を出力する
+             */
+            void putField(const FormatSpec& spec, const char* prefix, int32_t prefixLen, int32_t zeroCount, const char* body, int32_t bodyLen)
+            {
+                int32_t padding = spec.width - (prefixLen + zeroCount + bodyLen);
+
+                if (spec.left == false)
+                    fill(' ', padding);
+
+                put(prefix, prefixLen);
+                fill('0', zeroCount);
+                put(body, bodyLen);
+
+                if (spec.left)
+                    fill(' ', padding);
+            }
+};
+
+/*!
+ * \brief   例外を投げる
+ */
+static void throwFormatException(const char* format, const char* reason) throw(Exception)
+{
+    Exception e;
+    e.setMessage("Format(\"%.64s\") / %s", format, reason);
+
+    throw e;
+}
+
+/*!
+ * \brief   整数かどうか調べる
+ */
+inline bool isInteger(const FormatArg* arg)
+{
+    return (FormatArg::INT32 <= arg->type && arg->type <= FormatArg::UINT64);
+}
+
+/*!
+ * \brief   符号なし整数を10進数字に変換する（末尾から書き込み、書き込んだ先頭を返す）
+ */
+static char* toDecimal(char* end, uint64_t value)
+{
+    char* p = end;
+
+    while (100 <= value)
+    {
+        uint32_t pair = (uint32_t)(value % 100) * 2;
+        value /= 100;
+
+        p -= 2;
+        p[0] = sDigitPairs[pair];
+        p[1] = sDigitPairs[pair + 1];
+    }
+
+    if (10 <= value)
+    {
+        uint32_t pair = (uint32_t)value * 2;
+
+        p -= 2;
+        p[0] = sDigitPairs[pair];
+        p[1] = sDigitPairs[pair + 1];
+    }
+    else
+    {
+        p--;
+        *p = (char)('0' + value);
+    }
+
+    return p;
+}
+
+/*!
+ * \brief   整数の出力
+ */
+static void putInteger(FormatOutput* out, const FormatSpec& spec, const FormatArg* arg)
+{
+    bool negative = false;
+    uint64_t value;
+    bool isSigned = (spec.conv == 'd' || spec.conv == 'i');
+
+    switch (arg->type)
+    {
+    case FormatArg::INT32:
+        if (isSigned)
+        {
+            negative = (arg->i < 0);
+            value = (negative ? 0 - (uint64_t)arg->i : (uint64_t)arg->i);
+        }
+        else
+        {
+            value = (uint32_t)arg->i;   // printf と同じく同じ幅の符号なし整数として扱う
+        }
+        break;
+
+    case FormatArg::INT64:
+        if (isSigned)
+        {
+            negative = (arg->i < 0);
+            value = (negative ? 0 - (uint64_t)arg->i : (uint64_t)arg->i);
+        }
+        else
+        {
+            value = (uint64_t)arg->i;
+        }
+        break;
+
+    default:
+        value = arg->u;
+        break;
+    }
+
+    char buffer[32];
+    char* end = buffer + sizeof(buffer);
+    char* body = end;
+    char prefix[2];
+    int32_t prefixLen = 0;
+
+    if (value != 0 || spec.precision != 0)
+    {
+        switch (spec.conv)
+        {
+        case 'x':
+        case 'X':
+        case 'p':
+        {
+            const char* digits = (spec.conv == 'X' ? "0123456789ABCDEF" : "0123456789abcdef");
+
+            do
+            {
+                body--;
+                *body = digits[value & 0x0F];
+                value >>= 4;
+            }
+            while (value);
+
+            break;
+        }
+
+        case 'o':
+            do
+            {
+                body--;
+                *body = (char)('0' + (value & 0x07));
+                value >>= 3;
+            }
+            while (value);
+
+            break;
+
+        default:
+            body = toDecimal(end, value);
+            break;
+        }
+    }
+
+    int32_t bodyLen = (int32_t)(end - body);
+
+    // 前置詞
+    if (isSigned)
+    {
+        if (negative)
+            prefix[prefixLen++] = '-';
+
+        else if (spec.sign)
+            prefix[prefixLen++] = spec.sign;
+    }
+    else if ((spec.conv == 'x' || spec.conv == 'X') && spec.alt && arg->u != 0)
+    {
+        prefix[prefixLen++] = '0';
+        prefix[prefixLen++] = spec.conv;
+    }
+    else if (spec.conv == 'p')
+    {
+        prefix[prefixLen++] = '0';
+        prefix[prefixLen++] = 'x';
+    }
+
+    // ゼロ埋め
+    int32_t zeroCount = 0;
+
+    if (spec.precision >= 0)
+        zeroCount = spec.precision - bodyLen;
+
+    if (zeroCount < 0)
+        zeroCount = 0;
+
+    // 8進数の代替形式は先頭が '0' でなければ '0' を付ける
+    if (spec.conv == 'o' && spec.alt && zeroCount == 0 && (bodyLen == 0 || *body != '0'))
+        prefix[prefixLen++] = '0';
+
+    if (spec.precision < 0 && spec.zero && spec.left == false)
+    {
+        zeroCount = spec.width - prefixLen - bodyLen;
+
+        if (zeroCount < 0)
+            zeroCount = 0;
+    }
+
+    out->putField(spec, prefix, prefixLen, zeroCount, body, bodyLen);
+}
+
+/*!
+ * \brief   浮動小数点数の出力
+ *
+ * \note    %f で精度が9桁以下、値が小さい場合は整数演算で変換する。
+ *          丸めの境界に近い値やそれ以外の変換指定子は snprintf に任せる。
+ */
+static void putDouble(FormatOutput* out, const FormatSpec& spec, double value)
+{
+    int32_t precision = (spec.precision < 0 ? 6 : spec.precision);
+
+    if ((spec.conv == 'f' || spec.conv == 'F') && precision <= 9 && std::isfinite(value))
+    {
+        bool negative = std::signbit(value);
+        double scaled = fabs(value) * (double)sPow10[precision];
+
+        if (scaled < 1e12)
+        {
+            double integral = floor(scaled);
+            double fraction = scaled - integral;
+
+            if (fabs(fraction - 0.5) > 1e-3)
+            {
+                uint64_t n = (uint64_t)integral + (fraction > 0.5 ? 1 : 0);
+
+                char buffer[40];
+                char* end = buffer + sizeof(buffer);
+                char* body = end;
+
+                if (precision > 0 || spec.alt)
+                {
+                    uint64_t frac = n % sPow10[precision];
+
+                    for (int32_t i = 0; i < precision; i++)
+                    {
+                        body--;
+                        *body = (char)('0' + frac % 10);
+                        frac /= 10;
+                    }
+
+                    body--;
+                    *body = '.';
+                }
+
+                body = toDecimal(body, n / sPow10[precision]);
+
+                char prefix = (negative ? '-' : spec.sign);
+                int32_t prefixLen = (prefix ? 1 : 0);
+                int32_t bodyLen = (int32_t)(end - body);
+                int32_t zeroCount = 0;
+
+                if (spec.zero && spec.left == false)
+                    zeroCount = spec.width - prefixLen - bodyLen;
+
+                if (zeroCount < 0)
+                    zeroCount = 0;
+
+                out->putField(spec, &prefix, prefixLen, zeroCount, body, bodyLen);
+                return;
+            }
+        }
+    }
+
+    // 書式を組み立て直して snprintf で変換する
+    char fmt[32];
+    char* p = fmt;
+
+    *p++ = '%';
+
+    if (spec.left) *p++ = '-';
+    if (spec.zero) *p++ = '0';
+    if (spec.alt)  *p++ = '#';
+    if (spec.sign) *p++ = spec.sign;
+
+    *p++ = '*';
+
+    if (spec.precision >= 0)
+    {
+        *p++ = '.';
+        *p++ = '*';
+    }
+
+    *p++ = spec.conv;
+    *p   = '\0';
+
+    char local[512];
+    std::vector<char> heap;
+    int32_t size = 350 + spec.width + precision;   // DBL_MAX を %f で変換しても収まる大きさ
+    char* buffer = local;
+
+    if ((int32_t)sizeof(local) < size)
+    {
+        heap.resize(size);
+        buffer = &heap[0];
+    }
+
+    int32_t len;
+
+    if (spec.precision >= 0)
+        len = snprintf(buffer, size, fmt, spec.width, spec.precision, value);
+    else
+        len = snprintf(buffer, size, fmt, spec.width, value);
+
+    if (len < 0 || size <= len)
+        len = (int32_t)strlen(buffer);
+
+    out->put(buffer, len);
+}
+
+/*!
+ * \brief   次の引数を取得する
+ */
+inline const FormatArg* nextArg(const char* format, const FormatArg* args, int32_t count, int32_t* index) throw(Exception)
+{
+    if (count <= *index)
+        throwFormatException(format, "too few arguments");
+
+    return &args[(*index)++];
+}
+
+/*!
+ * \brief   幅または精度の '*' に対応する引数を取得する
+ */
+static int32_t nextIntArg(const char* format, const FormatArg* args, int32_t count, int32_t* index) throw(Exception)
+{
+    const FormatArg* arg = nextArg(format, args, count, index);
+
+    if (isInteger(arg) == false)
+        throwFormatException(format, "'*' requires an integer argument");
+
+    return (int32_t)arg->i;
+}
+
+/*!
+ * \brief   フォーマット処理
+ */
+static void process(FormatOutput* out, const char* format, const FormatArg* args, int32_t count) throw(Exception)
+{
+    const char* p = format;
+    int32_t index = 0;
+
+    while (true)
+    {
+        // 変換指定までの文字列はそのまま出力する（書式の文字列は短いので１文字ずつ調べる）
+        const char* literal = p;
+
+        while (*p != '%' && *p != '\0')
+            p++;
+
+        out->put(literal, (int32_t)(p - literal));
+
+        if (*p == '\0')
+            break;
+
+        p++;
+
+        if (*p == '%')
+        {
+            out->put(p, 1);
+            p++;
+            continue;
+        }
+
+        // フラグ
+        FormatSpec spec = {false, false, false, '\0', 0, -1, '\0'};
+
+        for (;; p++)
+        {
+                 if (*p == '-') spec.left = true;
+            else if (*p == '0') spec.zero = true;
+            else if (*p == '#') spec.alt =  true;
+            else if (*p == '+') spec.sign = '+';
+            else if (*p == ' ') {if (spec.sign == '\0') spec.sign = ' ';}
+            else break;
+        }
+
+        // 幅
+        if (*p == '*')
+        {
+            spec.width = nextIntArg(format, args, count, &index);
+            p++;
+
+            if (spec.width < 0)
+            {
+                spec.left = true;
+                spec.width = -spec.width;
+            }
+        }
+        else
+        {
+            while ('0' <= *p && *p <= '9')
+                spec.width = spec.width * 10 + (*p++ - '0');
+        }
+
+        // 精度
+        if (*p == '.')
+        {
+            p++;
+
+            if (*p == '*')
+            {
+                spec.precision = nextIntArg(format, args, count, &index);
+                p++;
+
+                if (spec.precision < 0)
+                    spec.precision = -1;
+            }
+            else
+            {
+                spec.precision = 0;
+
+                while ('0' <= *p && *p <= '9')
+                    spec.precision = spec.precision * 10 + (*p++ - '0');
+            }
+        }
+
+        // 長さ修飾子（引数の型で判断するので読み飛ばす）
+        while (*p == 'h' || *p == 'l' || *p == 'L' || *p == 'q' || *p == 'j' || *p == 'z' || *p == 't')
+            p++;
+
+        if (*p == 'I')
+        {
+            p++;
+
+            if ((p[0] == '6' && p[1] == '4') || (p[0] == '3' && p[1] == '2'))
+                p += 2;
+        }
+
+        spec.conv = *p;
+
+        if (spec.conv == '\0')
+            throwFormatException(format, "incomplete conversion");
+
+        p++;
+
+        if (spec.conv == '%')
+        {
+            out->put("%", 1);
+            continue;
+        }
+
+        const FormatArg* arg = nextArg(format, args, count, &index);
+
+        switch (spec.conv)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            if (isInteger(arg) == false)
+                throwFormatException(format, "integer conversion requires an integer argument");
+
+            putInteger(out, spec, arg);
+            break;
+
+        case 'c':
+        {
+            if (isInteger(arg) == false)
+                throwFormatException(format, "%c requires an integer argument");
+
+            char c = (char)arg->i;
+            out->putField(spec, "", 0, 0, &c, 1);
+            break;
+        }
+
+        case 's':
+        {
+            const char* text;
+            int32_t len;
+
+            if (arg->type == FormatArg::STRING)
+            {
+                text = arg->str->getBuffer();
+                len =  arg->str->getLength();
+
+                if (0 <= spec.precision && spec.precision < len)
+                    len = spec.precision;
+            }
+            else if (arg->type == FormatArg::TEXT)
+            {
+                text = (arg->text ? arg->text : "(null)");
+
+                if (0 <= spec.precision)
+                {
+                    // 精度の範囲外は読まない（'\0'で終端されていない場合がある）
+                    const char* nul = (const char*)memchr(text, '\0', spec.precision);
+                    len = (nul ? (int32_t)(nul - text) : spec.precision);
+                }
+                else
+                {
+                    len = (int32_t)strlen(text);
+                }
+            }
+            else
+            {
+                throwFormatException(format, "%s requires a string argument");
+            }
+
+            out->putField(spec, "", 0, 0, text, len);
+            break;
+        }
+
+        case 'p':
+        {
+            FormatArg value;
+            value.type = FormatArg::UINT64;
+
+            if (arg->type == FormatArg::TEXT || arg->type == FormatArg::POINTER)
+                value.u = (uint64_t)(uintptr_t)arg->ptr;
+
+            else if (arg->type == FormatArg::STRING)
+                value.u = (uint64_t)(uintptr_t)arg->str;
+
+            else if (isInteger(arg))
+                value.u = arg->u;
+
+            else
+                throwFormatException(format, "%p requires a pointer argument");
+
+            spec.precision = -1;
+            putInteger(out, spec, &value);
+            break;
+        }
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            double value = 0;
+
+            switch (arg->type)
+            {
+            case FormatArg::DOUBLE: value = arg->d;                 break;
+            case FormatArg::INT32:
+            case FormatArg::INT64:  value = (double)arg->i;         break;
+            case FormatArg::UINT32:
+            case FormatArg::UINT64: value = (double)arg->u;         break;
+
+            default:
+                throwFormatException(format, "floating point conversion requires a number argument");
+            }
+
+            putDouble(out, spec, value);
+            break;
+        }
+
+        default:
+            throwFormatException(format, "unknown conversion");
+        }
+    }
+}
+
+/*!
+ * \brief   結果の長さ取得
+ *
+ * \param[in]   format  書式
+ * \param[in]   args    引数
+ * \param[in]   count   引数の数
+ *
+ * \return  結果の長さ（終端の'\0'を含まない）
+ */
+int32_t Format::getLength(const char* format, const FormatArg* args, int32_t count) throw(Exception)
+{
+    FormatOutput out(nullptr, 0);
+    process(&out, format, args, count);
+
+    return out.getLength();
+}
+
+/*!
+ * \brief   書き込み
+ *
+ * \param[out]  dest        書き込み先
+ * \param[in]   capacity    書き込み先の容量（終端の'\0'を含まない）
+ * \param[in]   format      書式
+ * \param[in]   args        引数
+ * \param[in]   count       引数の数
+ *
+ * \return  結果の長さ（終端の'\0'を含まない）
+ *
+ * \note    戻り値が capacity より大きい場合、dest の内容は不完全で'\0'も書き込まない。
+ */
+int32_t Format::write(char* dest, int32_t capacity, const char* format, const FormatArg* args, int32_t count) throw(Exception)
+{
+    FormatOutput out(dest, capacity);
+    process(&out, format, args, count);
+
+    int32_t len = out.getLength();
+
+    if (len <= capacity)
+        dest[len] = '\0';
+
+    return len;
+}
+
+} // namespace slog
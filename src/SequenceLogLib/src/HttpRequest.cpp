@@ -183,109 +183,173 @@ bool HttpRequest::analizeRequest()
             }
             else
             {
-                // Content-Length
-                const char* compare = "Content-Length: ";
-                int32_t compareLen = String::GetLength(compare);
+                // ヘッダー名の先頭文字で比較対象を絞り込む
+                const char* compare;
+                int32_t compareLen;
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
+                switch (request[0])
                 {
-                    contentLen = Integer::parse(request + compareLen);
-                }
+                case 'C':
+                    // Content-Length
+                    compare = "Content-Length: ";
+                    compareLen = String::GetLength(compare);
 
-                // Accept
-                compare = "Accept: ";
-                compareLen = String::GetLength(compare);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        contentLen = Integer::parse(request + compareLen);
+                    }
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    char* p = (char*)String::Find((char*)request, ',');
+                    // Cookie
+                    compare = "Cookie: ";
+                    compareLen = String::GetLength(compare);
 
-                    if (p)
-                        p[0] = '\0';
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        getStringPairs(&mCookies, request + compareLen, i - compareLen, "; ");
+                    }
 
-                    mMimeType.setText(request + compareLen);
-                }
+                    // Content-Type
+                    compare = "Content-Type";
+                    compareLen = String::GetLength(compare);
 
-                // X-Requested-With
-                compare = "X-Requested-With: XMLHttpRequest";
-                compareLen = String::GetLength(compare);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mContentType.copy(request + compareLen);
+                    }
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mAjax = true;
-                }
+                    // Connection
+                    compare = "Connection";
+                    compareLen = String::GetLength(compare);
 
-                // Sec-WebSocket-Key
-                compare = "Sec-WebSocket-Key: ";
-                compareLen = String::GetLength(compare);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mConnection.copy(request + compareLen);
+                    }
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mWebSocketKey.copy(request + compareLen);
-                }
+                    break;
 
-                // Authorization
-                compare = "Authorization: Basic ";
-                compareLen = String::GetLength(compare);
+                case 'A':
+                    // Accept
+                    compare = "Accept: ";
+                    compareLen = String::GetLength(compare);
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    String basicAuth;
-                    Util::decodeBase64(&basicAuth, request + compareLen);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        char* p = (char*)String::Find((char*)request, ',');
+
+                        if (p)
+                            p[0] = '\0';
+
+                        mMimeType.setText(request + compareLen);
+                    }
 
-                    int32_t pos =   basicAuth.indexOf(':');
-                    const char* p = basicAuth.getBuffer();
+                    // Authorization
+                    compare = "Authorization: Basic ";
+                    compareLen = String::GetLength(compare);
 
-                    if (pos != -1)
+                    if (String::CompareTo(request, compare, compareLen) == 0)
                     {
-                        mUser.    copy(p, pos);
-                        mPassword.copy(p + pos + 1);
+                        String basicAuth;
+                        Util::decodeBase64(&basicAuth, request + compareLen);
+
+                        int32_t pos =   basicAuth.indexOf(':');
+                        const char* p = basicAuth.getBuffer();
+
+                        if (pos != -1)
+                        {
+                            mUser.    copy(p, pos);
+                            mPassword.copy(p + pos + 1);
+                        }
                     }
-                }
 
-                // Cookie
-                compare = "Cookie: ";
-                compareLen = String::GetLength(compare);
+                    // Accept-Language
+                    compare = "Accept-Language: ";
+                    compareLen = String::GetLength(compare);
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    getStringPairs(&mCookies, request + compareLen, i - compareLen, "; ");
-                }
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mAcceptLanguage.copy(request + compareLen);
+                    }
 
-                // Accept-Language
-                compare = "Accept-Language: ";
-                compareLen = String::GetLength(compare);
+                    break;
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mAcceptLanguage.copy(request + compareLen);
-                }
+                case 'X':
+                    // X-Requested-With
+                    compare = "X-Requested-With: XMLHttpRequest";
+                    compareLen = String::GetLength(compare);
+
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mAjax = true;
+                    }
 
-                // User-Agent
-                compare = "User-Agent: ";
-                compareLen = String::GetLength(compare);
+                    break;
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mUserAgent.copy(request + compareLen);
-                }
+                case 'S':
+                    // Sec-WebSocket-Key
+                    compare = "Sec-WebSocket-Key: ";
+                    compareLen = String::GetLength(compare);
 
-                // Content-Type
-                compare = "Content-Type";
-                compareLen = String::GetLength(compare);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mWebSocketKey.copy(request + compareLen);
+                    }
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mContentType.copy(request + compareLen);
-                }
+                    break;
 
-                // Connection
-                compare = "Connection";
-                compareLen = String::GetLength(compare);
+                case 'U':
+                    // User-Agent
+                    compare = "User-Agent: ";
+                    compareLen = String::GetLength(compare);
 
-                if (String::CompareTo(request, compare, compareLen) == 0)
-                {
-                    mConnection.copy(request + compareLen);
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mUserAgent.copy(request + compareLen);
+                    }
+
+                    break;
+
+                case 'R':
+                    // Range
+                    compare = "Range: ";
+                    compareLen = String::GetLength(compare);
+
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mRange.copy(request + compareLen);
+                    }
+
+                    break;
+
+                case 'I':
+                    // If-Range
+                    compare = "If-Range: ";
+                    compareLen = String::GetLength(compare);
+
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mIfRange.copy(request + compareLen);
+                    }
+
+                    // If-Modified-Since
+                    compare = "If-Modified-Since: ";
+                    compareLen = String::GetLength(compare);
+
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mIfModifiedSince.copy(request + compareLen);
+                    }
+
+                    // If-None-Match
+                    compare = "If-None-Match: ";
+                    compareLen = String::GetLength(compare);
+
+                    if (String::CompareTo(request, compare, compareLen) == 0)
+                    {
+                        mIfNoneMatch.copy(request + compareLen);
+                    }
+
+                    break;
                 }
             }
         }
@@ -529,6 +593,38 @@ const CoreString* HttpRequest::getConnection() const
     return &mConnection;
 }
 
+/*!
+ * \brief   Range取得
+ */
+const CoreString* HttpRequest::getRange() const
+{
+    return &mRange;
+}
+
+/*!
+ * \brief   If-Range取得
+ */
+const CoreString* HttpRequest::getIfRange() const
+{
+    return &mIfRange;
+}
+
+/*!
+ * \brief   If-Modified-Since取得
+ */
+const CoreString* HttpRequest::getIfModifiedSince() const
+{
+    return &mIfModifiedSince;
+}
+
+/*!
+ * \brief   If-None-Match取得
+ */
+const CoreString* HttpRequest::getIfNoneMatch() const
+{
+    return &mIfNoneMatch;
+}
+
 /*!
  * \brief   リセット
  */
@@ -546,6 +642,10 @@ void HttpRequest::reset()
     mUserAgent.     setLength(0);
     mContentType.   setLength(0);
     mConnection.    setLength(0);
+    mRange.         setLength(0);
+    mIfRange.       setLength(0);
+    mIfModifiedSince.setLength(0);
+    mIfNoneMatch.   setLength(0);
 }
 
 } // namespace slog
@@ -21,6 +21,11 @@
  */
 #include "slog/Json.h"
 
+#if defined(__unix__)
+    #include <string.h>
+    #include <stdio.h>
+#endif
+
 using namespace std;
 
 namespace slog
@@ -38,7 +43,7 @@ static void encodeEscape(String* dest, const char* p)
 {
     static const char targets[] = {'\\', '"'};
 
-    int32_t len = String::GetLength(p) * 2;   // 全ての文字をエスケープするとしても２倍のバッファがあれば足りる
+    int32_t len = String::GetLength(p) * 6;   // 全ての文字を\u00XX形式でエスケープするとしても６倍のバッファがあれば足りる
 
     char* buffer = new char[len + 1];
     int32_t pos = 0;
@@ -57,7 +62,21 @@ static void encodeEscape(String* dest, const char* p)
             break;
         }
 
-        if (isTarget == false)
+        if (isTarget == false && (uint8_t)*p < 0x20)
+        {
+            // 制御文字
+            switch (*p)
+            {
+            case '\n': memcpy(buffer + pos, "\\n", 2); pos += 2; break;
+            case '\r': memcpy(buffer + pos, "\\r", 2); pos += 2; break;
+            case '\t': memcpy(buffer + pos, "\\t", 2); pos += 2; break;
+            default:
+                sprintf(buffer + pos, "\\u%04x", (uint8_t)*p);
+                pos += 6;
+                break;
+            }
+        }
+        else if (isTarget == false)
         {
             // 単純にコピー
             buffer[pos] = *p;
@@ -117,7 +136,7 @@ public:     enum class Type : int32_t
             /*!
              * \brief   値（数値）
              */
-            int32_t mNumber;
+            int64_t mNumber;
 
             /*!
              * コンストラクタ
@@ -127,7 +146,7 @@ public:     JsonValue(const char* name, const char* value);
             /*!
              * コンストラクタ
              */
-            JsonValue(const char* name, int32_t value);
+            JsonValue(const char* name, int64_t value);
 
             /*!
              * シリアライズ
@@ -153,7 +172,7 @@ JsonValue::JsonValue(const char* name, const char* value) : JsonAbstract(name)
  * \param[in]   name    キーの名前
  * \param[in]   value   値
  */
-JsonValue::JsonValue(const char* name, int32_t value) : JsonAbstract(name)
+JsonValue::JsonValue(const char* name, int64_t value) : JsonAbstract(name)
 {
     mType = Type::NUMBER;
     mNumber = value;
@@ -169,7 +188,7 @@ JsonValue::JsonValue(const char* name, int32_t value) : JsonAbstract(name)
 void JsonValue::serializeChild(CoreString* content) const
 {
          if (mType == Type::STRING) content->format("\"%s\":\"%s\"", mName.getBuffer(), mString.getBuffer());
-    else if (mType == Type::NUMBER) content->format("\"%s\":%d",     mName.getBuffer(), mNumber);
+    else if (mType == Type::NUMBER) content->format("\"%s\":%lld",   mName.getBuffer(), (long long)mNumber);
 }
 
 /*!
@@ -230,6 +249,19 @@ void Json::add(const char* name, const char* value)
  * \return  なし
  */
 void Json::add(const char* name, int32_t value)
+{
+    add(name, (int64_t)value);
+}
+
+/*!
+ * \brief   JSONデータ追加
+ *
+ * \param[in]   name    キーの名前
+ * \param[in]   value   値
+ *
+ * \return  なし
+ */
+void Json::add(const char* name, int64_t value)
 {
     mName.setLength(0);
     mBracket[0] = '{';
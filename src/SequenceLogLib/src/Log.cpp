@@ -44,8 +44,22 @@ int64_t Log::StepIn(String^ aClassName, String^ aFuncName)
     slog::CSharpString className = aClassName;
     slog::CSharpString funcName = aFuncName;
 
-    slog::SequenceLog* slogObj = new slog::SequenceLog(className.getBuffer(), funcName.getBuffer());
-    return (int64_t)slogObj;
+    return (int64_t)_slog_stepIn(className.getBuffer(), funcName.getBuffer());
+}
+
+/*!
+ * \brief   ステップイン（ハンドルなし）
+ *
+ * \note    スレッド毎のフレームスタックに積む（ヒープに確保しない）。
+ *          StepOutCurrent() と V() などハンドルなしのメッセージはステップインしたスレッドで呼ぶこと。
+ *          await の後など別のスレッドで続きを実行する場合はハンドルを返す StepIn() を使う。
+ */
+void Log::StepInCurrent(String^ aClassName, String^ aFuncName)
+{
+    slog::CSharpString className = aClassName;
+    slog::CSharpString funcName = aFuncName;
+
+    _slog_stepInCurrent(className.getBuffer(), funcName.getBuffer());
 }
 
 /*!
@@ -73,8 +87,15 @@ int64_t Log::StepIn(String^ aClassName, String^ aFuncName)
  */
 void Log::StepOut(int64_t slog)
 {
-    slog::SequenceLog* slogObj = (slog::SequenceLog*)slog;
-    delete slogObj;
+    _slog_stepOut((void*)slog);
+}
+
+/*!
+ * \brief   ステップアウト（ハンドルなし）
+ */
+void Log::StepOutCurrent()
+{
+    _slog_stepOutCurrent();
 }
 
 /*!
@@ -88,6 +109,15 @@ void Log::Message(int32_t level, String^ aMessage, int64_t slog)
     slogObj->message((slog::SequenceLogLevel)level, "%s", message.getBuffer());
 }
 
+/*!
+ * \brief   メッセージ（ハンドルなし）
+ */
+void Log::MessageCurrent(int32_t level, String^ aMessage)
+{
+    slog::CSharpString message = aMessage;
+    _slog_messageCurrent(level, "%s", message.getBuffer());
+}
+
 /*!
  * \brief   メッセージ
  */
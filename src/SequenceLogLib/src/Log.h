@@ -45,7 +45,12 @@ public:     static void LoadConfig(String^ aFileName);
 
             static void StepOut(int64_t slog);
 
+            // ハンドルなし（StepInCurrent() から StepOutCurrent() までは同じスレッドで呼ぶこと）
+            static void StepInCurrent(String^ aClassName, String^ aFuncName);
+            static void StepOutCurrent();
+
 private:    static void Message(int32_t level, String^ aMessage,  int64_t slog);
+            static void MessageCurrent(int32_t level, String^ aMessage);
 //          static void Message(int32_t level, int32_t messageID, int64_t slog);
 
 public:     static void V(int64_t slog, String^ message)   {Message(slog::DEBUG, message,   slog);}
@@ -54,6 +59,12 @@ public:     static void V(int64_t slog, String^ message)   {Message(slog::DEBUG,
             static void W(int64_t slog, String^ message)   {Message(slog::WARN,  message,   slog);}
             static void E(int64_t slog, String^ message)   {Message(slog::ERROR, message,   slog);}
 
+            static void V(String^ message)                 {MessageCurrent(slog::DEBUG, message);}
+            static void D(String^ message)                 {MessageCurrent(slog::DEBUG, message);}
+            static void I(String^ message)                 {MessageCurrent(slog::INFO,  message);}
+            static void W(String^ message)                 {MessageCurrent(slog::WARN,  message);}
+            static void E(String^ message)                 {MessageCurrent(slog::ERROR, message);}
+
 //          static void V(int64_t slog, int32_t messageID) {Message(slog::DEBUG, messageID, slog);}
 //          static void D(int64_t slog, int32_t messageID) {Message(slog::DEBUG, messageID, slog);}
 //          static void I(int64_t slog, int32_t messageID) {Message(slog::INFO,  messageID, slog);}
@@ -25,6 +25,12 @@
 #include <string.h>
 #endif
 
+#if defined(_WINDOWS)
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
 //nclude "SequenceLog.h"
 #include "SequenceLogItem.h"
 
@@ -37,6 +43,366 @@
 #include "slog/Tokenizer.h"
 #include "slog/WebServerResponseThread.h"
 
+#include <atomic>
+#include <vector>
+#include <list>
+#include <new>
+
+/******************************************************************************
+*
+* スレッド毎のフレームスタック
+*
+******************************************************************************/
+namespace slog
+{
+/*!
+ * \brief   フレーム
+ */
+struct SequenceLogFrame
+{
+    union
+    {
+        char        log[sizeof(SequenceLog)];   //!< シーケンスログ（placement new で構築する）
+        int64_t     align1;                     //!< アラインメント用
+        void*       align2;                     //!< 〃
+        SequenceLogFrame* next;                 //!< 次の空きフレーム（未使用の場合）
+    };
+};
+
+/*!
+ * \brief   フレームスタック
+ *
+ * \note    スレッド毎に最初のステップインで１回だけ確保し、以降のステップイン／アウトではメモリを確保しない。
+ *          frames はハンドルなしのステップイン／アウト（_slog_stepInCurrent() など）が使う。
+ *          freeFrames はハンドルを返すステップイン用の空きフレームで、スレッドに固定しない（下記のフレームプール参照）。
+ */
+struct SequenceLogFrameStack
+{
+    enum
+    {
+        MAX_DEPTH = 256,    //!< 最大の深さ
+    };
+
+    int32_t             depth;                  //!< 深さ
+    int32_t             overflow;               //!< 最大の深さを超えたステップインの数
+    SequenceLogFrame    frames[MAX_DEPTH];      //!< フレーム
+    SequenceLogFrame*   freeFrames;             //!< ハンドル用の空きフレーム
+    int32_t             freeCount;              //!< ハンドル用の空きフレームの数
+};
+
+/*!
+ * \brief   ハンドル用のフレームプール
+ *
+ * \note    ハンドルは別のスレッドでステップアウトしたり、ステップインしたスレッドの終了後まで残ったりするため、
+ *          スレッドのフレームスタックではなくプロセス共通のプールから取る。
+ *          空きフレームはスレッド毎に FRAME_CACHE_MAX までキャッシュし、ロックはまとめて受け渡す時だけ取る。
+ *          一度確保したフレームは解放せずに再利用するので、メモリは同時に使用中のハンドル数の最大で頭打ちになる。
+ */
+static const int32_t FRAME_BATCH =     32;  //!< プールとまとめて受け渡す数（＝一度に確保する数）
+static const int32_t FRAME_CACHE_MAX = 64;  //!< スレッド毎にキャッシュする最大数
+
+static std::atomic_flag     sFramePoolLock = ATOMIC_FLAG_INIT;
+static SequenceLogFrame*    sFramePool = nullptr;
+
+/*!
+ * \brief   フレームプールのロック（保持するのはリストをつなぎ替える間だけなのでスピンする）
+ */
+class FramePoolLock
+{
+public:     FramePoolLock()
+            {
+                while (sFramePoolLock.test_and_set(std::memory_order_acquire))
+                    ;
+            }
+
+            ~FramePoolLock()
+            {
+                sFramePoolLock.clear(std::memory_order_release);
+            }
+};
+
+/*!
+ * \brief   空きフレームのリストをプールに戻す
+ */
+static void putFramePool(SequenceLogFrame* first, SequenceLogFrame* last)
+{
+    FramePoolLock lock;
+    last->next = sFramePool;
+    sFramePool = first;
+}
+
+/*!
+ * \brief   プールから空きフレームをまとめて取る（プールが空の場合は確保する）
+ *
+ * \param[out]  count   取ったフレーム数
+ *
+ * \return  空きフレームのリスト
+ */
+static SequenceLogFrame* getFramePool(int32_t* count)
+{
+    {
+        FramePoolLock lock;
+        SequenceLogFrame* first = sFramePool;
+
+        if (first)
+        {
+            SequenceLogFrame* last = first;
+            *count = 1;
+
+            while (*count < FRAME_BATCH && last->next)
+            {
+                last = last->next;
+                (*count)++;
+            }
+
+            sFramePool = last->next;
+            last->next = nullptr;
+            return first;
+        }
+    }
+
+    SequenceLogFrame* frames = new SequenceLogFrame[FRAME_BATCH];
+
+    for (int32_t i = 0; i < FRAME_BATCH - 1; i++)
+        frames[i].next = &frames[i + 1];
+
+    frames[FRAME_BATCH - 1].next = nullptr;
+    *count = FRAME_BATCH;
+    return frames;
+}
+
+/*!
+ * \brief   フレームスタック削除（スレッド終了時）
+ */
+static void deleteFrameStack(void* p)
+{
+    SequenceLogFrameStack* stack = (SequenceLogFrameStack*)p;
+
+    while (0 < stack->depth)
+    {
+        stack->depth--;
+        ((SequenceLog*)stack->frames[stack->depth].log)->~SequenceLog();
+    }
+
+    // キャッシュしていた空きフレームは他のスレッドが使えるようにプールに戻す
+    SequenceLogFrame* first = stack->freeFrames;
+
+    if (first)
+    {
+        SequenceLogFrame* last = first;
+
+        while (last->next)
+            last = last->next;
+
+        putFramePool(first, last);
+    }
+
+    delete stack;
+}
+
+#if defined(_WINDOWS)
+static void WINAPI deleteFrameStackFls(void* p)
+{
+    if (p)
+        deleteFrameStack(p);
+}
+#endif
+
+/*!
+ * \brief   フレームスタックのキー
+ */
+class SequenceLogFrameStackKey
+{
+#if defined(_WINDOWS)
+            DWORD           mKey;       //!< ファイバーローカルストレージのインデックス
+#else
+            pthread_key_t   mKey;       //!< スレッド固有データのキー
+#endif
+            bool            mCreated;   //!< 作成フラグ（静的初期化前はfalse）
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogFrameStackKey()
+            {
+#if defined(_WINDOWS)
+                mKey = FlsAlloc(deleteFrameStackFls);
+                mCreated = (mKey != FLS_OUT_OF_INDEXES);
+#else
+                mCreated = (pthread_key_create(&mKey, deleteFrameStack) == 0);
+#endif
+            }
+
+            /*!
+             * フレームスタック取得
+             */
+            SequenceLogFrameStack* get(bool create)
+            {
+                if (mCreated == false)
+                    return nullptr;
+
+#if defined(_WINDOWS)
+                SequenceLogFrameStack* stack = (SequenceLogFrameStack*)FlsGetValue(mKey);
+#else
+                SequenceLogFrameStack* stack = (SequenceLogFrameStack*)pthread_getspecific(mKey);
+#endif
+
+                if (stack == nullptr && create)
+                {
+                    stack = new SequenceLogFrameStack;
+                    stack->depth = 0;
+                    stack->overflow = 0;
+                    stack->freeFrames = nullptr;
+                    stack->freeCount = 0;
+
+#if defined(_WINDOWS)
+                    FlsSetValue(mKey, stack);
+#else
+                    pthread_setspecific(mKey, stack);
+#endif
+                }
+
+                return stack;
+            }
+};
+
+static SequenceLogFrameStackKey sFrameStackKey;
+
+/*!
+ * \brief   フレーム確保
+ *
+ * \return  フレーム（最大の深さを超えた場合はnullptr）
+ */
+static SequenceLogFrame* allocFrame()
+{
+    SequenceLogFrameStack* stack = sFrameStackKey.get(true);
+
+    if (stack == nullptr)
+        return nullptr;
+
+    if (SequenceLogFrameStack::MAX_DEPTH <= stack->depth)
+    {
+        stack->overflow++;
+        return nullptr;
+    }
+
+    return &stack->frames[stack->depth++];
+}
+
+/*!
+ * \brief   ハンドル用のフレーム確保
+ *
+ * \note    スレッドのキャッシュが空の場合だけプールからまとめて取る。
+ */
+static SequenceLogFrame* allocHandleFrame()
+{
+    SequenceLogFrameStack* stack = sFrameStackKey.get(true);
+    SequenceLogFrame* frame;
+
+    if (stack && stack->freeFrames)
+    {
+        frame = stack->freeFrames;
+        stack->freeFrames = frame->next;
+        stack->freeCount--;
+        return frame;
+    }
+
+    int32_t count;
+    frame = getFramePool(&count);
+
+    SequenceLogFrame* rest = frame->next;
+    count--;
+
+    if (stack)
+    {
+        stack->freeFrames = rest;
+        stack->freeCount = count;
+    }
+    else if (rest)
+    {
+        SequenceLogFrame* last = rest;
+
+        while (last->next)
+            last = last->next;
+
+        putFramePool(rest, last);
+    }
+
+    return frame;
+}
+
+/*!
+ * \brief   ハンドル用のフレーム解放
+ *
+ * \note    ステップアウトしたスレッドのキャッシュに戻す（ステップインしたスレッドでなくてもよい）。
+ *          キャッシュが FRAME_CACHE_MAX を超えたら FRAME_BATCH 個をプールに戻す。
+ */
+static void freeHandleFrame(SequenceLogFrame* frame)
+{
+    SequenceLogFrameStack* stack = sFrameStackKey.get(false);
+
+    if (stack == nullptr)
+    {
+        putFramePool(frame, frame);
+        return;
+    }
+
+    frame->next = stack->freeFrames;
+    stack->freeFrames = frame;
+    stack->freeCount++;
+
+    if (stack->freeCount <= FRAME_CACHE_MAX)
+        return;
+
+    SequenceLogFrame* first = stack->freeFrames;
+    SequenceLogFrame* last = first;
+
+    for (int32_t i = 1; i < FRAME_BATCH; i++)
+        last = last->next;
+
+    stack->freeFrames = last->next;
+    stack->freeCount -= FRAME_BATCH;
+    putFramePool(first, last);
+}
+
+/*!
+ * \brief   一番上のフレーム解放（ステップアウト）
+ */
+static void freeFrame()
+{
+    SequenceLogFrameStack* stack = sFrameStackKey.get(false);
+
+    if (stack == nullptr)
+        return;
+
+    if (stack->overflow)
+    {
+        stack->overflow--;
+        return;
+    }
+
+    if (stack->depth)
+    {
+        stack->depth--;
+        ((SequenceLog*)stack->frames[stack->depth].log)->~SequenceLog();
+    }
+}
+
+/*!
+ * \brief   現在のスレッドの一番上のフレームのシーケンスログ取得
+ */
+static SequenceLog* getCurrentFrame()
+{
+    SequenceLogFrameStack* stack = sFrameStackKey.get(false);
+
+    if (stack == nullptr || stack->depth == 0)
+        return nullptr;
+
+    return (SequenceLog*)stack->frames[stack->depth - 1].log;
+}
+
+} // namespace slog
+
 /******************************************************************************
 *
 * C言語用
@@ -49,8 +415,19 @@ extern "C"
      */
     void* _slog_stepIn(const char* className, const char* funcName)
     {
-        slog::SequenceLog* slog = new slog::SequenceLog(className, funcName);
-        return slog;
+        slog::SequenceLogFrame* frame = slog::allocHandleFrame();
+        new (frame->log) slog::SequenceLog(className, funcName);
+        return frame;
+    }
+
+    /*!
+     * \brief   ステップイン時のログ出力
+     */
+    void* _slog_stepInSite(slog::SequenceLogSite* site)
+    {
+        slog::SequenceLogFrame* frame = slog::allocHandleFrame();
+        new (frame->log) slog::SequenceLog(site);
+        return frame;
     }
 
     /*!
@@ -94,8 +471,11 @@ extern "C"
      */
     void _slog_stepOut(void* p)
     {
-        slog::SequenceLog* slog = (slog::SequenceLog*)p;
-        delete slog;
+        if (p == nullptr)
+            return;
+
+        ((slog::SequenceLog*)p)->~SequenceLog();
+        slog::freeHandleFrame((slog::SequenceLogFrame*)p);
     }
 
     /*!
@@ -161,6 +541,56 @@ extern "C"
         _slog_assert(p, _assertName.getBuffer(), result);
 #endif
     }
+
+    /*!
+     * \brief   ステップイン時のログ出力（ハンドルなし）
+     *
+     * \note    現在のスレッドのフレームスタックに積む。最大の深さを超えた場合は何もしない。
+     *          対になる _slog_stepOutCurrent() は同じスレッドで呼ぶこと。
+     */
+    void _slog_stepInCurrent(const char* className, const char* funcName)
+    {
+        slog::SequenceLogFrame* frame = slog::allocFrame();
+
+        if (frame)
+            new (frame->log) slog::SequenceLog(className, funcName);
+    }
+
+    /*!
+     * \brief   ステップアウト時のログ出力（ハンドルなし）
+     */
+    void _slog_stepOutCurrent()
+    {
+        slog::freeFrame();
+    }
+
+    /*!
+     * \brief   メッセージ出力（ハンドルなし）
+     */
+    void _slog_messageCurrent(int32_t level, const char* format, ...)
+    {
+        slog::SequenceLog* slog = slog::getCurrentFrame();
+
+        if (slog == nullptr)
+            return;
+
+        va_list arg;
+        va_start(arg, format);
+
+        slog->messageV((slog::SequenceLogLevel)level, format, arg);
+        va_end(arg);
+    }
+
+    /*!
+     * \brief   アサート（ハンドルなし）
+     */
+    void _slog_assertCurrent(const char* assertName, bool result)
+    {
+        slog::SequenceLog* slog = slog::getCurrentFrame();
+
+        if (slog)
+            slog->assert(assertName, result);
+    }
 }
 
 /*-----------------------------------------------------------------------------
@@ -193,6 +623,171 @@ static SequenceLogClient* sClient = nullptr;
 //!< 初期化フラグ
 static bool sClientInitialized = false;
 
+/*!
+ * \brief   ログ出力フィルターの条件
+ */
+struct SequenceLogFilterRule
+{
+    String  className;  //!< クラス名（ワイルドカード '*' 可）
+    String  funcName;   //!< 関数名（ワイルドカード '*' 可）
+    int32_t level;      //!< ログレベル
+};
+
+/*!
+ * \brief   ログ出力フィルター（シーケンスログサービスから実行時に変更される）
+ */
+struct SequenceLogFilter
+{
+    int32_t                             level;  //!< 条件に一致しない関数のログレベル
+    std::vector<SequenceLogFilterRule>  rules;  //!< 関数毎の条件（先頭から順に調べる）
+};
+
+//!< ログ出力フィルター（nullptrの場合は全て送信し、シーケンスログサービスで絞り込む）
+static std::atomic<SequenceLogFilter*> sFilter(nullptr);
+
+//!< ログ出力フィルターを参照中のスレッド数
+static std::atomic<int32_t> sFilterReaders(0);
+
+//!< 置き換えたログ出力フィルター（参照中のスレッドがいなくなった後の置き換え時に解放する）
+static std::list<SequenceLogFilter*> sOldFilters;
+
+//!< 登録済みの呼び出し箇所（添字 + 1 が呼び出し箇所ID）
+static std::vector<SequenceLogSite*> sSites;
+
+//!< 呼び出し箇所の登録／更新用ミューテックス
+static Mutex sSiteMutex;
+
+//!< 呼び出し箇所をシーケンスログサービスに報告するかどうか（SITE_LIST_CONTROL受信後）
+static std::atomic<bool> sSiteReport(false);
+
+//!< 過負荷時の縮退レベル（シーケンスログサービスから変更される）
+static std::atomic<int32_t> sOverloadLevel(OVERLOAD_NONE);
+
+//!< サンプリング間隔とカウンター
+static std::atomic<int32_t>  sSamplingRate(1);
+static std::atomic<uint32_t> sSamplingCount(0);
+
+//!< 縮退により送信しなかった数（DEBUGメッセージ、呼び出し、サンプリングしなかったメッセージ）
+static std::atomic<int32_t> sShedDebug(0);
+static std::atomic<int32_t> sShedStep(0);
+static std::atomic<int32_t> sShedSampled(0);
+
+/*!
+ * \brief   ワイルドカード '*' を含むパターンに一致するか調べる
+ */
+static bool matchPattern(const char* pattern, const char* str)
+{
+    const char* star = nullptr;
+    const char* retry = nullptr;
+
+    while (*str)
+    {
+        if (*pattern == '*')
+        {
+            star = pattern++;
+            retry = str;
+            continue;
+        }
+
+        if (*pattern == *str)
+        {
+            pattern++;
+            str++;
+            continue;
+        }
+
+        if (star == nullptr)
+            return false;
+
+        pattern = star + 1;
+        str = ++retry;
+    }
+
+    while (*pattern == '*')
+        pattern++;
+
+    return (*pattern == '\0');
+}
+
+/*!
+ * \brief   関数のログレベル取得
+ *
+ * \param[in]   className   クラス名
+ * \param[in]   funcName    関数名
+ *
+ * \return  ログレベル（ERROR + 1 の場合はステップイン／アウトも含めて送信しない）
+ *
+ * \note    フィルターを読み込む前に sFilterReaders を増やし、参照を終えてから減らす。
+ *          置き換えた側は sFilterReaders が 0 であれば、置き換え前のフィルターを参照中のスレッドはいないと判断できる。
+ */
+static int32_t getFilterLevel(const char* className, const char* funcName)
+{
+    sFilterReaders.fetch_add(1);
+
+    const SequenceLogFilter* filter = sFilter.load();
+    int32_t level = DEBUG - 1;
+
+    if (filter)
+    {
+        level = filter->level;
+
+        for (auto i = filter->rules.begin(); i != filter->rules.end(); i++)
+        {
+            if (matchPattern(i->className.getBuffer(), className ? className : "(null)") &&
+                matchPattern(i->funcName. getBuffer(), funcName  ? funcName  : "(null)"))
+            {
+                level = i->level;
+                break;
+            }
+        }
+    }
+
+    sFilterReaders.fetch_sub(1, std::memory_order_release);
+    return level;
+}
+
+/*!
+ * \brief   置き換えたログ出力フィルターを解放する
+ *
+ * \note    sFilter を置き換えた後に呼ぶこと。参照中のスレッドがいる場合は次の置き換えまで残す。
+ */
+static void freeOldFilters()
+{
+    if (sFilterReaders.load() != 0)
+        return;
+
+    for (auto i = sOldFilters.begin(); i != sOldFilters.end(); i++)
+        delete *i;
+
+    sOldFilters.clear();
+}
+
+/*!
+ * \brief   呼び出し箇所のログレベル取得
+ *
+ * \param[in]   site    呼び出し箇所
+ *
+ * \return  ログレベル（無効な場合は ERROR + 1）
+ */
+static int32_t getSiteLevel(const SequenceLogSite* site)
+{
+    if (sLogLevel == ERROR + 1/*NONE*/ || site->disabled)
+        return ERROR + 1;
+
+    return getFilterLevel(site->className, site->funcName);
+}
+
+/*!
+ * \brief   登録済みの呼び出し箇所のログレベルを更新する
+ */
+static void updateSiteLevels()
+{
+    ScopedLock lock(&sSiteMutex);
+
+    for (auto i = sSites.begin(); i != sSites.end(); i++)
+        (*i)->level = getSiteLevel(*i);
+}
+
 /*!
  * \brief   シーケンスログクライアントクラス
  */
@@ -208,6 +803,16 @@ class SequenceLogClient : public WebSocketListener
              */
             uint32_t mSeqNo;
 
+            /*!
+             * \brief   コンパクト形式で送信するかどうか
+             */
+            bool mCompact;
+
+            /*!
+             * \brief   コンパクト形式の符号化状態
+             */
+            SequenceLogCompactState mCompactState;
+
             /*!
              * コンストラクタ
              */
@@ -228,6 +833,21 @@ public:     void init();
              */
 public:     virtual void onOpen() override;
             virtual void onError(const char* message) override;
+            virtual void onMessage(const ByteBuffer& buffer) override;
+
+            /*!
+             * 制御メッセージ処理
+             */
+private:    void setLogLevel(ByteBuffer* data) throw(Exception);
+            void setOverloadLevel(ByteBuffer* data) throw(Exception);
+            void setSiteEnabled(ByteBuffer* data) throw(Exception);
+
+            /*!
+             * 呼び出し箇所登録／報告
+             */
+public:     void registerSite(SequenceLogSite* site);
+private:    void reportSites();
+            void sendSite(const SequenceLogSite* site);
 
             /*!
              * シーケンスログアイテム生成
@@ -247,6 +867,7 @@ inline SequenceLogClient::SequenceLogClient()
 {
     Socket::startup();
     mSeqNo = 1;
+    mCompact = false;
 }
 
 /*!
@@ -290,6 +911,14 @@ void SequenceLogClient::init()
  */
 void SequenceLogClient::onOpen()
 {
+    // 接続先のサービスがコンパクト形式を読めるとは限らないので、通知されるまでは通常の形式で送信する
+    {
+        ScopedLock lock(mSocket.getMutex());
+
+        mCompact = false;
+        mCompactState = SequenceLogCompactState();
+    }
+
     // WebSocketヘッダー送信
     Process process;
     uint32_t pid = process.getId();
@@ -304,12 +933,15 @@ void SequenceLogClient::onOpen()
     FixedString<MAX_PATH> fileName = sSequenceLogFileName;
     int32_t fileNameLen = fileName.getLength() + 1;
 
+    int32_t capabilities = CLIENT_CAPABILITY_SITE_LIST | CLIENT_CAPABILITY_COMPACT;
+
     mSocket.sendHeader(
         sizeof(pid) +
         sizeof(userNameLen) + userNameLen +
         sizeof(passwdLen)   + passwdLen +
         sizeof(fileNameLen) + fileNameLen +
-        sizeof(sLogLevel),
+        sizeof(sLogLevel) +
+        sizeof(capabilities),
         false);
 
     // プロセスID送信
@@ -329,6 +961,9 @@ void SequenceLogClient::onOpen()
 
     // ログレベル送信
     mSocket.send(&sLogLevel);
+
+    // 対応している制御メッセージ送信
+    mSocket.send(&capabilities);
 }
 
 /*!
@@ -339,6 +974,203 @@ void SequenceLogClient::onError(const char* message)
     noticeLog("onError: %s\n", message);
 }
 
+/*!
+ * \brief   Web Socket onMessage
+ *
+ * \note    シーケンスログサービスからの制御メッセージを受信する。
+ */
+void SequenceLogClient::onMessage(const ByteBuffer& buffer)
+{
+    ByteBuffer* data = (ByteBuffer*)&buffer;
+
+    try
+    {
+        int32_t type = data->getInt();
+
+        if (type == LOG_LEVEL_CONTROL)
+            setLogLevel(data);
+
+        if (type == OVERLOAD_CONTROL)
+            setOverloadLevel(data);
+
+        if (type == SITE_LIST_CONTROL)
+            reportSites();
+
+        if (type == SITE_ENABLE_CONTROL)
+            setSiteEnabled(data);
+
+        if (type == COMPACT_ENCODING_CONTROL)
+        {
+            ScopedLock lock(mSocket.getMutex());
+            mCompact = true;
+        }
+    }
+    catch (Exception& e)
+    {
+        noticeLog("onMessage: %s\n", e.getMessage());
+    }
+}
+
+/*!
+ * \brief   ログレベル制御メッセージ処理
+ *
+ * \note    ログ出力フィルターを置き換え、以降のステップイン／メッセージから適用する。
+ */
+void SequenceLogClient::setLogLevel(ByteBuffer* data) throw(Exception)
+{
+    SequenceLogFilter* filter = new SequenceLogFilter;
+
+    try
+    {
+        filter->level = data->getInt();
+
+        int32_t count = data->getInt();
+
+        for (int32_t i = 0; i < count; i++)
+        {
+            SequenceLogFilterRule rule;
+            rule.level = data->getInt();
+
+            int32_t len = data->getInt();
+            rule.className.copy(data->get(len), len);
+
+            len = data->getInt();
+            rule.funcName.copy(data->get(len), len);
+
+            filter->rules.push_back(rule);
+        }
+    }
+    catch (Exception)
+    {
+        delete filter;
+        throw;
+    }
+
+    SequenceLogFilter* oldFilter = sFilter.exchange(filter);
+
+    if (oldFilter)
+        sOldFilters.push_back(oldFilter);
+
+    freeOldFilters();
+
+    // 呼び出し箇所のログレベルに反映する
+    updateSiteLevels();
+
+    if (sSiteReport)
+        reportSites();
+}
+
+/*!
+ * \brief   過負荷制御メッセージ処理
+ *
+ * \note    縮退レベルを変更し、前回の変更から間引いた数があればWARNメッセージで報告する。
+ */
+void SequenceLogClient::setOverloadLevel(ByteBuffer* data) throw(Exception)
+{
+    int32_t level =        data->getInt();
+    int32_t samplingRate = data->getInt();
+
+    int32_t oldLevel = sOverloadLevel.exchange(level, std::memory_order_relaxed);
+    sSamplingRate.store(0 < samplingRate ? samplingRate : 1, std::memory_order_relaxed);
+
+    int32_t shedDebug =   sShedDebug.  exchange(0);
+    int32_t shedStep =    sShedStep.   exchange(0);
+    int32_t shedSampled = sShedSampled.exchange(0);
+
+    if (shedDebug == 0 && shedStep == 0 && shedSampled == 0)
+        return;
+
+    SequenceLogItem* item = createItem();
+
+    if (item)
+    {
+        item->init(0, WARN);
+        item->mMessageId = 0;
+        item->getMessage()->format(
+            "slog overload level %d -> %d: shed %d debug messages, %d calls, %d sampled messages",
+            oldLevel, level, shedDebug, shedStep, shedSampled);
+
+        sendItem(item);
+    }
+}
+
+/*!
+ * \brief   呼び出し箇所有効／無効制御メッセージ処理
+ */
+void SequenceLogClient::setSiteEnabled(ByteBuffer* data) throw(Exception)
+{
+    int32_t enabled = data->getInt();
+    int32_t count =   data->getInt();
+
+    ScopedLock lock(&sSiteMutex);
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        uint32_t id = data->getInt();
+
+        if (id == 0 || sSites.size() < id)
+            continue;
+
+        SequenceLogSite* site = sSites[id - 1];
+        site->disabled = (enabled == 0);
+        site->level = getSiteLevel(site);
+
+        sendSite(site);
+    }
+}
+
+/*!
+ * \brief   呼び出し箇所登録
+ *
+ * \param[in]   site    呼び出し箇所
+ *
+ * \return  なし
+ */
+void SequenceLogClient::registerSite(SequenceLogSite* site)
+{
+    {
+        ScopedLock lock(&sSiteMutex);
+
+        if (site->id)
+            return;
+
+        sSites.push_back(site);
+        site->level = getSiteLevel(site);
+        site->id = (uint32_t)sSites.size();
+    }
+
+    // ソケットのミューテックスはロックを解除してから取得する（受信スレッドはソケット、呼び出し箇所の順にロックする）
+    if (sSiteReport)
+        sendSite(site);
+}
+
+/*!
+ * \brief   登録済みの呼び出し箇所を全て報告する
+ */
+void SequenceLogClient::reportSites()
+{
+    sSiteReport = true;
+
+    ScopedLock lock(&sSiteMutex);
+
+    for (auto i = sSites.begin(); i != sSites.end(); i++)
+        sendSite(*i);
+}
+
+/*!
+ * \brief   呼び出し箇所報告
+ */
+void SequenceLogClient::sendSite(const SequenceLogSite* site)
+{
+    SequenceLogItem* item = createItem();
+
+    if (item)
+    {
+        item->init(site);
+        sendItem(item);
+    }
+}
+
 /*!
  * \brief   シーケンスログアイテム生成
  */
@@ -395,7 +1227,9 @@ void SequenceLogClient::sendItem(
         }
 
         SequenceLogByteBuffer buffer(capacity);
-        uint32_t size = buffer.putSequenceLogItem(item);
+        uint32_t size = (mCompact
+            ? buffer.putCompactSequenceLogItem(item, &mCompactState)
+            : buffer.putSequenceLogItem(item));
 
         // シーケンスログアイテム送信
         mSocket.sendHeader(size, false);
@@ -430,6 +1264,12 @@ public:     ~SequenceLogClientDeleter()
             {
                 delete sClient;
                 sClient = nullptr;
+
+                for (auto i = sOldFilters.begin(); i != sOldFilters.end(); i++)
+                    delete *i;
+
+                sOldFilters.clear();
+                delete sFilter.exchange(nullptr);
             }
 };
 
@@ -442,14 +1282,60 @@ static SequenceLogClientDeleter s_deleter;
 ******************************************************************************/
 
 /*!
- * \brief   コンストラクタ
+ * \brief   コンストラクタ
+ *
+ * \param[in]   className   クラス名
+ * \param[in]   funcName    メソッド名
+ */
+SequenceLog::SequenceLog(const char* className, const char* funcName)
+{
+    init();
+    mLogLevel = getFilterLevel(className, funcName);
+
+    if (mLogLevel == ERROR + 1/*NONE*/)
+        return;
+
+    stepIn(className, funcName);
+}
+
+/*!
+ * \brief   ステップイン
+ *
+ * \param[in]   site    呼び出し箇所
+ *
+ * \note    最初の呼び出しで呼び出し箇所を登録し、ログレベルを決める。
+ */
+void SequenceLog::stepIn(SequenceLogSite* site)
+{
+    init();
+
+    if (site->id == 0)
+    {
+        sClient->registerSite(site);
+        mLogLevel = site->level;
+
+        if (mLogLevel == ERROR + 1/*NONE*/)
+            return;
+    }
+
+    stepIn(site->className, site->funcName);
+}
+
+/*!
+ * \brief   ステップイン
  *
  * \param[in]   className   クラス名
  * \param[in]   funcName    メソッド名
  */
-SequenceLog::SequenceLog(const char* className, const char* funcName)
+void SequenceLog::stepIn(const char* className, const char* funcName)
 {
-    init();
+    if (sOverloadLevel.load(std::memory_order_relaxed) >= OVERLOAD_DROP_STEP)
+    {
+        // 過負荷のため呼び出しを送信しない（mSeqNoは0のまま）
+        sShedStep++;
+        return;
+    }
+
     SequenceLogItem* item = sClient->createItem();
 
     if (item)
@@ -506,9 +1392,9 @@ SequenceLog::SequenceLog(const char* className, const char* funcName)
 //}
 
 /*!
- * \brief   デストラクタ
+ * \brief   ステップアウト
  */
-SequenceLog::~SequenceLog()
+void SequenceLog::stepOut()
 {
     SequenceLogItem* item = sClient->createItem();
 
@@ -536,14 +1422,74 @@ void SequenceLog::init()
 }
 
 /*!
- * \brief   メッセージ出力
+ * \brief   メッセージ用のアイテムを生成する
+ *
+ * \return  メッセージを出力しない場合はnullptrを返す
+ */
+static SequenceLogItem* createMessageItem(uint32_t seqNo, int32_t logLevel, SequenceLogLevel level)
+{
+    // ログレベル未満のメッセージは送信しない
+    if ((int32_t)level < logLevel)
+        return nullptr;
+
+    // 過負荷時の間引き
+    int32_t overloadLevel = sOverloadLevel.load(std::memory_order_relaxed);
+
+    if (overloadLevel >= OVERLOAD_DROP_DEBUG && level == DEBUG)
+    {
+        sShedDebug++;
+        return nullptr;
+    }
+
+    if (overloadLevel >= OVERLOAD_SAMPLING && level < WARN)
+    {
+        uint32_t samplingRate = (uint32_t)sSamplingRate.load(std::memory_order_relaxed);
+
+        if (sSamplingCount++ % samplingRate != 0)
+        {
+            sShedSampled++;
+            return nullptr;
+        }
+    }
+
+    SequenceLogItem* item = sClient->createItem();
+
+    if (item)
+    {
+        item->init(seqNo, level);
+        item->mMessageId = 0;
+    }
+
+    return item;
+}
+
+/*!
+ * \brief   メッセージ出力（型情報付きの引数）
  */
-void SequenceLog::message(SequenceLogLevel level, const char* format, ...)
+void SequenceLog::messageArgs(SequenceLogLevel level, const char* format, const FormatArg* args, int32_t count)
 {
-    va_list arg;
-    va_start(arg, format);
+    SequenceLogItem* item = createMessageItem(mSeqNo, mLogLevel, level);
+
+    if (item)
+    {
+        try
+        {
+            CoreString* message = item->getMessage();
+
+            if (format)
+                message->formatArgs(format, args, count);
+
+            else
+                message->copy("(null)");
+        }
+        catch (Exception e)
+        {
+            // 書式の誤りはメッセージとして出力する
+            item->getMessage()->copy(e.getMessage());
+        }
 
-    messageV(level, format, arg);
+        sClient->sendItem(item);
+    }
 }
 
 /*!
@@ -551,13 +1497,10 @@ void SequenceLog::message(SequenceLogLevel level, const char* format, ...)
  */
 void SequenceLog::messageV(SequenceLogLevel level, const char* format, va_list arg)
 {
-    SequenceLogItem* item = sClient->createItem();
+    SequenceLogItem* item = createMessageItem(mSeqNo, mLogLevel, level);
 
     if (item)
     {
-        item->init(mSeqNo, level);
-        item->mMessageId = 0;
-
         try
         {
             CoreString* message = item->getMessage();
@@ -612,33 +1555,47 @@ void SequenceLog::assert(const char* assertName, bool result)
 /*!
  * \brief   シーケンスログアイテム取得
  *
- * \param[out]  item    結果を受け取るシーケンスログアイテム
+ * \param[out]  item                結果を受け取るシーケンスログアイテム
+ * \param[in]   isInputDateTime     日時を読み込むかどうか（シーケンスログファイルのレコードの場合はtrue）
+ * \param[in]   state               コンパクト形式の符号化状態（クライアントから受信したレコードの場合）
  *
  * \return  なし
  */
-void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item) throw(Exception)
+void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item, bool isInputDateTime, SequenceLogCompactState* state) throw(Exception)
 {
     Exception e;
     setPosition(0);
 
+    // コンパクト形式（クライアントから受信したレコードのみ）
+    if (isInputDateTime == false &&
+        getLength() < COMPACT_SIZE_LIMIT &&
+        (uint8_t)getBuffer()[0] == COMPACT_MARKER)
+    {
+        getCompactSequenceLogItem(item, state);
+        return;
+    }
+
+    ByteBufferReader reader(this, getCapacity());
+
     // レコード長
-    uint16_t size = getShort();
+    uint16_t size = reader.getShort();
 
     // シーケンス番号
-    uint32_t seq = getInt();
+    uint32_t seq = reader.getInt();
     item->mSeqNo = seq;
 
     // 日時
-//  uint64_t datetime = getLong();
-//  item->mDateTime.setValue(datetime);
-    item->mDateTime.setCurrent();
+    if (isInputDateTime)
+        item->mDateTime.setValue(reader.getLong());
+    else
+        item->mDateTime.setCurrent();
 
     // シーケンスログアイテム種別
-    SequenceLogItem::Type type = (SequenceLogItem::Type)get();
+    SequenceLogItem::Type type = (SequenceLogItem::Type)reader.get();
     item->mType = type;
 
     // ID
-    uint32_t threadId = getInt();
+    uint32_t threadId = reader.getInt();
     item->mThreadId = threadId;
 
     switch (type)
@@ -646,27 +1603,27 @@ void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item) throw(Exce
     case SequenceLogItem::STEP_IN:
     {
         // クラス名
-        uint32_t ID = getInt();
+        uint32_t ID = reader.getInt();
         item->mClassId = ID;
 
         if (ID == 0)
         {
-            short classLen = getShort();
+            short classLen = reader.getShort();
             CoreString* className = item->getClassName();
 
-            className->copy(get(classLen), classLen);
+            className->copy(reader.get(classLen), classLen);
         }
 
         // 関数名
-        ID = getInt();
+        ID = reader.getInt();
         item->mFuncId = ID;
 
         if (ID == 0)
         {
-            short funcLen = getShort();
+            short funcLen = reader.getShort();
             CoreString* funcName = item->getFuncName();
 
-            funcName->copy(get(funcLen), funcLen);
+            funcName->copy(reader.get(funcLen), funcLen);
         }
 
         break;
@@ -678,28 +1635,45 @@ void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item) throw(Exce
     case SequenceLogItem::MESSAGE:
     {
         // メッセージ
-        SequenceLogLevel level = (SequenceLogLevel)get();
+        SequenceLogLevel level = (SequenceLogLevel)reader.get();
         item->mLevel = level;
 
-        uint32_t ID = getInt();
+        uint32_t ID = reader.getInt();
         item->mMessageId = ID;
 
         if (ID == 0)
         {
-            short msgLen = getShort();
+            short msgLen = reader.getShort();
             CoreString* message = item->getMessage();
 
-            message->copy(get(msgLen), msgLen);
+            message->copy(reader.get(msgLen), msgLen);
         }
 
         break;
     }
 
+    case SequenceLogItem::SITE:
+    {
+        // 呼び出し箇所
+        item->mLevel =     reader.getInt();
+        item->mMessageId = reader.getInt();
+
+        short classLen = reader.getShort();
+        item->getClassName()->copy(reader.get(classLen), classLen);
+
+        short funcLen = reader.getShort();
+        item->getFuncName()->copy(reader.get(funcLen), funcLen);
+
+        break;
+    }
+
     default:
         e.setMessage("シーケンスログアイテム種別(%d)が正しくありません。", type);
         throw e;
     }
 
+    reader.commit();
+
     if (getPosition() != size)
     {
         e.setMessage("データが異常です(%d, %d)。シーケンスログアイテムを設定できませんでした。", getPosition(), size);
@@ -707,6 +1681,116 @@ void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item) throw(Exce
     }
 }
 
+/*!
+ * \brief   シーケンスログアイテム取得（コンパクト形式）
+ *
+ * \param[out]  item    結果を受け取るシーケンスログアイテム
+ * \param[in]   state   コンパクト形式の符号化状態
+ *
+ * \return  なし
+ */
+void SequenceLogByteBuffer::getCompactSequenceLogItem(SequenceLogItem* item, SequenceLogCompactState* state) throw(Exception)
+{
+    Exception e;
+
+    if (state == nullptr)
+    {
+        e.setMessage("コンパクト形式のシーケンスログアイテムは読み込めません。");
+        throw e;
+    }
+
+    ByteBufferReader reader(this, getLength());
+    reader.get();   // COMPACT_MARKER
+
+    // シーケンスログアイテム種別
+    SequenceLogItem::Type type = (SequenceLogItem::Type)(uint8_t)reader.get();
+    item->mType = type;
+
+    // シーケンス番号
+    uint32_t seq = state->seqNo + (uint32_t)fromZigZag(reader.getVarInt());
+    item->mSeqNo = seq;
+
+    // 日時
+    item->mDateTime.setCurrent();
+
+    // スレッドID
+    item->mThreadId = (uint32_t)reader.getVarInt();
+
+    int32_t len;
+
+    switch (type)
+    {
+    case SequenceLogItem::STEP_IN:
+    {
+        // クラス名
+        item->mClassId = (uint32_t)reader.getVarInt();
+
+        if (item->mClassId == 0)
+        {
+            len = (int32_t)reader.getVarInt();
+            item->getClassName()->copy(reader.get(len), len);
+        }
+
+        // 関数名
+        item->mFuncId = (uint32_t)reader.getVarInt();
+
+        if (item->mFuncId == 0)
+        {
+            len = (int32_t)reader.getVarInt();
+            item->getFuncName()->copy(reader.get(len), len);
+        }
+
+        break;
+    }
+
+    case SequenceLogItem::STEP_OUT:
+        break;
+
+    case SequenceLogItem::MESSAGE:
+    {
+        // メッセージ
+        item->mLevel = (SequenceLogLevel)reader.get();
+        item->mMessageId = (uint32_t)reader.getVarInt();
+
+        if (item->mMessageId == 0)
+        {
+            len = (int32_t)reader.getVarInt();
+            item->getMessage()->copy(reader.get(len), len);
+        }
+
+        break;
+    }
+
+    case SequenceLogItem::SITE:
+    {
+        // 呼び出し箇所
+        item->mLevel =     (uint32_t)fromZigZag(reader.getVarInt());
+        item->mMessageId = (uint32_t)reader.getVarInt();
+
+        len = (int32_t)reader.getVarInt();
+        item->getClassName()->copy(reader.get(len), len);
+
+        len = (int32_t)reader.getVarInt();
+        item->getFuncName()->copy(reader.get(len), len);
+
+        break;
+    }
+
+    default:
+        e.setMessage("シーケンスログアイテム種別(%d)が正しくありません。", type);
+        throw e;
+    }
+
+    if (reader.getRemaining() != 0)
+    {
+        e.setMessage("データが異常です(%d, %d)。シーケンスログアイテムを設定できませんでした。", reader.getLength(), getLength());
+        throw e;
+    }
+
+    reader.commit();
+    state->seqNo = seq;
+}
+
 /*!
  * \brief   シーケンスログアイテム書き込み
  *
@@ -715,51 +1799,86 @@ void SequenceLogByteBuffer::getSequenceLogItem(SequenceLogItem* item) throw(Exce
  *
  * \return  レコード長
  */
-uint32_t SequenceLogByteBuffer::putSequenceLogItem(const SequenceLogItem* item, bool isOutputDateTime)
+uint32_t SequenceLogByteBuffer::putSequenceLogItem(const SequenceLogItem* item, bool isOutputDateTime) throw(Exception)
 {
-    unsigned short size;
+    const CoreString* className = item->getClassName();
+    const CoreString* funcName =  item->getFuncName();
+    const CoreString* message =   item->getMessage();
+
+    // 最大のレコード長（範囲は最初に一度だけ調べる）
+    int32_t maxLength =
+        sizeof(int16_t) +                                       // レコード長
+        sizeof(int32_t) +                                       // シーケンス番号
+        (isOutputDateTime ? sizeof(int64_t) : 0) +              // 日時
+        sizeof(char) +                                          // 種別
+        sizeof(int32_t);                                        // スレッドID
+
+    switch (item->mType)
+    {
+    case SequenceLogItem::STEP_IN:
+        maxLength +=
+            sizeof(int32_t) + sizeof(int16_t) + className->getLength() +
+            sizeof(int32_t) + sizeof(int16_t) + funcName-> getLength();
+        break;
+
+    case SequenceLogItem::MESSAGE:
+        maxLength += sizeof(char) + sizeof(int32_t) + sizeof(int16_t) + message->getLength();
+        break;
+
+    case SequenceLogItem::SITE:
+        maxLength +=
+            sizeof(int32_t) + sizeof(int32_t) +
+            sizeof(int16_t) + className->getLength() +
+            sizeof(int16_t) + funcName-> getLength();
+        break;
+
+    default:
+        break;
+    }
+
+    setPosition(0);
+    ByteBufferWriter writer(this, maxLength);
     int32_t len;
 
-    setPosition(sizeof(size));
+    // レコード長（後で設定する）
+    writer.putShort(0);
 
     // シーケンス番号
-    putInt(item->mSeqNo);
+    writer.putInt(item->mSeqNo);
 
     // 日時
     if (isOutputDateTime)
-        putLong(item->mDateTime.getValue());
+        writer.putLong(item->mDateTime.getValue());
 
     // シーケンスログアイテム種別
-    put(item->mType);
+    writer.put(item->mType);
 
     // スレッド ID
-    putInt(item->mThreadId);
+    writer.putInt(item->mThreadId);
 
     switch (item->mType)
     {
     case SequenceLogItem::STEP_IN:
         // クラス名
-        putInt(item->mClassId);
+        writer.putInt(item->mClassId);
 
         if (item->mClassId == 0)
         {
-            CoreString* className = item->getClassName();
             len = className->getLength();
 
-            putShort(len);
-            put(className, len);
+            writer.putShort(len);
+            writer.put(className->getBuffer(), len);
         }
 
         // 関数名
-        putInt(item->mFuncId);
+        writer.putInt(item->mFuncId);
 
         if (item->mFuncId == 0)
         {
-            CoreString* funcName = item->getFuncName();
             len = funcName->getLength();
 
-            putShort(len);
-            put(funcName, len);
+            writer.putShort(len);
+            writer.put(funcName->getBuffer(), len);
         }
 
         break;
@@ -770,30 +1889,174 @@ uint32_t SequenceLogByteBuffer::putSequenceLogItem(const SequenceLogItem* item,
     case SequenceLogItem::MESSAGE:
     {
         // メッセージ
-        put(item->mLevel);
-        putInt(item->mMessageId);
+        writer.put(item->mLevel);
+        writer.putInt(item->mMessageId);
 
         if (item->mMessageId == 0)
         {
-            CoreString* message = item->getMessage();
             len = message->getLength();
 
-            putShort(len);
-            put(message, len);
+            writer.putShort(len);
+            writer.put(message->getBuffer(), len);
         }
         break;
     }
 
+    case SequenceLogItem::SITE:
+    {
+        // 呼び出し箇所
+        writer.putInt(item->mLevel);
+        writer.putInt(item->mMessageId);
+
+        len = className->getLength();
+
+        writer.putShort(len);
+        writer.put(className->getBuffer(), len);
+
+        len = funcName->getLength();
+
+        writer.putShort(len);
+        writer.put(funcName->getBuffer(), len);
+        break;
+    }
+
     default:
         break;
     }
 
     // 先頭にレコード長を設定
-    size = getPosition();
+    unsigned short size = writer.getLength();
+    writer.putShort(0, size);
+    writer.commit();
+
+    return size;
+}
+
+/*!
+ * \brief   シーケンスログアイテム書き込み（コンパクト形式）
+ *
+ * \param[in]       item    シーケンスログアイテム
+ * \param[in,out]   state   コンパクト形式の符号化状態
+ *
+ * \return  レコード長
+ *
+ * \note    コンパクト形式で COMPACT_SIZE_LIMIT 以上になる可能性がある場合は通常の形式で書き込む。
+ */
+uint32_t SequenceLogByteBuffer::putCompactSequenceLogItem(const SequenceLogItem* item, SequenceLogCompactState* state) throw(Exception)
+{
+    const CoreString* className = item->getClassName();
+    const CoreString* funcName =  item->getFuncName();
+    const CoreString* message =   item->getMessage();
+
+    // 最大のレコード長（可変長整数は uint32_t で５バイト、文字列長は３バイト）
+    int32_t maxLength = 32;
+
+    switch (item->mType)
+    {
+    case SequenceLogItem::STEP_IN:
+        maxLength += className->getLength() + funcName->getLength();
+        break;
+
+    case SequenceLogItem::MESSAGE:
+        maxLength += message->getLength();
+        break;
+
+    case SequenceLogItem::SITE:
+        maxLength += className->getLength() + funcName->getLength();
+        break;
+
+    default:
+        break;
+    }
+
+    if (COMPACT_SIZE_LIMIT <= maxLength)
+        return putSequenceLogItem(item);
 
     setPosition(0);
-    putShort(size);
+    ByteBufferWriter writer(this, maxLength);
+    int32_t len;
+
+    writer.put((char)COMPACT_MARKER);
+
+    // シーケンスログアイテム種別
+    writer.put(item->mType);
+
+    // シーケンス番号、スレッドID
+    writer.putVarInt(toZigZag((int32_t)(item->mSeqNo - state->seqNo)));
+    writer.putVarInt(item->mThreadId);
+
+    switch (item->mType)
+    {
+    case SequenceLogItem::STEP_IN:
+        // クラス名
+        writer.putVarInt(item->mClassId);
+
+        if (item->mClassId == 0)
+        {
+            len = className->getLength();
+
+            writer.putVarInt(len);
+            writer.put(className->getBuffer(), len);
+        }
+
+        // 関数名
+        writer.putVarInt(item->mFuncId);
+
+        if (item->mFuncId == 0)
+        {
+            len = funcName->getLength();
+
+            writer.putVarInt(len);
+            writer.put(funcName->getBuffer(), len);
+        }
+
+        break;
+
+    case SequenceLogItem::STEP_OUT:
+        break;
+
+    case SequenceLogItem::MESSAGE:
+    {
+        // メッセージ
+        writer.put(item->mLevel);
+        writer.putVarInt(item->mMessageId);
+
+        if (item->mMessageId == 0)
+        {
+            len = message->getLength();
+
+            writer.putVarInt(len);
+            writer.put(message->getBuffer(), len);
+        }
+        break;
+    }
+
+    case SequenceLogItem::SITE:
+    {
+        // 呼び出し箇所
+        writer.putVarInt(toZigZag((int32_t)item->mLevel));
+        writer.putVarInt(item->mMessageId);
+
+        len = className->getLength();
+
+        writer.putVarInt(len);
+        writer.put(className->getBuffer(), len);
+
+        len = funcName->getLength();
+
+        writer.putVarInt(len);
+        writer.put(funcName->getBuffer(), len);
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    uint32_t size = writer.getLength();
+    writer.commit();
 
+    state->seqNo = item->mSeqNo;
     return size;
 }
 
@@ -920,6 +2183,7 @@ extern "C" void loadSequenceLogConfig(const char* fileName)
         setSequenceLogPassword(&passwd);
         setSequenceLogFileName(&logFileName);
         setLogLevel(&logLevel);
+        slog::updateSiteLevels();
     }
     catch (slog::Exception e)
     {
@@ -0,0 +1,1006 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogArchive.cpp
+ * \brief   シーケンスログアーカイブクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogArchive.h"
+#include "SequenceLogFileReader.h"
+
+#include "slog/ByteBuffer.h"
+#include "slog/CompressedFile.h"
+#include "slog/FixedString.h"
+
+#include <map>
+#include <set>
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+
+/*!
+ * シグネチャ
+ */
+static const char SIGNATURE[] = "SLA1";
+static const int32_t SIGNATURE_SIZE = 4;
+
+/*!
+ * フッターのサイズ（ディレクトリの位置、シグネチャ）
+ */
+static const int32_t FOOTER_SIZE = 8 + SIGNATURE_SIZE;
+
+/*!
+ * アーカイブの拡張子
+ */
+static const char ARCHIVE_EXT[] = ".sloga";
+
+/*!
+ * グループの最大レコード数
+ */
+static const int32_t GROUP_RECORD_COUNT = 4096;
+
+/*!
+ * グループの展開後のサイズの目安（CompressedFileのブロックとして展開できる大きさに抑える）
+ */
+static const int32_t GROUP_RAW_SIZE = 1024 * 1024;
+
+/*!
+ * レコードの最大サイズ
+ */
+static const int32_t MAX_RECORD_SIZE = 0xFFFF;
+
+typedef std::vector<uint8_t> ArchiveColumn;
+
+/*!
+ * \brief   不正なアーカイブの例外を送出する
+ */
+static void throwIllegalArchive(const char* where)
+{
+    Exception e;
+    e.setMessage("SequenceLogArchive::%s / illegal archive", where);
+
+    throw e;
+}
+
+/*!
+ * \brief   可変長整数（７ビット単位）書き込み
+ */
+static void putVarInt(ArchiveColumn* column, uint64_t value)
+{
+    while (0x80 <= value)
+    {
+        column->push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+
+    column->push_back((uint8_t)value);
+}
+
+/*!
+ * \brief   カラム読み込みクラス
+ */
+class ArchiveColumnReader
+{
+            const uint8_t* mP;
+            const uint8_t* mEnd;
+
+            /*!
+             * コンストラクタ
+             */
+public:     ArchiveColumnReader(const ArchiveColumn* column)
+            {
+                mP =   (column->empty() ? nullptr : &(*column)[0]);
+                mEnd = mP + column->size();
+            }
+
+            /*!
+             * 可変長整数読み込み
+             */
+            uint64_t getVarInt() throw(Exception)
+            {
+                uint64_t value = 0;
+                int32_t shift = 0;
+
+                while (true)
+                {
+                    if (mEnd <= mP || 63 < shift)
+                        throwIllegalArchive("readGroup()");
+
+                    uint8_t c = *mP++;
+                    value |= (uint64_t)(c & 0x7F) << shift;
+
+                    if ((c & 0x80) == 0)
+                        break;
+
+                    shift += 7;
+                }
+
+                return value;
+            }
+
+            /*!
+             * バイト列読み込み
+             */
+            const char* get(int32_t len) throw(Exception)
+            {
+                if (mEnd - mP < len)
+                    throwIllegalArchive("readGroup()");
+
+                const char* p = (const char*)mP;
+                mP += len;
+
+                return p;
+            }
+};
+
+/*!
+ * \brief   シーケンスログアーカイブ書き込みクラス
+ */
+class SequenceLogArchiveWriter
+{
+            /*!
+             * ファイル
+             */
+            File mFile;
+
+            /*!
+             * ファイル内の書き込み位置
+             */
+            int64_t mPosition;
+
+            /*!
+             * 展開後の位置
+             */
+            int64_t mRawPosition;
+
+            /*!
+             * 書き込み中のグループのカラム
+             */
+            ArchiveColumn mColumns[SequenceLogArchive::COLUMN_COUNT];
+
+            /*!
+             * 書き込み中のグループ
+             */
+            SequenceLogArchiveGroup mGroup;
+
+            /*!
+             * 書き込み中のグループに出現したスレッド（辞書番号）
+             */
+            std::set<uint32_t> mGroupThreads;
+
+            /*!
+             * 書き込み中のグループのメッセージ数
+             */
+            int32_t mMessageCount;
+
+            /*!
+             * 前レコードのシーケンス番号、日時、日時の差分
+             */
+            uint32_t mPrevSeqNo;
+            uint64_t mPrevDateTime;
+            int64_t  mPrevDelta;
+
+            /*!
+             * スレッドIDの辞書
+             */
+            std::map<uint32_t, uint32_t> mThreadDictionary;
+            std::vector<uint32_t> mThreadIds;
+
+            /*!
+             * クラス名・関数名の辞書
+             */
+            std::map<String, uint32_t> mNameDictionary;
+            ArchiveColumn mNames;
+
+            /*!
+             * 書き込み済みのグループ
+             */
+            std::vector<SequenceLogArchiveGroup> mGroups;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogArchiveWriter()
+            {
+                mPosition = 0;
+                mRawPosition = 0;
+                mGroup.count = 0;
+                mMessageCount = 0;
+            }
+
+            /*!
+             * オープン
+             */
+            void open(const CoreString* fileName) throw(Exception);
+
+            /*!
+             * クローズ（ディレクトリを書き込む）
+             */
+            void close() throw(Exception);
+
+            /*!
+             * レコード追加
+             */
+            void add(const SequenceLogItem* item, int32_t size) throw(Exception);
+
+            /*!
+             * クラス名・関数名追加
+             */
+private:    void addName(uint32_t id, const CoreString* name);
+
+            /*!
+             * 書き込み中のグループをファイルに書き込む
+             */
+            void flush() throw(Exception);
+};
+
+/*!
+ * \brief   オープン
+ */
+void SequenceLogArchiveWriter::open(const CoreString* fileName) throw(Exception)
+{
+    mFile.open(fileName, File::WRITE);
+
+    ByteBuffer signature(SIGNATURE_SIZE);
+    signature.put(SIGNATURE, SIGNATURE_SIZE);
+
+    mFile.write(&signature, SIGNATURE_SIZE);
+    mPosition = SIGNATURE_SIZE;
+}
+
+/*!
+ * \brief   レコード追加
+ *
+ * \param[in]   item    シーケンスログアイテム
+ * \param[in]   size    シーケンスログファイル上のレコードのサイズ
+ *
+ * \return  なし
+ */
+void SequenceLogArchiveWriter::add(const SequenceLogItem* item, int32_t size) throw(Exception)
+{
+    uint64_t dateTime = item->mDateTime.getValue();
+
+    if (mGroup.count == 0)
+    {
+        mGroup.rawPosition = mRawPosition;
+        mGroup.rawSize = 0;
+        mGroup.minDateTime = dateTime;
+        mGroup.maxDateTime = dateTime;
+        mGroup.levels = 0;
+
+        mPrevSeqNo = 0;
+        mPrevDateTime = 0;
+        mPrevDelta = 0;
+    }
+
+    int32_t row = mGroup.count;
+
+    // シーケンス番号
+    putVarInt(&mColumns[SequenceLogArchive::SEQ_NO], ByteBuffer::toZigZag((int32_t)(item->mSeqNo - mPrevSeqNo)));
+    mPrevSeqNo = item->mSeqNo;
+
+    // 日時
+    int64_t delta = (int64_t)(dateTime - mPrevDateTime);
+    putVarInt(&mColumns[SequenceLogArchive::DATE_TIME], ByteBuffer::toZigZag(delta - mPrevDelta));
+
+    mPrevDateTime = dateTime;
+    mPrevDelta = delta;
+
+    // 種別
+    ArchiveColumn* types = &mColumns[SequenceLogArchive::TYPE];
+
+    if (row % 4 == 0)
+        types->push_back(0);
+
+    types->back() |= (item->mType & 0x03) << ((row % 4) * 2);
+
+    // スレッド
+    auto i = mThreadDictionary.find(item->mThreadId);
+    uint32_t threadIndex;
+
+    if (i == mThreadDictionary.end())
+    {
+        threadIndex = (uint32_t)mThreadIds.size();
+        mThreadDictionary[item->mThreadId] = threadIndex;
+        mThreadIds.push_back(item->mThreadId);
+    }
+    else
+    {
+        threadIndex = i->second;
+    }
+
+    putVarInt(&mColumns[SequenceLogArchive::THREAD], threadIndex);
+    mGroupThreads.insert(threadIndex);
+
+    switch (item->mType)
+    {
+    case SequenceLogItem::STEP_IN:
+        addName(item->mClassId, item->getClassName());
+        addName(item->mFuncId,  item->getFuncName());
+        break;
+
+    case SequenceLogItem::MESSAGE:
+    {
+        // ログレベル
+        ArchiveColumn* levels = &mColumns[SequenceLogArchive::LEVEL];
+        uint32_t level = item->mLevel & 0x0F;
+
+        if (mMessageCount % 2 == 0)
+            levels->push_back(0);
+
+        levels->back() |= level << ((mMessageCount % 2) * 4);
+        mGroup.levels |= (1 << level);
+        mMessageCount++;
+
+        // メッセージ
+        ArchiveColumn* messages = &mColumns[SequenceLogArchive::MESSAGE];
+
+        if (item->mMessageId)
+        {
+            putVarInt(messages, ((uint64_t)item->mMessageId << 1) | 1);
+        }
+        else
+        {
+            const CoreString* message = item->getMessage();
+            const uint8_t* p = (const uint8_t*)message->getBuffer();
+            int32_t len = message->getLength();
+
+            putVarInt(messages, (uint64_t)len << 1);
+            messages->insert(messages->end(), p, p + len);
+        }
+
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    if (dateTime < mGroup.minDateTime)
+        mGroup.minDateTime = dateTime;
+
+    if (mGroup.maxDateTime < dateTime)
+        mGroup.maxDateTime = dateTime;
+
+    mGroup.count++;
+    mGroup.rawSize += size;
+    mRawPosition += size;
+
+    if (GROUP_RECORD_COUNT <= mGroup.count || GROUP_RAW_SIZE <= mGroup.rawSize)
+        flush();
+}
+
+/*!
+ * \brief   クラス名・関数名追加
+ *
+ * \param[in]   id      クラスIDまたは関数ID
+ * \param[in]   name    クラス名または関数名（IDが0の場合）
+ *
+ * \return  なし
+ *
+ * \note    IDがある場合は (ID << 1) | 1、ない場合は (辞書番号 << 1) を書き込む
+ */
+void SequenceLogArchiveWriter::addName(uint32_t id, const CoreString* name)
+{
+    ArchiveColumn* names = &mColumns[SequenceLogArchive::NAME];
+
+    if (id)
+    {
+        putVarInt(names, ((uint64_t)id << 1) | 1);
+        return;
+    }
+
+    String key;
+    key.copy(name);
+
+    auto i = mNameDictionary.find(key);
+    uint32_t nameIndex;
+
+    if (i == mNameDictionary.end())
+    {
+        nameIndex = (uint32_t)mNameDictionary.size();
+        mNameDictionary[key] = nameIndex;
+
+        // 辞書は [長さ(2)][名前] を並べる
+        const uint8_t* p = (const uint8_t*)name->getBuffer();
+        int32_t len = name->getLength();
+
+        mNames.push_back((uint8_t)(len >> 8));
+        mNames.push_back((uint8_t)(len     ));
+        mNames.insert(mNames.end(), p, p + len);
+    }
+    else
+    {
+        nameIndex = i->second;
+    }
+
+    putVarInt(names, (uint64_t)nameIndex << 1);
+}
+
+/*!
+ * \brief   書き込み中のグループをファイルに書き込む
+ *
+ * \note    カラム毎にLZ圧縮し、小さくならないカラムはそのまま書き込む
+ */
+void SequenceLogArchiveWriter::flush() throw(Exception)
+{
+    if (mGroup.count == 0)
+        return;
+
+    int32_t capacity = 0;
+
+    for (int32_t i = 0; i < SequenceLogArchive::COLUMN_COUNT; i++)
+        capacity += CompressedFile::getCompressBound((int32_t)mColumns[i].size());
+
+    ByteBuffer data(capacity);
+    char* p = data.getBuffer();
+    int32_t total = 0;
+
+    mGroup.position = mPosition;
+    mGroup.sizes.clear();
+    mGroup.rawSizes.clear();
+
+    for (int32_t i = 0; i < SequenceLogArchive::COLUMN_COUNT; i++)
+    {
+        const ArchiveColumn* column = &mColumns[i];
+        int32_t rawSize = (int32_t)column->size();
+        int32_t size = 0;
+
+        if (rawSize)
+        {
+            const char* raw = (const char*)&(*column)[0];
+            size = CompressedFile::compress(raw, rawSize, p + total, capacity - total);
+
+            if (size <= 0 || rawSize <= size)
+            {
+                memcpy(p + total, raw, rawSize);
+                size = rawSize;
+            }
+        }
+
+        mGroup.sizes.   push_back(size);
+        mGroup.rawSizes.push_back(rawSize);
+
+        total += size;
+        mColumns[i].clear();
+    }
+
+    mFile.write(&data, total);
+    mPosition += total;
+
+    mGroup.threadIds.assign(mGroupThreads.begin(), mGroupThreads.end());
+    mGroups.push_back(mGroup);
+
+    mGroup.count = 0;
+    mGroupThreads.clear();
+    mMessageCount = 0;
+}
+
+/*!
+ * \brief   クローズ
+ *
+ * \note    ディレクトリは
+ *          [展開後のサイズ(8)][スレッド数(4)][スレッドID(4)×スレッド数]
+ *          [名前の数(4)][名前の長さ(2)][名前]…[グループ数(4)] に続けて、グループ毎に
+ *          [位置(8)][展開後の位置(8)][展開後のサイズ(4)][レコード数(4)][最も古い日時(8)][最も新しい日時(8)]
+ *          [ログレベル(4)][スレッド数(4)][スレッドの辞書番号(4)×スレッド数][カラムのサイズ(4)、展開後のサイズ(4)×カラム数]
+ *          を並べる。ファイルの末尾には [ディレクトリの位置(8)][シグネチャ(4)] を書き込む。
+ */
+void SequenceLogArchiveWriter::close() throw(Exception)
+{
+    flush();
+
+    // ディレクトリのサイズを見積もる
+    int32_t size = 8 + 4 + (int32_t)mThreadIds.size() * 4 + 4 + (int32_t)mNames.size() + 4;
+
+    for (auto i = mGroups.begin(); i != mGroups.end(); i++)
+        size += 8 + 8 + 4 + 4 + 8 + 8 + 4 + 4 + (int32_t)i->threadIds.size() * 4 + SequenceLogArchive::COLUMN_COUNT * 8;
+
+    ByteBuffer directory(size + FOOTER_SIZE);
+    directory.putLong(mRawPosition);
+
+    directory.putInt((int32_t)mThreadIds.size());
+
+    for (auto i = mThreadIds.begin(); i != mThreadIds.end(); i++)
+        directory.putInt(*i);
+
+    directory.putInt((int32_t)mNameDictionary.size());
+
+    if (mNames.size())
+        directory.put((const char*)&mNames[0], (int32_t)mNames.size());
+
+    directory.putInt((int32_t)mGroups.size());
+
+    for (auto i = mGroups.begin(); i != mGroups.end(); i++)
+    {
+        directory.putLong(i->position);
+        directory.putLong(i->rawPosition);
+        directory.putInt( i->rawSize);
+        directory.putInt( i->count);
+        directory.putLong(i->minDateTime);
+        directory.putLong(i->maxDateTime);
+        directory.putInt( i->levels);
+        directory.putInt((int32_t)i->threadIds.size());
+
+        for (auto j = i->threadIds.begin(); j != i->threadIds.end(); j++)
+            directory.putInt(*j);
+
+        for (int32_t j = 0; j < SequenceLogArchive::COLUMN_COUNT; j++)
+        {
+            directory.putInt(i->sizes[j]);
+            directory.putInt(i->rawSizes[j]);
+        }
+    }
+
+    // フッター
+    directory.putLong(mPosition);
+    directory.put(SIGNATURE, SIGNATURE_SIZE);
+
+    mFile.write(&directory, directory.getPosition());
+    mFile.close();
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogArchive::SequenceLogArchive()
+{
+    mRawSize = 0;
+    mDirectory = nullptr;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogArchive::~SequenceLogArchive()
+{
+    close();
+}
+
+/*!
+ * \brief   アーカイブ作成
+ *
+ * \param[in]   logPath     シーケンスログファイル（.slog、.slogz）のパス
+ * \param[in]   archivePath アーカイブのパス
+ *
+ * \return  なし
+ *
+ * \note    作業用のファイルに書き込んでから名前を変更するので、作成途中のアーカイブが残ることはない。
+ *          ファイル末尾に不完全なレコードがある場合は、レコードを落とさないようにアーカイブを作成せずに例外を投げる
+ *          （元のファイルは残る）。
+ */
+void SequenceLogArchive::create(const CoreString* logPath, const CoreString* archivePath) throw(Exception)
+{
+    FixedString<MAX_PATH> tempPath;
+    tempPath.format("%s.tmp", archivePath->getBuffer());
+
+    try
+    {
+        SequenceLogFileReader reader;
+        SequenceLogItem item;
+        SequenceLogArchiveWriter writer;
+
+        reader.open(logPath);
+        writer.open(&tempPath);
+
+        while (true)
+        {
+            int64_t position = reader.getPosition();
+
+            if (reader.read(&item) == false)
+                break;
+
+            writer.add(&item, (int32_t)(reader.getPosition() - position));
+        }
+
+        if (reader.hasPartialRecord())
+        {
+            Exception e;
+            e.setMessage("SequenceLogArchive::create(\"%s\") / incomplete record at %lld", logPath->getBuffer(), reader.getPosition());
+
+            throw e;
+        }
+
+        writer.close();
+        reader.close();
+
+        if (File::move(&tempPath, archivePath) == false)
+        {
+            Exception e;
+            e.setMessage("SequenceLogArchive::create(\"%s\") / rename failed", archivePath->getBuffer());
+
+            throw e;
+        }
+    }
+    catch (Exception&)
+    {
+        try
+        {
+            File::unlink(&tempPath);
+        }
+        catch (Exception&)
+        {
+        }
+
+        throw;
+    }
+}
+
+/*!
+ * \brief   アーカイブのパス取得
+ *
+ * \param[out]  archivePath アーカイブのパスを受け取る
+ * \param[in]   logPath     シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogArchive::getArchivePath(CoreString* archivePath, const CoreString* logPath)
+{
+    const char* p = logPath->getBuffer();
+    const char* ext = strrchr(p, '.');
+
+    archivePath->copy(p, (ext ? (int32_t)(ext - p) : logPath->getLength()));
+    archivePath->append(ARCHIVE_EXT);
+}
+
+/*!
+ * \brief   アーカイブのファイル名かどうか調べる
+ */
+bool SequenceLogArchive::isArchiveFileName(const CoreString* fileName)
+{
+    int32_t extLen = sizeof(ARCHIVE_EXT) - 1;
+    int32_t len = fileName->getLength();
+
+    if (len < extLen)
+        return false;
+
+    return (strcmp(fileName->getBuffer() + len - extLen, ARCHIVE_EXT) == 0);
+}
+
+/*!
+ * \brief   オープン
+ *
+ * \param[in]   fileName    ファイル名
+ *
+ * \return  なし
+ */
+void SequenceLogArchive::open(const CoreString* fileName) throw(Exception)
+{
+    close();
+    mFile.open(fileName, File::READ);
+
+    try
+    {
+        readDirectory();
+    }
+    catch (Exception&)
+    {
+        close();
+        throw;
+    }
+}
+
+/*!
+ * \brief   クローズ
+ */
+void SequenceLogArchive::close()
+{
+    mFile.close();
+
+    delete mDirectory;
+    mDirectory = nullptr;
+
+    mRawSize = 0;
+    mThreadIds.clear();
+    mNames.clear();
+    mGroups.clear();
+}
+
+/*!
+ * \brief   オープンしているか調べる
+ */
+bool SequenceLogArchive::isOpen() const
+{
+    return mFile.isOpen();
+}
+
+/*!
+ * \brief   ファイルサイズ取得
+ */
+int64_t SequenceLogArchive::getSize() const
+{
+    return mFile.getSize();
+}
+
+/*!
+ * \brief   ディレクトリ読み込み
+ */
+void SequenceLogArchive::readDirectory() throw(Exception)
+{
+    int64_t size = mFile.getSize();
+
+    if (size < SIGNATURE_SIZE + FOOTER_SIZE)
+        throwIllegalArchive("open()");
+
+    // シグネチャ、フッター
+    ByteBuffer footer(FOOTER_SIZE);
+
+    if (mFile.read(&footer, SIGNATURE_SIZE) != SIGNATURE_SIZE || memcmp(footer.getBuffer(), SIGNATURE, SIGNATURE_SIZE) != 0)
+        throwIllegalArchive("open()");
+
+    mFile.setPosition(size - FOOTER_SIZE);
+
+    if (mFile.read(&footer, FOOTER_SIZE) != FOOTER_SIZE || memcmp(footer.getBuffer() + 8, SIGNATURE, SIGNATURE_SIZE) != 0)
+        throwIllegalArchive("open()");
+
+    int64_t position = footer.getLong();
+
+    if (position < SIGNATURE_SIZE || size - FOOTER_SIZE < position)
+        throwIllegalArchive("open()");
+
+    // ディレクトリ
+    int32_t directorySize = (int32_t)(size - FOOTER_SIZE - position);
+    mDirectory = new ByteBuffer(directorySize);
+    mFile.setPosition(position);
+
+    if (mFile.read(mDirectory, directorySize) != directorySize)
+        throwIllegalArchive("open()");
+
+    ByteBuffer* d = mDirectory;
+
+    mRawSize = d->getLong();
+
+    // 辞書（件数は残りのサイズで妥当性を確かめてから確保する）
+    int32_t threadCount = d->getInt();
+
+    if (threadCount < 0 || (directorySize - d->getPosition()) / 4 < threadCount)
+        throwIllegalArchive("open()");
+
+    for (int32_t i = 0; i < threadCount; i++)
+        mThreadIds.push_back(d->getInt());
+
+    int32_t nameCount = d->getInt();
+
+    if (nameCount < 0 || (directorySize - d->getPosition()) / 2 < nameCount)
+        throwIllegalArchive("open()");
+
+    for (int32_t i = 0; i < nameCount; i++)
+    {
+        mNames.push_back(d->getPosition());
+
+        uint16_t len = d->getShort();
+        d->get(len);
+    }
+
+    // グループ
+    int32_t groupCount = d->getInt();
+
+    if (groupCount < 0 || (directorySize - d->getPosition()) / (48 + COLUMN_COUNT * 8) < groupCount)
+        throwIllegalArchive("open()");
+
+    mGroups.resize(groupCount);
+
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        SequenceLogArchiveGroup* group = &mGroups[i];
+
+        group->position =    d->getLong();
+        group->rawPosition = d->getLong();
+        group->rawSize =     d->getInt();
+        group->count =       d->getInt();
+        group->minDateTime = d->getLong();
+        group->maxDateTime = d->getLong();
+        group->levels =      d->getInt();
+
+        int32_t count = d->getInt();
+
+        if (count < 0 || threadCount < count || directorySize < d->getPosition() + count * 4 + COLUMN_COUNT * 8)
+            throwIllegalArchive("open()");
+
+        for (int32_t j = 0; j < count; j++)
+        {
+            uint32_t threadIndex = d->getInt();
+
+            if ((uint32_t)threadCount <= threadIndex)
+                throwIllegalArchive("open()");
+
+            group->threadIds.push_back(mThreadIds[threadIndex]);
+        }
+
+        int64_t total = 0;
+
+        for (int32_t j = 0; j < COLUMN_COUNT; j++)
+        {
+            int32_t columnSize =    d->getInt();
+            int32_t columnRawSize = d->getInt();
+
+            if (columnSize < 0 || columnRawSize < columnSize || CompressedFile::getCompressBound(columnRawSize) < columnSize)
+                throwIllegalArchive("open()");
+
+            group->sizes.   push_back(columnSize);
+            group->rawSizes.push_back(columnRawSize);
+            total += columnSize;
+        }
+
+        if (group->rawSize < 0 || group->count <= 0 || group->position < SIGNATURE_SIZE || position < group->position + total)
+            throwIllegalArchive("open()");
+    }
+}
+
+/*!
+ * \brief   グループ読み込み
+ *
+ * \param[in]   index   グループ番号
+ * \param[out]  buffer  展開後のバイト列（シーケンスログファイルと同じ形式）を受け取るバッファ
+ *                      （グループの展開後のサイズ以上の容量が必要）
+ *
+ * \return  なし
+ */
+void SequenceLogArchive::readGroup(int32_t index, ByteBuffer* buffer) throw(Exception)
+{
+    const SequenceLogArchiveGroup* group = &mGroups[index];
+    int32_t total = 0;
+
+    for (int32_t i = 0; i < COLUMN_COUNT; i++)
+        total += group->sizes[i];
+
+    ByteBuffer data(total);
+    mFile.setPosition(group->position);
+
+    if (mFile.read(&data, total) != total)
+        throwIllegalArchive("readGroup()");
+
+    // カラム展開
+    ArchiveColumn columns[COLUMN_COUNT];
+    const char* p = data.getBuffer();
+
+    for (int32_t i = 0; i < COLUMN_COUNT; i++)
+    {
+        int32_t size =    group->sizes[i];
+        int32_t rawSize = group->rawSizes[i];
+
+        columns[i].resize(rawSize);
+
+        if (rawSize == 0)
+            continue;
+
+        char* raw = (char*)&columns[i][0];
+
+        if (size < rawSize)
+        {
+            if (CompressedFile::decompress(p, size, raw, rawSize) != rawSize)
+                throwIllegalArchive("readGroup()");
+        }
+        else
+        {
+            memcpy(raw, p, rawSize);
+        }
+
+        p += size;
+    }
+
+    if ((int32_t)columns[TYPE].size() < (group->count + 3) / 4)
+        throwIllegalArchive("readGroup()");
+
+    // レコード復元
+    ArchiveColumnReader seqNos(   &columns[SEQ_NO]);
+    ArchiveColumnReader dateTimes(&columns[DATE_TIME]);
+    ArchiveColumnReader threads(  &columns[THREAD]);
+    ArchiveColumnReader names(    &columns[NAME]);
+    ArchiveColumnReader messages( &columns[MESSAGE]);
+
+    const uint8_t* types =  &columns[TYPE][0];
+    const ArchiveColumn* levels = &columns[LEVEL];
+    int32_t messageCount = 0;
+
+    uint32_t seqNo = 0;
+    uint64_t dateTime = 0;
+    int64_t delta = 0;
+
+    SequenceLogItem item;
+    SequenceLogByteBuffer record(MAX_RECORD_SIZE);
+    CoreString* itemNames[] = {item.getClassName(), item.getFuncName()};
+    uint32_t* itemIds[] =     {&item.mClassId,      &item.mFuncId};
+
+    buffer->setPosition(0);
+
+    for (int32_t row = 0; row < group->count; row++)
+    {
+        seqNo += (uint32_t)ByteBuffer::fromZigZag(seqNos.getVarInt());
+        delta += ByteBuffer::fromZigZag(dateTimes.getVarInt());
+        dateTime += delta;
+
+        item.mSeqNo = seqNo;
+        item.mDateTime.setValue(dateTime);
+        item.mType = (types[row / 4] >> ((row % 4) * 2)) & 0x03;
+
+        uint64_t threadIndex = threads.getVarInt();
+
+        if (mThreadIds.size() <= threadIndex)
+            throwIllegalArchive("readGroup()");
+
+        item.mThreadId = mThreadIds[(size_t)threadIndex];
+
+        switch (item.mType)
+        {
+        case SequenceLogItem::STEP_IN:
+            for (int32_t i = 0; i < 2; i++)
+            {
+                uint64_t value = names.getVarInt();
+
+                if (value & 1)
+                {
+                    *itemIds[i] = (uint32_t)(value >> 1);
+                    continue;
+                }
+
+                if (mNames.size() <= (value >> 1))
+                    throwIllegalArchive("readGroup()");
+
+                const uint8_t* name = (const uint8_t*)mDirectory->getBuffer() + mNames[(size_t)(value >> 1)];
+
+                *itemIds[i] = 0;
+                itemNames[i]->copy((const char*)name + 2, (name[0] << 8) | name[1]);
+            }
+
+            break;
+
+        case SequenceLogItem::MESSAGE:
+        {
+            if ((int32_t)levels->size() <= messageCount / 2)
+                throwIllegalArchive("readGroup()");
+
+            item.mLevel = ((*levels)[messageCount / 2] >> ((messageCount % 2) * 4)) & 0x0F;
+            messageCount++;
+
+            uint64_t value = messages.getVarInt();
+
+            if (value & 1)
+            {
+                item.mMessageId = (uint32_t)(value >> 1);
+            }
+            else
+            {
+                if (MAX_RECORD_SIZE < (value >> 1))
+                    throwIllegalArchive("readGroup()");
+
+                int32_t len = (int32_t)(value >> 1);
+
+                item.mMessageId = 0;
+                item.getMessage()->copy(messages.get(len), len);
+            }
+
+            break;
+        }
+
+        default:
+            break;
+        }
+
+        uint32_t size = record.putSequenceLogItem(&item, true);
+        buffer->put(&record, size);
+    }
+
+    if (buffer->getPosition() != group->rawSize)
+        throwIllegalArchive("readGroup()");
+}
+
+} // namespace slog
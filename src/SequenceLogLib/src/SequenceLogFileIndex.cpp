@@ -0,0 +1,430 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*!
+ * \file    SequenceLogFileIndex.cpp
+ * \brief   シーケンスログファイル索引クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogFileIndex.h"
+#include "SequenceLogFileReader.h"
+
+#include "slog/File.h"
+#include "slog/Dir.h"
+#include "slog/CompressedFile.h"
+#include "slog/FixedString.h"
+#include "slog/PointerString.h"
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+
+/*!
+ * シグネチャ
+ */
+static const char SIGNATURE[] = "SLI1";
+static const int32_t SIGNATURE_SIZE = 4;
+
+/*!
+ * 索引フォルダ名
+ */
+static const char INDEX_DIR_NAME[] = "index";
+
+/*!
+ * \brief   可変長整数（７ビット単位）読み込み
+ */
+static uint32_t getVarInt(const uint8_t** p, const uint8_t* end) throw(Exception)
+{
+    uint32_t value = 0;
+    int32_t shift = 0;
+
+    while (true)
+    {
+        if (end <= *p || 28 < shift)
+        {
+            Exception e;
+            e.setMessage("SequenceLogFileIndex / illegal index");
+
+            throw e;
+        }
+
+        uint8_t c = *(*p)++;
+        value |= (uint32_t)(c & 0x7F) << shift;
+
+        if ((c & 0x80) == 0)
+            break;
+
+        shift += 7;
+    }
+
+    return value;
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogFileIndex::SequenceLogFileIndex()
+{
+    mData = nullptr;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogFileIndex::~SequenceLogFileIndex()
+{
+    delete mData;
+}
+
+/*!
+ * \brief   索引フォルダのパス取得
+ *
+ * \note    索引をシーケンスログファイルと同じフォルダに作成するとフォルダの最終書込日時が更新され、
+ *          ファイルカタログが古いと判定されてしまうため、サブフォルダに保存する。
+ */
+void SequenceLogFileIndex::getIndexDirPath(CoreString* indexDirPath, const CoreString* logPath)
+{
+    const char* p = logPath->getBuffer();
+    const char* delimiter = strrchr(p, PATH_DELIMITER);
+    int32_t len = (delimiter ? (int32_t)(delimiter - p + 1) : 0);
+
+    indexDirPath->copy(p, len);
+    indexDirPath->append(INDEX_DIR_NAME);
+}
+
+/*!
+ * \brief   索引のパス取得
+ */
+void SequenceLogFileIndex::getIndexPath(CoreString* indexPath, const CoreString* logPath)
+{
+    const char* p = logPath->getBuffer();
+    const char* delimiter = strrchr(p, PATH_DELIMITER);
+    const char* name = (delimiter ? delimiter + 1 : p);
+
+    getIndexDirPath(indexPath, logPath);
+
+    char delimiterText[] = {PATH_DELIMITER, '\0'};
+    indexPath->append(delimiterText);
+    indexPath->append(name);
+    indexPath->append(".idx");
+}
+
+/*!
+ * \brief   索引を作成できるシーケンスログファイルかどうか調べる
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  バイナリ形式のシーケンスログファイルであればtrue
+ */
+bool SequenceLogFileIndex::isIndexable(const CoreString* logPath)
+{
+    const char* ext = strrchr(logPath->getBuffer(), '.');
+
+    if (ext == nullptr)
+        return false;
+
+    return (strcmp(ext, ".slog") == 0 || strcmp(ext, ".slogz") == 0);
+}
+
+/*!
+ * \brief   索引作成
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  なし
+ *
+ * \note    [シグネチャ(4)][シーケンスログファイルのサイズ(8)][ブロック数(4)][ブロックの開始位置(8)×ブロック数]
+ *          [トライグラム数(4)] に続けて、トライグラム毎に
+ *          [トライグラム(4)][ブロック数(可変長)][ブロック番号の差分(可変長)×ブロック数] を並べる。
+ */
+void SequenceLogFileIndex::build(const CoreString* logPath) throw(Exception)
+{
+    std::vector<int64_t> blockPositions;
+    std::map<uint32_t, std::vector<int32_t> > postings;
+
+    SequenceLogFileReader reader;
+    SequenceLogItem item;
+
+    reader.open(logPath);
+    int64_t blockPosition = -BLOCK_SIZE;
+
+    while (true)
+    {
+        int64_t position = reader.getPosition();
+
+        if (reader.read(&item) == false)
+            break;
+
+        // ブロックの区切り
+        if (BLOCK_SIZE <= position - blockPosition)
+        {
+            blockPosition = position;
+            blockPositions.push_back(position);
+        }
+
+        if (item.mType != SequenceLogItem::MESSAGE)
+            continue;
+
+        // メッセージのトライグラムを登録
+        int32_t blockNo = (int32_t)blockPositions.size() - 1;
+        const uint8_t* p = (const uint8_t*)item.getMessage()->getBuffer();
+        int32_t len = item.getMessage()->getLength();
+
+        for (int32_t i = 0; i + 3 <= len; i++)
+        {
+            uint32_t trigram = (p[i] << 16) | (p[i + 1] << 8) | p[i + 2];
+            std::vector<int32_t>* blocks = &postings[trigram];
+
+            if (blocks->empty() || blocks->back() != blockNo)
+                blocks->push_back(blockNo);
+        }
+    }
+
+    reader.close();
+
+    // 索引のサイズを見積もる
+    int32_t size = SIGNATURE_SIZE + 8 + 4 + (int32_t)blockPositions.size() * 8 + 4;
+
+    for (auto i = postings.begin(); i != postings.end(); i++)
+        size += 4 + 5 + (int32_t)i->second.size() * 5;
+
+    ByteBuffer buffer(size);
+    File logFile;
+    logFile.open(logPath, File::READ);
+
+    PointerString signature = SIGNATURE;
+    buffer.put(&signature, SIGNATURE_SIZE);
+    buffer.putLong(logFile.getSize());
+    buffer.putInt((int32_t)blockPositions.size());
+
+    logFile.close();
+
+    for (auto i = blockPositions.begin(); i != blockPositions.end(); i++)
+        buffer.putLong(*i);
+
+    buffer.putInt((int32_t)postings.size());
+
+    for (auto i = postings.begin(); i != postings.end(); i++)
+    {
+        const std::vector<int32_t>* blocks = &i->second;
+        int32_t prev = 0;
+
+        buffer.putInt(i->first);
+        buffer.putVarInt((uint32_t)blocks->size());
+
+        for (auto j = blocks->begin(); j != blocks->end(); j++)
+        {
+            buffer.putVarInt((uint32_t)(*j - prev));
+            prev = *j;
+        }
+    }
+
+    // 保存（索引フォルダは既にあれば作成に失敗するだけなので結果は見ない）
+    FixedString<MAX_PATH> indexDirPath;
+    getIndexDirPath(&indexDirPath, logPath);
+    Dir::create(&indexDirPath);
+
+    FixedString<MAX_PATH> indexPath;
+    getIndexPath(&indexPath, logPath);
+
+    File file;
+    file.open(&indexPath, File::WRITE);
+    file.write(&buffer, buffer.getPosition());
+    file.close();
+}
+
+/*!
+ * \brief   索引読み込み
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  索引を読み込めた場合はtrue、索引がないか古い場合はfalseを返す
+ */
+bool SequenceLogFileIndex::load(const CoreString* logPath)
+{
+    delete mData;
+    mData = nullptr;
+
+    mBlockPositions.clear();
+    mPostings.clear();
+
+    try
+    {
+        FixedString<MAX_PATH> indexPath;
+        getIndexPath(&indexPath, logPath);
+
+        File logFile;
+        logFile.open(logPath, File::READ);
+        int64_t logSize = logFile.getSize();
+        logFile.close();
+
+        File file;
+        file.open(&indexPath, File::READ);
+
+        int32_t size = (int32_t)file.getSize();
+        mData = new ByteBuffer(size);
+
+        if (file.read(mData, size) != size)
+            return false;
+
+        file.close();
+
+        // ヘッダー
+        const uint8_t* p =   (const uint8_t*)mData->getBuffer();
+        const uint8_t* end = p + size;
+
+        if (size < SIGNATURE_SIZE + 8 + 4 || memcmp(p, SIGNATURE, SIGNATURE_SIZE) != 0)
+            return false;
+
+        mData->setPosition(SIGNATURE_SIZE);
+
+        if (mData->getLong() != logSize)
+            return false;   // 索引作成後に追記された
+
+        int32_t blockCount = mData->getInt();
+
+        if (blockCount < 0 || size < mData->getPosition() + blockCount * 8 + 4)
+            return false;
+
+        for (int32_t i = 0; i < blockCount; i++)
+            mBlockPositions.push_back(mData->getLong());
+
+        // トライグラム
+        int32_t trigramCount = mData->getInt();
+        p += mData->getPosition();
+
+        for (int32_t i = 0; i < trigramCount; i++)
+        {
+            if (end < p + 4)
+                return false;
+
+            uint32_t trigram = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+            p += 4;
+
+            mPostings[trigram] = (int32_t)(p - (const uint8_t*)mData->getBuffer());
+
+            int32_t count = getVarInt(&p, end);
+
+            for (int32_t j = 0; j < count; j++)
+                getVarInt(&p, end);
+        }
+    }
+    catch (Exception&)
+    {
+        mBlockPositions.clear();
+        mPostings.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief   索引削除
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogFileIndex::remove(const CoreString* logPath)
+{
+    FixedString<MAX_PATH> indexPath;
+    getIndexPath(&indexPath, logPath);
+
+    try
+    {
+        File::unlink(&indexPath);
+    }
+    catch (Exception&)
+    {
+        // 索引がない
+    }
+
+    // 以前のバージョンで同じフォルダに作成された索引
+    indexPath.copy(logPath);
+    indexPath.append(".idx");
+
+    try
+    {
+        File::unlink(&indexPath);
+    }
+    catch (Exception&)
+    {
+        // 索引がない
+    }
+}
+
+/*!
+ * \brief   文字列を含む可能性のあるブロックを取得
+ *
+ * \param[in]   text    検索する文字列
+ * \param[out]  blocks  ブロック毎に文字列を含む可能性があればtrueを返す
+ *
+ * \return  索引で絞り込めた場合はtrue、文字列が短く絞り込めない場合はfalseを返す
+ */
+bool SequenceLogFileIndex::find(const CoreString* text, std::vector<bool>* blocks) const
+{
+    const uint8_t* p = (const uint8_t*)text->getBuffer();
+    int32_t len = text->getLength();
+
+    if (len < 3 || mData == nullptr)
+        return false;
+
+    int32_t blockCount = getBlockCount();
+    blocks->assign(blockCount, true);
+
+    std::vector<bool> hits;
+    const uint8_t* end = (const uint8_t*)mData->getBuffer() + mData->getCapacity();
+
+    for (int32_t i = 0; i + 3 <= len; i++)
+    {
+        uint32_t trigram = (p[i] << 16) | (p[i + 1] << 8) | p[i + 2];
+        auto posting = mPostings.find(trigram);
+
+        if (posting == mPostings.end())
+        {
+            // どのブロックにも含まれないトライグラム
+            blocks->assign(blockCount, false);
+            break;
+        }
+
+        // ブロック番号リストとの積をとる
+        hits.assign(blockCount, false);
+
+        const uint8_t* q = (const uint8_t*)mData->getBuffer() + posting->second;
+        int32_t count = getVarInt(&q, end);
+        int32_t blockNo = 0;
+
+        for (int32_t j = 0; j < count; j++)
+        {
+            blockNo += getVarInt(&q, end);
+
+            if (0 <= blockNo && blockNo < blockCount)
+                hits[blockNo] = true;
+        }
+
+        for (int32_t j = 0; j < blockCount; j++)
+            (*blocks)[j] = ((*blocks)[j] && hits[j]);
+    }
+
+    return true;
+}
+
+} // namespace slog
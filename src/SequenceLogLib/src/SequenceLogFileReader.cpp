@@ -0,0 +1,176 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogFileReader.cpp
+ * \brief   シーケンスログファイル読み込みクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogFileReader.h"
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+
+/*!
+ * レコードの最小サイズ（レコード長、シーケンス番号、日時、種別、スレッドID）
+ */
+static const int32_t MIN_RECORD_SIZE = 2 + 4 + 8 + 1 + 4;
+
+/*!
+ * レコードの最大サイズ
+ */
+static const int32_t MAX_RECORD_SIZE = 0xFFFF;
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogFileReader::SequenceLogFileReader() :
+    mBuffer(MAX_RECORD_SIZE + CompressedFile::BLOCK_SIZE),
+    mRecord(MAX_RECORD_SIZE)
+{
+    mCompressed = false;
+    mOffset = 0;
+    mLength = 0;
+    mPosition = 0;
+}
+
+/*!
+ * \brief   オープン
+ *
+ * \param[in]   fileName    ファイル名
+ *
+ * \return  なし
+ */
+void SequenceLogFileReader::open(const CoreString* fileName) throw(Exception)
+{
+    close();
+    mCompressed = CompressedFile::isCompressedFileName(fileName);
+
+    if (mCompressed)
+        mCompressedFile.open(fileName, File::READ);
+    else
+        mFile.open(fileName, File::READ);
+}
+
+/*!
+ * \brief   クローズ
+ */
+void SequenceLogFileReader::close()
+{
+    mFile.close();
+    mCompressedFile.close();
+
+    mOffset = 0;
+    mLength = 0;
+    mPosition = 0;
+}
+
+/*!
+ * \brief   次のレコードのファイル内の位置設定
+ *
+ * \param[in]   position    レコードの先頭の位置（圧縮ファイルの場合は展開後の位置）
+ *
+ * \return  なし
+ */
+void SequenceLogFileReader::setPosition(int64_t position) throw(Exception)
+{
+    mOffset = 0;
+    mLength = 0;
+
+    if (mCompressed)
+    {
+        mPosition = mCompressedFile.setRawPosition(position);
+    }
+    else
+    {
+        mFile.setPosition(position);
+        mPosition = position;
+    }
+}
+
+/*!
+ * \brief   レコード読み込み
+ *
+ * \param[out]  item    読み込んだレコードを受け取るシーケンスログアイテム
+ *
+ * \return  レコードを読み込めた場合はtrue、ファイルの終端（書き込み途中のレコードを含む）に達した場合はfalseを返す
+ */
+bool SequenceLogFileReader::read(SequenceLogItem* item) throw(Exception)
+{
+    SequenceLogByteBuffer* record = readRecord();
+
+    if (record == nullptr)
+        return false;
+
+    record->getSequenceLogItem(item, true);
+    return true;
+}
+
+/*!
+ * \brief   レコード読み込み（シーケンスログファイル上のバイト列のまま）
+ *
+ * \return  読み込んだレコード（次に読み込むまで有効）、ファイルの終端に達した場合はnullptrを返す
+ */
+SequenceLogByteBuffer* SequenceLogFileReader::readRecord() throw(Exception)
+{
+    while (true)
+    {
+        const uint8_t* p = (const uint8_t*)mBuffer.getBuffer() + mOffset;
+        int32_t remains = mLength - mOffset;
+
+        if (2 <= remains)
+        {
+            int32_t size = (p[0] << 8) | p[1];
+
+            if (size < MIN_RECORD_SIZE)
+            {
+                Exception e;
+                e.setMessage("SequenceLogFileReader::read() size=%d / illegal record", size);
+
+                throw e;
+            }
+
+            if (size <= remains)
+            {
+                memcpy(mRecord.getBuffer(), p, size);
+
+                mOffset += size;
+                mPosition += size;
+                return &mRecord;
+            }
+        }
+
+        // 残りを先頭に詰めて読み足す
+        memmove(mBuffer.getBuffer(), p, remains);
+        mOffset = 0;
+        mLength = remains;
+
+        int64_t len = (mCompressed
+            ? mCompressedFile.read(&mBuffer, mLength, mBuffer.getCapacity() - mLength)
+            : mFile.          read(&mBuffer, mLength, mBuffer.getCapacity() - mLength));
+
+        if (len <= 0)
+            return nullptr;
+
+        mLength += (int32_t)len;
+    }
+}
+
+} // namespace slog
@@ -0,0 +1,470 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogMerger.cpp
+ * \brief   シーケンスログマージクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogMerger.h"
+#include "SequenceLogFileReader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+
+/*!
+ * バッチのサイズ（最大サイズのレコードが必ず入る大きさ）
+ */
+static const int32_t BATCH_SIZE = 128 * 1024;
+
+/*!
+ * ファイル毎に先読みするバッチの最大数
+ */
+static const int32_t MAX_BATCHES = 2;
+
+/*!
+ * レコードの最大サイズ
+ */
+static const int32_t MAX_RECORD_SIZE = 0xFFFF;
+
+/*!
+ * \brief   レコード長取得
+ */
+static inline int32_t getRecordSize(const char* record)
+{
+    const uint8_t* p = (const uint8_t*)record;
+    return (p[0] << 8) | p[1];
+}
+
+/*!
+ * \brief   レコードの日時取得
+ */
+static inline uint64_t getRecordDateTime(const char* record)
+{
+    const uint8_t* p = (const uint8_t*)record + 2 + 4;
+    uint64_t value = 0;
+
+    for (int32_t i = 0; i < 8; i++)
+        value = (value << 8) | p[i];
+
+    return value;
+}
+
+/*!
+ * \brief   マージするファイル
+ *
+ * \note    スレッドでファイルからレコードを読み込んでバッチに詰め（生産側）、
+ *          マージクラスはバッチからレコードを一つずつ取り出す（消費側）。
+ *          バッチの空き、バッチの追加、終了、停止の要求は mCondition で通知し、待つ側はスリープせずに起こされる。
+ */
+class SequenceLogMergeSource : public Thread
+{
+            /*!
+             * パス
+             */
+            String mPath;
+
+            /*!
+             * 追加した順番
+             */
+            int32_t mIndex;
+
+            /*!
+             * ミューテックス（読み込み済みのバッチ、終了、エラー）
+             */
+            std::mutex mMutex;
+
+            /*!
+             * 読み込み済みのバッチ、終了、停止の要求が変わったことの通知
+             */
+            std::condition_variable mCondition;
+
+            /*!
+             * 読み込み済みのバッチ
+             */
+            std::list<ByteBuffer*> mBatches;
+
+            /*!
+             * ファイルの終端に達したかどうか
+             */
+            bool mEnd;
+
+            /*!
+             * 読み込みに失敗した場合のエラーメッセージ
+             */
+            String mError;
+
+            /*!
+             * 取り出し中のバッチ
+             */
+            ByteBuffer* mBatch;
+
+            /*!
+             * 取り出し中のバッチ内の現在のレコードの位置
+             */
+            int32_t mOffset;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogMergeSource(const CoreString* path, int32_t index)
+            {
+                mPath.copy(path);
+                mIndex = index;
+                mEnd = false;
+                mBatch = nullptr;
+                mOffset = 0;
+            }
+
+            /*!
+             * デストラクタ
+             */
+            virtual ~SequenceLogMergeSource() override
+            {
+                delete mBatch;
+
+                for (auto i = mBatches.begin(); i != mBatches.end(); i++)
+                    delete *i;
+            }
+
+            /*!
+             * 追加した順番取得
+             */
+            int32_t getIndex() const {return mIndex;}
+
+            /*!
+             * 現在のレコード取得
+             */
+            const char* getRecord() const {return mBatch->getBuffer() + mOffset;}
+
+            /*!
+             * 現在のレコードの日時取得
+             */
+            uint64_t getDateTime() const {return getRecordDateTime(getRecord());}
+
+            /*!
+             * 次のレコードへ進む
+             */
+            bool next() throw(Exception);
+
+            /*!
+             * 割り込み
+             */
+            virtual void interrupt() override;
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override;
+
+            /*!
+             * 読み込んだバッチを渡す
+             */
+            bool push(ByteBuffer* batch);
+};
+
+/*!
+ * \brief   スレッド実行（生産側）
+ */
+void SequenceLogMergeSource::run()
+{
+    ByteBuffer* batch = nullptr;
+
+    try
+    {
+        SequenceLogFileReader reader;
+        reader.open(&mPath);
+
+        while (isInterrupted() == false)
+        {
+            SequenceLogByteBuffer* record = reader.readRecord();
+
+            if (record == nullptr)
+                break;
+
+            int32_t size = getRecordSize(record->getBuffer());
+
+            if (batch && BATCH_SIZE < batch->getPosition() + size)
+            {
+                ByteBuffer* full = batch;
+                batch = nullptr;
+
+                if (push(full) == false)
+                    break;
+            }
+
+            if (batch == nullptr)
+                batch = new ByteBuffer(BATCH_SIZE);
+
+            batch->put(record, size);
+        }
+
+        if (batch)
+        {
+            ByteBuffer* last = batch;
+            batch = nullptr;
+
+            push(last);
+        }
+    }
+    catch (Exception& e)
+    {
+        delete batch;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mError.copy(e.getMessage());
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEnd = true;
+    mCondition.notify_all();
+}
+
+/*!
+ * \brief   割り込み
+ *
+ * \note    バッチの空きを待っている生産側を起こす。
+ */
+void SequenceLogMergeSource::interrupt()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    Thread::interrupt();
+    mCondition.notify_all();
+}
+
+/*!
+ * \brief   読み込んだバッチを渡す
+ *
+ * \param[in]   batch   バッチ（渡せなかった場合は削除する）
+ *
+ * \return  渡した場合はtrue、停止を要求された場合はfalseを返す
+ *
+ * \note    先読みしたバッチが上限に達している場合は、消費側が取り出すまで待つ。
+ */
+bool SequenceLogMergeSource::push(ByteBuffer* batch)
+{
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+
+        while (isInterrupted() == false && MAX_BATCHES <= (int32_t)mBatches.size())
+            mCondition.wait(lock);
+
+        if (isInterrupted() == false)
+        {
+            mBatches.push_back(batch);
+            mCondition.notify_all();
+            return true;
+        }
+    }
+
+    delete batch;
+    return false;
+}
+
+/*!
+ * \brief   次のレコードへ進む（消費側）
+ *
+ * \return  次のレコードがある場合はtrue、ファイルの終端に達した場合はfalseを返す
+ *
+ * \note    最初に呼び出すと先頭のレコードへ進む。
+ */
+bool SequenceLogMergeSource::next() throw(Exception)
+{
+    if (mBatch)
+    {
+        mOffset += getRecordSize(getRecord());
+
+        if (mOffset < mBatch->getPosition())
+            return true;
+
+        delete mBatch;
+        mBatch = nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    while (mBatches.empty() && mEnd == false)
+        mCondition.wait(lock);
+
+    if (mBatches.size())
+    {
+        mBatch = mBatches.front();
+        mBatches.pop_front();
+        mCondition.notify_all();
+
+        mOffset = 0;
+        return true;
+    }
+
+    if (mError.getLength() == 0)
+        return false;
+
+    Exception e;
+    e.setMessage("SequenceLogMerger: %s %s", mPath.getBuffer(), mError.getBuffer());
+
+    throw e;
+}
+
+/*!
+ * \brief   ヒープの比較（日時が新しいものほど後ろ）
+ */
+static bool compareSource(const SequenceLogMergeSource* source1, const SequenceLogMergeSource* source2)
+{
+    uint64_t dateTime1 = source1->getDateTime();
+    uint64_t dateTime2 = source2->getDateTime();
+
+    if (dateTime1 != dateTime2)
+        return (dateTime1 > dateTime2);
+
+    return (source1->getIndex() > source2->getIndex());
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogMerger::SequenceLogMerger() : mRecord(MAX_RECORD_SIZE)
+{
+    mStarted = false;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogMerger::~SequenceLogMerger()
+{
+    stop();
+
+    for (auto i = mSources.begin(); i != mSources.end(); i++)
+        delete *i;
+}
+
+/*!
+ * \brief   マージするファイルを追加
+ *
+ * \param[in]   path    シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogMerger::add(const CoreString* path)
+{
+    if (mStarted)
+        return;
+
+    mSources.push_back(new SequenceLogMergeSource(path, (int32_t)mSources.size()));
+}
+
+/*!
+ * \brief   開始
+ *
+ * \note    全てのファイルの読み込みを開始し、先頭のレコードが揃うまで待つ。
+ */
+void SequenceLogMerger::start() throw(Exception)
+{
+    if (mStarted)
+        return;
+
+    mStarted = true;
+
+    for (auto i = mSources.begin(); i != mSources.end(); i++)
+        (*i)->start();
+
+    for (auto i = mSources.begin(); i != mSources.end(); i++)
+    {
+        if ((*i)->next())
+            mHeap.push_back(*i);
+    }
+
+    std::make_heap(mHeap.begin(), mHeap.end(), compareSource);
+}
+
+/*!
+ * \brief   停止
+ *
+ * \note    読み込み中のファイルは読み込みを中断する。
+ */
+void SequenceLogMerger::stop()
+{
+    if (mStarted == false)
+        return;
+
+    for (auto i = mSources.begin(); i != mSources.end(); i++)
+        (*i)->interrupt();
+
+    for (auto i = mSources.begin(); i != mSources.end(); i++)
+        (*i)->join();
+
+    mHeap.clear();
+    mStarted = false;
+}
+
+/*!
+ * \brief   レコード読み込み
+ *
+ * \param[out]  item    読み込んだレコードを受け取るシーケンスログアイテム
+ * \param[out]  index   レコードを読み込んだファイルの追加した順番を受け取る（不要な場合はnullptr）
+ *
+ * \return  レコードを読み込めた場合はtrue、全てのファイルの終端に達した場合はfalseを返す
+ */
+bool SequenceLogMerger::read(SequenceLogItem* item, int32_t* index) throw(Exception)
+{
+    SequenceLogByteBuffer* record = readRecord(index);
+
+    if (record == nullptr)
+        return false;
+
+    record->getSequenceLogItem(item, true);
+    return true;
+}
+
+/*!
+ * \brief   レコード読み込み（シーケンスログファイル上のバイト列のまま）
+ *
+ * \param[out]  index   レコードを読み込んだファイルの追加した順番を受け取る（不要な場合はnullptr）
+ *
+ * \return  読み込んだレコード（次に読み込むまで有効）、全てのファイルの終端に達した場合はnullptrを返す
+ */
+SequenceLogByteBuffer* SequenceLogMerger::readRecord(int32_t* index) throw(Exception)
+{
+    if (mHeap.empty())
+        return nullptr;
+
+    std::pop_heap(mHeap.begin(), mHeap.end(), compareSource);
+    SequenceLogMergeSource* source = mHeap.back();
+
+    const char* record = source->getRecord();
+    memcpy(mRecord.getBuffer(), record, getRecordSize(record));
+
+    if (index)
+        *index = source->getIndex();
+
+    if (source->next())
+        std::push_heap(mHeap.begin(), mHeap.end(), compareSource);
+    else
+        mHeap.pop_back();
+
+    return &mRecord;
+}
+
+} // namespace slog
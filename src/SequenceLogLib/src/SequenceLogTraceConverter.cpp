@@ -0,0 +1,337 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogTraceConverter.cpp
+ * \brief   Chrome Trace Event形式変換クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogTraceConverter.h"
+
+#include "slog/File.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <string.h>
+#endif
+
+#if defined(_WINDOWS)
+    #pragma warning(disable:4996)
+    #define snprintf _snprintf
+#endif
+
+namespace slog
+{
+
+/*!
+ * イベント１件の最大サイズ（最大長のメッセージを全てエスケープした場合）
+ */
+static const int32_t MAX_EVENT_SIZE = 0xFFFF * 6 + 1024;
+
+/*!
+ * \brief   JSON文字列としてエスケープして追加
+ *
+ * \param[out]  json    追加先
+ * \param[in]   p       文字列
+ * \param[in]   len     文字列の長さ
+ *
+ * \return  なし
+ */
+static void appendEscape(CoreString* json, const char* p, int32_t len)
+{
+    int32_t start = 0;
+
+    for (int32_t i = 0; i < len; i++)
+    {
+        uint8_t c = (uint8_t)p[i];
+
+        if (c != '\\' && c != '"' && 0x20 <= c)
+            continue;
+
+        json->append(p + start, i - start);
+
+        char escape[8];
+
+        switch (c)
+        {
+        case '\\': strcpy(escape, "\\\\"); break;
+        case '"':  strcpy(escape, "\\\""); break;
+        case '\n': strcpy(escape, "\\n");  break;
+        case '\r': strcpy(escape, "\\r");  break;
+        case '\t': strcpy(escape, "\\t");  break;
+        default:   snprintf(escape, sizeof(escape), "\\u%04x", c); break;
+        }
+
+        json->append(escape);
+        start = i + 1;
+    }
+
+    json->append(p + start, len - start);
+}
+
+/*!
+ * \brief   名前（IDで出力された場合は "#ID"）を追加
+ */
+static void appendName(CoreString* json, uint32_t id, const CoreString* name)
+{
+    if (id)
+    {
+        char str[16];
+        snprintf(str, sizeof(str), "#%u", id);
+        json->append(str);
+    }
+    else
+    {
+        appendEscape(json, name->getBuffer(), name->getLength());
+    }
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogTraceConverter::SequenceLogTraceConverter()
+{
+    mProcessId = 0;
+    mBaseTime = -1;
+    mLastTime = 0;
+    mState = State::CLOSED;
+    mSeparator = false;
+}
+
+/*!
+ * \brief   オープン
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  なし
+ *
+ * \note    ファイル名が "名前-プロセスID-日付-時刻-ミリ秒.拡張子" の形式であれば、プロセスIDとプロセス名を取得する。
+ */
+void SequenceLogTraceConverter::open(const CoreString* logPath) throw(Exception)
+{
+    close();
+    mReader.open(logPath);
+
+    const char* p = logPath->getBuffer();
+    const char* fileName = strrchr(p, PATH_DELIMITER);
+    fileName = (fileName ? fileName + 1 : p);
+
+    const char* ext = strrchr(fileName, '.');
+    mProcessName.copy(fileName, (int32_t)(ext ? ext - fileName : strlen(fileName)));
+
+    // 後ろから４つ目の '-' の前が名前、その後ろがプロセスID
+    int32_t hyphens = 0;
+
+    for (int32_t i = mProcessName.getLength() - 1; 0 <= i; i--)
+    {
+        if (mProcessName[i] != '-')
+            continue;
+
+        if (++hyphens == 4)
+        {
+            mProcessId = atoi(mProcessName.getBuffer() + i + 1);
+            mProcessName.setLength(i);
+            break;
+        }
+    }
+
+    mState = State::HEADER;
+}
+
+/*!
+ * \brief   クローズ
+ */
+void SequenceLogTraceConverter::close()
+{
+    mReader.close();
+    mStacks.clear();
+
+    mProcessId = 0;
+    mProcessName.setLength(0);
+    mBaseTime = -1;
+    mLastTime = 0;
+    mState = State::CLOSED;
+    mSeparator = false;
+}
+
+/*!
+ * \brief   変換（JSONの続きを取得）
+ *
+ * \param[out]  json    JSONの続きを受け取る（追加ではなく置き換える）
+ * \param[in]   size    受け取るサイズの目安（このサイズを超えたところでイベントの追加をやめる）
+ *
+ * \return  続きを取得した場合はtrue、全て取得済みの場合はfalseを返す
+ */
+bool SequenceLogTraceConverter::read(CoreString* json, int32_t size) throw(Exception)
+{
+    json->setLength(0);
+
+    if (mState == State::CLOSED || mState == State::END)
+        return false;
+
+    if (json->getCapacity() < size + MAX_EVENT_SIZE)
+        json->setCapacity(size + MAX_EVENT_SIZE);
+
+    if (mState == State::HEADER)
+    {
+        json->append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        char event[128];
+        snprintf(event, sizeof(event), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"", mProcessId);
+
+        json->append(event);
+        appendEscape(json, mProcessName.getBuffer(), mProcessName.getLength());
+        json->append("\"}}");
+
+        mSeparator = true;
+        mState = State::EVENTS;
+    }
+
+    while (json->getLength() < size)
+    {
+        if (mReader.read(&mItem) == false)
+        {
+            // 呼び出し中の関数を全て終了
+            for (auto i = mStacks.begin(); i != mStacks.end(); i++)
+            {
+                while (i->second.size())
+                {
+                    i->second.pop_back();
+                    appendEnd(json, i->first, mLastTime);
+                }
+            }
+
+            json->append("\n]}\n");
+            mState = State::END;
+            break;
+        }
+
+        appendItem(json);
+    }
+
+    return true;
+}
+
+/*!
+ * \brief   シーケンスログアイテムのイベントを追加
+ */
+void SequenceLogTraceConverter::appendItem(CoreString* json) throw(Exception)
+{
+    int64_t time = mItem.mDateTime.toMilliSeconds();
+
+    if (mBaseTime == -1)
+        mBaseTime = time;
+
+    if (mLastTime < time)
+        mLastTime = time;
+
+    std::vector<uint32_t>* stack = &mStacks[mItem.mThreadId];
+
+    if (mItem.mType == SequenceLogItem::STEP_IN)
+    {
+        stack->push_back(mItem.mSeqNo);
+
+        char event[128];
+        snprintf(event, sizeof(event), "{\"ph\":\"B\",\"pid\":%d,\"tid\":%u,\"ts\":%lld,\"name\":\"",
+            mProcessId, mItem.mThreadId, (long long)(time - mBaseTime) * 1000);
+
+        appendEvent(json, event);
+        appendName(json, mItem.mClassId, mItem.getClassName());
+        json->append("::");
+        appendName(json, mItem.mFuncId,  mItem.getFuncName());
+        json->append("\"}");
+        return;
+    }
+
+    while (stack->size() && stack->back() != mItem.mSeqNo)
+    {
+        stack->pop_back();
+        appendEnd(json, mItem.mThreadId, time);
+    }
+
+    if (mItem.mType == SequenceLogItem::STEP_OUT)
+    {
+        if (stack->size())
+        {
+            stack->pop_back();
+            appendEnd(json, mItem.mThreadId, time);
+        }
+
+        return;
+    }
+
+    static const char* levels[] = {"d", "i", "w", "e"};
+
+    char event[160];
+    snprintf(event, sizeof(event), "{\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%u,\"ts\":%lld,\"cat\":\"%s\",\"name\":\"",
+        mProcessId, mItem.mThreadId, (long long)(time - mBaseTime) * 1000, levels[mItem.mLevel & 3]);
+
+    appendEvent(json, event);
+    appendName(json, mItem.mMessageId, mItem.getMessage());
+    json->append("\"}");
+}
+
+/*!
+ * \brief   関数終了イベントを追加
+ */
+void SequenceLogTraceConverter::appendEnd(CoreString* json, uint32_t threadId, int64_t time) throw(Exception)
+{
+    char event[128];
+    snprintf(event, sizeof(event), "{\"ph\":\"E\",\"pid\":%d,\"tid\":%u,\"ts\":%lld}",
+        mProcessId, threadId, (long long)(time - mBaseTime) * 1000);
+
+    appendEvent(json, event);
+}
+
+/*!
+ * \brief   イベントを追加（区切りを含む）
+ */
+void SequenceLogTraceConverter::appendEvent(CoreString* json, const char* event) throw(Exception)
+{
+    if (mSeparator)
+        json->append(",\n");
+
+    json->append(event);
+    mSeparator = true;
+}
+
+/*!
+ * \brief   ファイルに変換
+ *
+ * \param[in]   logPath     シーケンスログファイルのパス
+ * \param[in]   tracePath   出力するJSONファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogTraceConverter::convert(const CoreString* logPath, const CoreString* tracePath) throw(Exception)
+{
+    SequenceLogTraceConverter converter;
+    converter.open(logPath);
+
+    File file;
+    file.open(tracePath, File::WRITE);
+
+    String json;
+
+    while (converter.read(&json, 64 * 1024))
+        file.write(&json, json.getLength());
+
+    file.close();
+}
+
+} // namespace slog
@@ -23,6 +23,7 @@
 #include "slog/ByteBuffer.h"
 #include "slog/FixedString.h"
 #include "slog/Thread.h"
+#include "slog/File.h"
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -34,12 +35,20 @@
     #include <netinet/tcp.h>
     #include <unistd.h>
     #include <netdb.h>
+    #include <errno.h>
 
     #if defined(__APPLE__)
         #define MSG_NOSIGNAL 0x2000
     #endif
 #endif
 
+#if defined(__linux__)
+    #include <sys/sendfile.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <pthread.h>
+#endif
+
 namespace slog
 {
 const int Socket::STREAM = SOCK_STREAM;
@@ -721,6 +730,121 @@ void Socket::send(
     }
 }
 
+/*!
+ * \brief   送信
+ */
+void Socket::send(const int64_t* value) const throw(Exception)
+{
+    mBuffer->setPosition(0);
+    mBuffer->putLong(*value);
+
+    Socket::send(mBuffer, sizeof(*value));
+}
+
+/*!
+ * \brief   ファイル送信
+ *
+ * \param[in]   path        パス
+ * \param[in]   position    送信開始位置
+ * \param[in]   count       送信するバイト数
+ *
+ * \return  送信したバイト数（ファイルが短い場合はcountより小さい）
+ *
+ * \note    SSLを使用していない場合はsendfile()でカーネル内で転送し、
+ *          SSLを使用している場合は固定長のバッファで読み込みと送信を繰り返す
+ */
+int64_t Socket::sendFile(const CoreString* path, int64_t position, int64_t count) const throw(Exception)
+{
+    int64_t remains = count;
+
+#if defined(__linux__)
+    if (mData->mSSL == nullptr && mStream)
+    {
+        int fd = ::open(path->getBuffer(), O_RDONLY);
+
+        if (fd == -1)
+        {
+            Exception e;
+            e.setMessage("Socket::sendFile(\"%s\")", path->getBuffer());
+
+            throw e;
+        }
+
+        // 送信中の切断でSIGPIPEが発生しないようにブロックする
+        sigset_t pipeSet;
+        sigset_t oldSet;
+
+        sigemptyset(&pipeSet);
+        sigaddset(  &pipeSet, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+
+        off_t offset = position;
+        ssize_t result = 0;
+
+        while (0 < remains)
+        {
+            size_t len = (size_t)(remains < 0x40000000 ? remains : 0x40000000);
+            result = ::sendfile(mSocket, fd, &offset, len);
+
+            if (result == -1 && errno == EINTR)
+                continue;
+
+            if (result <= 0)
+                break;
+
+            remains -= result;
+        }
+
+        ::close(fd);
+
+        // ブロック中に発生したSIGPIPEを破棄
+        if (sigismember(&oldSet, SIGPIPE) == 0)
+        {
+            sigset_t pending;
+            sigpending(&pending);
+
+            if (sigismember(&pending, SIGPIPE))
+            {
+                timespec timeout = {0, 0};
+                sigtimedwait(&pipeSet, nullptr, &timeout);
+            }
+
+            pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
+        }
+
+        if (result == -1)
+        {
+            Exception e;
+            e.setMessage("Socket::sendFile(\"%s\", %lld, %lld)", path->getBuffer(), position, count);
+
+            throw e;
+        }
+
+        return count - remains;
+    }
+#endif
+
+    File file;
+    file.open(path, File::READ);
+    file.setPosition(position);
+
+    ByteBuffer buffer(64 * 1024);
+
+    while (0 < remains)
+    {
+        int64_t len = (remains < buffer.getCapacity() ? remains : buffer.getCapacity());
+        int32_t readLen = (int32_t)file.read(&buffer, len);
+
+        if (readLen <= 0)
+            break;
+
+        Socket::send(&buffer, readLen);
+        remains -= readLen;
+    }
+
+    return count - remains;
+}
+
 /*!
  * \brief   受信
  */
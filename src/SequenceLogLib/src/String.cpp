@@ -36,15 +36,44 @@ String::String(const char* text)
 /*!
  * \brief   初期化
  */
-void String::init(const char* text, int16_t len)
+void String::init(const char* text, int32_t len)
 {
-    mBuffer = new char[len + 1];
+    mBuffer = (len <= INLINE_CAPACITY ? mInline : new char[len + 1]);
     mCapacity = len;
 
     memcpy(mBuffer, text, len);
     setLength(len);
 }
 
+/*!
+ * \brief   移動
+ *
+ * \param[in,out]   str     移動元（空の文字列になる）
+ *
+ * \note    this のバッファは解放済みであること。
+ */
+void String::move(String* str)
+{
+    int32_t len = str->getLength();
+    mCapacity = str->mCapacity;
+
+    if (str->isInline())
+    {
+        mBuffer = mInline;
+        memcpy(mInline, str->mInline, len);
+    }
+    else
+    {
+        mBuffer = str->mBuffer;
+
+        str->mBuffer = str->mInline;
+        str->mCapacity = 0;
+        str->setLength(0);
+    }
+
+    setLength(len);
+}
+
 /*!
  * \brief   バッファサイズ設定
  */
@@ -52,14 +81,29 @@ void String::setCapacity(int32_t capacity) throw(Exception)
 {
     char* oldBuffer = mBuffer;
     int32_t oldLen = getLength();
+    int32_t len = (capacity < oldLen ? capacity : oldLen);
 
-    mBuffer = new char[capacity + 1];
-    mCapacity = capacity;
+    if (capacity <= INLINE_CAPACITY)
+    {
+        // オブジェクト内のバッファに収まる
+        if (isInline() == false)
+        {
+            mBuffer = mInline;
+            memcpy(mBuffer, oldBuffer, len);
+
+            delete [] oldBuffer;
+        }
+    }
+    else
+    {
+        mBuffer = new char[capacity + 1];
+        memcpy(mBuffer, oldBuffer, len);
 
-    int32_t len = (mCapacity < oldLen ? mCapacity : oldLen);
-    memcpy(mBuffer, oldBuffer, len);
+        if (oldBuffer != mInline)
+            delete [] oldBuffer;
+    }
 
-    delete [] oldBuffer;
+    mCapacity = capacity;
     setLength(len);
 }
 
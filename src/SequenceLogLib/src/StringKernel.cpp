@@ -0,0 +1,694 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    StringKernel.cpp
+ * \brief   文字列検索カーネル
+ * \author  Copyright 2015 printf.jp
+ */
+#include "StringKernel.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__)))
+    #define SLOG_STRING_KERNEL_X86
+
+    #include <emmintrin.h>
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define SLOG_TARGET_AVX2
+    #else
+        #include <cpuid.h>
+        #define SLOG_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace slog
+{
+
+/*!
+ * \brief   カーネルの関数テーブル
+ */
+struct StringKernelTable
+{
+    const char* name;
+    const char* (*findAny)( const char* p, const char* end, const char* set,     int32_t setLen);
+    const char* (*find)(    const char* p, const char* end, const char* pattern, int32_t patternLen);
+    const char* (*findLast)(const char* p, const char* end, const char* pattern, int32_t patternLen);
+    int32_t     (*countCharacters)(const char* p, const char* end);
+    void        (*mask)(char* p, char* end, uint32_t key);
+};
+
+/*!
+ * \brief   スカラー版：いずれかの文字を前方検索
+ */
+static const char* findAnyScalar(const char* p, const char* end, const char* set, int32_t setLen)
+{
+    for (; p < end; p++)
+    {
+        for (int32_t i = 0; i < setLen; i++)
+        {
+            if (*p == set[i])
+                return p;
+        }
+    }
+
+    return nullptr;
+}
+
+/*!
+ * \brief   スカラー版：前方検索
+ */
+static const char* findScalar(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (patternLen == 0)
+        return p;
+
+    const char* last = end - patternLen;
+
+    for (; p <= last; p++)
+    {
+        if (*p == *pattern && memcmp(p, pattern, patternLen) == 0)
+            return p;
+    }
+
+    return nullptr;
+}
+
+/*!
+ * \brief   スカラー版：後方検索
+ */
+static const char* findLastScalar(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (end - p < patternLen)
+        return nullptr;
+
+    for (const char* s = end - patternLen; p <= s; s--)
+    {
+        if (patternLen == 0 || (*s == *pattern && memcmp(s, pattern, patternLen) == 0))
+            return s;
+    }
+
+    return nullptr;
+}
+
+/*!
+ * \brief   スカラー版：UTF-8の文字数を取得する
+ */
+static int32_t countCharactersScalar(const char* p, const char* end)
+{
+    int32_t num = 0;
+
+    for (; p < end; p++)
+    {
+        if ((*(const uint8_t*)p & 0xC0) != 0x80)
+            num++;
+    }
+
+    return num;
+}
+
+/*!
+ * \brief   スカラー版：マスキングキーでXORする（８バイト単位）
+ *
+ * \note    keyはメモリ上の並びで p[0] から順に適用するキー４バイト。
+ */
+static void maskScalar(char* p, char* end, uint32_t key)
+{
+    uint64_t key64 = ((uint64_t)key << 32) | key;
+
+    for (; 8 <= end - p; p += 8)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        value ^= key64;
+        memcpy(p, &value, sizeof(value));
+    }
+
+    uint8_t keys[4];
+    memcpy(keys, &key, sizeof(keys));
+
+    for (int32_t i = 0; p < end; p++, i++)
+        *p ^= keys[i & 3];
+}
+
+static const StringKernelTable sScalarTable =
+{
+    "scalar",
+    findAnyScalar,
+    findScalar,
+    findLastScalar,
+    countCharactersScalar,
+    maskScalar,
+};
+
+#if defined(SLOG_STRING_KERNEL_X86)
+/*!
+ * \brief   最下位のセットビットの位置を取得する
+ */
+inline int32_t lowestBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int32_t)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/*!
+ * \brief   最上位のセットビットの位置を取得する
+ */
+inline int32_t highestBit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return (int32_t)index;
+#else
+    return 31 - __builtin_clz(mask);
+#endif
+}
+
+/*!
+ * \brief   SSE2版：いずれかの文字を前方検索
+ */
+static const char* findAnySSE2(const char* p, const char* end, const char* set, int32_t setLen)
+{
+    __m128i chars[8];
+
+    for (int32_t i = 0; i < setLen; i++)
+        chars[i] = _mm_set1_epi8(set[i]);
+
+    for (; 16 <= end - p; p += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+        __m128i eq = _mm_cmpeq_epi8(block, chars[0]);
+
+        for (int32_t i = 1; i < setLen; i++)
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, chars[i]));
+
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(eq);
+
+        if (mask)
+            return p + lowestBit(mask);
+    }
+
+    return findAnyScalar(p, end, set, setLen);
+}
+
+/*!
+ * \brief   SSE2版：前方検索
+ *
+ * \note    先頭文字と末尾文字が一致する位置だけをmemcmpで確かめる。
+ */
+static const char* findSSE2(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (patternLen == 0 || end - p < patternLen)
+        return findScalar(p, end, pattern, patternLen);
+
+    __m128i first = _mm_set1_epi8(pattern[0]);
+    __m128i last =  _mm_set1_epi8(pattern[patternLen - 1]);
+    const char* limit = end - patternLen + 1;   // 検索開始位置の上限（含まない）
+
+    for (; 16 <= limit - p; p += 16)
+    {
+        __m128i eqFirst = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)p));
+        __m128i eqLast =  _mm_cmpeq_epi8(last,  _mm_loadu_si128((const __m128i*)(p + patternLen - 1)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast));
+
+        while (mask)
+        {
+            const char* s = p + lowestBit(mask);
+
+            if (memcmp(s, pattern, patternLen) == 0)
+                return s;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return findScalar(p, end, pattern, patternLen);
+}
+
+/*!
+ * \brief   SSE2版：後方検索
+ */
+static const char* findLastSSE2(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (patternLen == 0 || end - p < patternLen)
+        return findLastScalar(p, end, pattern, patternLen);
+
+    __m128i first = _mm_set1_epi8(pattern[0]);
+    __m128i last =  _mm_set1_epi8(pattern[patternLen - 1]);
+    const char* limit = end - patternLen + 1;   // 検索開始位置の上限（含まない）
+
+    for (; 16 <= limit - p; limit -= 16)
+    {
+        const char* block = limit - 16;
+        __m128i eqFirst = _mm_cmpeq_epi8(first, _mm_loadu_si128((const __m128i*)block));
+        __m128i eqLast =  _mm_cmpeq_epi8(last,  _mm_loadu_si128((const __m128i*)(block + patternLen - 1)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(eqFirst, eqLast));
+
+        while (mask)
+        {
+            int32_t bit = highestBit(mask);
+            const char* s = block + bit;
+
+            if (memcmp(s, pattern, patternLen) == 0)
+                return s;
+
+            mask &= ~(1u << bit);
+        }
+    }
+
+    return findLastScalar(p, limit + patternLen - 1, pattern, patternLen);
+}
+
+/*!
+ * \brief   SSE2版：UTF-8の文字数を取得する
+ *
+ * \note    継続バイト（0x80～0xBF）は符号付きで -65 以下になることを利用する。
+ *          バイト毎のカウンタがあふれないよう255ブロック毎に合計する。
+ */
+static int32_t countCharactersSSE2(const char* p, const char* end)
+{
+    const __m128i threshold = _mm_set1_epi8(-65);
+    const __m128i zero = _mm_setzero_si128();
+    int64_t num = 0;
+
+    while (16 <= end - p)
+    {
+        __m128i counts = zero;
+        int32_t blocks = (int32_t)((end - p) / 16);
+
+        if (255 < blocks)
+            blocks = 255;
+
+        for (int32_t i = 0; i < blocks; i++, p += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i*)p);
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(block, threshold));
+        }
+
+        __m128i sum = _mm_sad_epu8(counts, zero);
+        num += _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+
+    return (int32_t)num + countCharactersScalar(p, end);
+}
+
+/*!
+ * \brief   SSE2版：マスキングキーでXORする
+ */
+static void maskSSE2(char* p, char* end, uint32_t key)
+{
+    const __m128i keys = _mm_set1_epi32((int)key);
+
+    for (; 16 <= end - p; p += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)p);
+        _mm_storeu_si128((__m128i*)p, _mm_xor_si128(block, keys));
+    }
+
+    maskScalar(p, end, key);
+}
+
+static const StringKernelTable sSSE2Table =
+{
+    "sse2",
+    findAnySSE2,
+    findSSE2,
+    findLastSSE2,
+    countCharactersSSE2,
+    maskSSE2,
+};
+
+/*!
+ * \brief   AVX2版：いずれかの文字を前方検索
+ */
+SLOG_TARGET_AVX2 static const char* findAnyAVX2(const char* p, const char* end, const char* set, int32_t setLen)
+{
+    __m256i chars[8];
+
+    for (int32_t i = 0; i < setLen; i++)
+        chars[i] = _mm256_set1_epi8(set[i]);
+
+    for (; 32 <= end - p; p += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i*)p);
+        __m256i eq = _mm256_cmpeq_epi8(block, chars[0]);
+
+        for (int32_t i = 1; i < setLen; i++)
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(block, chars[i]));
+
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(eq);
+
+        if (mask)
+            return p + lowestBit(mask);
+    }
+
+    return findAnySSE2(p, end, set, setLen);
+}
+
+/*!
+ * \brief   AVX2版：前方検索
+ */
+SLOG_TARGET_AVX2 static const char* findAVX2(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (patternLen == 0 || end - p < patternLen)
+        return findScalar(p, end, pattern, patternLen);
+
+    __m256i first = _mm256_set1_epi8(pattern[0]);
+    __m256i last =  _mm256_set1_epi8(pattern[patternLen - 1]);
+    const char* limit = end - patternLen + 1;   // 検索開始位置の上限（含まない）
+
+    for (; 32 <= limit - p; p += 32)
+    {
+        __m256i eqFirst = _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*)p));
+        __m256i eqLast =  _mm256_cmpeq_epi8(last,  _mm256_loadu_si256((const __m256i*)(p + patternLen - 1)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast));
+
+        while (mask)
+        {
+            const char* s = p + lowestBit(mask);
+
+            if (memcmp(s, pattern, patternLen) == 0)
+                return s;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return findSSE2(p, end, pattern, patternLen);
+}
+
+/*!
+ * \brief   AVX2版：後方検索
+ */
+SLOG_TARGET_AVX2 static const char* findLastAVX2(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    if (patternLen == 0 || end - p < patternLen)
+        return findLastScalar(p, end, pattern, patternLen);
+
+    __m256i first = _mm256_set1_epi8(pattern[0]);
+    __m256i last =  _mm256_set1_epi8(pattern[patternLen - 1]);
+    const char* limit = end - patternLen + 1;   // 検索開始位置の上限（含まない）
+
+    for (; 32 <= limit - p; limit -= 32)
+    {
+        const char* block = limit - 32;
+        __m256i eqFirst = _mm256_cmpeq_epi8(first, _mm256_loadu_si256((const __m256i*)block));
+        __m256i eqLast =  _mm256_cmpeq_epi8(last,  _mm256_loadu_si256((const __m256i*)(block + patternLen - 1)));
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(eqFirst, eqLast));
+
+        while (mask)
+        {
+            int32_t bit = highestBit(mask);
+            const char* s = block + bit;
+
+            if (memcmp(s, pattern, patternLen) == 0)
+                return s;
+
+            mask &= ~(1u << bit);
+        }
+    }
+
+    return findLastSSE2(p, limit + patternLen - 1, pattern, patternLen);
+}
+
+/*!
+ * \brief   AVX2版：UTF-8の文字数を取得する
+ */
+SLOG_TARGET_AVX2 static int32_t countCharactersAVX2(const char* p, const char* end)
+{
+    const __m256i threshold = _mm256_set1_epi8(-65);
+    const __m256i zero = _mm256_setzero_si256();
+    int64_t num = 0;
+
+    while (32 <= end - p)
+    {
+        __m256i counts = zero;
+        int32_t blocks = (int32_t)((end - p) / 32);
+
+        if (255 < blocks)
+            blocks = 255;
+
+        for (int32_t i = 0; i < blocks; i++, p += 32)
+        {
+            __m256i block = _mm256_loadu_si256((const __m256i*)p);
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(block, threshold));
+        }
+
+        __m256i sum = _mm256_sad_epu8(counts, zero);
+        __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        num += _mm_cvtsi128_si32(sum128) + _mm_cvtsi128_si32(_mm_srli_si128(sum128, 8));
+    }
+
+    return (int32_t)num + countCharactersSSE2(p, end);
+}
+
+/*!
+ * \brief   AVX2版：マスキングキーでXORする
+ */
+SLOG_TARGET_AVX2 static void maskAVX2(char* p, char* end, uint32_t key)
+{
+    const __m256i keys = _mm256_set1_epi32((int)key);
+
+    for (; 64 <= end - p; p += 64)
+    {
+        __m256i block1 = _mm256_loadu_si256((const __m256i*)p);
+        __m256i block2 = _mm256_loadu_si256((const __m256i*)(p + 32));
+        _mm256_storeu_si256((__m256i*) p,       _mm256_xor_si256(block1, keys));
+        _mm256_storeu_si256((__m256i*)(p + 32), _mm256_xor_si256(block2, keys));
+    }
+
+    maskSSE2(p, end, key);
+}
+
+static const StringKernelTable sAVX2Table =
+{
+    "avx2",
+    findAnyAVX2,
+    findAVX2,
+    findLastAVX2,
+    countCharactersAVX2,
+    maskAVX2,
+};
+
+/*!
+ * \brief   AVX2が使えるかどうか調べる
+ *
+ * \note    CPUがAVX2に対応していても、OSがYMMレジスタを保存しない場合は使えない。
+ */
+static bool isAVX2Supported()
+{
+    uint32_t regs[4];
+
+#if defined(_MSC_VER)
+    __cpuid((int*)regs, 0);
+
+    if (regs[0] < 7)
+        return false;
+
+    __cpuid((int*)regs, 1);
+#else
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    const uint32_t osxsave = (1u << 27);
+    const uint32_t avx =     (1u << 28);
+
+    if ((regs[2] & (osxsave | avx)) != (osxsave | avx))
+        return false;
+
+#if defined(_MSC_VER)
+    uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    uint64_t xcr0 = ((uint64_t)edx << 32) | eax;
+#endif
+
+    if ((xcr0 & 0x06) != 0x06)
+        return false;
+
+#if defined(_MSC_VER)
+    __cpuidex((int*)regs, 7, 0);
+#else
+    __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    return ((regs[1] & (1u << 5)) != 0);
+}
+#endif
+
+/*!
+ * \brief   使用するカーネルの関数テーブル（初回呼び出し時に決める）
+ *
+ * \note    複数スレッドから同時に初期化されても同じ値を書き込むだけなので排他は不要。
+ */
+static const StringKernelTable* volatile sTable = nullptr;
+
+/*!
+ * \brief   カーネルの関数テーブルを取得する
+ */
+static const StringKernelTable* getTable()
+{
+    const StringKernelTable* table = sTable;
+
+    if (table == nullptr)
+    {
+#if defined(SLOG_STRING_KERNEL_X86)
+        table = (isAVX2Supported() ? &sAVX2Table : &sSSE2Table);
+#else
+        table = &sScalarTable;
+#endif
+        sTable = table;
+    }
+
+    return table;
+}
+
+/*!
+ * \brief   いずれかの文字を前方検索
+ *
+ * \param[in]   p       検索開始位置
+ * \param[in]   end     検索終了位置（含まない）
+ * \param[in]   set     検索する文字の並び
+ * \param[in]   setLen  検索する文字数（8以下）
+ *
+ * \return  見つかった位置、見つからなかった場合はnullptrを返す
+ */
+const char* StringKernel::findAny(const char* p, const char* end, const char* set, int32_t setLen)
+{
+    if (setLen <= 0 || 8 < setLen)
+        return findAnyScalar(p, end, set, setLen);
+
+    return getTable()->findAny(p, end, set, setLen);
+}
+
+/*!
+ * \brief   前方検索
+ *
+ * \param[in]   p           検索開始位置
+ * \param[in]   end         検索終了位置（含まない）
+ * \param[in]   pattern     検索文字列
+ * \param[in]   patternLen  検索文字列の長さ
+ *
+ * \return  見つかった位置、見つからなかった場合はnullptrを返す
+ */
+const char* StringKernel::find(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    return getTable()->find(p, end, pattern, patternLen);
+}
+
+/*!
+ * \brief   後方検索
+ *
+ * \param[in]   p           検索開始位置
+ * \param[in]   end         検索終了位置（含まない）
+ * \param[in]   pattern     検索文字列
+ * \param[in]   patternLen  検索文字列の長さ
+ *
+ * \return  最後に見つかった位置、見つからなかった場合はnullptrを返す
+ */
+const char* StringKernel::findLast(const char* p, const char* end, const char* pattern, int32_t patternLen)
+{
+    return getTable()->findLast(p, end, pattern, patternLen);
+}
+
+/*!
+ * \brief   UTF-8の文字数を取得する
+ */
+int32_t StringKernel::countCharacters(const char* p, const char* end)
+{
+    return getTable()->countCharacters(p, end);
+}
+
+/*!
+ * \brief   マスキングキーでXORする（WebSocketのマスク／アンマスク）
+ *
+ * \param[in,out]  p       開始位置
+ * \param[in]      end     終了位置（含まない）
+ * \param[in]      key     マスキングキー（４バイト）
+ * \param[in]      offset  p がフレームのペイロードの先頭から何バイト目か
+ */
+void StringKernel::mask(char* p, char* end, const char* key, uint64_t offset)
+{
+    char keys[4];
+
+    for (int32_t i = 0; i < 4; i++)
+        keys[i] = key[(offset + i) & 3];
+
+    uint32_t value;
+    memcpy(&value, keys, sizeof(value));
+
+    getTable()->mask(p, end, value);
+}
+
+/*!
+ * \brief   使用中のカーネル名を取得する
+ */
+const char* StringKernel::getName()
+{
+    return getTable()->name;
+}
+
+/*!
+ * \brief   使用するカーネルを名前で選ぶ
+ *
+ * \param[in]   name    カーネル名（"avx2"、"sse2"、"scalar"）、nullptrの場合は自動選択に戻す
+ *
+ * \return  選べた場合はtrue、この環境で使えないカーネルの場合はfalseを返す
+ *
+ * \note    各カーネルを同じ入力で比較するテスト用。処理中の他のスレッドとは排他しない。
+ */
+bool StringKernel::select(const char* name)
+{
+    const StringKernelTable* table = nullptr;
+
+    if (name == nullptr)
+    {
+        sTable = nullptr;
+        return true;
+    }
+
+    if (strcmp(name, sScalarTable.name) == 0)
+        table = &sScalarTable;
+
+#if defined(SLOG_STRING_KERNEL_X86)
+    if (strcmp(name, sSSE2Table.name) == 0)
+        table = &sSSE2Table;
+
+    if (strcmp(name, sAVX2Table.name) == 0 && isAVX2Supported())
+        table = &sAVX2Table;
+#endif
+
+    if (table == nullptr)
+        return false;
+
+    sTable = table;
+    return true;
+}
+
+} // namespace slog
@@ -23,6 +23,7 @@
 #include "slog/String.h"
 #include "slog/Convert.h"
 #include "slog/DateTime.h"
+#include "StringKernel.h"
 
 #if defined(_WINDOWS)
     #include <windows.h>
@@ -228,24 +229,34 @@ void Util::decodePercent(CoreString* str, char* start, const char* end)
 
     while (cursor < end)
     {
-        char c = *cursor;
+        // デコード不要な範囲はまとめて移動する
+        const char* special = StringKernel::findAny(cursor, end, "%+", 2);
 
-        switch (c)
-        {
-        case '%':
+        if (special == nullptr)
+            special = end;
+
+        int32_t len = (int32_t)(special - cursor);
+
+        if (decodeCursor != cursor)
+            memmove(decodeCursor, cursor, len);
+
+        decodeCursor += len;
+        cursor = special;
+
+        if (cursor == end)
+            break;
+
+        char c;
+
+        if (*cursor == '%')
         {
             c = Convert::toByte(cursor + 1, 16, 2);
             cursor += (1 + 2);
-            break;
         }
-
-        case '+':
+        else
+        {
             c =  ' ';
-//          break;
-
-        default:
             cursor++;
-            break;
         }
 
         *decodeCursor = c;
@@ -282,19 +293,32 @@ void Util::encodeHtml(CoreString* str)
         {'\n', "<br />", 6},
     };
 
+    static const char targets[] = "\"&<>\n";
+    const int32_t count = sizeof(list) / sizeof(list[0]);
+
     int32_t len = str->getLength();
+    const char* src = str->getBuffer();
+    const char* end = src + len;
+    const char* special = StringKernel::findAny(src, end, targets, count);
+
+    if (special == nullptr)
+    {
+        // エンコード対象の文字がなければ何もしない
+        return;
+    }
+
     char* buffer = new char[len * 6 + 1];
     char* dest = buffer;
-    const char* src = str->getBuffer();
 
-    for (int32_t i = 0; i < len; i++)
+    while (special)
     {
-        char c = *src;
-        int32_t j;
+        // エンコード不要な範囲はまとめてコピーする
+        memcpy(dest, src, special - src);
+        dest += special - src;
 
-        for (j = 0; j < sizeof(list) / sizeof(list[0]); j++)
+        for (int32_t j = 0; j < count; j++)
         {
-            if (c == list[j].target)
+            if (*special == list[j].target)
             {
                 memcpy(dest, list[j].encode, list[j].len);
                 dest += list[j].len;
@@ -302,15 +326,13 @@ void Util::encodeHtml(CoreString* str)
             }
         }
 
-        if (j == sizeof(list) / sizeof(list[0]))
-        {
-            *dest = c;
-             dest++;
-        }
-
-        src++;
+        src = special + 1;
+        special = StringKernel::findAny(src, end, targets, count);
     }
 
+    memcpy(dest, src, end - src);
+    dest += end - src;
+
     *dest = '\0';
 
     str->copy(buffer);
@@ -24,6 +24,7 @@
 #include "slog/WebSocket.h"
 #include "slog/Util.h"
 #include "slog/File.h"
+#include "slog/CompressedFile.h"
 #include "slog/FileInfo.h"
 #include "slog/ByteBuffer.h"
 #include "slog/SHA1.h"
@@ -172,32 +173,268 @@ void WebServerResponse::sendBinary(HtmlGenerator* generator, const CoreString* p
 {
     SLOG(CLS_NAME, "sendBinary");
     Socket* socket = mHttpRequest->getSocket();
+    bool headerSent = false;
 
     try
     {
+        if (CompressedFile::isCompressedFileName(path))
+        {
+            sendCompressedBinary(path);
+            return;
+        }
+
         File file;
         file.open(path, File::READ);
 
-        int32_t len = (int32_t)file.getSize();
+        DateTime lastModified = *file.getLastWriteTime();
+        int64_t size = file.getSize();
+        int64_t position;
+        int64_t len;
 
-        // HTTPヘッダー送信
-        sendHttpHeader(file.getLastWriteTime(), len);
+        file.close();
 
-        // コンテンツ送信
-        ByteBuffer buffer(1024 * 1024);
-        int32_t readLen;
+        // HTTPヘッダー送信（以降は not found を返せない）
+        headerSent = true;
+        bool hasBody = sendBinaryHeader(&lastModified, size, &position, &len);
 
-        while (0 < (readLen = (int32_t)file.read(&buffer, buffer.getCapacity())))
-            socket->send(&buffer, readLen);
+        // コンテンツ送信（Content-Length に満たない場合はクライアントが待ち続けないように切断する）
+        if (hasBody && socket->sendFile(path, position, len) != len)
+            socket->close();
 
 //      socket->close();
     }
     catch (Exception)
     {
-        sendNotFound(generator);
+        if (headerSent == false)
+            sendNotFound(generator);
+        else
+            socket->close();
     }
 }
 
+/*!
+ * \brief   圧縮ファイルを展開しながら送信
+ *
+ * \param[in]   path    パス
+ *
+ * \return  なし
+ */
+void WebServerResponse::sendCompressedBinary(const CoreString* path) const throw(Exception)
+{
+    SLOG(CLS_NAME, "sendCompressedBinary");
+    Socket* socket = mHttpRequest->getSocket();
+
+    CompressedFile file;
+    file.open(path, File::READ);
+
+    FileInfo info(path);
+    const DateTime* lastModified = &info.getLastWriteTime();
+
+    String headers;
+    const char* status;
+    int64_t position;
+    int64_t len;
+
+    bool hasBody = getBinaryHeader(lastModified, file.getRawSize(), &position, &len, &status, &headers);
+
+    // ヘッダー送信前に送信開始位置まで展開しておく（失敗した場合は例外を投げて not found を返す）
+    if (hasBody && file.setRawPosition(position) != position)
+    {
+        Exception e;
+        e.setMessage("WebServerResponse::sendCompressedBinary(\"%s\") : illegal position %lld", path->getBuffer(), position);
+
+        throw e;
+    }
+
+    // HTTPヘッダー送信（送信途中で失敗した場合は not found を返さずに切断する）
+    try
+    {
+        sendHttpHeader(status, lastModified, len, &headers);
+    }
+    catch (Exception&)
+    {
+        socket->close();
+        return;
+    }
+
+    if (hasBody == false)
+        return;
+
+    // コンテンツ送信（ヘッダー送信後に追記されたブロックは送らない）
+    ByteBuffer buffer(CompressedFile::BLOCK_SIZE);
+    int32_t readLen;
+
+    try
+    {
+        while (0 < len && 0 < (readLen = (int32_t)file.read(&buffer, (len < buffer.getCapacity() ? len : buffer.getCapacity()))))
+        {
+            socket->send(&buffer, readLen);
+            len -= readLen;
+        }
+    }
+    catch (Exception&)
+    {
+    }
+
+    // Content-Length に満たない場合はクライアントが待ち続けないように切断する
+    if (0 < len)
+        socket->close();
+}
+
+/*!
+ * \brief   バイナリ用HTTPヘッダー送信（Range、条件付きGET対応）
+ *
+ * \param[in]   lastModified    最終書込日時
+ * \param[in]   size            ファイルサイズ
+ * \param[out]  position        送信開始位置
+ * \param[out]  count           送信バイト数
+ *
+ * \return  コンテンツを送信する必要があればtrue、ヘッダーのみで完了した場合はfalseを返す
+ */
+bool WebServerResponse::sendBinaryHeader(const DateTime* lastModified, int64_t size, int64_t* position, int64_t* count) const
+{
+    SLOG(CLS_NAME, "sendBinaryHeader");
+
+    String headers;
+    const char* status;
+
+    bool hasBody = getBinaryHeader(lastModified, size, position, count, &status, &headers);
+    sendHttpHeader(status, lastModified, *count, &headers);
+
+    return hasBody;
+}
+
+/*!
+ * \brief   バイナリ用HTTPヘッダー取得（Range、条件付きGET対応）
+ *
+ * \param[in]   lastModified    最終書込日時
+ * \param[in]   size            ファイルサイズ
+ * \param[out]  position        送信開始位置
+ * \param[out]  count           送信バイト数（Content-Length）
+ * \param[out]  status          ステータス
+ * \param[out]  headers         追加するヘッダー
+ *
+ * \return  コンテンツを送信する必要があればtrue、ヘッダーのみで完了する場合はfalseを返す
+ *
+ * \note    Rangeは単一範囲（bytes=a-b、bytes=a-、bytes=-n）のみ対応し、
+ *          複数範囲の要求は無視して全体を返す。
+ */
+bool WebServerResponse::getBinaryHeader(const DateTime* lastModified, int64_t size, int64_t* position, int64_t* count, const char** status, CoreString* headers) const
+{
+    String lastModifiedString;
+    Util::getDateString(&lastModifiedString, lastModified);
+
+    String etag;
+    etag.format("\"%llx-%llx\"", size, lastModified->getValue());
+
+    headers->format(
+        "Accept-Ranges: bytes\r\n"
+        "ETag: %s\r\n",
+        etag.getBuffer());
+
+    *position = 0;
+    *count = size;
+
+    // 条件付きGET
+    const CoreString* ifNoneMatch =     mHttpRequest->getIfNoneMatch();
+    const CoreString* ifModifiedSince = mHttpRequest->getIfModifiedSince();
+    bool notModified;
+
+    if (ifNoneMatch->getLength())
+        notModified = (ifNoneMatch->equals(&etag) || ifNoneMatch->equals("*"));
+    else
+        notModified = ifModifiedSince->equals(&lastModifiedString);
+
+    if (notModified)
+    {
+        *status = "304 Not Modified";
+        *count = 0;
+        return false;
+    }
+
+    // Range
+    const CoreString* range =   mHttpRequest->getRange();
+    const CoreString* ifRange = mHttpRequest->getIfRange();
+
+    if (range->getLength() == 0 || range->indexOf(',') != -1 || range->indexOf("bytes=") != 0)
+    {
+        *status = "200 OK";
+        return true;
+    }
+
+    if (ifRange->getLength() && ifRange->equals(&etag) == false && ifRange->equals(&lastModifiedString) == false)
+    {
+        *status = "200 OK";
+        return true;
+    }
+
+    const char* p = range->getBuffer() + sizeof("bytes=") - 1;
+    char* end;
+    int64_t first = -1;
+    int64_t last =  -1;
+
+    if (*p != '-')
+    {
+        first = strtoll(p, &end, 10);
+
+        if (end == p || *end != '-')
+            first = -2;
+
+        p = end;
+    }
+
+    if (first != -2)
+    {
+        p++;
+
+        if (*p)
+        {
+            last = strtoll(p, &end, 10);
+
+            if (end == p || *end != '\0')
+                first = -2;
+        }
+    }
+
+    if (first == -2 || (first == -1 && last == -1))
+    {
+        // 解釈できない範囲指定は無視する
+        *status = "200 OK";
+        return true;
+    }
+
+    if (first == -1)
+    {
+        // 末尾からnバイト
+        first = (last < size ? size - last : 0);
+        last = size - 1;
+    }
+    else if (last == -1 || size <= last)
+    {
+        last = size - 1;
+    }
+
+    String work;
+
+    if (size <= first || last < first)
+    {
+        work.format("Content-Range: bytes */%lld\r\n", size);
+        headers->append(&work);
+
+        *status = "416 Range Not Satisfiable";
+        *count = 0;
+        return false;
+    }
+
+    work.format("Content-Range: bytes %lld-%lld/%lld\r\n", first, last, size);
+    headers->append(&work);
+
+    *status = "206 Partial Content";
+    *position = first;
+    *count = last - first + 1;
+    return true;
+}
+
 /*!
  * \brief   HTTPヘッダー送信（＆切断）
  *
@@ -206,7 +443,22 @@ void WebServerResponse::sendBinary(HtmlGenerator* generator, const CoreString* p
  *
  * \return  なし
  */
-void WebServerResponse::sendHttpHeader(const DateTime* lastModified, int32_t contentLen) const
+void WebServerResponse::sendHttpHeader(const DateTime* lastModified, int64_t contentLen) const
+{
+    sendHttpHeader("200 OK", lastModified, contentLen, nullptr);
+}
+
+/*!
+ * \brief   HTTPヘッダー送信（＆切断）
+ *
+ * \param[in]   status          ステータス（"200 OK"など）
+ * \param[in]   lastModified    最終書込日時（NULL可）
+ * \param[in]   contentLen      コンテンツの長さ
+ * \param[in]   extraHeaders    追加ヘッダー（NULL可）
+ *
+ * \return  なし
+ */
+void WebServerResponse::sendHttpHeader(const char* status, const DateTime* lastModified, int64_t contentLen, const CoreString* extraHeaders) const
 {
     SLOG(CLS_NAME, "sendHttpHeader");
 
@@ -228,21 +480,29 @@ void WebServerResponse::sendHttpHeader(const DateTime* lastModified, int32_t con
     String work;
 
     str.format(
-        "HTTP/1.1 200 OK\r\n"
+        "HTTP/1.1 %s\r\n"
         "Content-Type: %s%s\r\n"
         "Date: %s\r\n"
         "Last-Modified: %s\r\n"
         "Access-Control-Allow-Origin: *\r\n",
+         status,
          mimeType->text.getBuffer(),
         (mimeType->binary == false ? "; charset=UTF-8" : ""),
         dateString.getBuffer(),
         lastModifiedString.getBuffer());
 
-    if (0 <= contentLen)
+    if (extraHeaders)
+        str.append(extraHeaders);
+
+    if (strncmp(status, "304", 3) == 0)
+    {
+        // 304はボディを持たない
+    }
+    else if (0 <= contentLen)
     {
         work.format(
 //          "Connection: Close\r\n"
-            "Content-Length: %d\r\n", contentLen);
+            "Content-Length: %lld\r\n", contentLen);
         str.append(&work);
     }
     else
@@ -289,11 +549,12 @@ void WebServerResponse::sendContent(const Buffer* content) const
 
         if (content)
         {
-            str.format(
-                "%x\r\n"
-                "%s\r\n",
-                content->getLength(),
-                content->getBuffer());
+            // バイナリデータも送信できるように、内容は書式化せずにそのまま送信する
+            str.format("%x\r\n", content->getLength());
+            socket->send(&str, str.getLength());
+            socket->send(content, content->getLength());
+
+            str.copy("\r\n");
         }
         else
         {
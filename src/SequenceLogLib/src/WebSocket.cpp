@@ -28,6 +28,12 @@
 #include "slog/Thread.h"
 #include "slog/Mutex.h"
 
+#include "StringKernel.h"
+
+#include <openssl/rand.h>
+#include <string.h>
+#include <time.h>
+
 namespace slog
 {
 
@@ -165,6 +171,17 @@ WebSocket::WebSocket(bool isServer)
     mIsText = false;
     mMutex = new Mutex();
     mReceiver = new WebSocketReceiver(this);
+
+    // マスキングキーは乱数の種だけをOpenSSLから取得し、フレーム毎に生成する
+    mMaskSeed = 0;
+    mMaskOffset = 0;
+    memset(mMaskKey, 0, sizeof(mMaskKey));
+
+    if (isServer == false)
+    {
+        if (RAND_bytes((unsigned char*)&mMaskSeed, sizeof(mMaskSeed)) != 1)
+            mMaskSeed = ((uint64_t)time(nullptr) << 32) ^ (uint64_t)(uintptr_t)this;
+    }
 }
 
 /*!
@@ -228,13 +245,105 @@ void WebSocket::sendHeader(uint64_t payloadLen, bool isText) throw(Exception)
     mPayloadLen = payloadLen;
     mIsText = isText;
 
-    WebSocket::sendHeader(this, payloadLen, isText, mIsServer);
+    nextMaskKey();
+    WebSocket::sendHeader(this, payloadLen, isText, mIsServer, mMaskKey);
+}
+
+/*!
+ * \brief   マスキングキー生成
+ *
+ * \note    クライアントから送信するフレーム毎に新しいキーにする（RFC 6455 5.3）。
+ */
+void WebSocket::nextMaskKey()
+{
+    mMaskOffset = 0;
+
+    if (mIsServer)
+        return;
+
+    // splitmix64
+    uint64_t z = (mMaskSeed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z =  z ^ (z >> 31);
+
+    mMaskKey[0] = (char)(z      );
+    mMaskKey[1] = (char)(z >>  8);
+    mMaskKey[2] = (char)(z >> 16);
+    mMaskKey[3] = (char)(z >> 24);
+}
+
+/*!
+ * \brief   ペイロード送信
+ *
+ * \note    クライアントの場合は固定長のバッファにコピーしてマスクしながら送信する。
+ */
+void WebSocket::sendPayload(const char* buffer, int32_t len) throw(Exception)
+{
+    if (mIsServer)
+    {
+        Socket::send(buffer, len);
+        return;
+    }
+
+    char work[1024 * 16];
+
+    while (0 < len)
+    {
+        int32_t size = (len < (int32_t)sizeof(work) ? len : (int32_t)sizeof(work));
+
+        memcpy(work, buffer, size);
+        StringKernel::mask(work, work + size, mMaskKey, mMaskOffset);
+        mMaskOffset += size;
+
+        Socket::send(work, size);
+
+        buffer += size;
+        len -=    size;
+    }
+}
+
+/*!
+ * \brief   ペイロード送信（バッファ上でマスクする）
+ *
+ * \note    送信後にマスクを戻すので、バッファの内容は変わらない。
+ */
+void WebSocket::sendPayloadInPlace(char* buffer, int32_t len) throw(Exception)
+{
+    if (mIsServer)
+    {
+        Socket::send(buffer, len);
+        return;
+    }
+
+    uint64_t offset = mMaskOffset;
+    StringKernel::mask(buffer, buffer + len, mMaskKey, offset);
+    mMaskOffset += len;
+
+    try
+    {
+        Socket::send(buffer, len);
+    }
+    catch (Exception)
+    {
+        StringKernel::mask(buffer, buffer + len, mMaskKey, offset);
+        throw;
+    }
+
+    StringKernel::mask(buffer, buffer + len, mMaskKey, offset);
 }
 
 /*!
  * \brief   Web Socket ヘッダー送信
+ *
+ * \param[in]   socket      ソケット
+ * \param[in]   payloadLen  データ長
+ * \param[in]   isText      テキストかどうか
+ * \param[in]   toClient    サーバーからクライアントへの送信かどうか
+ * \param[in]   maskingKey  マスキングキー（４バイト、クライアントからサーバーへの送信の場合）
+ *                          nullptrの場合はキーを０にする（データはそのまま送信できる）
  */
-void WebSocket::sendHeader(Socket* socket, uint64_t payloadLen, bool isText, bool toClient) throw(Exception)
+void WebSocket::sendHeader(Socket* socket, uint64_t payloadLen, bool isText, bool toClient, const char* maskingKey) throw(Exception)
 {
     ByteBuffer buffer(2 + 8 + 4);
     char opcode = 0x01;     // text frame
@@ -277,10 +386,8 @@ void WebSocket::sendHeader(Socket* socket, uint64_t payloadLen, bool isText, boo
     // Masking-key
     if (toClient == false)
     {
-        buffer.put((char)0x00);
-        buffer.put((char)0x00);
-        buffer.put((char)0x00);
-        buffer.put((char)0x00);
+        static const char zero[4] = {0, 0, 0, 0};
+        buffer.put(maskingKey ? maskingKey : zero, 4);
     }
 
     socket->Socket::send(&buffer, buffer.getLength());
@@ -320,20 +427,7 @@ void WebSocket::check(uint64_t len, bool isText) throw(Exception)
  */
 void WebSocket::send(const int32_t* value) const throw(Exception)
 {
-    WebSocket* self = (WebSocket*)this;
-    int32_t len = sizeof(*value);
-
-    if (mPayloadLen == 0)
-    {
-        ScopedLock lock(mMutex);
-        sendHeader(self, len, false, mIsServer);
-        Socket::send(value);
-    }
-    else
-    {
-        self->check(len, false);
-        Socket::send(value);
-    }
+    send((const uint32_t*)value);
 }
 
 /*!
@@ -344,16 +438,23 @@ void WebSocket::send(const uint32_t* value) const throw(Exception)
     WebSocket* self = (WebSocket*)this;
     int32_t len = sizeof(*value);
 
+    char buffer[sizeof(*value)];
+    buffer[0] = (char)(*value >> 24);
+    buffer[1] = (char)(*value >> 16);
+    buffer[2] = (char)(*value >>  8);
+    buffer[3] = (char)(*value      );
+
     if (mPayloadLen == 0)
     {
         ScopedLock lock(mMutex);
-        sendHeader(self, len, false, mIsServer);
-        Socket::send(value);
+        self->nextMaskKey();
+        sendHeader(self, len, false, mIsServer, mMaskKey);
+        self->sendPayloadInPlace(buffer, len);
     }
     else
     {
         self->check(len, false);
-        Socket::send(value);
+        self->sendPayloadInPlace(buffer, len);
     }
 }
 
@@ -361,39 +462,51 @@ void WebSocket::send(const uint32_t* value) const throw(Exception)
  * \brief   バイナリ送信
  */
 void WebSocket::send(const Buffer* buffer, int32_t len) const throw(Exception)
+{
+    buffer->validateOverFlow(0, len);
+    send(buffer->getBuffer(), len);
+}
+
+/*!
+ * \brief   バイナリ送信
+ */
+void WebSocket::send(const char* buffer, int32_t len) const throw(Exception)
 {
     WebSocket* self = (WebSocket*)this;
 
     if (mPayloadLen == 0)
     {
         ScopedLock lock(mMutex);
-        sendHeader(self, len, false, mIsServer);
-        Socket::send(buffer, len);
+        self->nextMaskKey();
+        sendHeader(self, len, false, mIsServer, mMaskKey);
+        self->sendPayload(buffer, len);
     }
     else
     {
         self->check(len, false);
-        Socket::send(buffer, len);
+        self->sendPayload(buffer, len);
     }
 }
 
 /*!
- * \brief   バイナリ送信
+ * \brief   バイナリ送信（バッファ上でマスクする）
  */
-void WebSocket::send(const char* buffer, int32_t len) const throw(Exception)
+void WebSocket::send(ByteBuffer* buffer, int32_t len) const throw(Exception)
 {
     WebSocket* self = (WebSocket*)this;
+    buffer->validateOverFlow(0, len);
 
     if (mPayloadLen == 0)
     {
         ScopedLock lock(mMutex);
-        sendHeader(self, len, false, mIsServer);
-        Socket::send(buffer, len);
+        self->nextMaskKey();
+        sendHeader(self, len, false, mIsServer, mMaskKey);
+        self->sendPayloadInPlace(buffer->getBuffer(), len);
     }
     else
     {
         self->check(len, false);
-        Socket::send(buffer, len);
+        self->sendPayloadInPlace(buffer->getBuffer(), len);
     }
 }
 
@@ -408,13 +521,14 @@ void WebSocket::send(const CoreString* str) const throw(Exception)
     if (mPayloadLen == 0)
     {
         ScopedLock lock(mMutex);
-        sendHeader(self, len, true, mIsServer);
-        Socket::send(str, len);
+        self->nextMaskKey();
+        sendHeader(self, len, true, mIsServer, mMaskKey);
+        self->sendPayload(str->getBuffer(), len);
     }
     else
     {
         self->check(len, true);
-        Socket::send(str, len);
+        self->sendPayload(str->getBuffer(), len);
     }
 }
 
@@ -510,12 +624,7 @@ ByteBuffer* WebSocket::recv(Socket* socket, ByteBuffer* dataBuffer) throw(Except
         if (mask)
         {
             char* p2 = dataBuffer->getBuffer();
-
-            for (uint64_t i = 0; i < payloadLen; i++)
-            {
-//              noticeLog("%03u: %02X ^ %02X = %02X", i, (uint8_t)p2[i], (uint8_t)p[i % 4], (uint8_t)(p2[i] ^ p[i % 4]));
-                p2[i] ^= p[i % 4];
-            }
+            StringKernel::mask(p2, p2 + payloadLen, p, 0);
         }
     }
 
@@ -23,6 +23,10 @@
 #include "slog/JavaString.h"
 #include "slog/WebSocketClient.h"
 #include "slog/ByteBuffer.h"
+#include "slog/Mutex.h"
+
+#include <atomic>
+#include <string.h>
 
 #if defined(__ANDROID__)
     #include <android/log.h>
@@ -45,6 +49,17 @@ struct JNINativeMethodEx
     void*       fnPtr;
 };
 
+/*!
+ *  \brief  Java用の呼び出し箇所
+ *
+ *  \note   Log.registerSite() で採番した呼び出し箇所IDを添字とし、登録後は変更しない。
+ */
+static const int32_t JAVA_SITE_MAX = 16384;
+
+static SequenceLogSite*     sJavaSites[JAVA_SITE_MAX];
+static std::atomic<int32_t> sJavaSiteCount(0);
+static Mutex                sJavaSiteMutex;
+
 /*!
  *  \brief  JNIメソッド登録
  */
@@ -88,6 +103,29 @@ static JNIEnv* getJNIEnv()
     return nullptr;
 }
 
+/*!
+ *  \brief  Java文字列をUTF-8でバッファに取得する
+ *
+ *  \return  バッファ（収まらない場合はnullptr）
+ *
+ *  \note   GetStringUTFChars() と違ってコピーを確保しない。
+ */
+static const char* getStringUTF(JNIEnv* env, jstring str, char* buffer, int32_t size)
+{
+    if (str == nullptr)
+        return "(null)";
+
+    jsize utfLen = env->GetStringUTFLength(str);
+
+    if (size <= utfLen)
+        return nullptr;
+
+    env->GetStringUTFRegion(str, 0, env->GetStringLength(str), buffer);
+    buffer[utfLen] = '\0';
+
+    return buffer;
+}
+
 /*
  * Class:     jp_printf_slog_Log
  * Method:    loadConfig
@@ -106,11 +144,121 @@ static void JNICALL loadConfig(JNIEnv* env, jclass, jstring aFileName)
  */
 static jlong JNICALL stepIn1(JNIEnv* env, jclass, jstring aClassName, jstring aFuncName)
 {
+    char classBuffer[256];
+    char funcBuffer[256];
+
+    const char* className = getStringUTF(env, aClassName, classBuffer, sizeof(classBuffer));
+    const char* funcName =  getStringUTF(env, aFuncName,  funcBuffer,  sizeof(funcBuffer));
+
+    if (className == nullptr || funcName == nullptr)
+    {
+        JavaString longClassName(env, aClassName);
+        JavaString longFuncName( env, aFuncName);
+
+        return (jlong)_slog_stepIn(longClassName.getBuffer(), longFuncName.getBuffer());
+    }
+
+    return (jlong)_slog_stepIn(className, funcName);
+}
+
+/*
+ * Class:     jp_printf_slog_Log
+ * Method:    stepInCurrent
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)V
+ *
+ * スレッド毎のフレームスタックに積む（ヒープに確保しない）。
+ * stepOutCurrent() と messageCurrent() はステップインしたスレッドで呼ぶこと。
+ * 別のスレッドでステップアウトする場合はハンドルを返す stepIn() を使う。
+ */
+static void JNICALL stepInCurrent(JNIEnv* env, jclass, jstring aClassName, jstring aFuncName)
+{
+    char classBuffer[256];
+    char funcBuffer[256];
+
+    const char* className = getStringUTF(env, aClassName, classBuffer, sizeof(classBuffer));
+    const char* funcName =  getStringUTF(env, aFuncName,  funcBuffer,  sizeof(funcBuffer));
+
+    if (className == nullptr || funcName == nullptr)
+    {
+        JavaString longClassName(env, aClassName);
+        JavaString longFuncName( env, aFuncName);
+
+        _slog_stepInCurrent(longClassName.getBuffer(), longFuncName.getBuffer());
+        return;
+    }
+
+    _slog_stepInCurrent(className, funcName);
+}
+
+/*
+ * Class:     jp_printf_slog_Log
+ * Method:    stepOutCurrent
+ * Signature: ()V
+ */
+static void JNICALL stepOutCurrent(JNIEnv* env, jclass)
+{
+    _slog_stepOutCurrent();
+}
+
+/*
+ * Class:     jp_printf_slog_Log
+ * Method:    stepIn
+ * Signature: (I)J
+ */
+static jlong JNICALL stepIn4(JNIEnv* env, jclass, jint siteId)
+{
+    if (siteId < 0 || sJavaSiteCount.load(std::memory_order_acquire) <= siteId)
+        return 0;
+
+    return (jlong)_slog_stepInSite(sJavaSites[siteId]);
+}
+
+/*
+ * Class:     jp_printf_slog_Log
+ * Method:    registerSite
+ * Signature: (Ljava/lang/String;Ljava/lang/String;)I
+ */
+static jint JNICALL registerSite(JNIEnv* env, jclass, jstring aClassName, jstring aFuncName)
+{
+    if (aClassName == nullptr || aFuncName == nullptr)
+        return -1;
+
     JavaString className(env, aClassName);
     JavaString funcName( env, aFuncName);
 
-    SequenceLog* slogObj = new SequenceLog(className.getBuffer(), funcName.getBuffer());
-    return (jlong)slogObj;
+    ScopedLock lock(&sJavaSiteMutex);
+    int32_t count = sJavaSiteCount.load(std::memory_order_relaxed);
+
+    // 同じ名前の呼び出し箇所は同じIDにする
+    for (int32_t siteId = 0; siteId < count; siteId++)
+    {
+        const SequenceLogSite* site = sJavaSites[siteId];
+
+        if (strcmp(site->className, className.getBuffer()) == 0 &&
+            strcmp(site->funcName,  funcName. getBuffer()) == 0)
+        {
+            return siteId;
+        }
+    }
+
+    if (JAVA_SITE_MAX <= count)
+        return -1;
+
+    int32_t classLen = className.getLength();
+    int32_t funcLen =  funcName. getLength();
+
+    char* names = new char[classLen + 1 + funcLen + 1];
+    memcpy(names,                className.getBuffer(), classLen + 1);
+    memcpy(names + classLen + 1, funcName. getBuffer(), funcLen  + 1);
+
+    SequenceLogSite* site = new SequenceLogSite();
+    site->className = names;
+    site->funcName =  names + classLen + 1;
+
+    sJavaSites[count] = site;
+    sJavaSiteCount.store(count + 1, std::memory_order_release);
+
+    return count;
 }
 
 /*
@@ -144,8 +292,7 @@ static jlong JNICALL stepIn1(JNIEnv* env, jclass, jstring aClassName, jstring aF
  */
 static void JNICALL stepOut(JNIEnv* env, jclass, jlong slog)
 {
-    SequenceLog* slogObj = (SequenceLog*)slog;
-    delete slogObj;
+    _slog_stepOut((void*)slog);
 }
 
 /*
@@ -156,11 +303,43 @@ static void JNICALL stepOut(JNIEnv* env, jclass, jlong slog)
 static void JNICALL message1(JNIEnv* env, jclass, jint level, jstring aMessage, jlong slog)
 {
     SequenceLog* slogObj = (SequenceLog*)slog;
-    JavaString message(env, aMessage);
 
+    if (slogObj == nullptr || slogObj->isOutput((SequenceLogLevel)level) == false)
+        return;
+
+    char buffer[1024];
+    const char* p = getStringUTF(env, aMessage, buffer, sizeof(buffer));
+
+    if (p)
+    {
+        slogObj->message((SequenceLogLevel)level, "%s", p);
+        return;
+    }
+
+    JavaString message(env, aMessage);
     slogObj->message((SequenceLogLevel)level, "%s", message.getBuffer());
 }
 
+/*
+ * Class:     jp_printf_slog_Log
+ * Method:    messageCurrent
+ * Signature: (ILjava/lang/String;)V
+ */
+static void JNICALL messageCurrent(JNIEnv* env, jclass, jint level, jstring aMessage)
+{
+    char buffer[1024];
+    const char* p = getStringUTF(env, aMessage, buffer, sizeof(buffer));
+
+    if (p)
+    {
+        _slog_messageCurrent(level, "%s", p);
+        return;
+    }
+
+    JavaString message(env, aMessage);
+    _slog_messageCurrent(level, "%s", message.getBuffer());
+}
+
 /*
  * Class:     jp_printf_slog_Log
  * Method:    message
@@ -403,11 +582,16 @@ static void JNICALL ws_sendBinary(JNIEnv* env, jobject thiz, jobject data)
 static JNINativeMethodEx sSlogMethods[] =
 {
     {"loadConfig",        "(Ljava/lang/String;)V",                    (void*)loadConfig       },
-    {"stepIn",            "(Ljava/lang/String;Ljava/lang/String;)J",  (void*)stepIn1          },
+    {"stepInByName",      "(Ljava/lang/String;Ljava/lang/String;)J",  (void*)stepIn1          },
+    {"stepIn",            "(I)J",                                     (void*)stepIn4          },
+    {"registerSite",      "(Ljava/lang/String;Ljava/lang/String;)I",  (void*)registerSite     },
 //  {"stepIn",            "(ILjava/lang/String;)J",                   (void*)stepIn2          },
 //  {"stepIn",            "(II)J",                                    (void*)stepIn3          },
     {"stepOut",           "(J)V",                                     (void*)stepOut          },
+    {"stepInCurrent",     "(Ljava/lang/String;Ljava/lang/String;)V",  (void*)stepInCurrent    },
+    {"stepOutCurrent",    "()V",                                      (void*)stepOutCurrent   },
     {"message",           "(ILjava/lang/String;J)V",                  (void*)message1         },
+    {"messageCurrent",    "(ILjava/lang/String;)V",                   (void*)messageCurrent   },
 //  {"message",           "(IIJ)V",                                   (void*)message2         },
     {"message",           "(ILjava/lang/String;Ljava/lang/String;)V", (void*)message3         },
     {"assertThat",        "(JLjava/lang/String;Z)V",                  (void*)assertThat       },
@@ -1,7 +1,10 @@
 ﻿#pragma execution_character_set("utf-8")
 
+#include "slog/ByteBuffer.h"
+#include "slog/CompressedFile.h"
 #include "slog/Convert.h"
 #include "slog/DateTime.h"
+#include "slog/DateTimeFormat.h"
 #include "slog/Json.h"
 #include "slog/Resource.h"
 #include "slog/PointerString.h"
@@ -9,8 +12,17 @@
 #include "slog/Validate.h"
 #include "slog/SequenceLog.h"
 #include "slog/Thread.h"
+#include "slog/Util.h"
+#include "slog/WebSocket.h"
+
+#include "SequenceLogArchive.h"
+#include "SequenceLogFileReader.h"
+#include "SequenceLogItem.h"
+#include "StringKernel.h"
 
 #include <vector>
+#include <chrono>
+#include <utility>
 
 using namespace slog;
 
@@ -48,6 +60,226 @@ void TestManager::run()
         test->run();
 }
 
+/*!
+ * ByteBufferテスト
+ */
+namespace slog
+{
+class ByteBufferTest : public Test
+{
+            static const char* CLS_NAME;
+
+public:     virtual void run() override;
+
+private:    void test01();
+            void test02();
+};
+
+const char* ByteBufferTest::CLS_NAME = "ByteBufferTest";
+
+void ByteBufferTest::run()
+{
+    test01();
+    test02();
+}
+
+void ByteBufferTest::test01()
+{
+    SLOG(CLS_NAME, "test01");
+    ByteBuffer buffer(32);
+
+    buffer.putVarInt(0);
+    buffer.putVarInt(127);
+    buffer.putVarInt(128);
+    buffer.putVarInt(0xFFFFFFFFFFFFFFFFULL);
+    SASSERT("01", buffer.getPosition() == 1 + 1 + 2 + 10);
+
+    buffer.setPosition(0);
+    SASSERT("02", buffer.getVarInt() == 0);
+    SASSERT("03", buffer.getVarInt() == 127);
+    SASSERT("04", buffer.getVarInt() == 128);
+    SASSERT("05", buffer.getVarInt() == 0xFFFFFFFFFFFFFFFFULL);
+
+    SASSERT("06", ByteBuffer::toZigZag( 0) == 0);
+    SASSERT("07", ByteBuffer::toZigZag(-1) == 1);
+    SASSERT("08", ByteBuffer::toZigZag( 1) == 2);
+    SASSERT("09", ByteBuffer::fromZigZag(ByteBuffer::toZigZag(-123456789)) == -123456789);
+}
+
+void ByteBufferTest::test02()
+{
+    SLOG(CLS_NAME, "test02");
+    ByteBuffer buffer(16);
+
+    ByteBufferWriter writer(&buffer, 8);
+    writer.putShort(0);
+    writer.putInt(0x12345678);
+    writer.putVarInt(300);
+    writer.putShort(0, 8);
+    writer.commit();
+    SASSERT("01", buffer.getPosition() == 8);
+
+    buffer.setPosition(0);
+    ByteBufferReader reader(&buffer, 8);
+    SASSERT("02", reader.getShort() == 8);
+    SASSERT("03", reader.getInt() == 0x12345678);
+    SASSERT("04", reader.getVarInt() == 300);
+
+    bool result = false;
+
+    try
+    {
+        reader.getInt();
+    }
+    catch (Exception)
+    {
+        result = true;
+    }
+
+    SASSERT("05", result);
+}
+}
+
+/*!
+ * シーケンスログファイルのテスト用データ作成
+ */
+namespace slog
+{
+static void createTestRecords(ByteBuffer* records, std::vector<int32_t>* offsets, int32_t count)
+{
+    SequenceLogItem item;
+    SequenceLogByteBuffer record(0xFFFF);
+    int64_t time = 1404604800LL * 1000 * 1000 * 1000;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        switch (i % 3)
+        {
+        case 0:  item.init(i / 3, "TestClass", "testFunc");   break;
+        case 1:  item.init(i / 3, (SequenceLogLevel)(i % 4)); item.getMessage()->format("message %d", i); break;
+        default: item.init(i / 3);                            break;
+        }
+
+        item.mThreadId = 100 + i % 5;
+        item.mDateTime.setEpochNanoSeconds(time + (int64_t)i * 1000 * 1000);
+
+        int32_t size = (int32_t)record.putSequenceLogItem(&item, true);
+
+        offsets->push_back(records->getPosition());
+        records->put(&record, size);
+    }
+
+    records->setLength(records->getPosition());
+}
+
+static void writeTestFile(const char* fileName, const ByteBuffer* records, int32_t size)
+{
+    String path = fileName;
+    File file;
+    file.open(&path, File::WRITE);
+    file.write(records, size);
+    file.close();
+}
+
+static bool existsTestFile(const char* fileName)
+{
+    String path = fileName;
+    File file;
+
+    try
+    {
+        file.open(&path, File::READ);
+        file.close();
+        return true;
+    }
+    catch (Exception)
+    {
+        return false;
+    }
+}
+
+static bool readTestFile(CompressedFile* file, int64_t position, const ByteBuffer* records)
+{
+    int64_t remains = records->getLength() - position;
+    ByteBuffer buffer(CompressedFile::BLOCK_SIZE);
+
+    if (file->setRawPosition(position) != position)
+        return false;
+
+    while (0 < remains)
+    {
+        int64_t len = file->read(&buffer, (remains < buffer.getCapacity() ? remains : buffer.getCapacity()));
+
+        if (len <= 0 || memcmp(buffer.getBuffer(), records->getBuffer() + position, (size_t)len) != 0)
+            return false;
+
+        position += len;
+        remains -= len;
+    }
+
+    return true;
+}
+}
+
+/*!
+ * CompressedFileテスト
+ */
+namespace slog
+{
+class CompressedFileTest : public Test
+{
+            static const char* CLS_NAME;
+
+public:     virtual void run() override;
+
+private:    void test01();
+};
+
+const char* CompressedFileTest::CLS_NAME = "CompressedFileTest";
+
+void CompressedFileTest::run()
+{
+    test01();
+}
+
+/*!
+ * SLZ1形式（.slogz）の書き込み、読み込み、シーク
+ */
+void CompressedFileTest::test01()
+{
+    SLOG(CLS_NAME, "test01");
+    ByteBuffer records(1024 * 1024);
+    std::vector<int32_t> offsets;
+    createTestRecords(&records, &offsets, 10000);
+
+    String path = "CompressedFileTest.slogz";
+    CompressedFile file;
+    file.setSequenceLog(true);
+    file.open(&path, File::WRITE);
+
+    for (int32_t i = 0; i < (int32_t)offsets.size(); i++)
+    {
+        int32_t next = (i + 1 < (int32_t)offsets.size() ? offsets[i + 1] : records.getLength());
+        ByteBuffer record(next - offsets[i]);
+        record.put(records.getBuffer() + offsets[i], next - offsets[i]);
+        file.write(&record, next - offsets[i]);
+    }
+
+    file.close();
+
+    file.open(&path, File::READ);
+    SASSERT("01", file.getRawSize() == records.getLength());
+    SASSERT("02", file.getSize() < records.getLength());
+    SASSERT("03", readTestFile(&file, 0, &records));
+    SASSERT("04", readTestFile(&file, CompressedFile::BLOCK_SIZE + 123, &records));
+    SASSERT("05", readTestFile(&file, offsets[5000], &records));
+    SASSERT("06", readTestFile(&file, 7, &records));
+    file.close();
+
+    File::unlink(&path);
+}
+}
+
 /*!
  * Convertテスト
  */
@@ -183,6 +415,7 @@ public:     virtual void run() override;
 
 private:    void test01();
             void test02();
+            void test03();
 
             void output(const char* title,const DateTime* dateTime);
 };
@@ -193,6 +426,7 @@ void DateTimeTest::run()
 {
     test01();
     test02();
+    test03();
 }
 
 void DateTimeTest::test01()
@@ -230,6 +464,41 @@ void DateTimeTest::test02()
     SASSERT("05", dateTime.getWeekDay() == 0);  // 日曜日
 }
 
+void DateTimeTest::test03()
+{
+    SLOG(CLS_NAME, "test03");
+    DateTime dateTime;
+    String str;
+
+    SASSERT("01", dateTime.getValue() == 0);
+
+    dateTime.setTime_t(1404604800, 5);     // 2014/07/06 00:00:00.005
+    DateTimeFormat::toString(&str, dateTime, DateTimeFormat::Format::YYYYMMDDHHMISSMS);
+    SASSERT("02", str.equals("2014/07/06 00:00:00.005"));
+
+    // 同じ秒の間はミリ秒だけ変わる
+    dateTime.setTime_t(1404604800, 999);
+    DateTimeFormat::toString(&str, dateTime, DateTimeFormat::Format::YYYYMMDDHHMISSMS);
+    SASSERT("03", str.equals("2014/07/06 00:00:00.999"));
+
+    dateTime.setTime_t(1404604800 + 86400 + 3600 + 60 + 1);
+    DateTimeFormat::toString(&str, dateTime, DateTimeFormat::Format::YYYYMMDDHHMISSMS);
+    SASSERT("04", str.equals("2014/07/07 01:01:01.000"));
+
+    DateTimeFormat::toString(&str, dateTime, DateTimeFormat::Format::HHMI);
+    SASSERT("05", str.equals("01:01"));
+
+    DateTime dateTime2;
+    dateTime2.setValue(dateTime.getValue());
+    SASSERT("06", dateTime2.getEpochNanoSeconds() == dateTime.getEpochNanoSeconds());
+    SASSERT("07", dateTime.toMilliSeconds() == (1404604800LL + 86400 + 3600 + 60 + 1) * 1000);
+
+    // コンストラクタは setValue(0) と同じ値になる
+    DateTime dateTime3;
+    dateTime2.setValue(0);
+    SASSERT("08", (dateTime3.getValue() == 0 && dateTime3.getEpochNanoSeconds() == dateTime2.getEpochNanoSeconds()));
+}
+
 void DateTimeTest::output(const char* title,const DateTime* dateTime)
 {
     SLOG(CLS_NAME, "output");
@@ -447,6 +716,105 @@ void ResourceTest::test04()
 }
 }
 
+/*!
+ * SequenceLogArchiveテスト
+ */
+namespace slog
+{
+class SequenceLogArchiveTest : public Test
+{
+            static const char* CLS_NAME;
+
+public:     virtual void run() override;
+
+private:    void test01();
+            void test02();
+};
+
+const char* SequenceLogArchiveTest::CLS_NAME = "SequenceLogArchiveTest";
+
+void SequenceLogArchiveTest::run()
+{
+    test01();
+    test02();
+}
+
+/*!
+ * アーカイブ作成、展開、シーク
+ */
+void SequenceLogArchiveTest::test01()
+{
+    SLOG(CLS_NAME, "test01");
+    ByteBuffer records(1024 * 1024);
+    std::vector<int32_t> offsets;
+    createTestRecords(&records, &offsets, 10000);
+    writeTestFile("SequenceLogArchiveTest01.slog", &records, records.getLength());
+
+    String logPath =     "SequenceLogArchiveTest01.slog";
+    String archivePath = "SequenceLogArchiveTest01.sloga";
+    SequenceLogArchive::create(&logPath, &archivePath);
+
+    SequenceLogArchive archive;
+    archive.open(&archivePath);
+    SASSERT("01", archive.getRawSize() == records.getLength());
+    SASSERT("02", archive.getGroupCount() == 3);
+    SASSERT("03", (archive.getGroup(1)->rawPosition == offsets[4096] && archive.getGroup(1)->count == 4096));
+    archive.close();
+
+    CompressedFile file;
+    file.open(&archivePath, File::READ);
+    SASSERT("04", file.getRawSize() == records.getLength());
+    SASSERT("05", readTestFile(&file, 0, &records));
+    SASSERT("06", readTestFile(&file, offsets[4096], &records));
+    SASSERT("07", readTestFile(&file, offsets[9000] + 5, &records));
+    file.close();
+
+    // レコード単位で読み込み、途中のレコードへ移動
+    SequenceLogFileReader reader;
+    SequenceLogItem item;
+    reader.open(&archivePath);
+    reader.setPosition(offsets[8195]);
+    SASSERT("08", (reader.read(&item) && item.mSeqNo == 8195 / 3 && item.mType == SequenceLogItem::STEP_OUT && item.mThreadId == 100 + 8195 % 5));
+    SASSERT("09", reader.getPosition() == offsets[8196]);
+    reader.close();
+
+    File::unlink(&logPath);
+    File::unlink(&archivePath);
+}
+
+/*!
+ * 末尾のレコードが不完全な場合はアーカイブを作成しない
+ */
+void SequenceLogArchiveTest::test02()
+{
+    SLOG(CLS_NAME, "test02");
+    ByteBuffer records(64 * 1024);
+    std::vector<int32_t> offsets;
+    createTestRecords(&records, &offsets, 100);
+    writeTestFile("SequenceLogArchiveTest02.slog", &records, offsets[99] + 3);
+
+    String logPath =     "SequenceLogArchiveTest02.slog";
+    String archivePath = "SequenceLogArchiveTest02.sloga";
+    bool result = false;
+
+    try
+    {
+        SequenceLogArchive::create(&logPath, &archivePath);
+    }
+    catch (Exception)
+    {
+        result = true;
+    }
+
+    SASSERT("01", result);
+    SASSERT("02", existsTestFile("SequenceLogArchiveTest02.slog"));
+    SASSERT("03", existsTestFile("SequenceLogArchiveTest02.sloga") == false);
+    SASSERT("04", existsTestFile("SequenceLogArchiveTest02.sloga.tmp") == false);
+
+    File::unlink(&logPath);
+}
+}
+
 /*!
  * Stringテスト
  */
@@ -461,6 +829,9 @@ public:     virtual void run() override;
 private:    void test01();
             void test02();
             void test03();
+            void test04();
+            void test05();
+            void test06();
 };
 
 const char* StringTest::CLS_NAME = "StringTest";
@@ -470,6 +841,9 @@ void StringTest::run()
     test01();
     test02();
     test03();
+    test04();
+    test05();
+    test06();
 }
 
 void StringTest::test01()
@@ -533,6 +907,311 @@ void StringTest::test03()
         SASSERT("02", true);
     }
 }
+
+void StringTest::test04()
+{
+    SLOG(CLS_NAME, "test04");
+
+    String str1 = "12345";
+    SASSERT("01", str1.isInline());
+
+    str1.copy("12345678901234567890123456789012");
+    SASSERT("02", (str1.isInline() == false && str1.getCapacity() == 32));
+
+    const char* p = str1.getBuffer();
+    String str2 = std::move(str1);
+    SASSERT("03", (str2.getBuffer() == p && str2.equals("12345678901234567890123456789012")));
+    SASSERT("04", (str1.getLength() == 0 && str1.isInline()));
+
+    str1 = std::move(str2);
+    SASSERT("05", (str1.getBuffer() == p && str2.getLength() == 0));
+
+    str2.copy("abc");
+    str1 = std::move(str2);
+    SASSERT("06", (str1.equals("abc") && str1.isInline()));
+
+    String str3(str1);
+    str3.setCapacity(100);
+    str3.setCapacity(3);
+    SASSERT("07", (str3.equals("abc") && str3.isInline()));
+}
+
+void StringTest::test05()
+{
+    SLOG(CLS_NAME, "test05");
+
+    // ベクトル幅（16、32バイト）をまたぐ長さで検索する
+    String str = "0123456789abcdef0123456789abcdef0123456789abcdef-xyz-0123456789abcdef";
+    SASSERT("01", (str.indexOf("-xyz-") == 48));
+    SASSERT("02", (str.indexOf("cdef0", 20) == 28));
+    SASSERT("03", (str.indexOf("-xyz-", 0, 52) == -1));
+    SASSERT("04", (str.lastIndexOf("abcdef") == 63));
+    SASSERT("05", (str.lastIndexOf("abcdef", 40) == 42));
+    SASSERT("06", (str.lastIndexOf("-xyz-", 60) == 48));
+    SASSERT("07", (str.lastIndexOf("zzz") == -1));
+
+    str.copy(u8"あいうえおかきくけこさしすせそたちつてとabcdefghijklmnopqrstuvwxyz");
+    SASSERT("08", (str.getCharacters() == 46));
+
+    str.copy("0123456789abcdef0123456789abcdef<a href=\"x\">&</a>\n");
+    Util::encodeHtml(&str);
+    SASSERT("09", str.equals("0123456789abcdef0123456789abcdef&lt;a href=&quot;x&quot;&gt;&amp;&lt;/a&gt;<br />"));
+
+    str.copy("0123456789abcdef0123456789abcdef%E3%81%82+b%2Bc");
+    Util::decodePercent(&str);
+    SASSERT("10", str.equals(u8"0123456789abcdef0123456789abcdefあ b+c"));
+}
+
+void StringTest::test06()
+{
+    SLOG(CLS_NAME, "test06");
+
+    String str;
+    String name = "slog";
+
+    str.format("%c%d %s %05u %-4s| %x %08.3f %lld", 'n', -12, &name, 42u, name, 255, -3.14159, (int64_t)-9000000000LL);
+    SASSERT("01", str.equals("n-12 slog 00042 slog| ff -003.142 -9000000000"));
+
+    str.format("%.*s %*d %%", 2, "abcdef", 4, 7);
+    SASSERT("02", str.equals("ab    7 %"));
+
+    // 容量を超える場合は結果の長さちょうどで確保する
+    String str2;
+    str2.format("%s%s%s", "0123456789", "0123456789", "0123456789abcdef");
+    SASSERT("03", (str2.getLength() == 36 && str2.getCapacity() == 36));
+
+    try
+    {
+        str.format("%d %s", 1);
+        SASSERT("04", false);
+    }
+    catch (Exception e)
+    {
+        SMSG(slog::INFO, e.getMessage());
+        SASSERT("04", true);
+    }
+
+    try
+    {
+        str.format("%d", "1");
+        SASSERT("05", false);
+    }
+    catch (Exception e)
+    {
+        SMSG(slog::INFO, e.getMessage());
+        SASSERT("05", true);
+    }
+}
+}
+
+/*!
+ * ログ整形ベンチマーク
+ */
+namespace slog
+{
+class SequenceLogBenchmark : public Test
+{
+            static const char* CLS_NAME;
+
+public:     virtual void run() override;
+};
+
+const char* SequenceLogBenchmark::CLS_NAME = "SequenceLogBenchmark";
+
+/*!
+ * SequenceLogClient::createItem() / SequenceLog::messageArgs() / SequenceLogClient::sendItem() と同じ手順で
+ * アイテムの生成、メッセージの整形、バイトバッファへの格納を行う（ソケット送信のみ行わない）
+ */
+void SequenceLogBenchmark::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    const int32_t count = 1000000;
+    int64_t bytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        SequenceLogItem* item = new SequenceLogItem;
+        item->mThreadId = Thread::getCurrentId();
+        item->init(i, DEBUG);
+        item->getMessage()->format("count=%d, name=%s", i, CLS_NAME);
+
+        uint32_t capacity =
+            sizeof(int16_t) +
+            sizeof(SequenceLogItemCore) +
+            sizeof(int16_t) + item->getClassName()->getLength() +
+            sizeof(int16_t) + item->getFuncName()-> getLength() +
+            sizeof(int16_t) + item->getMessage()->  getLength();
+
+        SequenceLogByteBuffer buffer(capacity);
+        bytes += buffer.putSequenceLogItem(item);
+
+        delete item;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    int64_t usec = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    SMSG(slog::INFO, "%d items: %lld us (%lld ns/item), %lld bytes",
+        count, (long long)usec, (long long)(usec * 1000 / count), (long long)bytes);
+
+    SASSERT("01", (0 < bytes));
+}
+}
+
+/*!
+ * WebSocketテスト
+ */
+namespace slog
+{
+class WebSocketTest : public Test
+{
+            static const char* CLS_NAME;
+
+public:     virtual void run() override;
+
+private:    void test01();
+            void test02();
+};
+
+const char* WebSocketTest::CLS_NAME = "WebSocketTest";
+
+void WebSocketTest::run()
+{
+    test01();
+    test02();
+}
+
+void WebSocketTest::test01()
+{
+    SLOG(CLS_NAME, "test01");
+
+    // 各カーネルで、ベクトル幅（16、32、64バイト）に揃わない長さ・開始位置・オフセットをスカラーの結果と比べる
+    const char* names[] = {"scalar", "sse2", "avx2"};
+    const char key[] = {0x12, (char)0x9A, 0x5C, (char)0xE7};
+    const int32_t lengths[] = {0, 1, 3, 7, 15, 17, 31, 33, 63, 65, 127, 131, 1001};
+
+    for (auto name : names)
+    {
+        if (StringKernel::select(name) == false)
+        {
+            SMSG(slog::INFO, "%s is not supported", name);
+            continue;
+        }
+
+        bool result = true;
+
+        for (auto len : lengths)
+        {
+            for (int32_t start = 0; start < 4; start++)
+            {
+                for (uint64_t offset = 0; offset < 5; offset++)
+                {
+                    std::vector<char> data(start + len + 4);
+                    std::vector<char> expected;
+
+                    for (int32_t i = 0; i < (int32_t)data.size(); i++)
+                        data[i] = (char)(i * 31 + len);
+
+                    expected = data;
+
+                    for (int32_t i = 0; i < len; i++)
+                        expected[start + i] ^= key[(offset + i) & 3];
+
+                    char* p = &data[0] + start;
+                    StringKernel::mask(p, p + len, key, offset);
+
+                    if (data != expected)
+                        result = false;
+                }
+            }
+        }
+
+        SMSG(slog::INFO, "%s", name);
+        SASSERT("01", result);
+    }
+
+    StringKernel::select(nullptr);
+}
+
+/*!
+ * クライアント（送信時にマスクする）
+ */
+class WebSocketTestClient : public WebSocket
+{
+public:     WebSocketTestClient() : WebSocket(false) {}
+};
+
+void WebSocketTest::test02()
+{
+    SLOG(CLS_NAME, "test02");
+
+    const unsigned short port = 58090;
+
+    Socket::startup();
+
+    Socket server;
+    server.open();
+    server.setReUseAddress(true);
+    server.bind(port);
+    server.listen();
+
+    WebSocketTestClient client;
+    String host = "127.0.0.1";
+    client.open();
+    client.connect(&host, port);
+
+    Socket socket;
+    socket.accept(&server);
+
+    // その場でマスクして送信したバッファは元に戻っていること
+    const int32_t len = 1001;
+    ByteBuffer buffer(len);
+    std::vector<char> original(len);
+
+    for (int32_t i = 0; i < len; i++)
+        original[i] = buffer.getBuffer()[i] = (char)(i * 7);
+
+    client.send(&buffer, len);
+    SASSERT("01", (memcmp(buffer.getBuffer(), &original[0], len) == 0));
+
+    ByteBuffer* received = WebSocket::recv(&socket, nullptr);
+    SASSERT("02", (received && received->getCapacity() == len && memcmp(received->getBuffer(), &original[0], len) == 0));
+    delete received;
+
+    // １つのフレームを奇数長に分けて送信した場合、キーの位置が引き継がれること
+    uint32_t value = 0x01020304;
+    client.sendHeader(3 + len + sizeof(value) + 5, false);
+    client.send("abc", 3);
+    client.send(&buffer, len);
+    client.send(&value);
+    client.send("defgh", 5);
+    SASSERT("03", (memcmp(buffer.getBuffer(), &original[0], len) == 0));
+
+    received = WebSocket::recv(&socket, nullptr);
+    bool result = (received && received->getCapacity() == 3 + len + (int32_t)sizeof(value) + 5);
+
+    if (result)
+    {
+        const char* p = received->getBuffer();
+        result =
+            memcmp(p,            "abc",        3)   == 0 &&
+            memcmp(p + 3,        &original[0], len) == 0 &&
+            memcmp(p + 3 + len + sizeof(value), "defgh", 5) == 0;
+
+        received->setPosition(3 + len);
+        result = result && (received->getInt() == (int32_t)value);
+    }
+
+    SASSERT("04", result);
+    delete received;
+
+    socket.close();
+    client.close();
+    server.close();
+}
 }
 
 /*!
@@ -639,12 +1318,17 @@ int main()
 //  SLOG("test.cpp", "main");
 
     TestManager testManager;
+    testManager.add(new ByteBufferTest);
+    testManager.add(new CompressedFileTest);
 //  testManager.add(new ConvertTest);
-//  testManager.add(new DateTimeTest);
+    testManager.add(new DateTimeTest);
     testManager.add(new JsonTest);
 //  testManager.add(new ResourceTest);
-//  testManager.add(new StringTest);
+    testManager.add(new SequenceLogArchiveTest);
+    testManager.add(new StringTest);
 //  testManager.add(new ValidateTest);
+    testManager.add(new WebSocketTest);
+//  testManager.add(new SequenceLogBenchmark);
     testManager.run();
 
     Thread::sleep(2000);
@@ -10,6 +10,7 @@
         this.logFileListUpdateCallback = null;
         this.logViews = [];                     // シーケンスログビューの配列
         this.logBuffer = null;
+        this.tailCallback = null;               // シーケンスログ追跡コールバック
     };
 
     SequenceLogService.prototype =
@@ -27,6 +28,7 @@
             // WebSocket
             var protocol = (('http:' === document.location.protocol) ? 'ws://' : 'wss://');
             this.ws = new WebSocket(protocol + domain + '/getLog');
+            this.ws.binaryType = 'arraybuffer';
             var self = this;
 
             this.ws.onmessage = function(e) {onMessage(self, e.data);};
@@ -53,6 +55,72 @@
             dataView.setUint32(8, len);     // ファイル名の長さ
             exports.slog.utils.setStringToDataView(dataView, 12, fileName);
 
+            this.ws.send(dataView.buffer);
+        },
+
+        // シーケンスログを途中（position バイト目）からSequenceLog.exeに送信する
+        resumeLog: function(i, fileName, position)
+        {
+            var len = exports.slog.utils.getStringBytes(fileName) + 1;
+            var buffer = new ArrayBuffer(4 + 4 + 4 + len + 8);
+            var dataView = new DataView(buffer);
+
+            dataView.setUint32(0, 2);       // コマンドNo
+            dataView.setUint32(4, i);       // インデックス
+            dataView.setUint32(8, len);     // ファイル名の長さ
+            exports.slog.utils.setStringToDataView(dataView, 12, fileName);
+
+            // 送信開始位置（64ビット）
+            dataView.setUint32(12 + len,     Math.floor(position / 0x100000000));
+            dataView.setUint32(12 + len + 4, position % 0x100000000);
+
+            this.ws.send(dataView.buffer);
+        },
+
+        // シーケンスログを position バイト目から追跡する
+        // 既存の内容に続けて追記された内容を受信し、ローテーションされたら次のファイルに切り替わる
+        // callback(fileName) はファイル切り替え時、callback(null, position, data) は受信時に呼ばれる
+        // 受信したバイト数は ackLog() で通知しなければ window バイトを超えて送信されない
+        followLog: function(i, fileName, position, window, callback)
+        {
+            var len = exports.slog.utils.getStringBytes(fileName) + 1;
+            var buffer = new ArrayBuffer(4 + 4 + 4 + len + 8 + 4);
+            var dataView = new DataView(buffer);
+
+            dataView.setUint32(0, 3);       // コマンドNo
+            dataView.setUint32(4, i);       // インデックス
+            dataView.setUint32(8, len);     // ファイル名の長さ
+            exports.slog.utils.setStringToDataView(dataView, 12, fileName);
+
+            // 送信開始位置（64ビット）
+            dataView.setUint32(12 + len,     Math.floor(position / 0x100000000));
+            dataView.setUint32(12 + len + 4, position % 0x100000000);
+
+            // ウィンドウサイズ
+            dataView.setUint32(12 + len + 8, window);
+
+            this.tailCallback = callback;
+            this.ws.send(dataView.buffer);
+        },
+
+        // 追跡で受信したバイト数を通知する
+        ackLog: function(bytes)
+        {
+            var dataView = new DataView(new ArrayBuffer(4 + 4));
+
+            dataView.setUint32(0, 4);       // コマンドNo
+            dataView.setUint32(4, bytes);   // 受信したバイト数
+
+            this.ws.send(dataView.buffer);
+        },
+
+        // シーケンスログの追跡を終了する
+        unfollowLog: function()
+        {
+            var dataView = new DataView(new ArrayBuffer(4));
+            dataView.setUint32(0, 5);       // コマンドNo
+
+            this.tailCallback = null;
             this.ws.send(dataView.buffer);
         }
     };
@@ -66,6 +134,18 @@
     // WebSocket受信ハンドラ
     function onMessage(service, msg)
     {
+        // 追跡中のシーケンスログ（バイナリ）
+        if (msg instanceof ArrayBuffer)
+        {
+            var dataView = new DataView(msg);
+            var position = dataView.getUint32(4) * 0x100000000 + dataView.getUint32(8);
+
+            if (service.tailCallback)
+                service.tailCallback(null, position, new Uint8Array(msg, 4 + 8));
+
+            return;
+        }
+
         var cmd = msg.substring(0, 4);
 
         // シーケンスログファイル一覧更新
@@ -88,6 +168,13 @@
             for (var i = 0; i < service.logViews.length; i++)
                 service.logViews[i].onUpdateBuffer(level, message, removeCount);
         }
+
+        // 追跡中のシーケンスログファイル切り替え
+        else if (cmd === '0004')
+        {
+            if (service.tailCallback)
+                service.tailCallback(msg.slice(4));
+        }
     }
 
     // 初期設定
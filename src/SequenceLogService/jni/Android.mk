@@ -7,6 +7,7 @@ LOCAL_MODULE	:= slogsvc
 LOCAL_SRC_FILES	:= \
 	../src/main.cpp \
 	../src/getSequenceLogListJson.cpp \
+	../src/getSequenceLogItemJson.cpp \
 	../src/Account.cpp \
 	../src/AccountResponse.cpp \
 	../src/GetLogResponse.cpp \
@@ -19,6 +20,14 @@ LOCAL_SRC_FILES	:= \
 	../src/SequenceLogServiceWebServer.cpp \
 	../src/SequenceLogServiceWebServerResponse.cpp \
 	../src/SQLite.cpp \
+	../src/SitesResponse.cpp \
+	../src/LogLevelResponse.cpp \
+	../src/StatisticsResponse.cpp \
+	../src/SequenceLogStatistics.cpp \
+	../src/MergeLogResponse.cpp \
+	../src/SequenceLogArchiver.cpp \
+	../src/SequenceLogIndexBuilder.cpp \
+	../src/SearchLogResponse.cpp \
 	../src/sqlite3/sqlite3.c
 
 LOCAL_C_INCLUDES += \
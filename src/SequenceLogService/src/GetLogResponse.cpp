@@ -27,6 +27,7 @@
 #include "slog/HttpRequest.h"
 #include "slog/ByteBuffer.h"
 #include "slog/File.h"
+#include "slog/CompressedFile.h"
 #include "slog/WebSocket.h"
 #include "slog/Mutex.h"
 #include "slog/FileInfo.h"
@@ -47,45 +48,89 @@ class SendSequenceLogThread : public Thread
             uint16_t    mPort;
             String      mLogFilePath;
 
+            /*!
+             * 送信開始位置（-1の場合は従来の32ビットサイズのプロトコル）
+             */
+            int64_t     mPosition;
+
             /*!
              * コンストラクタ
              */
-public:     SendSequenceLogThread(const CoreString* ip, uint16_t port, const CoreString* path);
+public:     SendSequenceLogThread(const CoreString* ip, uint16_t port, const CoreString* path, int64_t position = -1);
 
             /*!
              * スレッド実行
              */
 private:    virtual void run() override;
+
+            /*!
+             * 圧縮ファイルを展開しながら送信
+             */
+            static int64_t sendCompressedFile(Socket* socket, CompressedFile* file, int64_t position, int64_t count) throw(Exception);
 };
 
 /*!
  * \brief   コンストラクタ
  */
-SendSequenceLogThread::SendSequenceLogThread(const CoreString* ip, uint16_t port, const CoreString* path)
+SendSequenceLogThread::SendSequenceLogThread(const CoreString* ip, uint16_t port, const CoreString* path, int64_t position)
 {
     mIP.copy(ip);
     mPort = port;
     mLogFilePath.copy(path);
+    mPosition = position;
 }
 
 /*!
  * \brief   実行
+ *
+ * \note    [ファイル名の長さ(4)][ファイル名][サイズ(4)][ファイル内容] を送信する。
+ *          送信開始位置が指定されている場合は
+ *          [ファイル名の長さ(4)][ファイル名][送信開始位置(8)][サイズ(8)][ファイル内容] を送信する。
+ *          いずれもファイル全体をメモリに読み込まず、少しずつ送信する。
  */
 void SendSequenceLogThread::run()
 {
-    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
-    bool result = false;
-
     String name = strrchr(mLogFilePath.getBuffer(), PATH_DELIMITER) + 1;
+    bool compressed = CompressedFile::isCompressedFileName(&mLogFilePath);
+
+    // 圧縮ファイルは展開して送信するので、ビューアーには非圧縮の拡張子で通知する
+    if (compressed)
+        name.deleteLast();
+
     int32_t len = name.getLength();
 
     try
     {
-        // ファイルオープン
-        File file;
-        file.open(&mLogFilePath, File::READ);
+        // ファイルサイズ取得
+        CompressedFile compressedFile;
+        int64_t size;
 
-        result = true;
+        if (compressed)
+        {
+            compressedFile.open(&mLogFilePath, File::READ);
+            size = compressedFile.getRawSize();
+        }
+        else
+        {
+            File file;
+            file.open(&mLogFilePath, File::READ);
+            size = file.getSize();
+        }
+
+        int64_t position = (mPosition < 0 ? 0 : mPosition);
+
+        if (size < position)
+            position = size;
+
+        int64_t count = size - position;
+
+        if (mPosition < 0 && 0x7FFFFFFF < count)
+        {
+            Exception e;
+            e.setMessage("SendSequenceLogThread: '%s' is too large for 32 bit size protocol", name.getBuffer());
+
+            throw e;
+        }
 
         // ソケット準備
         Socket viewerSocket;
@@ -97,14 +142,22 @@ void SendSequenceLogThread::run()
         viewerSocket.send(&name, len);
 
         // ファイルサイズ送信
-        int32_t size = (int32_t)file.getSize();
-        viewerSocket.send(&size);
+        if (mPosition < 0)
+        {
+            int32_t size32 = (int32_t)count;
+            viewerSocket.send(&size32);
+        }
+        else
+        {
+            viewerSocket.send(&position);
+            viewerSocket.send(&count);
+        }
 
         // ファイル内容送信
-        ByteBuffer buffer(size);
-
-        file.read(        &buffer, size);
-        viewerSocket.send(&buffer, size);
+        if (compressed)
+            sendCompressedFile(&viewerSocket, &compressedFile, position, count);
+        else
+            viewerSocket.sendFile(&mLogFilePath, position, count);
 
         // ステータス受信
         int32_t status;
@@ -112,7 +165,7 @@ void SendSequenceLogThread::run()
 
         // 後始末
         viewerSocket.close();
-        file.close();
+        compressedFile.close();
     }
     catch (Exception& e)
     {
@@ -120,12 +173,169 @@ void SendSequenceLogThread::run()
     }
 }
 
+/*!
+ * \brief   圧縮ファイルを展開しながら送信
+ *
+ * \param[in]   socket      ソケット
+ * \param[in]   file        圧縮ファイル
+ * \param[in]   position    送信開始位置（展開後）
+ * \param[in]   count       送信するバイト数（展開後）
+ *
+ * \return  送信したバイト数
+ */
+int64_t SendSequenceLogThread::sendCompressedFile(Socket* socket, CompressedFile* file, int64_t position, int64_t count) throw(Exception)
+{
+    ByteBuffer buffer(CompressedFile::BLOCK_SIZE);
+    int64_t remains = count;
+
+    // 送信開始位置まで読み飛ばす
+    if (file->setRawPosition(position) != position)
+        return 0;
+
+    while (0 < remains)
+    {
+        int64_t len = (remains < buffer.getCapacity() ? remains : buffer.getCapacity());
+        int32_t readLen = (int32_t)file->read(&buffer, len);
+
+        if (readLen <= 0)
+            break;
+
+        socket->send(&buffer, readLen);
+        remains -= readLen;
+    }
+
+    return count - remains;
+}
+
+/*!
+ * \brief   シーケンスログ追跡ファイル
+ *
+ * \note    書き込み中のシーケンスログファイルを読み込み専用で開き、追記された分を順次読み込む。
+ *          ビューアーから受け取ったクレジット（バイト数）を超えては読み込まない。
+ */
+class TailLogFile
+{
+            File            mFile;
+            CompressedFile  mCompressedFile;
+            bool            mCompressed;
+
+            /*!
+             * 読み込み位置（圧縮ファイルの場合は展開後の位置）
+             */
+            int64_t         mPosition;
+
+            /*!
+             * 送信可能なバイト数
+             */
+            int64_t         mCredit;
+
+            /*!
+             * 前回の読み込みでファイルの終端に達したかどうか
+             */
+            bool            mEOF;
+
+            /*!
+             * コンストラクタ
+             */
+public:     TailLogFile()
+            {
+                mCompressed = false;
+                mPosition = 0;
+                mCredit = 0;
+                mEOF = false;
+            }
+
+            /*!
+             * オープン
+             */
+            void open(const CoreString* path, int64_t position) throw(Exception);
+
+            /*!
+             * 読み込み
+             */
+            int64_t read(Buffer* buffer, int64_t count) throw(Exception);
+
+            int64_t getPosition() const {return mPosition;}
+            int64_t getCredit() const {return mCredit;}
+            void addCredit(int64_t credit) {mCredit += credit;}
+            bool isEOF() const {return mEOF;}
+};
+
+/*!
+ * \brief   オープン
+ *
+ * \param[in]   path        パス
+ * \param[in]   position    読み込み開始位置（ファイルより大きい場合は終端から）
+ *
+ * \return  なし
+ */
+void TailLogFile::open(const CoreString* path, int64_t position) throw(Exception)
+{
+    mFile.close();
+    mCompressedFile.close();
+
+    mCompressed = CompressedFile::isCompressedFileName(path);
+    mEOF = false;
+
+    if (mCompressed)
+    {
+        mCompressedFile.open(path, File::READ);
+        mPosition = mCompressedFile.setRawPosition(position);
+    }
+    else
+    {
+        mFile.open(path, File::READ);
+        int64_t size = mFile.getSize();
+
+        mPosition = (size < position ? size : position);
+    }
+}
+
+/*!
+ * \brief   読み込み
+ *
+ * \param[out]  buffer  読み込んだデータを受け取るバッファ
+ * \param[in]   count   読み込むバイト数
+ *
+ * \return  読み込んだバイト数
+ */
+int64_t TailLogFile::read(Buffer* buffer, int64_t count) throw(Exception)
+{
+    if (mCredit < count)
+        count = mCredit;
+
+    if (count <= 0)
+        return 0;
+
+    int64_t len;
+
+    if (mCompressed)
+    {
+        len = mCompressedFile.read(buffer, count);
+    }
+    else
+    {
+        // 一度終端に達するとそれ以降の追記を読めないので、毎回位置を設定し直す
+        mFile.setPosition(mPosition);
+        len = mFile.read(buffer, count);
+    }
+
+    mPosition += len;
+    mCredit -= len;
+    mEOF = (len < count);
+
+    return len;
+}
+
 /*!
  * \brief   コンストラクタ
  */
 GetLogResponse::GetLogResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest)
 {
     mSendSequenceLogThread = nullptr;
+    mTailLogFile = nullptr;
+    mTailWriter = nullptr;
+    mTailUpdated = false;
 }
 
 /*!
@@ -160,11 +370,14 @@ void GetLogResponse::run()
 
         while (true)
         {
-            bool isReceive = socket->isReceiveData(1000);
+            bool isReceive = socket->isReceiveData(mTailLogFile ? 100 : 1000);
 
             if (isInterrupted())
                 break;
 
+            // 追跡中のシーケンスログファイルに追記された分を送信
+            sendTailLog();
+
             if (isReceive == false)
                 continue;
 
@@ -175,7 +388,8 @@ void GetLogResponse::run()
 
             int32_t cmd = buffer->getInt();
 
-            if (cmd == 1 && (mSendSequenceLogThread == nullptr || mSendSequenceLogThread->isAlive() == false))
+            // 1:シーケンスログ送信、2:シーケンスログ送信（送信開始位置指定）
+            if ((cmd == 1 || cmd == 2) && (mSendSequenceLogThread == nullptr || mSendSequenceLogThread->isAlive() == false))
             {
                 SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
                 ScopedLock lock(serviceMain->getMutex());
@@ -196,17 +410,54 @@ void GetLogResponse::run()
                     String fileName;
                     fileName.copy(buffer->get(len), len);
 
+                    int64_t position = -1;
+
+                    if (cmd == 2)
+                        position = buffer->getLong();
+
                     delete mSendSequenceLogThread;
                     mSendSequenceLogThread = new SendSequenceLogThread(
                         socket->getInetAddress(),
                         serviceMain->getSequenceLogServerPort(),
 //                      &fileName);
-                        fileInfo->getCanonicalPath());
+                        fileInfo->getCanonicalPath(),
+                        position);
 
                     mSendSequenceLogThread->start();
                 }
             }
 
+            // 3:シーケンスログ追跡開始
+            if (cmd == 3)
+            {
+                ScopedLock lock(serviceMain->getMutex());
+
+                auto sum = serviceMain->getFileInfoArray(getUserId());
+                int32_t index = buffer->getInt();
+
+                if (0 <= index && index < (int32_t)sum->size())
+                {
+                    auto i = sum->begin();
+                    advance(i, index);
+
+                    int32_t len = buffer->getInt();
+                    buffer->get(len);
+
+                    int64_t position = buffer->getLong();
+                    int32_t window =   buffer->getInt();
+
+                    followLog(*i, position, window);
+                }
+            }
+
+            // 4:受信済み通知（送信可能なバイト数を追加）
+            if (cmd == 4 && mTailLogFile)
+                mTailLogFile->addCredit(buffer->getInt());
+
+            // 5:シーケンスログ追跡終了
+            if (cmd == 5)
+                unfollowLog();
+
             delete buffer;
         }
     }
@@ -227,6 +478,149 @@ void GetLogResponse::run()
     // シーケンスログサービスメインへのリスナー登録を解除
     serviceMain->removeThreadListener(this);
     serviceMain->removeSequenceLogServiceListener(this);
+
+    unfollowLog();
+}
+
+/*!
+ * \brief   シーケンスログファイル追跡開始
+ *
+ * \param[in]   fileInfo    シーケンスログファイル情報
+ * \param[in]   position    送信開始位置
+ * \param[in]   window      受信済み通知なしで送信できるバイト数
+ *
+ * \return  なし
+ *
+ * \note    既存の内容を送信したあと、追記された分を順次送信する。
+ *          ローテーションされた場合は次のファイルに切り替えて送信を続ける。
+ */
+void GetLogResponse::followLog(const FileInfo* fileInfo, int64_t position, int32_t window)
+{
+    unfollowLog();
+
+    TailLogFile* tail = new TailLogFile;
+
+    try
+    {
+        tail->open(fileInfo->getCanonicalPath(), position);
+    }
+    catch (Exception& e)
+    {
+        noticeLog("GetLogResponse: %s", e.getMessage());
+        delete tail;
+        return;
+    }
+
+    tail->addCredit(window);
+
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ScopedLock lock(serviceMain->getMutex());
+
+    mTailLogFile = tail;
+    mTailPath.copy(fileInfo->getCanonicalPath());
+    mTailNextPath.copy("");
+    mTailWriter = nullptr;
+    mTailUpdated = true;
+
+    sendTailName();
+}
+
+/*!
+ * \brief   シーケンスログファイル追跡終了
+ */
+void GetLogResponse::unfollowLog()
+{
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ScopedLock lock(serviceMain->getMutex());
+
+    delete mTailLogFile;
+    mTailLogFile = nullptr;
+
+    mTailPath.copy("");
+    mTailNextPath.copy("");
+    mTailWriter = nullptr;
+    mTailUpdated = false;
+}
+
+/*!
+ * \brief   追跡中のシーケンスログファイル名を送信
+ *
+ * \note    圧縮ファイルは展開して送信するので、ビューアーには非圧縮の拡張子で通知する
+ */
+void GetLogResponse::sendTailName()
+{
+    String name = strrchr(mTailPath.getBuffer(), PATH_DELIMITER) + 1;
+
+    if (CompressedFile::isCompressedFileName(&mTailPath))
+        name.deleteLast();
+
+    send("0004", &name);
+}
+
+/*!
+ * \brief   追跡中のシーケンスログファイルに追記された分を送信
+ *
+ * \note    他のコマンドを受け付けられるように、一度に送信する回数を制限する。
+ */
+void GetLogResponse::sendTailLog()
+{
+    if (mTailLogFile == nullptr)
+        return;
+
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ByteBuffer buffer(CompressedFile::BLOCK_SIZE);
+
+    for (int32_t count = 0; count < 16 && 0 < mTailLogFile->getCredit(); count++)
+    {
+        String nextPath;
+        bool updated;
+
+        {
+            ScopedLock lock(serviceMain->getMutex());
+
+            nextPath.copy(&mTailNextPath);
+            updated = mTailUpdated;
+            mTailUpdated = false;
+        }
+
+        if (mTailLogFile->isEOF() && updated == false && nextPath.getLength() == 0)
+            break;
+
+        try
+        {
+            int64_t position = mTailLogFile->getPosition();
+
+            int64_t len = mTailLogFile->read(&buffer, CompressedFile::BLOCK_SIZE);
+
+            if (0 < len)
+            {
+                sendTailData(position, &buffer, (int32_t)len);
+                continue;
+            }
+
+            if (nextPath.getLength() == 0)
+                break;
+
+            // 終端まで送信済みで、ローテーションされていれば次のファイルに切り替える
+            mTailLogFile->open(&nextPath, 0);
+
+            ScopedLock lock(serviceMain->getMutex());
+
+            mTailPath.copy(&nextPath);
+            mTailUpdated = true;
+
+            if (mTailNextPath.equals(&nextPath))
+                mTailNextPath.copy("");
+
+            sendTailName();
+        }
+        catch (Exception& e)
+        {
+            noticeLog("GetLogResponse: %s", e.getMessage());
+            unfollowLog();
+            break;
+        }
+    }
 }
 
 /*!
@@ -234,6 +628,14 @@ void GetLogResponse::run()
  */
 void GetLogResponse::onThreadTerminated(Thread* thread)
 {
+    {
+        SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+        ScopedLock lock(serviceMain->getMutex());
+
+        if (mTailWriter == thread)
+            mTailWriter = nullptr;
+    }
+
     // ログ出力スレッドの終了時もシーケンスログファイル変更通知を行う
     // thread != this
     onLogFileChanged(nullptr, nullptr, getUserId());
@@ -247,6 +649,10 @@ void GetLogResponse::onLogFileChanged(Thread* thread, const CoreString* fileName
     if (getUserId() != userId)
         return;
 
+    // 追跡中のシーケンスログファイルに書き込んでいたスレッドが新しいファイルを開いたらローテーション
+    if (thread && thread == mTailWriter && fileName && fileName->equals(&mTailPath) == false)
+        mTailNextPath.copy(fileName);
+
     String content;
     getSequenceLogListJson(&content, getUserId());
 
@@ -264,6 +670,49 @@ void GetLogResponse::onUpdateLog(const Buffer* text, int32_t userId)
     send("0002", text);
 }
 
+/*!
+ * \brief   シーケンスログ書き込み通知
+ */
+void GetLogResponse::onLogWritten(Thread* thread, const CoreString* fileName, int32_t userId)
+{
+    if (getUserId() != userId || fileName->equals(&mTailPath) == false)
+        return;
+
+    mTailWriter = thread;
+    mTailUpdated = true;
+}
+
+/*!
+ * \brief   追跡中のシーケンスログファイルの内容を送信
+ *
+ * \param[in]   position    送信開始位置
+ * \param[in]   data        ファイル内容
+ * \param[in]   len         ファイル内容の長さ
+ *
+ * \return  なし
+ *
+ * \note    [コマンド(4)][送信開始位置(8)][ファイル内容] をバイナリで送信する。
+ */
+void GetLogResponse::sendTailData(int64_t position, const Buffer* data, int32_t len)
+{
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ScopedLock lock(serviceMain->getMutex());
+
+    try
+    {
+        Socket* socket = mHttpRequest->getSocket();
+
+        WebSocket::sendHeader(socket, 4 + sizeof(position) + len, false);
+        socket->send("0003", 4);
+        socket->send(&position);
+        socket->send(data, len);
+    }
+    catch (Exception&)
+    {
+        interrupt();
+    }
+}
+
 /*!
  * \brief   取得ログ送信
  */
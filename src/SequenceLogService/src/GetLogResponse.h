@@ -27,6 +27,8 @@
 namespace slog
 {
 class SendSequenceLogThread;
+class TailLogFile;
+class FileInfo;
 
 /*!
  *  \brief  取得ログ送信クラス
@@ -41,6 +43,31 @@ class GetLogResponse :
              */
             SendSequenceLogThread* mSendSequenceLogThread;
 
+            /*!
+             * 追跡中のシーケンスログファイル
+             */
+            TailLogFile* mTailLogFile;
+
+            /*!
+             * 追跡中のシーケンスログファイルのパス
+             */
+            String mTailPath;
+
+            /*!
+             * 追跡中のシーケンスログファイルに書き込んでいるスレッド
+             */
+            Thread* mTailWriter;
+
+            /*!
+             * ローテーション後のシーケンスログファイル
+             */
+            String mTailNextPath;
+
+            /*!
+             * 追跡中のシーケンスログファイルに書き込みがあったかどうか
+             */
+            bool mTailUpdated;
+
             /*!
              * コンストラクタ
              */
@@ -56,6 +83,15 @@ public:     GetLogResponse(HttpRequest* httpRequest);
              */
 private:    virtual void run() override;
 
+            /*!
+             * シーケンスログファイル追跡
+             */
+            void followLog(const FileInfo* fileInfo, int64_t position, int32_t window);
+            void unfollowLog();
+            void sendTailName();
+            void sendTailLog();
+            void sendTailData(int64_t position, const Buffer* data, int32_t len);
+
             /*!
              * スレッド初期化完了通知
              */
@@ -68,6 +104,7 @@ public:     virtual void onThreadInitialized(Thread* thread) override {}
 
             virtual void onLogFileChanged(Thread* thread, const CoreString* fileName, int32_t userId) override;
             virtual void onUpdateLog(const Buffer* text,  int32_t userId) override;
+            virtual void onLogWritten(Thread* thread, const CoreString* fileName, int32_t userId) override;
 
             void send(const char* commandNo, const Buffer* payloadData);
 };
@@ -0,0 +1,244 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    LogLevelResponse.cpp
+ * \brief   ログレベル変更応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "LogLevelResponse.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogService.h"
+
+#include "slog/HttpRequest.h"
+#include "slog/Json.h"
+#include "slog/MimeType.h"
+#include "slog/Mutex.h"
+#include "slog/SequenceLog.h"
+
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+const char* LogLevelResponse::CLS_NAME = "LogLevelResponse";
+
+/*!
+ * \brief   実行
+ *
+ * \note    接続中のクライアントのログレベルを、再起動せずに変更する。
+ *          level（ALL、DEBUG、INFO、WARN、ERROR、NONE）は条件に一致しない関数のログレベル、
+ *          filter は "クラス名::関数名=ログレベル" のカンマ区切り（'*' 可、"::関数名" は省略可）で、先頭から順に調べる。
+ *          pid（プロセスID）、file（ベースファイル名）で対象のクライアントを絞り込み、変更した数をJSON形式で送信する。
+ */
+void LogLevelResponse::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    if (getUserId() < 0)
+    {
+        // 未ログイン
+        redirect("/login.html");
+        return;
+    }
+
+    String str;
+    String fileName;
+    String level;
+    String filter;
+
+    mHttpRequest->getParam("pid", &str);
+    int32_t processId = (str.getLength() ? atoi(str.getBuffer()) : -1);
+
+    mHttpRequest->getParam("file",   &fileName);
+    mHttpRequest->getParam("level",  &level);
+    mHttpRequest->getParam("filter", &filter);
+
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+    mimeType->setType(MimeType::Type::TEXT);
+
+    ByteBuffer message(sizeof(int32_t) * 3 + filter.getLength() + sizeof(int32_t) * 4 * (filter.getLength() + 1));
+    int32_t logLevel;
+
+    if (createMessage(&message, &logLevel, &level, &filter) == false)
+    {
+        str.copy("invalid level or filter");
+
+        sendHttpHeader("400 Bad Request", nullptr, str.getLength(), nullptr);
+        sendContent(&str);
+        return;
+    }
+
+    int32_t count = 0;
+    {
+        SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+        ScopedLock lock(serviceMain->getMutex());
+
+        auto list = serviceMain->getServiceList();
+
+        for (auto i = list->begin(); i != list->end(); i++)
+        {
+            SequenceLogService* service = *i;
+
+            if (service->getUserId() != getUserId())
+                continue;
+
+            if (processId != -1 && service->getProcessId() != (uint32_t)processId)
+                continue;
+
+            if (fileName.getLength() && service->getBaseFileName()->equals(&fileName) == false)
+                continue;
+
+            service->setLogControl(&message, message.getPosition(), logLevel);
+            count++;
+        }
+    }
+
+    Json* json = Json::getNewObject();
+    json->add("count", count);
+
+    String content;
+    json->serialize(&content);
+    delete json;
+
+    sendHttpHeader(nullptr, content.getLength());
+    sendContent(&content);
+}
+
+/*!
+ * \brief   ログレベル制御メッセージ作成
+ *
+ * \param[out]  message     ログレベル制御メッセージ（LOG_LEVEL_CONTROL）
+ * \param[out]  logLevel    シーケンスログサービスで絞り込むログレベル（全ての条件のうち最も低いログレベル）
+ * \param[in]   level       条件に一致しない関数のログレベル
+ * \param[in]   filter      関数毎の条件
+ *
+ * \return  パラメータが正しければtrue
+ */
+bool LogLevelResponse::createMessage(ByteBuffer* message, int32_t* logLevel, const CoreString* level, const CoreString* filter)
+{
+    int32_t defaultLevel;
+
+    if (getLogLevel(&defaultLevel, level->getBuffer(), level->getLength()) == false)
+        return false;
+
+    message->putInt(LOG_LEVEL_CONTROL);
+    message->putInt(defaultLevel);
+    message->putInt(0);
+
+    *logLevel = defaultLevel;
+
+    int32_t count = 0;
+    const char* p = filter->getBuffer();
+    const char* end = p + filter->getLength();
+
+    while (p < end)
+    {
+        const char* next = (const char*)memchr(p, ',', end - p);
+        next = (next ? next : end);
+
+        const char* equal = (const char*)memchr(p, '=', next - p);
+
+        if (equal == nullptr || equal == p)
+            return false;
+
+        int32_t ruleLevel;
+
+        if (getLogLevel(&ruleLevel, equal + 1, (int32_t)(next - equal - 1)) == false)
+            return false;
+
+        // "クラス名::関数名" の関数名を省略した場合は全ての関数
+        const char* className = p;
+        const char* funcName = "*";
+        int32_t classLen = (int32_t)(equal - p);
+        int32_t funcLen = 1;
+
+        for (const char* q = p; q + 1 < equal; q++)
+        {
+            if (q[0] == ':' && q[1] == ':')
+            {
+                classLen = (int32_t)(q - p);
+                funcName = q + 2;
+                funcLen = (int32_t)(equal - funcName);
+                break;
+            }
+        }
+
+        message->putInt(ruleLevel);
+        message->putInt(classLen);
+        message->put(className, classLen);
+        message->putInt(funcLen);
+        message->put(funcName, funcLen);
+
+        if (ruleLevel < *logLevel)
+            *logLevel = ruleLevel;
+
+        count++;
+        p = next + 1;
+    }
+
+    // 条件数
+    int32_t position = message->getPosition();
+
+    message->setPosition(sizeof(int32_t) * 2);
+    message->putInt(count);
+    message->setPosition(position);
+
+    return true;
+}
+
+/*!
+ * \brief   ログレベル取得
+ *
+ * \param[out]  logLevel    ログレベル（ALLはDEBUG - 1、NONEはERROR + 1）
+ * \param[in]   name        ログレベル名
+ * \param[in]   len         ログレベル名の長さ
+ *
+ * \return  ログレベル名が正しければtrue
+ */
+bool LogLevelResponse::getLogLevel(int32_t* logLevel, const char* name, int32_t len)
+{
+    static const struct
+    {
+        const char* name;
+        int32_t     level;
+    }
+    levels[] =
+    {
+        {"ALL",   DEBUG - 1},
+        {"DEBUG", DEBUG},
+        {"INFO",  INFO},
+        {"WARN",  WARN},
+        {"ERROR", ERROR},
+        {"NONE",  ERROR + 1},
+    };
+
+    for (int32_t i = 0; i < (int32_t)(sizeof(levels) / sizeof(levels[0])); i++)
+    {
+        if ((int32_t)strlen(levels[i].name) == len && strncmp(levels[i].name, name, len) == 0)
+        {
+            *logLevel = levels[i].level;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace slog
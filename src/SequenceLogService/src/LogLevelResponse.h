@@ -0,0 +1,58 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    LogLevelResponse.h
+ * \brief   ログレベル変更応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/WebServerResponseThread.h"
+
+namespace slog
+{
+class ByteBuffer;
+
+/*!
+ * \brief   ログレベル変更応答クラス
+ */
+class LogLevelResponse : public WebServerResponse
+{
+            static const char* CLS_NAME;
+
+            /*!
+             * コンストラクタ
+             */
+public:     LogLevelResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest) {}
+
+            /*!
+             * 実行
+             */
+private:    virtual void run() override;
+
+            /*!
+             * ログレベル制御メッセージ作成
+             */
+            static bool createMessage(ByteBuffer* message, int32_t* logLevel, const CoreString* level, const CoreString* filter);
+
+            /*!
+             * ログレベル取得
+             */
+            static bool getLogLevel(int32_t* logLevel, const char* name, int32_t len);
+};
+
+} // namespace slog
@@ -0,0 +1,237 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    MergeLogResponse.cpp
+ * \brief   ログマージ応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "MergeLogResponse.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogMerger.h"
+#include "getSequenceLogItemJson.h"
+
+#include "slog/HttpRequest.h"
+#include "slog/FileInfo.h"
+#include "slog/MimeType.h"
+#include "slog/Tokenizer.h"
+#include "slog/ByteBuffer.h"
+#include "slog/Mutex.h"
+#include "slog/SequenceLog.h"
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+const char* MergeLogResponse::CLS_NAME = "MergeLogResponse";
+
+/*!
+ * 一度に送信するデータの目安
+ */
+static const int32_t SEND_SIZE = 64 * 1024;
+
+/*!
+ * \brief   コンストラクタ
+ */
+MergeLogResponse::MergeLogResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest)
+{
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+MergeLogResponse::~MergeLogResponse()
+{
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        delete *i;
+}
+
+/*!
+ * \brief   実行
+ *
+ * \note    files（カンマ区切りのシーケンスログファイル名）で指定したファイルのレコードを日時順にマージして送信する。
+ *          format=slog の場合はシーケンスログファイルと同じバイト列、それ以外はJSON Lines形式（１行に１レコード）で送信する。
+ */
+void MergeLogResponse::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    if (getUserId() < 0)
+    {
+        // 未ログイン
+        redirect("/login.html");
+        return;
+    }
+
+    getPaths();
+
+    String format;
+    mHttpRequest->getParam("format", &format);
+
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+
+    if (format.equals("slog"))
+        mimeType->setText("application/octet-stream");
+    else
+        mimeType->setType(MimeType::Type::TEXT);
+
+    sendHttpHeader(nullptr, -1);
+
+    try
+    {
+        if (format.equals("slog"))
+            sendSequenceLog();
+        else
+            sendJsonLines();
+
+        sendContent(nullptr);
+    }
+    catch (Exception& e)
+    {
+        noticeLog("MergeLogResponse: %s", e.getMessage());
+    }
+}
+
+/*!
+ * \brief   マージするシーケンスログファイル取得
+ *
+ * \note    ログインユーザーが参照できるシーケンスログファイルのうち、ファイル名が一致するものを指定した順に取得する。
+ */
+void MergeLogResponse::getPaths()
+{
+    String files;
+    mHttpRequest->getParam("files", &files);
+
+    Tokenizer tokenizer(',');
+    tokenizer.exec(&files);
+
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ScopedLock lock(serviceMain->getMutex());
+
+    auto sum = serviceMain->getFileInfoArray(getUserId());
+    int32_t count = tokenizer.getCount();
+
+    for (int32_t index = 0; index < count; index++)
+    {
+        const CoreString* name = tokenizer.getValue(index);
+
+        for (auto i = sum->begin(); i != sum->end(); i++)
+        {
+            const CoreString* path = (*i)->getCanonicalPath();
+
+            // テキスト形式のシーケンスログファイルは対象外
+            if (isBinarySequenceLogFile(path) == false)
+                continue;
+
+            const char* fileName = strrchr(path->getBuffer(), PATH_DELIMITER) + 1;
+
+            if (name->equals(fileName) == false)
+                continue;
+
+            String* str = new String;
+            str->copy(path);
+
+            mPaths.push_back(str);
+            break;
+        }
+    }
+}
+
+/*!
+ * \brief   JSON Lines形式で送信
+ */
+void MergeLogResponse::sendJsonLines() throw(Exception)
+{
+    SequenceLogMerger merger;
+    SequenceLogItem item;
+
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        merger.add(*i);
+
+    merger.start();
+
+    String lines;
+    String line;
+    int32_t index;
+
+    while (merger.read(&item, &index))
+    {
+        const char* fileName = strrchr(mPaths[index]->getBuffer(), PATH_DELIMITER) + 1;
+        bool stepIn = (item.mType == SequenceLogItem::STEP_IN);
+
+        if (getSequenceLogItemJson(&line, fileName, &item,
+            (stepIn ? item.getClassName() : nullptr),
+            (stepIn ? item.getFuncName()  : nullptr)) == false)
+        {
+            continue;
+        }
+
+        lines.append(&line);
+        lines.append("\n");
+
+        if (SEND_SIZE <= lines.getLength())
+        {
+            sendContent(&lines);
+            lines.setLength(0);
+        }
+    }
+
+    if (lines.getLength())
+        sendContent(&lines);
+}
+
+/*!
+ * \brief   シーケンスログ形式で送信
+ *
+ * \note    レコードをそのまま連結するので、受け取ったデータはシーケンスログファイルとして読み込める。
+ */
+void MergeLogResponse::sendSequenceLog() throw(Exception)
+{
+    SequenceLogMerger merger;
+
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        merger.add(*i);
+
+    merger.start();
+
+    ByteBuffer buffer(SEND_SIZE + 0xFFFF);
+    SequenceLogByteBuffer* record;
+
+    while ((record = merger.readRecord(nullptr)) != nullptr)
+    {
+        const uint8_t* p = (const uint8_t*)record->getBuffer();
+        int32_t size = (p[0] << 8) | p[1];
+
+        buffer.put(record, size);
+
+        if (SEND_SIZE <= buffer.getPosition())
+        {
+            buffer.setLength(buffer.getPosition());
+            sendContent(&buffer);
+            buffer.setPosition(0);
+        }
+    }
+
+    if (buffer.getPosition())
+    {
+        buffer.setLength(buffer.getPosition());
+        sendContent(&buffer);
+    }
+}
+
+} // namespace slog
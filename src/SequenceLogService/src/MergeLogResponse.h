@@ -0,0 +1,74 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    MergeLogResponse.h
+ * \brief   ログマージ応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/WebServerResponseThread.h"
+
+#include <vector>
+
+namespace slog
+{
+
+/*!
+ * \brief   ログマージ応答クラス
+ */
+class MergeLogResponse : public WebServerResponse
+{
+            static const char* CLS_NAME;
+
+            /*!
+             * マージするシーケンスログファイル
+             */
+            std::vector<String*> mPaths;
+
+            /*!
+             * コンストラクタ
+             */
+public:     MergeLogResponse(HttpRequest* httpRequest);
+
+            /*!
+             * デストラクタ
+             */
+            virtual ~MergeLogResponse() override;
+
+            /*!
+             * 実行
+             */
+private:    virtual void run() override;
+
+            /*!
+             * マージするシーケンスログファイル取得
+             */
+            void getPaths();
+
+            /*!
+             * JSON Lines形式で送信
+             */
+            void sendJsonLines() throw(Exception);
+
+            /*!
+             * シーケンスログ形式で送信
+             */
+            void sendSequenceLog() throw(Exception);
+};
+
+} // namespace slog
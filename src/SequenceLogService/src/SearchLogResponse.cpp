@@ -0,0 +1,619 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SearchLogResponse.cpp
+ * \brief   ログ検索応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SearchLogResponse.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogFileReader.h"
+#include "SequenceLogFileIndex.h"
+#include "SequenceLogArchive.h"
+#include "getSequenceLogItemJson.h"
+
+#include "slog/HttpRequest.h"
+#include "slog/FileInfo.h"
+#include "slog/MimeType.h"
+#include "slog/Tokenizer.h"
+#include "slog/PointerString.h"
+#include "slog/SequenceLog.h"
+
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#if defined(__unix__)
+    #include <string.h>
+#endif
+
+namespace slog
+{
+const char* SearchLogResponse::CLS_NAME = "SearchLogResponse";
+
+/*!
+ * 並列に検索するスレッドの最大数
+ */
+static const int32_t MAX_SEARCH_THREADS = 4;
+
+/*!
+ * 一度に送信する検索結果の目安
+ */
+static const int32_t SEND_LINES_SIZE = 32 * 1024;
+
+/*!
+ * \brief   ログ検索スレッド
+ */
+class SearchLogThread : public Thread
+{
+            SearchLogResponse* mResponse;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SearchLogThread(SearchLogResponse* response) {mResponse = response;}
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override
+            {
+                String path;
+
+                while (mResponse->popPath(&path))
+                    mResponse->search(&path);
+            }
+};
+
+/*!
+ * \brief   呼び出し中の関数
+ */
+struct SearchLogFrame
+{
+            String className;   //!< クラス名
+            String funcName;    //!< 関数名
+};
+
+typedef std::map<uint32_t, std::list<SearchLogFrame*> > SearchLogStacks;   // キーはスレッドID
+
+/*!
+ * \brief   呼び出し中の関数をクリア
+ */
+static void clearStacks(SearchLogStacks* stacks)
+{
+    for (auto i = stacks->begin(); i != stacks->end(); i++)
+    {
+        std::list<SearchLogFrame*>* stack = &i->second;
+
+        for (auto j = stack->begin(); j != stack->end(); j++)
+            delete *j;
+    }
+
+    stacks->clear();
+}
+
+typedef std::vector<std::pair<int64_t, int64_t> > SearchLogRanges;          // 検索範囲の開始位置と終了位置（-1はファイルの終端）
+
+/*!
+ * \brief   アーカイブの検索範囲取得
+ *
+ * \param[out]  ranges  検索範囲
+ * \param[in]   path    アーカイブのパス
+ * \param[in]   cond    検索条件
+ *
+ * \return  なし
+ *
+ * \note    グループ毎の日時の範囲、スレッド、ログレベルだけで絞り込むので、カラムは読まない。
+ */
+static void getArchiveSearchRanges(SearchLogRanges* ranges, const CoreString* path, const SearchLogCondition* cond)
+{
+    SequenceLogArchive archive;
+
+    try
+    {
+        archive.open(path);
+    }
+    catch (Exception&)
+    {
+        ranges->push_back(std::make_pair(0LL, -1LL));
+        return;
+    }
+
+    // メッセージのログレベルの条件（レベル毎のビット）
+    uint32_t levels = 0xFFFFFFFF;
+
+    if (0 < cond->level)
+        levels = (cond->level < 32 ? levels << cond->level : 0);
+
+    int32_t groupCount = archive.getGroupCount();
+
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        const SequenceLogArchiveGroup* group = archive.getGroup(i);
+
+        if (cond->from && group->maxDateTime < cond->from)
+            continue;
+
+        if (cond->to   && cond->to < group->minDateTime)
+            continue;
+
+        if (cond->threadId != -1 &&
+            std::find(group->threadIds.begin(), group->threadIds.end(), (uint32_t)cond->threadId) == group->threadIds.end())
+        {
+            continue;
+        }
+
+        if ((cond->level != -1 || cond->text.getLength()) && (group->levels & levels) == 0)
+            continue;
+
+        int64_t start = group->rawPosition;
+        int64_t end =   group->rawPosition + group->rawSize;
+
+        // 連続するグループはまとめる
+        if (ranges->size() && ranges->back().second == start)
+            ranges->back().second = end;
+        else
+            ranges->push_back(std::make_pair(start, end));
+    }
+}
+
+/*!
+ * \brief   検索範囲取得
+ *
+ * \param[out]  ranges  検索範囲
+ * \param[in]   path    シーケンスログファイルのパス
+ * \param[in]   cond    検索条件
+ *
+ * \return  なし
+ *
+ * \note    索引があればメッセージを含む可能性のあるブロックだけに、
+ *          アーカイブであれば条件に合う可能性のあるグループだけに絞り込む。
+ *          クラス名、関数名の指定がある場合は呼び出し中の関数を追跡するためにファイル全体を検索する。
+ */
+static void getSearchRanges(SearchLogRanges* ranges, const CoreString* path, const SearchLogCondition* cond)
+{
+    SequenceLogFileIndex index;
+    std::vector<bool> blocks;
+
+    if (cond->className.getLength() == 0 && cond->funcName.getLength() == 0 && SequenceLogArchive::isArchiveFileName(path))
+    {
+        getArchiveSearchRanges(ranges, path, cond);
+        return;
+    }
+
+    if (cond->className.getLength() || cond->funcName.getLength() ||
+        index.load(path) == false || index.find(&cond->text, &blocks) == false)
+    {
+        ranges->push_back(std::make_pair(0LL, -1LL));
+        return;
+    }
+
+    int32_t blockCount = index.getBlockCount();
+
+    for (int32_t i = 0; i < blockCount; i++)
+    {
+        if (blocks[i] == false)
+            continue;
+
+        int64_t start = index.getBlockPosition(i);
+        int64_t end = (i + 1 < blockCount ? index.getBlockPosition(i + 1) : -1);
+
+        // 連続するブロックはまとめる
+        if (ranges->size() && ranges->back().second == start)
+            ranges->back().second = end;
+        else
+            ranges->push_back(std::make_pair(start, end));
+    }
+}
+
+/*!
+ * \brief   数字列を数値に変換
+ *
+ * \param[in]   p       数字列
+ * \param[in]   len     数字列の長さ
+ *
+ * \return  数値
+ */
+static uint32_t toNumber(const char* p, int32_t len)
+{
+    uint32_t value = 0;
+
+    for (int32_t i = 0; i < len; i++)
+        value = value * 10 + (p[i] - '0');
+
+    return value;
+}
+
+/*!
+ * \brief   日時文字列（YYYYMMDDHHMISS[mmm]、UTC）を日時に変換
+ *
+ * \param[in]   str     日時文字列
+ *
+ * \return  日時（変換できなかった場合は0）
+ */
+static uint64_t toDateTimeValue(const CoreString* str)
+{
+    const char* p = str->getBuffer();
+    int32_t len = str->getLength();
+
+    if (len != 14 && len != 17)
+        return 0;
+
+    for (int32_t i = 0; i < len; i++)
+    {
+        if (p[i] < '0' || '9' < p[i])
+            return 0;
+    }
+
+    DateTime dateTime;
+    dateTime.setValue(0);
+
+    dateTime.setYear(       toNumber(p +  0, 4));
+    dateTime.setMonth(      toNumber(p +  4, 2));
+    dateTime.setDay(        toNumber(p +  6, 2));
+    dateTime.setHour(       toNumber(p +  8, 2));
+    dateTime.setMinute(     toNumber(p + 10, 2));
+    dateTime.setSecond(     toNumber(p + 12, 2));
+    dateTime.setMilliSecond(len == 17 ? toNumber(p + 14, 3) : 0);
+
+    return dateTime.getValue();
+}
+
+/*!
+ * \brief   シーケンスログファイル名からプロセスIDを取得
+ *
+ * \param[in]   path    シーケンスログファイルのパス
+ *
+ * \return  プロセスID（取得できなかった場合は-1）
+ *
+ * \note    ファイル名は "名前-プロセスID-日付-時刻-ミリ秒.拡張子" の形式
+ */
+static int32_t getProcessId(const CoreString* path)
+{
+    PointerString fileName = strrchr(path->getBuffer(), PATH_DELIMITER) + 1;
+    Tokenizer tokenizer('-');
+    tokenizer.exec(&fileName);
+
+    if (tokenizer.getCount() < 4)
+        return -1;
+
+    const CoreString* processId = tokenizer.getValue(tokenizer.getCount() - 4);
+    return atoi(processId->getBuffer());
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SearchLogResponse::SearchLogResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest)
+{
+    mCount = 0;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SearchLogResponse::~SearchLogResponse()
+{
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        delete *i;
+}
+
+/*!
+ * \brief   実行
+ *
+ * \note    一致したレコードをJSON Lines形式（１行に１レコード）で送信する。
+ */
+void SearchLogResponse::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    if (getUserId() < 0)
+    {
+        // 未ログイン
+        redirect("/login.html");
+        return;
+    }
+
+    getCondition();
+    getPaths();
+
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+    mimeType->setType(MimeType::Type::TEXT);
+    sendHttpHeader(nullptr, -1);
+
+    // シーケンスログファイル毎に並列に検索する
+    std::list<SearchLogThread*> threads;
+    int32_t count = (int32_t)mPaths.size();
+
+    if (MAX_SEARCH_THREADS < count)
+        count = MAX_SEARCH_THREADS;
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        SearchLogThread* thread = new SearchLogThread(this);
+        thread->start();
+        threads.push_back(thread);
+    }
+
+    for (auto i = threads.begin(); i != threads.end(); i++)
+    {
+        (*i)->join();
+        delete *i;
+    }
+
+    try
+    {
+        sendContent(nullptr);
+    }
+    catch (Exception&)
+    {
+    }
+}
+
+/*!
+ * \brief   検索条件取得
+ *
+ * \note    from、to（YYYYMMDDHHMISS[mmm]、UTC）、pid、thread、level（0:DEBUG〜3:ERROR）、
+ *          class、func、text、limit をクエリパラメータで受け取る。
+ */
+void SearchLogResponse::getCondition()
+{
+    String str;
+
+    mCondition.from =       toDateTimeValue(mHttpRequest->getParam("from", &str));
+    mCondition.to =         toDateTimeValue(mHttpRequest->getParam("to",   &str));
+
+    mHttpRequest->getParam("pid", &str);
+    mCondition.processId = (str.getLength() ? atoi(str.getBuffer()) : -1);
+
+    mHttpRequest->getParam("thread", &str);
+    mCondition.threadId =  (str.getLength() ? strtoul(str.getBuffer(), nullptr, 10) : -1);
+
+    mHttpRequest->getParam("level", &str);
+    mCondition.level =     (str.getLength() ? atoi(str.getBuffer()) : -1);
+
+    mHttpRequest->getParam("class", &mCondition.className);
+    mHttpRequest->getParam("func",  &mCondition.funcName);
+    mHttpRequest->getParam("text",  &mCondition.text);
+
+    mHttpRequest->getParam("limit", &str);
+    mCondition.limit =     (str.getLength() ? atoi(str.getBuffer()) : 1000);
+}
+
+/*!
+ * \brief   検索対象のシーケンスログファイル取得
+ */
+void SearchLogResponse::getPaths()
+{
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+    ScopedLock lock(serviceMain->getMutex());
+
+    auto sum = serviceMain->getFileInfoArray(getUserId());
+
+    for (auto i = sum->begin(); i != sum->end(); i++)
+    {
+        const CoreString* path = (*i)->getCanonicalPath();
+
+        // テキスト形式のシーケンスログファイルは対象外
+        if (isBinarySequenceLogFile(path) == false)
+            continue;
+
+        if (mCondition.processId != -1 && getProcessId(path) != mCondition.processId)
+            continue;
+
+        String* str = new String;
+        str->copy(path);
+
+        mPaths.push_back(str);
+    }
+}
+
+/*!
+ * \brief   未検索のシーケンスログファイル取得
+ *
+ * \param[out]  path    シーケンスログファイルのパスを受け取る
+ *
+ * \return  未検索のシーケンスログファイルがあればtrue、なければfalseを返す
+ */
+bool SearchLogResponse::popPath(String* path)
+{
+    ScopedLock lock(&mMutex);
+
+    if (mPaths.empty() || mCondition.limit <= mCount)
+        return false;
+
+    String* front = mPaths.front();
+    mPaths.pop_front();
+
+    path->copy(front);
+    delete front;
+
+    return true;
+}
+
+/*!
+ * \brief   シーケンスログファイル検索
+ *
+ * \param[in]   path    シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SearchLogResponse::search(const CoreString* path)
+{
+    const SearchLogCondition* cond = &mCondition;
+    const char* fileName = strrchr(path->getBuffer(), PATH_DELIMITER) + 1;
+
+    SequenceLogFileReader reader;
+    SequenceLogItem item;
+    SearchLogStacks stacks;
+
+    String lines;
+    String line;
+    int32_t count = 0;
+    bool searching = true;
+
+    SearchLogRanges ranges;
+    getSearchRanges(&ranges, path, cond);
+
+    try
+    {
+        reader.open(path);
+
+        for (auto range = ranges.begin(); searching && range != ranges.end(); range++)
+        {
+            if (reader.getPosition() != range->first)
+            {
+                reader.setPosition(range->first);
+                clearStacks(&stacks);
+            }
+
+            while ((range->second == -1 || reader.getPosition() < range->second) && reader.read(&item))
+            {
+                // 呼び出し中の関数を更新
+                std::list<SearchLogFrame*>* stack = &stacks[item.mThreadId];
+                SearchLogFrame* frame = (stack->empty() ? nullptr : stack->back());
+                SearchLogFrame* popFrame = nullptr;
+
+                if (item.mType == SequenceLogItem::STEP_IN)
+                {
+                    frame = new SearchLogFrame;
+                    frame->className.copy(item.getClassName());
+                    frame->funcName. copy(item.getFuncName());
+                    stack->push_back(frame);
+                }
+                else if (item.mType == SequenceLogItem::STEP_OUT && frame)
+                {
+                    stack->pop_back();
+                    popFrame = frame;
+                }
+
+                // 条件判定
+                bool match = true;
+                uint64_t dateTime = item.mDateTime.getValue();
+
+                if (cond->from && dateTime < cond->from)
+                    match = false;
+
+                if (cond->to   && cond->to < dateTime)
+                    match = false;
+
+                if (cond->threadId != -1 && item.mThreadId != (uint32_t)cond->threadId)
+                    match = false;
+
+                if ((cond->level != -1 || cond->text.getLength()) && item.mType != SequenceLogItem::MESSAGE)
+                    match = false;
+
+                if (cond->level != -1 && (int32_t)item.mLevel < cond->level)
+                    match = false;
+
+                if (cond->text.getLength() && item.getMessage()->indexOf(cond->text.getBuffer()) == -1)
+                    match = false;
+
+                if (cond->className.getLength() && (frame == nullptr || frame->className.indexOf(cond->className.getBuffer()) == -1))
+                    match = false;
+
+                if (cond->funcName.getLength()  && (frame == nullptr || frame->funcName. indexOf(cond->funcName. getBuffer()) == -1))
+                    match = false;
+
+                // 不正なタイプのレコードは結果に含めない
+                if (match && getSequenceLogItemJson(&line, fileName, &item,
+                    (frame ? &frame->className : nullptr),
+                    (frame ? &frame->funcName  : nullptr)))
+                {
+                    lines.append(&line);
+                    lines.append("\n");
+                    count++;
+                }
+
+                delete popFrame;
+
+                if (SEND_LINES_SIZE <= lines.getLength())
+                {
+                    searching = sendLines(&lines, count);
+
+                    if (searching == false)
+                        break;
+
+                    lines.setLength(0);
+                    count = 0;
+                }
+            }
+        }
+    }
+    catch (Exception& e)
+    {
+        noticeLog("SearchLogResponse: %s %s", fileName, e.getMessage());
+    }
+
+    if (searching && count)
+        sendLines(&lines, count);
+
+    clearStacks(&stacks);
+}
+
+/*!
+ * \brief   検索結果送信
+ *
+ * \param[in]   lines   JSON Lines形式の検索結果
+ * \param[in]   count   検索結果の件数
+ *
+ * \return  検索を続ける場合はtrue、最大件数に達したか送信に失敗した場合はfalseを返す
+ *
+ * \note    最大件数を超える分は送信しない。
+ */
+bool SearchLogResponse::sendLines(const CoreString* lines, int32_t count)
+{
+    ScopedLock lock(&mMutex);
+
+    if (mCondition.limit <= mCount)
+        return false;
+
+    const char* p = lines->getBuffer();
+    int32_t len = lines->getLength();
+
+    if (mCondition.limit < mCount + count)
+    {
+        // 最大件数までの行を送信する
+        count = mCondition.limit - mCount;
+        const char* end = p;
+
+        for (int32_t i = 0; i < count; i++)
+            end = strchr(end, '\n') + 1;
+
+        len = (int32_t)(end - p);
+    }
+
+    mCount += count;
+
+    try
+    {
+        String content;
+        content.copy(p, len);
+
+        sendContent(&content);
+    }
+    catch (Exception&)
+    {
+        mCount = mCondition.limit;
+        return false;
+    }
+
+    return (mCount < mCondition.limit);
+}
+
+} // namespace slog
@@ -0,0 +1,117 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SearchLogResponse.h
+ * \brief   ログ検索応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/WebServerResponseThread.h"
+#include "slog/Mutex.h"
+
+#include <list>
+
+namespace slog
+{
+class SequenceLogItem;
+
+/*!
+ * \brief   ログ検索条件
+ */
+struct SearchLogCondition
+{
+            uint64_t    from;           //!< 開始日時（0の場合は指定なし）
+            uint64_t    to;             //!< 終了日時（0の場合は指定なし）
+            int32_t     processId;      //!< プロセスID（-1の場合は指定なし）
+            int64_t     threadId;       //!< スレッドID（-1の場合は指定なし）
+            int32_t     level;          //!< ログレベル（指定したレベル以上のメッセージ、-1の場合は指定なし）
+            String      className;      //!< クラス名（部分一致）
+            String      funcName;       //!< 関数名（部分一致）
+            String      text;           //!< メッセージ（部分一致）
+            int32_t     limit;          //!< 最大件数
+};
+
+/*!
+ * \brief   ログ検索応答クラス
+ */
+class SearchLogResponse : public WebServerResponse
+{
+            static const char* CLS_NAME;
+
+            /*!
+             * 検索条件
+             */
+            SearchLogCondition mCondition;
+
+            /*!
+             * 未検索のシーケンスログファイル
+             */
+            std::list<String*> mPaths;
+
+            /*!
+             * 一致した件数
+             */
+            int32_t mCount;
+
+            /*!
+             * ミューテックス（未検索のシーケンスログファイル、一致した件数、送信）
+             */
+            Mutex mMutex;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SearchLogResponse(HttpRequest* httpRequest);
+
+            /*!
+             * デストラクタ
+             */
+            virtual ~SearchLogResponse() override;
+
+            /*!
+             * 実行
+             */
+private:    virtual void run() override;
+
+            /*!
+             * 検索条件取得
+             */
+            void getCondition();
+
+            /*!
+             * 検索対象のシーケンスログファイル取得
+             */
+            void getPaths();
+
+            /*!
+             * 未検索のシーケンスログファイル取得
+             */
+public:     bool popPath(String* path);
+
+            /*!
+             * シーケンスログファイル検索
+             */
+            void search(const CoreString* path);
+
+            /*!
+             * 検索結果送信
+             */
+            bool sendLines(const CoreString* lines, int32_t count);
+};
+
+} // namespace slog
@@ -0,0 +1,177 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogArchiver.cpp
+ * \brief   シーケンスログアーカイブ作成クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogArchiver.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogArchive.h"
+
+#include "slog/Thread.h"
+#include "slog/File.h"
+#include "slog/DateTime.h"
+#include "slog/FixedString.h"
+
+#include <time.h>
+
+namespace slog
+{
+
+/*!
+ * アーカイブするファイルを調べる間隔（ミリ秒）
+ */
+static const int32_t CHECK_INTERVAL = 10 * 60 * 1000;
+
+/*!
+ * \brief   アーカイブ作成スレッド
+ */
+class SequenceLogArchiverThread : public Thread
+{
+            SequenceLogArchiver* mArchiver;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogArchiverThread(SequenceLogArchiver* archiver) {mArchiver = archiver;}
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override;
+};
+
+/*!
+ * \brief   スレッド実行
+ */
+void SequenceLogArchiverThread::run()
+{
+    int32_t elapsed = CHECK_INTERVAL;
+
+    while (isInterrupted() == false)
+    {
+        if (CHECK_INTERVAL <= elapsed)
+        {
+            mArchiver->archive(this);
+            elapsed = 0;
+        }
+
+        sleep(500);
+        elapsed += 500;
+    }
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogArchiver::SequenceLogArchiver()
+{
+    mThread = nullptr;
+    mDays = 0;
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogArchiver::~SequenceLogArchiver()
+{
+    stop();
+}
+
+/*!
+ * \brief   開始
+ *
+ * \param[in]   days    最後に書き込まれてからアーカイブするまでの日数
+ *
+ * \return  なし
+ */
+void SequenceLogArchiver::start(int32_t days)
+{
+    if (mThread)
+        return;
+
+    mDays = days;
+
+    mThread = new SequenceLogArchiverThread(this);
+    mThread->start();
+}
+
+/*!
+ * \brief   停止
+ *
+ * \note    作成中のアーカイブは作成を終えてから停止する。
+ */
+void SequenceLogArchiver::stop()
+{
+    if (mThread == nullptr)
+        return;
+
+    mThread->interrupt();
+    mThread->join();
+
+    delete mThread;
+    mThread = nullptr;
+}
+
+/*!
+ * \brief   アーカイブ作成
+ *
+ * \param[in]   thread  アーカイブ作成スレッド（停止の要求を調べる）
+ *
+ * \return  なし
+ *
+ * \note    シーケンスログファイルマネージャーが作成済みのユーザーのファイルだけが対象になる。
+ *          アーカイブの作成中にローテーションで元のファイルが削除された場合、作成したアーカイブは削除する。
+ */
+void SequenceLogArchiver::archive(const Thread* thread)
+{
+    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+
+    DateTime lastWriteTime;
+    lastWriteTime.setTime_t(time(nullptr) - (time_t)mDays * 24 * 60 * 60);
+
+    std::list<String*> paths;
+    serviceMain->getArchiveTargets(&paths, lastWriteTime);
+
+    for (auto i = paths.begin(); i != paths.end(); i++)
+    {
+        const String* path = *i;
+
+        if (thread->isInterrupted() == false)
+        {
+            FixedString<MAX_PATH> archivePath;
+            SequenceLogArchive::getArchivePath(&archivePath, path);
+
+            try
+            {
+                SequenceLogArchive::create(path, &archivePath);
+
+                if (serviceMain->replaceFileInfo(path, &archivePath) == false)
+                    File::unlink(&archivePath);
+            }
+            catch (Exception& e)
+            {
+                noticeLog("SequenceLogArchiver: %s", e.getMessage());
+            }
+        }
+
+        delete path;
+    }
+}
+
+} // namespace slog
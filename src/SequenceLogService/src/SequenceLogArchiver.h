@@ -0,0 +1,70 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogArchiver.h
+ * \brief   シーケンスログアーカイブ作成クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/slog.h"
+
+namespace slog
+{
+class Thread;
+
+/*!
+ * \brief   シーケンスログアーカイブ作成クラス
+ *
+ * \note    最後に書き込まれてから一定の日数が経ったシーケンスログファイルを
+ *          バックグラウンドのスレッドで定期的にアーカイブ（.sloga）に置き換える。
+ */
+class SequenceLogArchiver
+{
+            /*!
+             * アーカイブ作成スレッド
+             */
+            Thread* mThread;
+
+            /*!
+             * アーカイブするまでの日数
+             */
+            int32_t mDays;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogArchiver();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogArchiver();
+
+            /*!
+             * 開始／停止
+             */
+            void start(int32_t days);
+            void stop();
+
+            /*!
+             * アーカイブ作成
+             */
+            void archive(const Thread* thread);
+};
+
+} // namespace slog
@@ -21,8 +21,14 @@
  */
 #include "SequenceLogFileManager.h"
 #include "SharedFileContainer.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogFileIndex.h"
 
 #include "slog/FileInfo.h"
+#include "slog/File.h"
+#include "slog/Tokenizer.h"
+
+#include <stdlib.h>
 
 #if defined(__unix__)
     #include <string.h>
@@ -32,6 +38,34 @@
 namespace slog
 {
 
+/*!
+ * \brief   ファイルカタログ名
+ */
+static const char CATALOG_FILE_NAME[] = "SequenceLogFileCatalog.txt";
+
+/*!
+ * \brief   ファイルカタログヘッダー
+ */
+static const char CATALOG_HEADER[] = "SequenceLogFileCatalog 1";
+
+/*!
+ * \brief   ファイルカタログジャーナル名
+ */
+static const char CATALOG_JOURNAL_FILE_NAME[] = "SequenceLogFileCatalog.journal";
+
+/*!
+ * \brief   ファイルカタログを書き直すジャーナルの最小行数
+ */
+static const int32_t CATALOG_JOURNAL_COMPACT_COUNT = 64;
+
+/*!
+ * \brief   文字列を64ビット整数に変換
+ */
+static uint64_t toUInt64(const CoreString* str)
+{
+    return strtoull(str->getBuffer(), nullptr, 10);
+}
+
 /*!
  * \brief   シーケンスログファイル情報比較
  */
@@ -74,6 +108,7 @@ SequenceLogFileManager::SequenceLogFileManager(int32_t userId, uint32_t maxFileS
     mUserId = userId;
     mMaxFileSize = maxFileSize;
     mMaxFileCount = maxFileCount;
+    mJournalCount = 0;
 }
 
 /*!
@@ -131,13 +166,22 @@ void SequenceLogFileManager::releaseSharedFileContainer(SharedFileContainer* con
 
     // 共有ファイルクローズ
     container->getFile()->close();
+    container->getCompressedFile()->close();
 
     // 共有ファイル情報更新
     FileInfo* fileInfo = container->getFileInfo();
 
     if (fileInfo)
+    {
         fileInfo->update();
 
+        // クローズしたファイルの索引を作成
+        SequenceLogServiceMain::getInstance()->buildIndex(fileInfo->getCanonicalPath());
+
+        // ファイルカタログ更新
+        updateCatalog(fileInfo);
+    }
+
     // リストから除外
     auto i = std::find(mSharedFileContainerArray.begin(), mSharedFileContainerArray.end(), container);
     mSharedFileContainerArray.erase(i);
@@ -175,6 +219,8 @@ void SequenceLogFileManager::addFileInfo(FileInfo* info)
 
                 // ファイルを削除
                 File::unlink(info->getCanonicalPath());
+                SequenceLogFileIndex::remove(info->getCanonicalPath());
+                removeCatalog(info->getCanonicalPath());
 
                 // リストからファイル情報を除外
                 i = mFileInfoArray.erase(i);
@@ -207,6 +253,88 @@ std::list<FileInfo*>* SequenceLogFileManager::getFileInfoList() const
     return (std::list<FileInfo*>*)&mFileInfoArray;
 }
 
+/*!
+ * \brief   アーカイブするシーケンスログファイルを取得
+ *
+ * \param[out]  paths           アーカイブするシーケンスログファイルのパスを受け取るリスト
+ * \param[in]   lastWriteTime   この日時より前に最後に書き込まれたファイルをアーカイブする
+ *
+ * \return  なし
+ *
+ * \note    使用中のファイル、テキスト形式のファイル、アーカイブ済みのファイルは対象外
+ */
+void SequenceLogFileManager::getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const
+{
+    for (auto i = mFileInfoArray.begin(); i != mFileInfoArray.end(); i++)
+    {
+        const FileInfo* info = *i;
+
+        if (info->isUsing() || lastWriteTime.getValue() <= info->getLastWriteTime().getValue())
+            continue;
+
+        const CoreString* path = info->getCanonicalPath();
+        const char* ext = strrchr(path->getBuffer(), '.');
+
+        if (ext == nullptr || (strcmp(ext, ".slog") != 0 && strcmp(ext, ".slogz") != 0))
+            continue;
+
+        String* str = new String;
+        str->copy(path);
+
+        paths->push_back(str);
+    }
+}
+
+/*!
+ * \brief   シーケンスログファイル情報をアーカイブに置き換える
+ *
+ * \param[in]   path        シーケンスログファイルのパス
+ * \param[in]   archivePath 作成したアーカイブのパス
+ *
+ * \return  置き換えた場合はtrue、ファイルが既に削除されたか使用中の場合はfalseを返す
+ *
+ * \note    作成日時と最終書込日時は元のファイルのものを引き継ぐので、一覧での並び順や表示は変わらない。
+ */
+bool SequenceLogFileManager::replaceFileInfo(const CoreString* path, const CoreString* archivePath)
+{
+    for (auto i = mFileInfoArray.begin(); i != mFileInfoArray.end(); i++)
+    {
+        FileInfo* info = *i;
+
+        if (info->getCanonicalPath()->equals(path) == false)
+            continue;
+
+        if (info->isUsing())
+            return false;
+
+        FileInfo* archiveInfo = nullptr;
+
+        try
+        {
+            archiveInfo = new FileInfo(archivePath);
+            File::unlink(path);
+        }
+        catch (Exception&)
+        {
+            delete archiveInfo;
+            return false;
+        }
+
+        SequenceLogFileIndex::remove(path);
+
+        archiveInfo->setCreationTime( info->getCreationTime());
+        archiveInfo->setLastWriteTime(info->getLastWriteTime());
+        *i = archiveInfo;
+        delete info;
+
+        removeCatalog(path);
+        updateCatalog(archiveInfo);
+        return true;
+    }
+
+    return false;
+}
+
 /*!
  * \brief   
  */
@@ -227,16 +355,314 @@ void SequenceLogFileManager::enumFileInfoList(const CoreString* dirName)
         return;
 
     FixedString<MAX_PATH> path;
+    path.format("%s%c%08d%c", dirName->getBuffer(), PATH_DELIMITER, mUserId, PATH_DELIMITER);
+
+    mCatalogPath.format("%s%s", path.getBuffer(), CATALOG_FILE_NAME);
+    mJournalPath.format("%s%s", path.getBuffer(), CATALOG_JOURNAL_FILE_NAME);
+
+    // ファイルカタログが有効であればディレクトリを走査しない
+    if (loadCatalog(&path))
+    {
+        if (CATALOG_JOURNAL_COMPACT_COUNT <= mJournalCount)
+            saveCatalog();
+
+        return;
+    }
+
     FileFind find;
     find.setListener(this);
 
     path.format("%s%c%08d%c*.slog", dirName->getBuffer(), PATH_DELIMITER, mUserId, PATH_DELIMITER);
     find.exec(&path);
 
+    path.format("%s%c%08d%c*.slogz", dirName->getBuffer(), PATH_DELIMITER, mUserId, PATH_DELIMITER);
+    find.exec(&path);
+
+    path.format("%s%c%08d%c*.sloga", dirName->getBuffer(), PATH_DELIMITER, mUserId, PATH_DELIMITER);
+    find.exec(&path);
+
     path.format("%s%c%08d%c*.log",  dirName->getBuffer(), PATH_DELIMITER, mUserId, PATH_DELIMITER);
     find.exec(&path);
 
     mFileInfoArray.sort(CompareFileInfo());
+    saveCatalog();
+}
+
+/*!
+ * \brief   ファイルカタログ読み込み
+ *
+ * \param[in]   dirPath ユーザーディレクトリのパス（末尾にデリミタが必要）
+ *
+ * \return  カタログからファイル情報を構築できた場合はtrue、ディレクトリの走査が必要な場合はfalseを返す
+ *
+ * \note    カタログとジャーナルはディレクトリ内のファイル作成・削除の後で書き込まれるため、
+ *          どちらの最終書込日時もディレクトリの最終書込日時より古い場合は外部から変更されたものとみなす。
+ *          書込み中だったファイルのサイズ・日時はカタログ保存後にも変化しているので、そのファイルだけ再取得する。
+ */
+bool SequenceLogFileManager::loadCatalog(const CoreString* dirPath)
+{
+    mJournalCount = 0;
+
+    try
+    {
+        FileInfo dirInfo(dirPath);
+        FileInfo catalogInfo(&mCatalogPath);
+        FileInfo journalInfo(&mJournalPath);
+
+        if (catalogInfo.isFile() == false)
+            return false;
+
+        uint64_t catalogTime = catalogInfo.getLastWriteTime().getValue();
+
+        if (journalInfo.isFile() && catalogTime < journalInfo.getLastWriteTime().getValue())
+            catalogTime = journalInfo.getLastWriteTime().getValue();
+
+        if (catalogTime < dirInfo.getLastWriteTime().getValue())
+            return false;
+
+        File file;
+        file.open(&mCatalogPath, File::READ);
+
+        String str;
+
+        if (file.read(&str) == false || str.equals(CATALOG_HEADER) == false)
+            return false;
+
+        // 作成日時、最終書込日時、サイズ、使用中かどうか、パス
+        Tokenizer tokenizer('\t');
+
+        while (file.read(&str))
+        {
+            if (str.getLength() == 0)
+                continue;
+
+            tokenizer.exec(&str);
+
+            if (tokenizer.getCount() != 5)
+            {
+                clearFileInfoList();
+                return false;
+            }
+
+            putCatalogEntry(&tokenizer, 0);
+        }
+
+        file.close();
+
+        // ジャーナルを反映（"+"に続けてカタログと同じ項目、または"-"に続けてパス）
+        if (journalInfo.isFile())
+        {
+            file.open(&mJournalPath, File::READ);
+
+            while (file.read(&str))
+            {
+                if (str.getLength() == 0)
+                    continue;
+
+                tokenizer.exec(&str);
+                const CoreString* op = tokenizer.getValue(0);
+
+                if (op->equals("+") && tokenizer.getCount() == 6)
+                {
+                    putCatalogEntry(&tokenizer, 1);
+                }
+                else if (op->equals("-") && tokenizer.getCount() == 2)
+                {
+                    eraseCatalogEntry(tokenizer.getValue(1));
+                }
+                else
+                {
+                    // 書込み途中で終了した場合など
+                    clearFileInfoList();
+                    return false;
+                }
+
+                mJournalCount++;
+            }
+        }
+    }
+    catch (Exception)
+    {
+        clearFileInfoList();
+        return false;
+    }
+
+    mFileInfoArray.sort(CompareFileInfo());
+    return true;
+}
+
+/*!
+ * \brief   ファイルカタログの項目をファイル情報リストに反映
+ *
+ * \param[in]   tokenizer   項目を分割したトークナイザー
+ * \param[in]   index       作成日時の位置
+ *
+ * \return  なし
+ *
+ * \note    使用中だった項目はサイズ・日時を再取得し、ファイルがなくなっていれば登録しない。
+ */
+void SequenceLogFileManager::putCatalogEntry(const Tokenizer* tokenizer, int32_t index)
+{
+    const CoreString* path = tokenizer->getValue(index + 4);
+    eraseCatalogEntry(path);
+
+    FileInfo* info = new FileInfo(path, false);
+
+    if ((int32_t)tokenizer->getValue(index + 3) != 0)
+    {
+        info->update();
+
+        if (info->isFile() == false)
+        {
+            delete info;
+            return;
+        }
+    }
+    else
+    {
+        DateTime dateTime;
+
+        dateTime.setValue(toUInt64(tokenizer->getValue(index + 0)));
+        info->setCreationTime(dateTime);
+
+        dateTime.setValue(toUInt64(tokenizer->getValue(index + 1)));
+        info->setLastWriteTime(dateTime);
+
+        info->setSize(toUInt64(tokenizer->getValue(index + 2)));
+    }
+
+    mFileInfoArray.push_back(info);
+}
+
+/*!
+ * \brief   ファイルカタログの項目をファイル情報リストから削除
+ */
+void SequenceLogFileManager::eraseCatalogEntry(const CoreString* path)
+{
+    for (auto i = mFileInfoArray.begin(); i != mFileInfoArray.end(); i++)
+    {
+        FileInfo* info = *i;
+
+        if (info->getCanonicalPath()->equals(path))
+        {
+            mFileInfoArray.erase(i);
+            delete info;
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief   ファイルカタログ保存
+ *
+ * \note    全項目を書き直してジャーナルを空にする。
+ */
+void SequenceLogFileManager::saveCatalog()
+{
+    if (mCatalogPath.getLength() == 0)
+        return;
+
+    try
+    {
+        File file;
+        file.open(&mCatalogPath, File::WRITE);
+
+        String str;
+        str.format("%s\n", CATALOG_HEADER);
+        file.write(&str, str.getLength());
+
+        for (auto i = mFileInfoArray.begin(); i != mFileInfoArray.end(); i++)
+        {
+            formatCatalogEntry(&str, *i);
+            file.write(&str, str.getLength());
+        }
+
+        file.close();
+
+        // ジャーナルを空にする（カタログより後に書くことでディレクトリより新しい状態を保つ）
+        file.open(&mJournalPath, File::WRITE);
+        file.close();
+
+        mJournalCount = 0;
+    }
+    catch (Exception)
+    {
+        // ディレクトリがまだない場合など。次回起動時にディレクトリを走査する
+    }
+}
+
+/*!
+ * \brief   ファイルカタログ更新
+ *
+ * \param[in]   info    追加または変更したファイル情報
+ *
+ * \return  なし
+ *
+ * \note    変更した項目だけをジャーナルに追記する。ジャーナルがファイル数より長くなったらカタログを書き直す。
+ */
+void SequenceLogFileManager::updateCatalog(const FileInfo* info)
+{
+    String str;
+    formatCatalogEntry(&str, info);
+    str.insert(0, "+\t");
+
+    appendJournal(&str);
+}
+
+/*!
+ * \brief   ファイルカタログから削除
+ *
+ * \param[in]   path    削除したファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogFileManager::removeCatalog(const CoreString* path)
+{
+    String str;
+    str.format("-\t%s\n", path->getBuffer());
+
+    appendJournal(&str);
+}
+
+/*!
+ * \brief   ジャーナルに追記
+ */
+void SequenceLogFileManager::appendJournal(const CoreString* str)
+{
+    if (mJournalPath.getLength() == 0)
+        return;
+
+    if (CATALOG_JOURNAL_COMPACT_COUNT <= mJournalCount && (int32_t)mFileInfoArray.size() < mJournalCount)
+    {
+        saveCatalog();
+        return;
+    }
+
+    try
+    {
+        File file;
+        file.open(&mJournalPath, File::APPEND);
+        file.write(str, str->getLength());
+
+        mJournalCount++;
+    }
+    catch (Exception)
+    {
+        // ディレクトリがまだない場合など。次回起動時にディレクトリを走査する
+    }
+}
+
+/*!
+ * \brief   ファイルカタログの項目を作成
+ */
+void SequenceLogFileManager::formatCatalogEntry(CoreString* str, const FileInfo* info)
+{
+    str->format("%llu\t%llu\t%llu\t%d\t%s\n",
+        info->getCreationTime(). getValue(),
+        info->getLastWriteTime().getValue(),
+        info->getSize(),
+        info->isUsing() ? 1 : 0,
+        info->getCanonicalPath()->getBuffer());
 }
 
 /*!
@@ -308,4 +734,27 @@ void SequenceLogFileManagerList::setMaxFileCount(int32_t maxFileCount)
         (*i)->setMaxFileCount(maxFileCount);
 }
 
+/*!
+ * \brief   アーカイブするシーケンスログファイルを取得
+ */
+void SequenceLogFileManagerList::getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const
+{
+    for (auto i = mList.begin(); i != mList.end(); i++)
+        (*i)->getArchiveTargets(paths, lastWriteTime);
+}
+
+/*!
+ * \brief   シーケンスログファイル情報をアーカイブに置き換える
+ */
+bool SequenceLogFileManagerList::replaceFileInfo(const CoreString* path, const CoreString* archivePath)
+{
+    for (auto i = mList.begin(); i != mList.end(); i++)
+    {
+        if ((*i)->replaceFileInfo(path, archivePath))
+            return true;
+    }
+
+    return false;
+}
+
 } // namespace slog
@@ -22,12 +22,17 @@
 #pragma once
 
 #include "slog/FileFind.h"
+#include "slog/FixedString.h"
+
 #include <list>
 
 namespace slog
 {
 class SharedFileContainer;
 class FileInfo;
+class DateTime;
+class String;
+class Tokenizer;
 
 /*!
  * \brief   シーケンスログファイルマネージャークラス
@@ -59,6 +64,21 @@ class SequenceLogFileManager : public FileFindListener
              */
             std::list<FileInfo*> mFileInfoArray;
 
+            /*!
+             * ファイルカタログのパス
+             */
+            FixedString<MAX_PATH> mCatalogPath;
+
+            /*!
+             * ファイルカタログジャーナルのパス
+             */
+            FixedString<MAX_PATH> mJournalPath;
+
+            /*!
+             * ファイルカタログジャーナルの行数
+             */
+            int32_t mJournalCount;
+
             /*!
              * コンストラクタ
              */
@@ -104,6 +124,16 @@ public:     SequenceLogFileManager(int32_t userId, uint32_t maxFileSize, int32_t
              */
             std::list<FileInfo*>* getFileInfoList() const;
 
+            /*!
+             * アーカイブするシーケンスログファイルを取得
+             */
+            void getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const;
+
+            /*!
+             * シーケンスログファイル情報をアーカイブに置き換える
+             */
+            bool replaceFileInfo(const CoreString* path, const CoreString* archivePath);
+
             /*!
              * 
              */
@@ -114,6 +144,46 @@ private:    void clearFileInfoList();
              */
 public:     void enumFileInfoList(const CoreString* dirName);
 
+            /*!
+             * ファイルカタログ保存
+             */
+            void saveCatalog();
+
+            /*!
+             * ファイルカタログ更新
+             */
+            void updateCatalog(const FileInfo* info);
+
+            /*!
+             * ファイルカタログから削除
+             */
+            void removeCatalog(const CoreString* path);
+
+            /*!
+             * ファイルカタログ読み込み
+             */
+private:    bool loadCatalog(const CoreString* dirPath);
+
+            /*!
+             * ファイルカタログの項目をファイル情報リストに反映
+             */
+            void putCatalogEntry(const Tokenizer* tokenizer, int32_t index);
+
+            /*!
+             * ファイルカタログの項目をファイル情報リストから削除
+             */
+            void eraseCatalogEntry(const CoreString* path);
+
+            /*!
+             * ジャーナルに追記
+             */
+            void appendJournal(const CoreString* str);
+
+            /*!
+             * ファイルカタログの項目を作成
+             */
+            static void formatCatalogEntry(CoreString* str, const FileInfo* info);
+
             /*!
              * 
              */
@@ -159,6 +229,16 @@ public:     ~SequenceLogFileManagerList() {clear();}
              * 最大ファイル数設定
              */
             void setMaxFileCount(int32_t maxFileCount);
+
+            /*!
+             * アーカイブするシーケンスログファイルを取得
+             */
+            void getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const;
+
+            /*!
+             * シーケンスログファイル情報をアーカイブに置き換える
+             */
+            bool replaceFileInfo(const CoreString* path, const CoreString* archivePath);
 };
 
 } // namespace slog
@@ -0,0 +1,172 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*!
+ * \file    SequenceLogIndexBuilder.cpp
+ * \brief   シーケンスログファイル索引作成クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogIndexBuilder.h"
+#include "SequenceLogFileIndex.h"
+
+#include "slog/Thread.h"
+
+namespace slog
+{
+
+/*!
+ * \brief   索引作成スレッド
+ */
+class SequenceLogIndexBuilderThread : public Thread
+{
+            SequenceLogIndexBuilder* mBuilder;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogIndexBuilderThread(SequenceLogIndexBuilder* builder) {mBuilder = builder;}
+
+            /*!
+             * スレッド実行
+             */
+private:    virtual void run() override;
+};
+
+/*!
+ * \brief   スレッド実行
+ */
+void SequenceLogIndexBuilderThread::run()
+{
+    String path;
+
+    while (isInterrupted() == false)
+    {
+        if (mBuilder->pop(&path) == false)
+        {
+            sleep(500);
+            continue;
+        }
+
+        try
+        {
+            SequenceLogFileIndex::build(&path);
+        }
+        catch (Exception& e)
+        {
+            noticeLog("SequenceLogIndexBuilder: %s", e.getMessage());
+        }
+    }
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogIndexBuilder::SequenceLogIndexBuilder()
+{
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogIndexBuilder::~SequenceLogIndexBuilder()
+{
+    stop();
+
+    for (auto i = mPaths.begin(); i != mPaths.end(); i++)
+        delete *i;
+}
+
+/*!
+ * \brief   開始
+ *
+ * \param[in]   threadCount 索引作成スレッドの数
+ *
+ * \return  なし
+ */
+void SequenceLogIndexBuilder::start(int32_t threadCount)
+{
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        Thread* thread = new SequenceLogIndexBuilderThread(this);
+        thread->start();
+
+        mThreads.push_back(thread);
+    }
+}
+
+/*!
+ * \brief   停止
+ *
+ * \note    作成中の索引は作成を終えてから停止する。
+ */
+void SequenceLogIndexBuilder::stop()
+{
+    for (auto i = mThreads.begin(); i != mThreads.end(); i++)
+        (*i)->interrupt();
+
+    for (auto i = mThreads.begin(); i != mThreads.end(); i++)
+    {
+        (*i)->join();
+        delete *i;
+    }
+
+    mThreads.clear();
+}
+
+/*!
+ * \brief   索引を作成するシーケンスログファイルを追加
+ *
+ * \param[in]   path    シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogIndexBuilder::add(const CoreString* path)
+{
+    if (SequenceLogFileIndex::isIndexable(path) == false)
+        return;
+
+    String* str = new String;
+    str->copy(path);
+
+    ScopedLock lock(&mMutex);
+    mPaths.push_back(str);
+}
+
+/*!
+ * \brief   索引を作成するシーケンスログファイルを取得
+ *
+ * \param[out]  path    シーケンスログファイルのパスを受け取る
+ *
+ * \return  索引を作成するシーケンスログファイルがあればtrue、なければfalseを返す
+ */
+bool SequenceLogIndexBuilder::pop(String* path)
+{
+    ScopedLock lock(&mMutex);
+
+    if (mPaths.empty())
+        return false;
+
+    String* front = mPaths.front();
+    mPaths.pop_front();
+
+    path->copy(front);
+    delete front;
+
+    return true;
+}
+
+} // namespace slog
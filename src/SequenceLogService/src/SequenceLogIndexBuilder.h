@@ -0,0 +1,83 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*!
+ * \file    SequenceLogIndexBuilder.h
+ * \brief   シーケンスログファイル索引作成クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/String.h"
+#include "slog/Mutex.h"
+
+#include <list>
+
+namespace slog
+{
+class Thread;
+
+/*!
+ * \brief   シーケンスログファイル索引作成クラス
+ *
+ * \note    クローズしたシーケンスログファイルの索引をバックグラウンドのスレッドで作成する。
+ */
+class SequenceLogIndexBuilder
+{
+            /*!
+             * 索引を作成するシーケンスログファイル
+             */
+            std::list<String*> mPaths;
+
+            /*!
+             * 索引作成スレッド
+             */
+            std::list<Thread*> mThreads;
+
+            /*!
+             * ミューテックス
+             */
+            Mutex mMutex;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogIndexBuilder();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogIndexBuilder();
+
+            /*!
+             * 開始／停止
+             */
+            void start(int32_t threadCount);
+            void stop();
+
+            /*!
+             * 索引を作成するシーケンスログファイルを追加
+             */
+            void add(const CoreString* path);
+
+            /*!
+             * 索引を作成するシーケンスログファイルを取得
+             */
+            bool pop(String* path);
+};
+
+} // namespace slog
@@ -22,6 +22,7 @@
 #include "SequenceLogService.h"
 #include "SequenceLogServiceMain.h"
 #include "SharedFileContainer.h"
+#include "SequenceLogStatistics.h"
 
 #include "slog/WebSocket.h"
 #include "slog/Mutex.h"
@@ -32,6 +33,8 @@
 
 #include "Account.h"
 
+#include <chrono>
+
 #if defined(_WINDOWS)
     #pragma warning(disable:4996)
 #endif
@@ -179,14 +182,54 @@ inline void ItemList::merge(ItemList& list)
  */
 class ItemQueue
 {
-public:     ItemList    mList;              //!< シーケンスログアイテムリスト
-            ItemList    mStepOutList;       //!< STEP_IN処理時にあらかじめ作成しておくSTEP_OUT用アイテムリスト
+public:     ItemList                mList;          //!< シーケンスログアイテムリスト
+            ItemList                mStepOutList;   //!< STEP_IN処理時にあらかじめ作成しておくSTEP_OUT用アイテムリスト
+            FunctionStatisticsStack mFrames;        //!< 関数毎の所要時間統計用の呼び出し中の関数
+
+            int64_t                 mRootTime;      //!< 最上位の呼び出しの開始日時（ミリ秒）
+            int64_t                 mReceivedTime;  //!< 最上位の呼び出しを受信した日時（ミリ秒）
+            int32_t                 mKeepCount;     //!< 最上位の呼び出しの開始からキープしているアイテム数
+            bool                    mSevere;        //!< 警告以上のメッセージを含むかどうか
+            bool                    mFlushed;       //!< 最上位の呼び出しが終わる前に出力したかどうか
+            int64_t                 mKeepSize;      //!< mListにキープしているアイテムのサイズ
 
             ItemQueue()
             {
+                mRootTime = 0;
+                mReceivedTime = 0;
+                mKeepCount = 0;
+                mSevere = false;
+                mFlushed = false;
+                mKeepSize = 0;
             }
 };
 
+/*!
+ *  \brief  経過時間計測用の時間取得（ナノ秒）
+ */
+static int64_t getNanoTime()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+ *  \brief  圧縮ファイルの書き込み待ちのデータをブロックとして書き込むまでの最大時間（ナノ秒）
+ */
+static const int64_t COMPRESSED_FLUSH_INTERVAL = 1000000000;
+
+/*!
+ *  \brief  シーケンスログアイテムのサイズ取得（キープ中のメモリの見積もり）
+ */
+static int64_t getItemSize(SequenceLogItem* item)
+{
+    return
+        sizeof(*item) +
+        item->getClassName()->getCapacity() +
+        item->getFuncName()-> getCapacity() +
+        item->getMessage()->  getCapacity();
+}
+
 /*!
  *  \brief  コンストラクタ
  */
@@ -200,6 +243,28 @@ SequenceLogService::SequenceLogService(HttpRequest* httpRequest) : WebServerResp
     mStockItems =       nullptr;
 
     mSharedFileContainer = nullptr;
+    mClientCapabilities = 0;
+    mCompressedLog = false;
+    mStatistics = nullptr;
+
+    mSlowCallThreshold = 0;
+    mSlowCallMaxItems = 0;
+    mSlowCallCheckTime = 0;
+
+    mKeepSize = 0;
+    mMaxKeepSize = 0;
+    mMaxConnectionKeepSize = 0;
+
+    mLogControl = nullptr;
+    mLogControlLevel = 0;
+    mLogControlPending = false;
+
+    mOverloadControl = false;
+    mOverloadLevel = OVERLOAD_NONE;
+    mOverloadCalmCount = 0;
+    mOverloadCheckTime = 0;
+    mOverloadBusyTime = 0;
+    mOverloadWriteTime = 0;
 }
 
 /*!
@@ -243,6 +308,10 @@ bool SequenceLogService::init()
         // ログレベル取得
         mLogLevel = buffer->getInt();
 
+        // 対応している制御メッセージ取得（以前のクライアントは送信しない）
+        if (buffer->getPosition() + (int32_t)sizeof(int32_t) <= buffer->getCapacity())
+            mClientCapabilities = buffer->getInt();
+
         // バッファ削除
         delete buffer;
 
@@ -291,6 +360,23 @@ bool SequenceLogService::init()
 //      openSeqLogFile(mFile);
         initBinaryOrText(&baseFileName);
 
+        // 関数毎の所要時間統計
+        mStatistics = new SequenceLogStatistics(getUserId(), mProcess.getId(), &baseFileName);
+        serviceMain->addStatistics(mStatistics);
+        serviceMain->addService(this);
+
+        // 遅い呼び出しだけを残すかどうか
+        mSlowCallThreshold = serviceMain->getSlowCallThreshold();
+        mSlowCallMaxItems =  serviceMain->getSlowCallMaxItems();
+
+        // キープするシーケンスログアイテムの最大サイズ
+        mMaxKeepSize =           serviceMain->getMaxKeepSize();
+        mMaxConnectionKeepSize = serviceMain->getMaxConnectionKeepSize();
+
+        // 過負荷制御
+        mOverloadControl = serviceMain->isOverloadControl();
+        mOverloadCheckTime = getNanoTime();
+
         mOutputList =       new ItemList;
         mItemQueueManager = new ItemQueueManager;
 
@@ -317,6 +403,190 @@ FileInfo* SequenceLogService::getFileInfo() const
     return mSharedFileContainer->getFileInfo();
 }
 
+/*
+ *  \brief  ベースファイル名取得
+ */
+const CoreString* SequenceLogService::getBaseFileName() const
+{
+    return mSharedFileContainer->getBaseFileName();
+}
+
+/*!
+ * \brief   ログレベル変更
+ *
+ * \param[in]   message     クライアントに送信するログレベル制御メッセージ（LOG_LEVEL_CONTROL）
+ * \param[in]   length      メッセージの長さ
+ * \param[in]   logLevel    送信後にこのサービスで絞り込むログレベル
+ *
+ * \return  なし
+ *
+ * \note    送信は受信スレッドで行う（アイテムの受信後、または受信待ちのタイムアウト後）。
+ */
+void SequenceLogService::setLogControl(const ByteBuffer* message, int32_t length, int32_t logLevel)
+{
+    delete mLogControl;
+
+    mLogControl = new ByteBuffer(length);
+    mLogControl->put(message, length);
+    mLogControlLevel = logLevel;
+    mLogControlPending = true;
+}
+
+/*!
+ * \brief   呼び出し箇所の有効／無効変更
+ *
+ * \param[in]   message     クライアントに送信する呼び出し箇所制御メッセージ（SITE_ENABLE_CONTROL）
+ * \param[in]   length      メッセージの長さ
+ *
+ * \return  なし
+ *
+ * \note    ログレベル制御メッセージと同じく受信スレッドで送信する。
+ */
+void SequenceLogService::setSiteControl(const ByteBuffer* message, int32_t length)
+{
+    ByteBuffer* siteControl = new ByteBuffer(length);
+    siteControl->put(message, length);
+
+    mSiteControls.push_back(siteControl);
+    mLogControlPending = true;
+}
+
+/*!
+ * \brief   ログレベル制御メッセージ、呼び出し箇所制御メッセージ送信
+ */
+void SequenceLogService::sendLogControl()
+{
+    if (mLogControlPending == false)
+        return;
+
+    std::list<ByteBuffer*> messages;
+    {
+        ScopedLock lock(SequenceLogServiceMain::getInstance()->getMutex());
+
+        if (mLogControl)
+        {
+            messages.push_back(mLogControl);
+            mLogControl = nullptr;
+            mLogLevel = mLogControlLevel;
+        }
+
+        messages.splice(messages.end(), mSiteControls);
+        mLogControlPending = false;
+    }
+
+    for (auto i = messages.begin(); i != messages.end(); i++)
+    {
+        ByteBuffer* message = *i;
+
+        sendControl(message, message->getPosition());
+        delete message;
+    }
+}
+
+/*!
+ * \brief   呼び出し箇所更新
+ *
+ * \param[in]   item    クライアントから報告された呼び出し箇所（SITE）
+ *
+ * \return  なし
+ */
+void SequenceLogService::updateSite(const SequenceLogItem* item)
+{
+    ScopedLock lock(SequenceLogServiceMain::getInstance()->getMutex());
+    SequenceLogServiceSite& site = mSites[item->mSeqNo];
+
+    site.className.copy(item->getClassName());
+    site.funcName. copy(item->getFuncName());
+    site.level =   (int32_t)item->mLevel;
+    site.enabled = (item->mMessageId != 0);
+}
+
+/*!
+ * \brief   制御メッセージ送信（受信スレッドから呼ぶこと）
+ */
+void SequenceLogService::sendControl(const ByteBuffer* message, int32_t length)
+{
+    Socket* socket = mHttpRequest->getSocket();
+
+    try
+    {
+        WebSocket::sendHeader(socket, length, false);
+        socket->send(message, length);
+    }
+    catch (Exception& e)
+    {
+        noticeLog("sendControl: %s", e.getMessage());
+    }
+}
+
+/*!
+ * \brief   過負荷制御
+ *
+ * \param[in]   busyTime    受信したアイテムの処理にかかった時間（ナノ秒）
+ * \param[in]   writeTime   書き込み（ファイル出力、ビューアーへの送信）にかかった時間（ナノ秒）
+ *
+ * \return  なし
+ *
+ * \note    １秒毎に、処理時間の割合（受信待ちをしていない割合）と書き込みの最大時間から縮退レベルを決め、
+ *          上がった場合はすぐに、下がった場合は５秒続いてから１段階ずつクライアントに通知する。
+ */
+void SequenceLogService::updateOverload(int64_t busyTime, int64_t writeTime)
+{
+    if (mOverloadControl == false)
+        return;
+
+    mOverloadBusyTime += busyTime;
+
+    if (mOverloadWriteTime < writeTime)
+        mOverloadWriteTime = writeTime;
+
+    int64_t now = getNanoTime();
+    int64_t elapsed = now - mOverloadCheckTime;
+
+    if (elapsed < 1000 * 1000 * 1000)
+        return;
+
+    int32_t busy =    (int32_t)(mOverloadBusyTime * 100 / elapsed);
+    int64_t writeMs = mOverloadWriteTime / (1000 * 1000);
+
+    mOverloadCheckTime = now;
+    mOverloadBusyTime = 0;
+    mOverloadWriteTime = 0;
+
+    int32_t level = OVERLOAD_NONE;
+
+    if      (95 <= busy || 1000 <= writeMs) level = OVERLOAD_SAMPLING;
+    else if (80 <= busy ||  200 <= writeMs) level = OVERLOAD_DROP_STEP;
+    else if (60 <= busy ||   50 <= writeMs) level = OVERLOAD_DROP_DEBUG;
+
+    if (level == mOverloadLevel)
+    {
+        mOverloadCalmCount = 0;
+        return;
+    }
+
+    if (level < mOverloadLevel)
+    {
+        if (++mOverloadCalmCount < 5)
+            return;
+
+        level = mOverloadLevel - 1;
+    }
+
+    noticeLog("SequenceLogService: overload level %d -> %d (busy %d%%, write %lldms)",
+        mOverloadLevel, level, busy, (long long)writeMs);
+
+    mOverloadLevel = level;
+    mOverloadCalmCount = 0;
+
+    ByteBuffer message(sizeof(int32_t) * 3);
+    message.putInt(OVERLOAD_CONTROL);
+    message.putInt(level);
+    message.putInt(level == OVERLOAD_SAMPLING ? 10 : 1);
+
+    sendControl(&message, message.getPosition());
+}
+
 /*
  *  \brief  シーケンスログサービススレッド
  */
@@ -334,6 +604,9 @@ void SequenceLogService::writeMain()
     SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
     SequenceLogItem* item = mOutputList->front();
 
+    if (mOutputList->empty())
+        return;
+
     // 共有ファイルコンテナをロック
     ScopedLock lock(mSharedFileContainer->getMutex());
 
@@ -341,8 +614,9 @@ void SequenceLogService::writeMain()
     while (item && mOutputList->isEnd(item) == false)
     {
         File* file = mSharedFileContainer->getFile();
+        CompressedFile* compressedFile = mSharedFileContainer->getCompressedFile();
 
-        if (file->isOpen() == false)
+        if (file->isOpen() == false && compressedFile->isOpen() == false)
         {
             const FileInfo* fileInfo = openSeqLogFile(file);
             callLogFileChanged(fileInfo->getCanonicalPath());
@@ -354,13 +628,18 @@ void SequenceLogService::writeMain()
         else
             writeSeqLogFileText(file, item);
 
-        // ローテーション
+        // ローテーション（圧縮している場合は圧縮後のサイズで判定）
         uint32_t maxSize = serviceMain->getMaxFileSize();
-        uint64_t size = file->getSize();
+        uint64_t size = (compressedFile->isOpen() ? compressedFile->getSize() : file->getSize());
 
         if (maxSize != 0 && maxSize < size)
         {
             file->close();
+            compressedFile->close();
+
+            // クローズしたファイルの索引を作成
+            if (mBinaryLog)
+                serviceMain->buildIndex(mSharedFileContainer->getFileInfo()->getCanonicalPath());
 
             const FileInfo* fileInfo = openSeqLogFile(file);
             callLogFileChanged(fileInfo->getCanonicalPath());
@@ -375,6 +654,58 @@ void SequenceLogService::writeMain()
 
     // シーケンスログリスト初期化
     mOutputList->clear();
+
+    // 追跡中のビューアーが読めるように書き込んだ分をフラッシュして通知する
+    // （圧縮ファイルはブロック単位でしか読めないので、書き込み待ちが一定時間を超えたらブロックにする）
+    File* file = mSharedFileContainer->getFile();
+    FileInfo* fileInfo = mSharedFileContainer->getFileInfo();
+
+    if (file->isOpen())
+        file->flush();
+
+    flushCompressedFile(false);
+
+    if (fileInfo)
+        callLogWritten(fileInfo->getCanonicalPath());
+}
+
+/*!
+ *  \brief  圧縮ファイルの書き込み待ちのデータをブロックとして書き込む
+ *
+ *  \param[in]  idle    受信がない場合はtrue（書き込み待ちがあれば時間に関係なく書き込む）
+ *
+ *  \note   書き込み待ちのデータがない状態から COMPRESSED_FLUSH_INTERVAL を超えた場合にも書き込み、
+ *          ログが少ないプロセスでも追跡・検索・ダウンロードで読めるようにし、異常終了で失うデータを抑える。
+ */
+void SequenceLogService::flushCompressedFile(bool idle)
+{
+    if (mSharedFileContainer == nullptr)
+        return;
+
+    ScopedLock lock(mSharedFileContainer->getMutex());
+    CompressedFile* compressedFile = mSharedFileContainer->getCompressedFile();
+
+    if (compressedFile->isOpen() == false)
+        return;
+
+    int64_t now = getNanoTime();
+
+    if (compressedFile->getPendingSize() == 0)
+    {
+        mSharedFileContainer->setCleanTime(now);
+        return;
+    }
+
+    if (idle == false && now - mSharedFileContainer->getCleanTime() < COMPRESSED_FLUSH_INTERVAL)
+        return;
+
+    compressedFile->flush();
+    mSharedFileContainer->setCleanTime(now);
+
+    FileInfo* fileInfo = mSharedFileContainer->getFileInfo();
+
+    if (idle && fileInfo)
+        callLogWritten(fileInfo->getCanonicalPath());
 }
 
 /*!
@@ -386,6 +717,15 @@ void SequenceLogService::callLogFileChanged(const CoreString* fileName)
         (*i)->onLogFileChanged(this, fileName, getUserId());
 }
 
+/*!
+ *  \brief  リスナーのonLogWritten()をコール
+ */
+void SequenceLogService::callLogWritten(const CoreString* fileName)
+{
+    for (auto i = mListeners.begin(); i != mListeners.end(); i++)
+        (*i)->onLogWritten(this, fileName, getUserId());
+}
+
 /*!
  *  \brief  クリーンアップ
  */
@@ -399,6 +739,7 @@ void SequenceLogService::cleanUp()
             std::pair<uint32_t, ItemQueue*> pair = *i;
             ItemQueue* queue = pair.second;
 
+            releaseKeepSize(queue);
             delete queue;
         }
 
@@ -429,8 +770,27 @@ void SequenceLogService::cleanUp()
     // ログバッファ削除
     delete mSHM;
 
-    // シーケンスログ共有ファイルコンテナリリース
+    // 関数毎の所要時間統計削除
     SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+
+    serviceMain->removeService(this);
+
+    delete mLogControl;
+    mLogControl = nullptr;
+
+    for (auto i = mSiteControls.begin(); i != mSiteControls.end(); i++)
+        delete *i;
+
+    mSiteControls.clear();
+
+    if (mStatistics)
+    {
+        serviceMain->removeStatistics(mStatistics);
+        delete mStatistics;
+        mStatistics = nullptr;
+    }
+
+    // シーケンスログ共有ファイルコンテナリリース
     serviceMain->releaseSharedFileContainer(mSharedFileContainer, getUserId());
 
 //  mSharedFileContainer = nullptr;
@@ -457,6 +817,21 @@ const char* SequenceLogService::initBinaryOrText(CoreString* fileName)
 
 //  mBinaryLog = (stricmp(ext, "slog") == 0);
     mBinaryLog = (strcmp( ext, "slog") == 0);
+
+    // 圧縮
+    if (strcmp(ext, "slogz") == 0)
+    {
+        mBinaryLog = true;
+        mCompressedLog = true;
+    }
+    else
+    {
+        mCompressedLog = (mBinaryLog && SequenceLogServiceMain::getInstance()->isCompressLogFile());
+
+        if (mCompressedLog)
+            ext = "slogz";
+    }
+
     return ext;
 }
 
@@ -523,12 +898,25 @@ const FileInfo* SequenceLogService::openSeqLogFile(File* file) throw(Exception)
 //  noticeLog("    openSeqLogFile(): '%s'\n", canonicalPath->getBuffer());
 
     fileInfo->mkdir();
-    file->open(canonicalPath, File::WRITE);
+
+    if (mCompressedLog)
+    {
+        CompressedFile* compressedFile = mSharedFileContainer->getCompressedFile();
+        compressedFile->setSequenceLog(true);
+        compressedFile->open(canonicalPath, File::WRITE);
+    }
+    else
+    {
+        file->open(canonicalPath, File::WRITE);
+    }
 
     // ファイル情報更新
     fileInfo->update(true);
     fileInfo->setLastWriteTime(DateTime());
 
+    // ファイルカタログ更新（ファイル作成後に追記することでディレクトリより新しい状態にする）
+    serviceMain->updateFileInfoCatalog(fileInfo, getUserId());
+
     return fileInfo;
 }
 
@@ -538,7 +926,12 @@ const FileInfo* SequenceLogService::openSeqLogFile(File* file) throw(Exception)
 void SequenceLogService::writeSeqLogFile(File* file, SequenceLogItem* item)
 {
     uint32_t size = mFileOutputBuffer.putSequenceLogItem(item, true);
-    file->write(&mFileOutputBuffer, size);
+    CompressedFile* compressedFile = mSharedFileContainer->getCompressedFile();
+
+    if (compressedFile->isOpen())
+        compressedFile->write(&mFileOutputBuffer, size);
+    else
+        file->write(&mFileOutputBuffer, size);
 
     // シーケンスログプリントにログを送信
     writeSeqLogFileText(nullptr, item);
@@ -636,8 +1029,6 @@ void SequenceLogService::writeSeqLogFileText(File* file, SequenceLogItem* item)
  */
 void SequenceLogService::divideItems()
 {
-    SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
-
     // 振り分け処理
     do
     {
@@ -653,6 +1044,15 @@ void SequenceLogService::divideItems()
         }
 
         ItemQueue* queue = getItemQueue(src);
+
+        if (src.mType == SequenceLogItem::MESSAGE && src.mSeqNo == 0 && queue->mStepOutList.empty() == false)
+        {
+            // 過負荷のため呼び出しが送信されなかったメッセージは、呼び出し中の関数のメッセージとして扱う
+            mSHM->item.mSeqNo = queue->mStepOutList.back()->mSeqNo;
+        }
+
+        mStatistics->update(&queue->mFrames, &src);
+
         SequenceLogItem* item = createSequenceLogItem(queue, src);
 
         if (item == nullptr)
@@ -683,12 +1083,17 @@ void SequenceLogService::divideItems()
         // 終了処理。保留中のログを全て出力する
         SequenceLogItem* item;
 
+        DateTime now;
+        now.setCurrent();
+
         for (ItemQueueManager::iterator i = mItemQueueManager->begin(); i != mItemQueueManager->end(); i++)
         {
             std::pair<uint32_t, ItemQueue*> pair = *i;
             ItemQueue* queue = pair.second;
 
             mOutputList->merge(queue->mList);
+            releaseKeepSize(queue);
+            mStatistics->close(&queue->mFrames, now.toMilliSeconds());
 
             while ((item = queue->mStepOutList.back()) != nullptr)
             {
@@ -706,7 +1111,15 @@ void SequenceLogService::divideItems()
  */
 void SequenceLogService::keep(ItemQueue* queue, SequenceLogItem* item)
 {
+    if (0 < mSlowCallThreshold)
+    {
+        keepCallTree(queue, item);
+        return;
+    }
+
     queue->mList.push_back(item);
+    addKeepSize(queue, getItemSize(item));
+    checkKeepSize();
 }
 
 /*!
@@ -714,6 +1127,12 @@ void SequenceLogService::keep(ItemQueue* queue, SequenceLogItem* item)
  */
 void SequenceLogService::forward(ItemQueue* queue, SequenceLogItem* item)
 {
+    if (0 < mSlowCallThreshold)
+    {
+        keepCallTree(queue, item);
+        return;
+    }
+
     do
     {
         if (item->mType != SequenceLogItem::STEP_OUT)
@@ -745,6 +1164,7 @@ void SequenceLogService::forward(ItemQueue* queue, SequenceLogItem* item)
 #endif
 
             queue->mList.pop_back();
+            addKeepSize(queue, -getItemSize(delItem));
             pushStockItem(delItem);
 
             delItem = queue->mList.back();
@@ -767,9 +1187,210 @@ void SequenceLogService::forward(ItemQueue* queue, SequenceLogItem* item)
     {
         mOutputList->merge(queue->mList);
         mOutputList->push_back(item);
+        releaseKeepSize(queue);
     }
 }
 
+/*!
+ * \brief   遅い呼び出しの判定のためにシーケンスログアイテムをキープする
+ *
+ * \note    最上位の呼び出しが終わるまで、その中のアイテムを全てキープする。
+ *          終わった時点で所要時間が閾値以上か、警告以上のメッセージを含んでいれば出力し、そうでなければ破棄する。
+ *          キープしているアイテム数が上限に達した場合と、経過時間が閾値に達した場合は、
+ *          終わるのを待たずに出力し、以降のアイテムもそのまま出力する。
+ */
+void SequenceLogService::keepCallTree(ItemQueue* queue, SequenceLogItem* item)
+{
+    if (item->mType == SequenceLogItem::MESSAGE && (int32_t)item->mLevel < mLogLevel)
+    {
+        // ログレベル以下のメッセージログは出力せずストックに戻す
+        pushStockItem(item);
+        return;
+    }
+
+    bool inCall = (queue->mFlushed || queue->mList.empty() == false);
+
+    if (inCall == false && item->mType != SequenceLogItem::STEP_IN)
+    {
+        // 呼び出しの外のアイテムはそのまま出力
+        mOutputList->push_back(item);
+        return;
+    }
+
+    int64_t time = item->mDateTime.toMilliSeconds();
+
+    if (inCall == false)
+    {
+        DateTime now;
+        now.setCurrent();
+
+        queue->mRootTime = time;
+        queue->mReceivedTime = now.toMilliSeconds();
+        queue->mKeepCount = 0;
+        queue->mSevere = false;
+    }
+
+    if (item->mType == SequenceLogItem::MESSAGE && (int32_t)item->mLevel >= slog::WARN)
+        queue->mSevere = true;
+
+    bool slow = (mSlowCallThreshold <= time - queue->mRootTime);
+
+    if (queue->mFlushed)
+    {
+        mOutputList->push_back(item);
+    }
+    else
+    {
+        queue->mList.push_back(item);
+        queue->mKeepCount++;
+        addKeepSize(queue, getItemSize(item));
+
+        if (slow || mSlowCallMaxItems <= queue->mKeepCount)
+            flushCallTree(queue);
+        else
+            checkKeepSize();
+    }
+
+    if (queue->mStepOutList.empty())
+    {
+        // 最上位の呼び出しが終わった
+        if (queue->mSevere)
+            flushCallTree(queue);
+        else
+            discardCallTree(queue);
+
+        queue->mFlushed = false;
+    }
+}
+
+/*!
+ * \brief   キープしているアイテムを出力する
+ */
+void SequenceLogService::flushCallTree(ItemQueue* queue)
+{
+    mOutputList->merge(queue->mList);
+    releaseKeepSize(queue);
+    queue->mFlushed = true;
+}
+
+/*!
+ * \brief   キープしているアイテムを破棄する
+ */
+void SequenceLogService::discardCallTree(ItemQueue* queue)
+{
+    SequenceLogItem* item = queue->mList.front();
+
+    while (item && queue->mList.isEnd(item) == false)
+    {
+        SequenceLogItem* next = (SequenceLogItem*)item->mNext;
+
+        pushStockItem(item);
+        item = next;
+    }
+
+    queue->mList.clear();
+    releaseKeepSize(queue);
+}
+
+/*!
+ * \brief   長時間実行中の呼び出しを出力する
+ *
+ * \note    アイテムが来ないまま閾値を過ぎた呼び出しも、受信した日時から判断して出力する（１秒毎）。
+ */
+void SequenceLogService::flushLongRunningCalls()
+{
+    if (mSlowCallThreshold <= 0)
+        return;
+
+    DateTime now;
+    now.setCurrent();
+
+    int64_t time = now.toMilliSeconds();
+
+    if (time - mSlowCallCheckTime < 1000)
+        return;
+
+    mSlowCallCheckTime = time;
+
+    for (ItemQueueManager::iterator i = mItemQueueManager->begin(); i != mItemQueueManager->end(); i++)
+    {
+        ItemQueue* queue = i->second;
+
+        if (queue->mList.empty() == false && mSlowCallThreshold <= time - queue->mReceivedTime)
+            flushCallTree(queue);
+    }
+}
+
+/*!
+ * \brief   キープ中のシーケンスログアイテムのサイズを加算する
+ */
+void SequenceLogService::addKeepSize(ItemQueue* queue, int64_t size)
+{
+    queue->mKeepSize += size;
+    mKeepSize += size;
+
+    SequenceLogServiceMain::getInstance()->addKeepSize(size);
+}
+
+/*!
+ * \brief   キープ中のシーケンスログアイテムのサイズを解放する（mListを空にした後に呼ぶ）
+ */
+void SequenceLogService::releaseKeepSize(ItemQueue* queue)
+{
+    if (queue->mKeepSize)
+        addKeepSize(queue, -queue->mKeepSize);
+}
+
+/*!
+ * \brief   キープ中のシーケンスログアイテムを出力する
+ */
+void SequenceLogService::flushKeptItems(ItemQueue* queue)
+{
+    if (queue->mList.empty())
+        return;
+
+    if (0 < mSlowCallThreshold)
+    {
+        flushCallTree(queue);
+        return;
+    }
+
+    mOutputList->merge(queue->mList);
+    releaseKeepSize(queue);
+}
+
+/*!
+ * \brief   キープ中のシーケンスログアイテムのサイズを調べる
+ *
+ * \note    この接続のサイズが上限を超えた場合は最も大きいキューを、
+ *          全接続の合計が上限を超えた場合はこの接続の全てのキューを出力して解放する。
+ *          終わらない呼び出し（イベントループ等）の中のアイテムが溜まり続けるのを防ぐ。
+ */
+void SequenceLogService::checkKeepSize()
+{
+    bool overConnection = (0 < mMaxConnectionKeepSize && mMaxConnectionKeepSize < mKeepSize);
+    bool overAll =        (0 < mMaxKeepSize && mMaxKeepSize < SequenceLogServiceMain::getInstance()->getKeepSize());
+
+    if (overConnection == false && overAll == false)
+        return;
+
+    ItemQueue* largest = nullptr;
+
+    for (ItemQueueManager::iterator i = mItemQueueManager->begin(); i != mItemQueueManager->end(); i++)
+    {
+        ItemQueue* queue = i->second;
+
+        if (overAll)
+            flushKeptItems(queue);
+
+        else if (largest == nullptr || largest->mKeepSize < queue->mKeepSize)
+            largest = queue;
+    }
+
+    if (largest)
+        flushKeptItems(largest);
+}
+
 /*!
  *  \brief  シーケンスログアイテムキュー取得
  */
@@ -804,6 +1425,14 @@ SequenceLogItem* SequenceLogService::createSequenceLogItem(ItemQueue* queue, con
         return item;
     }
 
+    if (src.mType == SequenceLogItem::MESSAGE && src.mSeqNo == 0 && queue->mStepOutList.empty())
+    {
+        // 呼び出しの外のメッセージ（過負荷のため呼び出しが送信されなかった等）
+         item = popStockItem();
+        *item = src;
+        return item;
+    }
+
     do
     {
         item = queue->mStepOutList.back();
@@ -850,15 +1479,39 @@ void SequenceLogService::receiveMain()
     {
         Socket* socket = mHttpRequest->getSocket();
 
+        // 呼び出し箇所の報告を要求する
+        if (mClientCapabilities & CLIENT_CAPABILITY_SITE_LIST)
+        {
+            ByteBuffer siteList(sizeof(int32_t));
+            siteList.putInt(SITE_LIST_CONTROL);
+            sendControl(&siteList, siteList.getPosition());
+        }
+
+        // コンパクト形式で送信するように要求する
+        if (mClientCapabilities & CLIENT_CAPABILITY_COMPACT)
+        {
+            ByteBuffer compact(sizeof(int32_t));
+            compact.putInt(COMPACT_ENCODING_CONTROL);
+            sendControl(&compact, compact.getPosition());
+        }
+
         while (true)
         {
             bool isReceive = socket->isReceiveData(3000);
+            int64_t start = getNanoTime();
 
             if (isInterrupted())
                 break;
 
             if (isReceive == false)
+            {
+                flushLongRunningCalls();
+                writeMain();
+                flushCompressedFile(true);
+                sendLogControl();
+                updateOverload(0, 0);
                 continue;
+            }
 
             // シーケンスログアイテム受信
             ByteBuffer* buffer = WebSocket::recv(socket, nullptr);
@@ -867,9 +1520,16 @@ void SequenceLogService::receiveMain()
                 continue;
 
             // バッファからシーケンスログアイテムを設定
-            ((SequenceLogByteBuffer*)buffer)->getSequenceLogItem(&mSHM->item);
+            ((SequenceLogByteBuffer*)buffer)->getSequenceLogItem(&mSHM->item, false, &mCompactState);
             delete buffer;
 
+            // 呼び出し箇所の報告はファイルに書き込まない
+            if (mSHM->item.mType == SequenceLogItem::SITE)
+            {
+                updateSite(&mSHM->item);
+                continue;
+            }
+
             // シーケンスログアイテムのタイプが STEP_IN の場合はシーケンス番号を返信する
             if (mSHM->item.mType == SequenceLogItem::STEP_IN)
             {
@@ -887,7 +1547,14 @@ void SequenceLogService::receiveMain()
             }
 
             divideItems();
+            flushLongRunningCalls();
+
+            int64_t writeStart = getNanoTime();
             writeMain();
+
+            int64_t end = getNanoTime();
+            sendLogControl();
+            updateOverload(end - start, end - writeStart);
         }
     }
     catch (Exception& e)
@@ -29,6 +29,7 @@
 #include "slog/FixedString.h"
 
 #include <map>
+#include <atomic>
 
 namespace slog
 {
@@ -37,9 +38,23 @@ class ItemQueue;
 class ItemList;
 class SharedFileContainer;
 class SequenceLogServiceListener;
+class SequenceLogStatistics;
 
 typedef std::map<uint32_t, ItemQueue*> ItemQueueManager;        // キーはスレッドID
 
+/*!
+ *  \brief  クライアントの呼び出し箇所
+ */
+struct SequenceLogServiceSite
+{
+    String  className;  //!< クラス名
+    String  funcName;   //!< 関数名
+    int32_t level;      //!< ログレベル（ERROR + 1 は送信しない）
+    bool    enabled;    //!< 有効フラグ
+};
+
+typedef std::map<uint32_t, SequenceLogServiceSite> SequenceLogServiceSiteMap;   // キーは呼び出し箇所ID
+
 /*!
  *  \brief  シーケンスログサービスクラス
  */
@@ -65,16 +80,31 @@ class SequenceLogService : public WebServerResponse
              */
             SequenceLogByteBuffer mFileOutputBuffer;
 
+            /*!
+             * クライアントから受信するコンパクト形式の符号化状態
+             */
+            SequenceLogCompactState mCompactState;
+
             /*!
              * ログレベル
              */
             int32_t mLogLevel;
 
+            /*!
+             * クライアントが対応している制御メッセージ（CLIENT_CAPABILITY_*）
+             */
+            int32_t mClientCapabilities;
+
             /*!
              * シーケンスログファイルタイプ
              */
             bool mBinaryLog;
 
+            /*!
+             * シーケンスログファイルを圧縮するかどうか
+             */
+            bool mCompressedLog;
+
             /*!
              * シーケンスログアイテムキューマネージャー
              */
@@ -95,6 +125,84 @@ class SequenceLogService : public WebServerResponse
              */
             std::list<SequenceLogServiceListener*> mListeners;
 
+            /*!
+             * 関数毎の所要時間統計
+             */
+            SequenceLogStatistics* mStatistics;
+
+            /*!
+             * 遅い呼び出しだけを残す場合の閾値（ミリ秒、0は全て残す）
+             */
+            int32_t mSlowCallThreshold;
+
+            /*!
+             * 遅い呼び出しの判定のためにスレッド毎にキープする最大アイテム数
+             */
+            int32_t mSlowCallMaxItems;
+
+            /*!
+             * 長時間実行中の呼び出しを最後に調べた日時（ミリ秒）
+             */
+            int64_t mSlowCallCheckTime;
+
+            /*!
+             * キープ中のシーケンスログアイテムのサイズ
+             */
+            int64_t mKeepSize;
+
+            /*!
+             * キープするシーケンスログアイテムの最大サイズ（全接続の合計／この接続、0は無制限）
+             */
+            int64_t mMaxKeepSize;
+            int64_t mMaxConnectionKeepSize;
+
+            /*!
+             * クライアントに送信するログレベル制御メッセージ（SequenceLogServiceMainのミューテックスで保護）
+             */
+            ByteBuffer* mLogControl;
+
+            /*!
+             * ログレベル制御メッセージ送信後のログレベル
+             */
+            int32_t mLogControlLevel;
+
+            /*!
+             * ログレベル制御メッセージがあるかどうか
+             */
+            std::atomic<bool> mLogControlPending;
+
+            /*!
+             * クライアントに送信する呼び出し箇所制御メッセージ（SequenceLogServiceMainのミューテックスで保護）
+             */
+            std::list<ByteBuffer*> mSiteControls;
+
+            /*!
+             * クライアントから報告された呼び出し箇所（SequenceLogServiceMainのミューテックスで保護）
+             */
+            SequenceLogServiceSiteMap mSites;
+
+            /*!
+             * 過負荷制御を行うかどうか
+             */
+            bool mOverloadControl;
+
+            /*!
+             * クライアントに送信した縮退レベル
+             */
+            int32_t mOverloadLevel;
+
+            /*!
+             * 縮退レベルより低い負荷が続いた回数（計測期間毎）
+             */
+            int32_t mOverloadCalmCount;
+
+            /*!
+             * 負荷の計測期間の開始時間、処理時間、書き込みの最大時間（ナノ秒）
+             */
+            int64_t mOverloadCheckTime;
+            int64_t mOverloadBusyTime;
+            int64_t mOverloadWriteTime;
+
             /*!
              * コンストラクタ
              */
@@ -115,6 +223,31 @@ private:    virtual bool init() override;
              */
 public:     FileInfo* getFileInfo() const;
 
+            /*!
+             * プロセスID取得
+             */
+            uint32_t getProcessId() const {return mProcess.getId();}
+
+            /*!
+             * ベースファイル名取得
+             */
+            const CoreString* getBaseFileName() const;
+
+            /*!
+             * ログレベル変更（SequenceLogServiceMainのミューテックスをロックしておくこと）
+             */
+            void setLogControl(const ByteBuffer* message, int32_t length, int32_t logLevel);
+
+            /*!
+             * 呼び出し箇所の有効／無効変更（SequenceLogServiceMainのミューテックスをロックしておくこと）
+             */
+            void setSiteControl(const ByteBuffer* message, int32_t length);
+
+            /*!
+             * 呼び出し箇所取得（SequenceLogServiceMainのミューテックスをロックしておくこと）
+             */
+            const SequenceLogServiceSiteMap* getSites() const {return &mSites;}
+
             /*!
              * リスナー追加
              */
@@ -125,7 +258,9 @@ public:     FileInfo* getFileInfo() const;
              */
 private:    virtual void run() override;
             void writeMain();
+            void flushCompressedFile(bool idle);
             void callLogFileChanged(const CoreString* fileName);
+            void callLogWritten(const CoreString* fileName);
             void cleanUp();
 
             /*!
@@ -136,6 +271,38 @@ private:    virtual void run() override;
             void keep(   ItemQueue* queue, SequenceLogItem* item);
             void forward(ItemQueue* queue, SequenceLogItem* item);
 
+            /*!
+             * 遅い呼び出しの判定
+             */
+            void keepCallTree(ItemQueue* queue, SequenceLogItem* item);
+            void flushCallTree(ItemQueue* queue);
+            void discardCallTree(ItemQueue* queue);
+            void flushLongRunningCalls();
+
+            /*!
+             * 制御メッセージ送信
+             */
+            void sendControl(const ByteBuffer* message, int32_t length);
+            void sendLogControl();
+
+            /*!
+             * 呼び出し箇所更新
+             */
+            void updateSite(const SequenceLogItem* item);
+
+            /*!
+             * 過負荷制御
+             */
+            void updateOverload(int64_t busyTime, int64_t writeTime);
+
+            /*!
+             * キープ中のシーケンスログアイテムのサイズ管理
+             */
+            void addKeepSize(ItemQueue* queue, int64_t size);
+            void releaseKeepSize(ItemQueue* queue);
+            void flushKeptItems(ItemQueue* queue);
+            void checkKeepSize();
+
             ItemQueue* getItemQueue(const SequenceLogItem& item) const;
             SequenceLogItem* createSequenceLogItem(ItemQueue* queue, const SequenceLogItem& src);
 
@@ -25,6 +25,8 @@
 #include "SequenceLogServiceWebServerResponse.h"
 #include "SequenceLogFileManager.h"
 #include "SharedFileContainer.h"
+#include "SequenceLogIndexBuilder.h"
+#include "SequenceLogArchiver.h"
 
 #include "slog/Mutex.h"
 #include "slog/FileInfo.h"
@@ -51,8 +53,21 @@ SequenceLogServiceMain::SequenceLogServiceMain()
 
     mMaxFileSize = 1024 * 4;
     mMaxFileCount = 10;
+    mCompressLogFile = false;
 
     mSequenceLogFileManagerList = new SequenceLogFileManagerList;
+    mIndexBuilder = new SequenceLogIndexBuilder;
+
+    mArchiveDays = 0;
+    mArchiver = new SequenceLogArchiver;
+
+    mSlowCallThreshold = 0;
+    mSlowCallMaxItems = 100000;
+
+    mKeepSize = 0;
+    mMaxKeepSize = 256 * 1024 * 1024;
+    mMaxConnectionKeepSize = 32 * 1024 * 1024;
+    mOverloadControl = false;
 
     mCleanupFlag = false;
 
@@ -76,6 +91,8 @@ SequenceLogServiceMain::~SequenceLogServiceMain()
     SLOG(CLS_NAME, "~SequenceLogServiceMain");
 
     delete mSequenceLogFileManagerList;
+    delete mIndexBuilder;
+    delete mArchiver;
     delete mMutex;
 }
 
@@ -107,18 +124,96 @@ void SequenceLogServiceMain::addFileInfo(FileInfo* info, int32_t userId)
     sequenceLogFileManager->addFileInfo(info);
 }
 
+/*!
+ *  \brief  シーケンスログファイルカタログ更新
+ */
+void SequenceLogServiceMain::updateFileInfoCatalog(const FileInfo* info, int32_t userId)
+{
+    SequenceLogFileManager* sequenceLogFileManager = getSequenceLogFileManager(userId);
+    sequenceLogFileManager->updateCatalog(info);
+}
+
+/*!
+ *  \brief  シーケンスログファイル索引作成
+ */
+void SequenceLogServiceMain::buildIndex(const CoreString* path)
+{
+    mIndexBuilder->add(path);
+}
+
+/*!
+ *  \brief  アーカイブするシーケンスログファイルを取得
+ */
+void SequenceLogServiceMain::getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const
+{
+    ScopedLock lock(getMutex());
+    mSequenceLogFileManagerList->getArchiveTargets(paths, lastWriteTime);
+}
+
+/*!
+ *  \brief  シーケンスログファイル情報をアーカイブに置き換える
+ */
+bool SequenceLogServiceMain::replaceFileInfo(const CoreString* path, const CoreString* archivePath)
+{
+    ScopedLock lock(getMutex());
+    return mSequenceLogFileManagerList->replaceFileInfo(path, archivePath);
+}
+
+/*!
+ *  \brief  関数毎の所要時間統計を追加
+ */
+void SequenceLogServiceMain::addStatistics(SequenceLogStatistics* statistics)
+{
+    ScopedLock lock(getMutex());
+    mStatistics.push_back(statistics);
+}
+
+/*!
+ *  \brief  関数毎の所要時間統計を削除
+ */
+void SequenceLogServiceMain::removeStatistics(SequenceLogStatistics* statistics)
+{
+    ScopedLock lock(getMutex());
+    mStatistics.remove(statistics);
+}
+
+/*!
+ *  \brief  接続中のシーケンスログサービスを追加
+ */
+void SequenceLogServiceMain::addService(SequenceLogService* service)
+{
+    ScopedLock lock(getMutex());
+    mServices.push_back(service);
+}
+
+/*!
+ *  \brief  接続中のシーケンスログサービスを削除
+ */
+void SequenceLogServiceMain::removeService(SequenceLogService* service)
+{
+    ScopedLock lock(getMutex());
+    mServices.remove(service);
+}
+
 /*!
  *  \brief  シーケンスログサービスメインスレッド
  */
 void SequenceLogServiceMain::run()
 {
     SLOG(CLS_NAME, "run");
+    mIndexBuilder->start(2);
+
+    if (0 < mArchiveDays)
+        mArchiver->start(mArchiveDays);
+
     mWebServerManager.start();
 
     while (isInterrupted() == false)
         sleep(2000);
 
     mWebServerManager.stop();
+    mIndexBuilder->stop();
+    mArchiver->stop();
     cleanup();
 }
 
@@ -234,6 +329,120 @@ void SequenceLogServiceMain::setMaxFileCount(int32_t count)
     mSequenceLogFileManagerList->setMaxFileCount(count);
 }
 
+/*!
+ *  \brief  シーケンスログファイルを圧縮するかどうか
+ */
+bool SequenceLogServiceMain::isCompressLogFile() const
+{
+    return mCompressLogFile;
+}
+
+/*!
+ *  \brief  シーケンスログファイルを圧縮するかどうか設定
+ */
+void SequenceLogServiceMain::setCompressLogFile(bool compress)
+{
+    mCompressLogFile = compress;
+}
+
+/*!
+ *  \brief  シーケンスログファイルをアーカイブするまでの日数取得
+ */
+int32_t SequenceLogServiceMain::getArchiveDays() const
+{
+    return mArchiveDays;
+}
+
+/*!
+ *  \brief  シーケンスログファイルをアーカイブするまでの日数設定
+ */
+void SequenceLogServiceMain::setArchiveDays(int32_t days)
+{
+    mArchiveDays = days;
+}
+
+/*!
+ *  \brief  遅い呼び出しだけを残す場合の閾値取得
+ */
+int32_t SequenceLogServiceMain::getSlowCallThreshold() const
+{
+    return mSlowCallThreshold;
+}
+
+/*!
+ *  \brief  遅い呼び出しだけを残す場合の閾値設定
+ *
+ *  \note    0より大きい場合、スレッド毎に最上位の呼び出しが終わるまでのアイテムを全てキープし、
+ *          所要時間が閾値以上か、警告以上のメッセージを含む場合だけ出力する。
+ */
+void SequenceLogServiceMain::setSlowCallThreshold(int32_t threshold)
+{
+    mSlowCallThreshold = threshold;
+}
+
+/*!
+ *  \brief  遅い呼び出しの判定のためにスレッド毎にキープする最大アイテム数取得
+ */
+int32_t SequenceLogServiceMain::getSlowCallMaxItems() const
+{
+    return mSlowCallMaxItems;
+}
+
+/*!
+ *  \brief  遅い呼び出しの判定のためにスレッド毎にキープする最大アイテム数設定
+ */
+void SequenceLogServiceMain::setSlowCallMaxItems(int32_t count)
+{
+    mSlowCallMaxItems = count;
+}
+
+/*!
+ *  \brief  キープするシーケンスログアイテムの最大サイズ取得（全接続の合計）
+ */
+int64_t SequenceLogServiceMain::getMaxKeepSize() const
+{
+    return mMaxKeepSize;
+}
+
+/*!
+ *  \brief  キープするシーケンスログアイテムの最大サイズ取得（接続毎）
+ */
+int64_t SequenceLogServiceMain::getMaxConnectionKeepSize() const
+{
+    return mMaxConnectionKeepSize;
+}
+
+/*!
+ *  \brief  キープするシーケンスログアイテムの最大サイズ設定
+ *
+ *  \param[in]  size            全接続の合計の最大サイズ（0は無制限）
+ *  \param[in]  connectionSize  接続毎の最大サイズ（0は無制限）
+ *
+ *  \note    STEP_OUTが来るまでキープしているアイテムがどちらかを超えた場合、
+ *          キープしているアイテムを出力して解放する。
+ */
+void SequenceLogServiceMain::setMaxKeepSize(int64_t size, int64_t connectionSize)
+{
+    mMaxKeepSize = size;
+    mMaxConnectionKeepSize = connectionSize;
+}
+
+/*!
+ *  \brief  過負荷時にクライアントに間引きを指示するかどうか
+ */
+bool SequenceLogServiceMain::isOverloadControl() const
+{
+    return mOverloadControl;
+}
+
+/*!
+ *  \brief  過負荷時にクライアントに間引きを指示するかどうか設定
+ */
+void SequenceLogServiceMain::setOverloadControl(bool overloadControl)
+{
+    mOverloadControl = overloadControl;
+}
+
 /*!
  *  \brief  シーケンスログWEBサーバーポート取得
  */
@@ -390,4 +599,15 @@ void SequenceLogServiceMain::onUpdateLog(const Buffer* text, int32_t userId)
         (*i)->onUpdateLog(text, userId);
 }
 
+/*!
+ *  \brief	シーケンスログ書き込み通知
+ */
+void SequenceLogServiceMain::onLogWritten(Thread* thread, const CoreString* fileName, int32_t userId)
+{
+    ScopedLock lock(getMutex());
+
+    for (auto i = mListeners.begin(); i != mListeners.end(); i++)
+        (*i)->onLogWritten(thread, fileName, userId);
+}
+
 } // namespace slog
@@ -28,6 +28,7 @@
 #include "slog/WebServerManager.h"
 
 #include <list>
+#include <atomic>
 
 namespace slog
 {
@@ -39,6 +40,10 @@ class SequenceLogFileManagerList;
 class SequenceLogFileManager;
 class SharedFileContainer;
 class FileInfo;
+class SequenceLogIndexBuilder;
+class SequenceLogArchiver;
+class SequenceLogStatistics;
+class DateTime;
 
 /*!
  * \brief   シーケンスログサービスリスナークラス
@@ -54,6 +59,11 @@ public:     virtual void onLogFileChanged(Thread* thread, const CoreString* file
              * シーケンスログ更新通知
              */
             virtual void onUpdateLog(const Buffer* text,  int32_t userId) {}
+
+            /*!
+             * シーケンスログ書き込み通知
+             */
+            virtual void onLogWritten(Thread* thread, const CoreString* fileName, int32_t userId) {}
 };
 
 /*!
@@ -79,11 +89,71 @@ class SequenceLogServiceMain :
              */
             int32_t mMaxFileCount;
 
+            /*!
+             * シーケンスログファイルを圧縮するかどうか
+             */
+            bool mCompressLogFile;
+
             /*!
              * シーケンスログファイルマネージャーリスト
              */
             SequenceLogFileManagerList* mSequenceLogFileManagerList;
 
+            /*!
+             * シーケンスログファイル索引作成
+             */
+            SequenceLogIndexBuilder* mIndexBuilder;
+
+            /*!
+             * シーケンスログファイルをアーカイブするまでの日数（0はアーカイブしない）
+             */
+            int32_t mArchiveDays;
+
+            /*!
+             * シーケンスログアーカイブ作成
+             */
+            SequenceLogArchiver* mArchiver;
+
+            /*!
+             * 遅い呼び出しだけを残す場合の閾値（ミリ秒、0は全て残す）
+             */
+            int32_t mSlowCallThreshold;
+
+            /*!
+             * 遅い呼び出しの判定のためにスレッド毎にキープする最大アイテム数
+             */
+            int32_t mSlowCallMaxItems;
+
+            /*!
+             * キープ中のシーケンスログアイテムのサイズ（全接続の合計）
+             */
+            std::atomic<int64_t> mKeepSize;
+
+            /*!
+             * キープするシーケンスログアイテムの最大サイズ（全接続の合計、0は無制限）
+             */
+            int64_t mMaxKeepSize;
+
+            /*!
+             * キープするシーケンスログアイテムの最大サイズ（接続毎、0は無制限）
+             */
+            int64_t mMaxConnectionKeepSize;
+
+            /*!
+             * 過負荷時にクライアントに間引きを指示するかどうか
+             */
+            bool mOverloadControl;
+
+            /*!
+             * 関数毎の所要時間統計（接続中のシーケンスログサービス毎）
+             */
+            std::list<SequenceLogStatistics*> mStatistics;
+
+            /*!
+             * 接続中のシーケンスログサービス
+             */
+            std::list<SequenceLogService*> mServices;
+
             /*!
              * クリーンアップフラグ
              */
@@ -165,6 +235,38 @@ public:     void printLog(const Buffer* text, int32_t len, int32_t userId);
              */
             std::list<FileInfo*>* getFileInfoArray(int32_t userId) const;
             void addFileInfo(FileInfo* info, int32_t accountId);
+            void updateFileInfoCatalog(const FileInfo* info, int32_t userId);
+
+            /*!
+             * シーケンスログファイル索引作成
+             */
+            void buildIndex(const CoreString* path);
+
+            /*!
+             * シーケンスログアーカイブ関連
+             */
+            void getArchiveTargets(std::list<String*>* paths, const DateTime& lastWriteTime) const;
+            bool replaceFileInfo(const CoreString* path, const CoreString* archivePath);
+
+            /*!
+             * 関数毎の所要時間統計関連（取得時はミューテックスをロックしておくこと）
+             */
+            void addStatistics(   SequenceLogStatistics* statistics);
+            void removeStatistics(SequenceLogStatistics* statistics);
+            const std::list<SequenceLogStatistics*>* getStatisticsList() const {return &mStatistics;}
+
+            /*!
+             * キープ中のシーケンスログアイテムのサイズ（全接続の合計）
+             */
+            int64_t addKeepSize(int64_t size) {return (mKeepSize += size);}
+            int64_t getKeepSize() const {return mKeepSize;}
+
+            /*!
+             * 接続中のシーケンスログサービス関連（取得時はミューテックスをロックしておくこと）
+             */
+            void addService(   SequenceLogService* service);
+            void removeService(SequenceLogService* service);
+            const std::list<SequenceLogService*>* getServiceList() const {return &mServices;}
 
             /*!
              * ミューテックス取得
@@ -195,6 +297,43 @@ public:     void printLog(const Buffer* text, int32_t len, int32_t userId);
             int32_t  getMaxFileCount() const;
             void     setMaxFileCount(int32_t count);
 
+            /*!
+             * シーケンスログファイルを圧縮するかどうか
+             */
+            bool isCompressLogFile() const;
+            void setCompressLogFile(bool compress);
+
+            /*!
+             * シーケンスログファイルをアーカイブするまでの日数
+             */
+            int32_t getArchiveDays() const;
+            void    setArchiveDays(int32_t days);
+
+            /*!
+             * 遅い呼び出しだけを残す場合の閾値（ミリ秒）
+             */
+            int32_t getSlowCallThreshold() const;
+            void    setSlowCallThreshold(int32_t threshold);
+
+            /*!
+             * 遅い呼び出しの判定のためにスレッド毎にキープする最大アイテム数
+             */
+            int32_t getSlowCallMaxItems() const;
+            void    setSlowCallMaxItems(int32_t count);
+
+            /*!
+             * キープするシーケンスログアイテムの最大サイズ
+             */
+            int64_t getMaxKeepSize() const;
+            int64_t getMaxConnectionKeepSize() const;
+            void    setMaxKeepSize(int64_t size, int64_t connectionSize);
+
+            /*!
+             * 過負荷時にクライアントに間引きを指示するかどうか
+             */
+            bool isOverloadControl() const;
+            void setOverloadControl(bool overloadControl);
+
             /*!
              * シーケンスログWEBサーバーポート
              */
@@ -236,6 +375,7 @@ private:    virtual void onThreadInitialized(Thread* thread) override;
 
             virtual void onLogFileChanged(Thread* thread, const CoreString* fileName, int32_t userId) override;
             virtual void onUpdateLog(const Buffer* text,  int32_t userId) override;
+            virtual void onLogWritten(Thread* thread, const CoreString* fileName, int32_t userId) override;
 };
 
 /*!
@@ -24,6 +24,11 @@
 #include "LoginResponse.h"
 #include "AccountResponse.h"
 #include "GetLogResponse.h"
+#include "SearchLogResponse.h"
+#include "MergeLogResponse.h"
+#include "StatisticsResponse.h"
+#include "LogLevelResponse.h"
+#include "SitesResponse.h"
 #include "SequenceLogService.h"
 
 namespace slog
@@ -48,6 +53,11 @@ static WebServerResponse* createSequenceLogServiceWebServerResponse(HttpRequest*
 static WebServerResponse* createLoginResponse(                      HttpRequest* httpRequest) {return new LoginResponse(                      httpRequest);}
 static WebServerResponse* createAccountResponse(                    HttpRequest* httpRequest) {return new AccountResponse(                    httpRequest);}
 static WebServerResponse* createGetLogResponse(                     HttpRequest* httpRequest) {return new GetLogResponse(                     httpRequest);}
+static WebServerResponse* createSearchLogResponse(                  HttpRequest* httpRequest) {return new SearchLogResponse(                  httpRequest);}
+static WebServerResponse* createMergeLogResponse(                   HttpRequest* httpRequest) {return new MergeLogResponse(                   httpRequest);}
+static WebServerResponse* createStatisticsResponse(                 HttpRequest* httpRequest) {return new StatisticsResponse(                 httpRequest);}
+static WebServerResponse* createLogLevelResponse(                   HttpRequest* httpRequest) {return new LogLevelResponse(                   httpRequest);}
+static WebServerResponse* createSitesResponse(                      HttpRequest* httpRequest) {return new SitesResponse(                      httpRequest);}
 static WebServerResponse* createSequenceLogService(                 HttpRequest* httpRequest) {return new SequenceLogService(                 httpRequest);}
 
 /*!
@@ -58,6 +68,11 @@ const WebServer::CREATE* SequenceLogServiceWebServer::getCreateList() const
     static const CREATE creates[] =
     {
         {"getLog",                "",              createGetLogResponse},
+        {"search",                "",              createSearchLogResponse},
+        {"merge",                 "",              createMergeLogResponse},
+        {"stats",                 "",              createStatisticsResponse},
+        {"logLevel",              "",              createLogLevelResponse},
+        {"sites",                 "",              createSitesResponse},
         {"outputLog",             "",              createSequenceLogService},
         {"login.html",            "",              createLoginResponse},
         {"account.html",          "",              createAccountResponse},
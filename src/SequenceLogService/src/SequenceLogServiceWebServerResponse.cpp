@@ -22,6 +22,7 @@
 #include "SequenceLogServiceWebServerResponse.h"
 #include "SequenceLogServiceMain.h"
 #include "R.h"
+#include "SequenceLogTraceConverter.h"
 
 #include "slog/HttpRequest.h"
 #include "slog/Json.h"
@@ -77,31 +78,82 @@ void SequenceLogServiceWebServerResponse::run()
         String logsPath = "logs/";
         if (url->indexOf(logsPath.getBuffer()) == 0)
         {
-            SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
-            ScopedLock lock(serviceMain->getMutex());
+            String format;
+            mHttpRequest->getParam("format", &format);
 
-            auto sum = serviceMain->getFileInfoArray(getUserId());
-
-            for (auto i = sum->begin(); i != sum->end(); i++)
+            String tracePath;
             {
-                const FileInfo* fileInfo = *i;
-                const CoreString* canonicalPath = fileInfo->getCanonicalPath();
+                SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+                ScopedLock lock(serviceMain->getMutex());
+
+                auto sum = serviceMain->getFileInfoArray(getUserId());
 
-                if (canonicalPath->lastIndexOf(url->getBuffer() + logsPath.getLength()) > 0)
+                for (auto i = sum->begin(); i != sum->end(); i++)
                 {
-                    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
-                    String ext = ".exe";
-                    mimeType->analize(&ext);
-                    sendBinary(nullptr, canonicalPath);
-                    return;
+                    const FileInfo* fileInfo = *i;
+                    const CoreString* canonicalPath = fileInfo->getCanonicalPath();
+
+                    if (canonicalPath->lastIndexOf(url->getBuffer() + logsPath.getLength()) > 0)
+                    {
+                        if (format.equals("trace"))
+                        {
+                            // 変換はロックの外で行う
+                            tracePath.copy(canonicalPath);
+                            break;
+                        }
+
+                        MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+                        String ext = ".exe";
+                        mimeType->analize(&ext);
+                        sendBinary(nullptr, canonicalPath);
+                        return;
+                    }
                 }
             }
+
+            if (0 < tracePath.getLength())
+            {
+                sendTrace(&tracePath);
+                return;
+            }
         }
     }
 
     WebServerResponse::run();
 }
 
+/*!
+ * \brief  Chrome Trace Event形式で送信
+ *
+ * \param[in]   logPath シーケンスログファイルのパス
+ *
+ * \return  なし
+ */
+void SequenceLogServiceWebServerResponse::sendTrace(const CoreString* logPath)
+{
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+    mimeType->setText("application/json");
+
+    sendHttpHeader(nullptr, -1);
+
+    try
+    {
+        SequenceLogTraceConverter converter;
+        converter.open(logPath);
+
+        String json;
+
+        while (converter.read(&json, 64 * 1024))
+            sendContent(&json);
+
+        sendContent(nullptr);
+    }
+    catch (Exception& e)
+    {
+        noticeLog("SequenceLogServiceWebServerResponse::sendTrace: %s", e.getMessage());
+    }
+}
+
 /*!
  * \brief  変数初期化
  */
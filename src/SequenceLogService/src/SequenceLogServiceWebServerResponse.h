@@ -63,6 +63,11 @@ private:    virtual void run() override;
              * ログアウト
              */
             void logout();
+
+            /*!
+             * Chrome Trace Event形式で送信
+             */
+            void sendTrace(const CoreString* logPath);
 };
 
 } // namespace slog
@@ -0,0 +1,376 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogStatistics.cpp
+ * \brief   関数毎の所要時間統計クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SequenceLogStatistics.h"
+#include "SequenceLogItem.h"
+
+#include "slog/Json.h"
+
+#include <algorithm>
+
+namespace slog
+{
+
+/*!
+ * \brief   コンストラクタ
+ */
+FunctionStatistics::FunctionStatistics()
+{
+    count.    store(0, std::memory_order_relaxed);
+    inclusive.store(0, std::memory_order_relaxed);
+    exclusive.store(0, std::memory_order_relaxed);
+    max.      store(0, std::memory_order_relaxed);
+
+    for (int32_t i = 0; i < BUCKET_COUNT; i++)
+        histogram[i].store(0, std::memory_order_relaxed);
+
+    next = nullptr;
+}
+
+/*!
+ * \brief   所要時間を追加
+ *
+ * \param[in]   inclusiveTime   所要時間（ミリ秒、呼び出した関数を含む）
+ * \param[in]   exclusiveTime   所要時間（ミリ秒、呼び出した関数を除く）
+ *
+ * \return  なし
+ *
+ * \note    書き込むのは受信スレッドだけなので、読み込んでから書き込んでも値が失われることはない。
+ */
+void FunctionStatistics::add(int64_t inclusiveTime, int64_t exclusiveTime)
+{
+    count.    store(count.    load(std::memory_order_relaxed) + 1,             std::memory_order_relaxed);
+    inclusive.store(inclusive.load(std::memory_order_relaxed) + inclusiveTime, std::memory_order_relaxed);
+    exclusive.store(exclusive.load(std::memory_order_relaxed) + exclusiveTime, std::memory_order_relaxed);
+
+    if (max.load(std::memory_order_relaxed) < inclusiveTime)
+        max.store(inclusiveTime, std::memory_order_relaxed);
+
+    std::atomic<uint32_t>* bucket = &histogram[getBucket(inclusiveTime)];
+    bucket->store(bucket->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief   バケット番号取得
+ *
+ * \param[in]   value   値
+ *
+ * \return  バケット番号
+ *
+ * \note    LINEAR_COUNT未満の値はそのまま、それ以上は２のべき乗の区間をSUB_BUCKET_COUNTに分割したバケットに割り当てる。
+ */
+int32_t FunctionStatistics::getBucket(int64_t value)
+{
+    if (value < LINEAR_COUNT)
+        return (int32_t)(value < 0 ? 0 : value);
+
+    if (((int64_t)1 << (MAX_EXPONENT + 1)) <= value)
+        return BUCKET_COUNT - 1;
+
+    int32_t exponent = SUB_BUCKET_BITS + 1;
+
+    while (((int64_t)1 << (exponent + 1)) <= value)
+        exponent++;
+
+    int32_t sub = (int32_t)(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return LINEAR_COUNT + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT + sub;
+}
+
+/*!
+ * \brief   バケットの下限値取得
+ *
+ * \param[in]   bucket  バケット番号
+ *
+ * \return  バケットの下限値
+ */
+int64_t FunctionStatistics::getBucketValue(int32_t bucket)
+{
+    if (bucket < LINEAR_COUNT)
+        return bucket;
+
+    int32_t exponent = (bucket - LINEAR_COUNT) / SUB_BUCKET_COUNT + SUB_BUCKET_BITS + 1;
+    int32_t sub =      (bucket - LINEAR_COUNT) % SUB_BUCKET_COUNT;
+
+    return (int64_t)(SUB_BUCKET_COUNT + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+/*!
+ * \brief   コンストラクタ
+ */
+SequenceLogStatistics::SequenceLogStatistics(int32_t userId, uint32_t processId, const CoreString* baseFileName)
+{
+    mUserId = userId;
+    mProcessId = processId;
+    mBaseFileName.copy(baseFileName);
+    mHead.store(nullptr, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief   デストラクタ
+ */
+SequenceLogStatistics::~SequenceLogStatistics()
+{
+    FunctionStatistics* function = mHead.load(std::memory_order_relaxed);
+
+    while (function)
+    {
+        FunctionStatistics* next = function->next;
+        delete function;
+        function = next;
+    }
+}
+
+/*!
+ * \brief   シーケンスログアイテムを集計
+ *
+ * \param[in,out]   stack   呼び出し中の関数（スレッド毎）
+ * \param[in]       item    シーケンスログアイテム
+ *
+ * \return  なし
+ *
+ * \note    STEP_OUTがないまま別の関数のアイテムが来た場合は、そのアイテムの日時で呼び出し中の関数を終了する
+ *          （SequenceLogService::createSequenceLogItem() と同じ扱い）。
+ */
+void SequenceLogStatistics::update(FunctionStatisticsStack* stack, const SequenceLogItem* item)
+{
+    int64_t dateTime = item->mDateTime.toMilliSeconds();
+
+    if (item->mType == SequenceLogItem::STEP_IN)
+    {
+        FunctionStatisticsFrame frame;
+        frame.seqNo =      item->mSeqNo;
+        frame.statistics = getFunction(item);
+        frame.start =      dateTime;
+        frame.children =   0;
+
+        stack->push_back(frame);
+        return;
+    }
+
+    while (stack->size() && stack->back().seqNo != item->mSeqNo)
+        pop(stack, dateTime);
+
+    if (item->mType == SequenceLogItem::STEP_OUT && stack->size())
+        pop(stack, dateTime);
+}
+
+/*!
+ * \brief   呼び出し中の関数を全て終了
+ *
+ * \param[in,out]   stack   呼び出し中の関数（スレッド毎）
+ * \param[in]       end     終了日時（ミリ秒）
+ *
+ * \return  なし
+ */
+void SequenceLogStatistics::close(FunctionStatisticsStack* stack, int64_t end)
+{
+    while (stack->size())
+        pop(stack, end);
+}
+
+/*!
+ * \brief   関数終了
+ */
+void SequenceLogStatistics::pop(FunctionStatisticsStack* stack, int64_t end)
+{
+    FunctionStatisticsFrame frame = stack->back();
+    stack->pop_back();
+
+    int64_t inclusiveTime = std::max(end - frame.start, (int64_t)0);
+    int64_t exclusiveTime = std::max(inclusiveTime - frame.children, (int64_t)0);
+
+    frame.statistics->add(inclusiveTime, exclusiveTime);
+
+    if (stack->size())
+        stack->back().children += inclusiveTime;
+}
+
+/*!
+ * \brief   関数毎の所要時間統計取得
+ *
+ * \param[in]   item    STEP_INのシーケンスログアイテム
+ *
+ * \return  関数毎の所要時間統計
+ *
+ * \note    名前ではなくIDで出力された関数は "#ID" を名前とする。
+ */
+FunctionStatistics* SequenceLogStatistics::getFunction(const SequenceLogItem* item)
+{
+    if (item->mClassId)
+        mClassName.format("#%u", item->mClassId);
+    else
+        mClassName.copy(item->getClassName());
+
+    if (item->mFuncId)
+        mFuncName.format("#%u", item->mFuncId);
+    else
+        mFuncName.copy(item->getFuncName());
+
+    mKey.copy(&mClassName);
+    mKey.append("::");
+    mKey.append(&mFuncName);
+
+    auto i = mFunctions.find(mKey);
+
+    if (i != mFunctions.end())
+        return i->second;
+
+    FunctionStatistics* function = new FunctionStatistics;
+    function->className.copy(&mClassName);
+    function->funcName. copy(&mFuncName);
+    function->next = mHead.load(std::memory_order_relaxed);
+
+    mFunctions[mKey] = function;
+
+    // 初期化を終えてから読み込み側に公開する
+    mHead.store(function, std::memory_order_release);
+    return function;
+}
+
+/*!
+ * \brief   関数毎の所要時間統計のスナップショット
+ */
+struct FunctionStatisticsSnapshot
+{
+            const FunctionStatistics*   function;
+            int64_t                     count;
+            int64_t                     inclusive;
+            int64_t                     exclusive;
+            int64_t                     max;
+
+            bool operator<(const FunctionStatisticsSnapshot& other) const {return (inclusive > other.inclusive);}
+};
+
+/*!
+ * \brief   パーセンタイル取得
+ *
+ * \param[in]   histogram   ヒストグラム
+ * \param[in]   total       ヒストグラムの合計
+ * \param[in]   percentile  パーセンタイル（0〜100）
+ * \param[in]   max         最大値
+ *
+ * \return  パーセンタイル値（バケット内の最大値、ただし最大値を超えない）
+ */
+static int64_t getPercentile(const std::vector<uint32_t>& histogram, int64_t total, int32_t percentile, int64_t max)
+{
+    int64_t target = (total * percentile + 99) / 100;
+    int64_t sum = 0;
+
+    if (target == 0)
+        target = 1;
+
+    for (int32_t i = 0; i < FunctionStatistics::BUCKET_COUNT; i++)
+    {
+        sum += histogram[i];
+
+        if (target <= sum)
+        {
+            int64_t value = (i + 1 < FunctionStatistics::BUCKET_COUNT ? FunctionStatistics::getBucketValue(i + 1) - 1 : max);
+            return std::min(value, max);
+        }
+    }
+
+    return max;
+}
+
+/*!
+ * \brief   JSON形式で取得
+ *
+ * \param[in]   limit   関数の最大数（所要時間の合計が大きい順）
+ *
+ * \return  JSONオブジェクト（呼び出し側で削除すること）
+ *
+ * \note    受信スレッドが更新中でもロックせずに読み込むので、関数毎の値は多少ずれることがある。
+ */
+Json* SequenceLogStatistics::toJson(int32_t limit) const
+{
+    std::vector<FunctionStatisticsSnapshot> snapshots;
+
+    for (const FunctionStatistics* function = mHead.load(std::memory_order_acquire); function; function = function->next)
+    {
+        FunctionStatisticsSnapshot snapshot;
+        snapshot.function =  function;
+        snapshot.count =     function->count.    load(std::memory_order_relaxed);
+        snapshot.inclusive = function->inclusive.load(std::memory_order_relaxed);
+        snapshot.exclusive = function->exclusive.load(std::memory_order_relaxed);
+        snapshot.max =       function->max.      load(std::memory_order_relaxed);
+
+        snapshots.push_back(snapshot);
+    }
+
+    std::sort(snapshots.begin(), snapshots.end());
+
+    if (0 <= limit && limit < (int32_t)snapshots.size())
+        snapshots.resize(limit);
+
+    Json* json = Json::getNewObject();
+    json->add("pid",  (int32_t)mProcessId);
+    json->add("file", &mBaseFileName);
+
+    Json* functions = Json::getNewObject("functions");
+    std::vector<uint32_t> histogram(FunctionStatistics::BUCKET_COUNT);
+
+    for (auto i = snapshots.begin(); i != snapshots.end(); i++)
+    {
+        const FunctionStatistics* function = i->function;
+        int64_t total = 0;
+
+        for (int32_t bucket = 0; bucket < FunctionStatistics::BUCKET_COUNT; bucket++)
+        {
+            histogram[bucket] = function->histogram[bucket].load(std::memory_order_relaxed);
+            total += histogram[bucket];
+        }
+
+        Json* item = Json::getNewObject();
+        item->add("class",     &function->className);
+        item->add("func",      &function->funcName);
+        item->add("count",     i->count);
+        item->add("inclusive", i->inclusive);
+        item->add("exclusive", i->exclusive);
+        item->add("max",       i->max);
+        item->add("p50",       getPercentile(histogram, total, 50, i->max));
+        item->add("p90",       getPercentile(histogram, total, 90, i->max));
+        item->add("p99",       getPercentile(histogram, total, 99, i->max));
+
+        // ヒストグラム（空のバケットは省略）
+        Json* buckets = Json::getNewObject("histogram");
+
+        for (int32_t bucket = 0; bucket < FunctionStatistics::BUCKET_COUNT; bucket++)
+        {
+            if (histogram[bucket] == 0)
+                continue;
+
+            Json* value = Json::getNewObject();
+            value->add("value", FunctionStatistics::getBucketValue(bucket));
+            value->add("count", (int64_t)histogram[bucket]);
+
+            buckets->add(value);
+        }
+
+        item->add(buckets);
+        functions->add(item);
+    }
+
+    json->add(functions);
+    return json;
+}
+
+} // namespace slog
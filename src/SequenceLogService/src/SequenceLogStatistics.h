@@ -0,0 +1,189 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogStatistics.h
+ * \brief   関数毎の所要時間統計クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/String.h"
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace slog
+{
+class SequenceLogItem;
+class Json;
+
+/*!
+ * \brief   関数毎の所要時間統計
+ *
+ * \note    書き込むのは受信スレッドだけなので、値はロックせずにatomicで読み書きする。
+ */
+struct FunctionStatistics
+{
+            enum
+            {
+                SUB_BUCKET_BITS =   3,                                  //!< ２のべき乗の区間を分割する数（ビット数）
+                SUB_BUCKET_COUNT =  1 << SUB_BUCKET_BITS,
+                LINEAR_COUNT =      SUB_BUCKET_COUNT * 2,               //!< 値をそのままバケット番号にする範囲
+                MAX_EXPONENT =      40,                                 //!< 最大の指数（約35年）
+                BUCKET_COUNT =      LINEAR_COUNT + (MAX_EXPONENT - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT,
+            };
+
+            String                  className;                      //!< クラス名
+            String                  funcName;                       //!< 関数名
+
+            std::atomic<int64_t>    count;                          //!< 呼び出し回数
+            std::atomic<int64_t>    inclusive;                      //!< 所要時間の合計（ミリ秒、呼び出した関数を含む）
+            std::atomic<int64_t>    exclusive;                      //!< 所要時間の合計（ミリ秒、呼び出した関数を除く）
+            std::atomic<int64_t>    max;                            //!< 最大所要時間（ミリ秒）
+            std::atomic<uint32_t>   histogram[BUCKET_COUNT];        //!< 所要時間のヒストグラム
+
+            FunctionStatistics*     next;                           //!< 次の関数
+
+            /*!
+             * コンストラクタ
+             */
+            FunctionStatistics();
+
+            /*!
+             * 所要時間を追加
+             */
+            void add(int64_t inclusiveTime, int64_t exclusiveTime);
+
+            /*!
+             * バケット番号取得
+             */
+            static int32_t getBucket(int64_t value);
+
+            /*!
+             * バケットの下限値取得
+             */
+            static int64_t getBucketValue(int32_t bucket);
+};
+
+/*!
+ * \brief   呼び出し中の関数
+ */
+struct FunctionStatisticsFrame
+{
+            uint32_t                seqNo;                          //!< シーケンス番号
+            FunctionStatistics*     statistics;                     //!< 関数毎の所要時間統計
+            int64_t                 start;                          //!< 開始日時（ミリ秒）
+            int64_t                 children;                       //!< 呼び出した関数の所要時間（ミリ秒）
+};
+
+typedef std::vector<FunctionStatisticsFrame> FunctionStatisticsStack;
+
+/*!
+ * \brief   関数毎の所要時間統計クラス
+ *
+ * \note    シーケンスログサービス（ユーザー、プロセス、ベースファイル名の組）毎に作成し、
+ *          STEP_INとSTEP_OUTの組から関数毎の呼び出し回数、所要時間、所要時間のヒストグラムを集計する。
+ *          ヒストグラムは２のべき乗の区間をさらに８分割した対数バケットで、誤差は1/8以内。
+ *          関数は先頭に追加するだけのリストで公開するので、読み込み側もロックせずに辿れる。
+ */
+class SequenceLogStatistics
+{
+            /*!
+             * ユーザーID
+             */
+            int32_t mUserId;
+
+            /*!
+             * プロセスID
+             */
+            uint32_t mProcessId;
+
+            /*!
+             * ベースファイル名
+             */
+            String mBaseFileName;
+
+            /*!
+             * 関数毎の所要時間統計（受信スレッド専用、キーは "クラス名::関数名"）
+             */
+            std::map<String, FunctionStatistics*> mFunctions;
+
+            /*!
+             * 関数毎の所要時間統計のリストの先頭（読み込み側に公開）
+             */
+            std::atomic<FunctionStatistics*> mHead;
+
+            /*!
+             * キー作成用バッファ
+             */
+            String mKey;
+            String mClassName;
+            String mFuncName;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogStatistics(int32_t userId, uint32_t processId, const CoreString* baseFileName);
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogStatistics();
+
+            /*!
+             * ユーザーID取得
+             */
+            int32_t getUserId() const {return mUserId;}
+
+            /*!
+             * プロセスID取得
+             */
+            uint32_t getProcessId() const {return mProcessId;}
+
+            /*!
+             * ベースファイル名取得
+             */
+            const CoreString* getBaseFileName() const {return &mBaseFileName;}
+
+            /*!
+             * シーケンスログアイテムを集計
+             */
+            void update(FunctionStatisticsStack* stack, const SequenceLogItem* item);
+
+            /*!
+             * 呼び出し中の関数を全て終了
+             */
+            void close(FunctionStatisticsStack* stack, int64_t end);
+
+            /*!
+             * JSON形式で取得
+             */
+            Json* toJson(int32_t limit) const;
+
+            /*!
+             * 関数毎の所要時間統計取得
+             */
+private:    FunctionStatistics* getFunction(const SequenceLogItem* item);
+
+            /*!
+             * 関数終了
+             */
+            void pop(FunctionStatisticsStack* stack, int64_t end);
+};
+
+} // namespace slog
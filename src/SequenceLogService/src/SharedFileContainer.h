@@ -22,6 +22,7 @@
 #pragma once
 
 #include "slog/File.h"
+#include "slog/CompressedFile.h"
 #include "slog/FixedString.h"
 #include "slog/Mutex.h"
 
@@ -33,10 +34,12 @@ namespace slog
 class SharedFileContainer
 {
             File                    mFile;                      //!< 共有ファイル
+            CompressedFile          mCompressedFile;            //!< 共有ファイル（圧縮）
             FixedString<MAX_PATH>   mBaseFileName;              //!< ベースファイル名
             FileInfo*               mFileInfo;                  //!< シーケンスログファイル情報
             Mutex                   mMutex;                     //!< ミューテックス
             int32_t                 mReferenceCount;            //!< 参照カウント
+            int64_t                 mCleanTime;                 //!< 圧縮ファイルに書き込み待ちのデータがないことを最後に確認した時刻（ナノ秒）
 
             /*!
              * コンストラクタ
@@ -45,12 +48,14 @@ public:     SharedFileContainer()
             {
                 mFileInfo = nullptr;
                 mReferenceCount = 1;
+                mCleanTime = 0;
             }
 
             /*!
              * 共有ファイル
              */
             File* getFile() const {return (File*)&mFile;}
+            CompressedFile* getCompressedFile() const {return (CompressedFile*)&mCompressedFile;}
 
             /*!
              * ベースファイル名
@@ -63,6 +68,12 @@ public:     SharedFileContainer()
             FileInfo* getFileInfo() const {return (FileInfo*)mFileInfo;}
             void setFileInfo(FileInfo* fileInfo) {mFileInfo = fileInfo;}
 
+            /*!
+             * 圧縮ファイルに書き込み待ちのデータがないことを最後に確認した時刻
+             */
+            int64_t getCleanTime() const {return mCleanTime;}
+            void setCleanTime(int64_t cleanTime) {mCleanTime = cleanTime;}
+
             /*!
              * ミューテックス
              */
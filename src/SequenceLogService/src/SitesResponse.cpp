@@ -0,0 +1,213 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SitesResponse.cpp
+ * \brief   呼び出し箇所応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "SitesResponse.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogService.h"
+
+#include "slog/HttpRequest.h"
+#include "slog/Json.h"
+#include "slog/MimeType.h"
+#include "slog/Mutex.h"
+#include "slog/SequenceLog.h"
+
+#include <stdlib.h>
+
+namespace slog
+{
+const char* SitesResponse::CLS_NAME = "SitesResponse";
+
+/*!
+ * \brief   実行
+ *
+ * \note    接続中のクライアントから報告された呼び出し箇所（ID、クラス名、関数名、ログレベル、有効フラグ）をJSON形式で送信する。
+ *          enable、disable に呼び出し箇所IDのカンマ区切り（'*' は全て）を指定すると、有効／無効を切り替える。
+ *          切り替えはクライアントからの報告後に反映される。
+ *          pid（プロセスID）、file（ベースファイル名）で対象のクライアントを絞り込む。
+ */
+void SitesResponse::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    if (getUserId() < 0)
+    {
+        // 未ログイン
+        redirect("/login.html");
+        return;
+    }
+
+    String str;
+    String fileName;
+    String enable;
+    String disable;
+
+    mHttpRequest->getParam("pid", &str);
+    int32_t processId = (str.getLength() ? atoi(str.getBuffer()) : -1);
+
+    mHttpRequest->getParam("file",    &fileName);
+    mHttpRequest->getParam("enable",  &enable);
+    mHttpRequest->getParam("disable", &disable);
+
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+    mimeType->setType(MimeType::Type::TEXT);
+
+    std::vector<uint32_t> enableIds;
+    std::vector<uint32_t> disableIds;
+    bool enableAll;
+    bool disableAll;
+
+    if (getIds(&enableIds,  &enableAll,  &enable)  == false ||
+        getIds(&disableIds, &disableAll, &disable) == false)
+    {
+        str.copy("invalid site id");
+
+        sendHttpHeader("400 Bad Request", nullptr, str.getLength(), nullptr);
+        sendContent(&str);
+        return;
+    }
+
+    Json* json = Json::getNewObject();
+    int32_t count = 0;
+
+    {
+        SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+        ScopedLock lock(serviceMain->getMutex());
+
+        auto list = serviceMain->getServiceList();
+
+        for (auto i = list->begin(); i != list->end(); i++)
+        {
+            SequenceLogService* service = *i;
+
+            if (service->getUserId() != getUserId())
+                continue;
+
+            if (processId != -1 && service->getProcessId() != (uint32_t)processId)
+                continue;
+
+            if (fileName.getLength() && service->getBaseFileName()->equals(&fileName) == false)
+                continue;
+
+            const SequenceLogServiceSiteMap* sites = service->getSites();
+
+            // 有効／無効切り替え
+            for (int32_t enabled = 1; 0 <= enabled; enabled--)
+            {
+                std::vector<uint32_t>& ids = (enabled ? enableIds : disableIds);
+                bool all =                   (enabled ? enableAll : disableAll);
+
+                if (all)
+                {
+                    ids.clear();
+
+                    for (auto j = sites->begin(); j != sites->end(); j++)
+                        ids.push_back(j->first);
+                }
+
+                if (ids.empty())
+                    continue;
+
+                ByteBuffer message(sizeof(int32_t) * (3 + (int32_t)ids.size()));
+                message.putInt(SITE_ENABLE_CONTROL);
+                message.putInt(enabled);
+                message.putInt((int32_t)ids.size());
+
+                for (auto j = ids.begin(); j != ids.end(); j++)
+                    message.putInt(*j);
+
+                service->setSiteControl(&message, message.getPosition());
+            }
+
+            // 呼び出し箇所
+            Json* item = Json::getNewObject();
+            item->add("pid",  (int32_t)service->getProcessId());
+            item->add("file", service->getBaseFileName());
+
+            Json* siteList = Json::getNewObject("sites");
+
+            for (auto j = sites->begin(); j != sites->end(); j++)
+            {
+                const SequenceLogServiceSite& site = j->second;
+
+                Json* value = Json::getNewObject();
+                value->add("id",      (int32_t)j->first);
+                value->add("class",   &site.className);
+                value->add("func",    &site.funcName);
+                value->add("level",   site.level);
+                value->add("enabled", (int32_t)site.enabled);
+
+                siteList->add(value);
+            }
+
+            item->add(siteList);
+            json->add(item);
+            count++;
+        }
+    }
+
+    String content;
+
+    if (count)
+        json->serialize(&content);
+    else
+        content.copy("[]");
+
+    delete json;
+
+    sendHttpHeader(nullptr, content.getLength());
+    sendContent(&content);
+}
+
+/*!
+ * \brief   呼び出し箇所IDのリスト取得
+ *
+ * \param[out]  ids     呼び出し箇所ID
+ * \param[out]  all     全ての呼び出し箇所かどうか（'*'）
+ * \param[in]   str     呼び出し箇所IDのカンマ区切り
+ *
+ * \return  パラメータが正しければtrue
+ */
+bool SitesResponse::getIds(std::vector<uint32_t>* ids, bool* all, const CoreString* str)
+{
+    *all = str->equals("*");
+
+    if (*all)
+        return true;
+
+    const char* p = str->getBuffer();
+    const char* end = p + str->getLength();
+
+    while (p < end)
+    {
+        char* next;
+        unsigned long id = strtoul(p, &next, 10);
+
+        if (next == p || id == 0 || (next < end && *next != ','))
+            return false;
+
+        ids->push_back((uint32_t)id);
+        p = next + 1;
+    }
+
+    return true;
+}
+
+} // namespace slog
@@ -0,0 +1,53 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SitesResponse.h
+ * \brief   呼び出し箇所応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/WebServerResponseThread.h"
+#include <vector>
+
+namespace slog
+{
+
+/*!
+ * \brief   呼び出し箇所応答クラス
+ */
+class SitesResponse : public WebServerResponse
+{
+            static const char* CLS_NAME;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SitesResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest) {}
+
+            /*!
+             * 実行
+             */
+private:    virtual void run() override;
+
+            /*!
+             * 呼び出し箇所IDのリスト取得
+             */
+            static bool getIds(std::vector<uint32_t>* ids, bool* all, const CoreString* str);
+};
+
+} // namespace slog
@@ -0,0 +1,109 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    StatisticsResponse.cpp
+ * \brief   関数毎の所要時間統計応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#include "StatisticsResponse.h"
+#include "SequenceLogServiceMain.h"
+#include "SequenceLogStatistics.h"
+
+#include "slog/HttpRequest.h"
+#include "slog/Json.h"
+#include "slog/MimeType.h"
+#include "slog/Mutex.h"
+#include "slog/SequenceLog.h"
+
+#include <stdlib.h>
+
+namespace slog
+{
+const char* StatisticsResponse::CLS_NAME = "StatisticsResponse";
+
+/*!
+ * \brief   実行
+ *
+ * \note    接続中のプロセス毎に、関数毎の呼び出し回数、所要時間（ミリ秒）、パーセンタイル、ヒストグラムをJSON形式で送信する。
+ *          pid（プロセスID）、file（ベースファイル名）で絞り込み、limit（既定は100）で関数の数を制限する。
+ */
+void StatisticsResponse::run()
+{
+    SLOG(CLS_NAME, "run");
+
+    if (getUserId() < 0)
+    {
+        // 未ログイン
+        redirect("/login.html");
+        return;
+    }
+
+    String str;
+    String fileName;
+
+    mHttpRequest->getParam("pid", &str);
+    int32_t processId = (str.getLength() ? atoi(str.getBuffer()) : -1);
+
+    mHttpRequest->getParam("file", &fileName);
+
+    mHttpRequest->getParam("limit", &str);
+    int32_t limit = (str.getLength() ? atoi(str.getBuffer()) : 100);
+
+    Json* json = Json::getNewObject();
+    int32_t count = 0;
+
+    {
+        SequenceLogServiceMain* serviceMain = SequenceLogServiceMain::getInstance();
+        ScopedLock lock(serviceMain->getMutex());
+
+        auto list = serviceMain->getStatisticsList();
+
+        for (auto i = list->begin(); i != list->end(); i++)
+        {
+            const SequenceLogStatistics* statistics = *i;
+
+            if (statistics->getUserId() != getUserId())
+                continue;
+
+            if (processId != -1 && statistics->getProcessId() != (uint32_t)processId)
+                continue;
+
+            if (fileName.getLength() && statistics->getBaseFileName()->equals(&fileName) == false)
+                continue;
+
+            json->add(statistics->toJson(limit));
+            count++;
+        }
+    }
+
+    String content;
+
+    if (count)
+        json->serialize(&content);
+    else
+        content.copy("[]");
+
+    delete json;
+
+    MimeType* mimeType = (MimeType*)mHttpRequest->getMimeType();
+    mimeType->setType(MimeType::Type::TEXT);
+
+    sendHttpHeader(nullptr, content.getLength());
+    sendContent(&content);
+}
+
+} // namespace slog
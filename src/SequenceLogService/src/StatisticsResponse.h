@@ -0,0 +1,47 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    StatisticsResponse.h
+ * \brief   関数毎の所要時間統計応答クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/WebServerResponseThread.h"
+
+namespace slog
+{
+
+/*!
+ * \brief   関数毎の所要時間統計応答クラス
+ */
+class StatisticsResponse : public WebServerResponse
+{
+            static const char* CLS_NAME;
+
+            /*!
+             * コンストラクタ
+             */
+public:     StatisticsResponse(HttpRequest* httpRequest) : WebServerResponse(httpRequest) {}
+
+            /*!
+             * 実行
+             */
+private:    virtual void run() override;
+};
+
+} // namespace slog
@@ -0,0 +1,90 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    getSequenceLogItemJson.cpp
+ * \brief   シーケンスログアイテム（JSON）取得
+ * \author  Copyright 2015 printf.jp
+ */
+#include "getSequenceLogItemJson.h"
+#include "SequenceLogItem.h"
+
+#include "slog/Json.h"
+#include "slog/String.h"
+
+namespace slog
+{
+
+/*!
+ *  \brief  バイナリ形式のシーケンスログファイルかどうか調べる
+ *
+ *  \note   テキスト形式のシーケンスログファイルは検索、マージの対象外。
+ */
+bool isBinarySequenceLogFile(const CoreString* path)
+{
+    return (path->lastIndexOf(".slog") != -1);
+}
+
+/*!
+ *  \brief  シーケンスログアイテム（JSON）取得
+ *
+ *  \param[out]  line        JSON Lines形式の１行（改行は含まない）を受け取る
+ *  \param[in]   fileName    シーケンスログファイル名
+ *  \param[in]   item        シーケンスログアイテム
+ *  \param[in]   className   クラス名（出力しない場合はnullptr）
+ *  \param[in]   funcName    関数名（出力しない場合はnullptr）
+ *
+ *  \return  JSONを作成した場合はtrue、ファイルに書き込まないタイプ（SITE）や不正なタイプの場合はfalseを返す
+ */
+bool getSequenceLogItemJson(CoreString* line, const char* fileName, const SequenceLogItem* item, const CoreString* className, const CoreString* funcName)
+{
+    static const char* types[] =  {"stepIn", "stepOut", "message"};
+    static const char* levels[] = {"d", "i", "w", "e"};
+
+    if (sizeof(types) / sizeof(types[0]) <= item->mType)
+        return false;
+
+    String dateTimeString;
+    const DateTime* dt = &item->mDateTime;
+    dateTimeString.format("%04d/%02d/%02d %02d:%02d:%02d.%03d",
+        dt->getYear(), dt->getMonth(), dt->getDay(), dt->getHour(), dt->getMinute(), dt->getSecond(), dt->getMilliSecond());
+
+    Json* json = Json::getNewObject();
+    json->add("file",     fileName);
+    json->add("seq",      (int32_t)item->mSeqNo);
+    json->add("time",     &dateTimeString);
+    json->add("thread",   (int32_t)item->mThreadId);
+    json->add("type",     types[item->mType]);
+
+    if (item->mType == SequenceLogItem::MESSAGE)
+        json->add("level", levels[item->mLevel & 3]);
+
+    if (className && funcName)
+    {
+        json->add("class", className);
+        json->add("func",  funcName);
+    }
+
+    if (item->mType == SequenceLogItem::MESSAGE)
+        json->add("message", item->getMessage());
+
+    json->serialize(line);
+    delete json;
+
+    return true;
+}
+
+} // namespace slog
@@ -0,0 +1,33 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    getSequenceLogItemJson.h
+ * \brief   シーケンスログアイテム（JSON）取得
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+#include "slog/slog.h"
+
+namespace slog
+{
+class CoreString;
+class SequenceLogItem;
+
+bool isBinarySequenceLogFile(const CoreString* path);
+bool getSequenceLogItemJson(CoreString* line, const char* fileName, const SequenceLogItem* item, const CoreString* className, const CoreString* funcName);
+
+} // namespace slog
@@ -118,6 +118,22 @@ static bool isDirectoryPermissionAllow(const CoreString& dirName)
     return true;
 }
 
+/*!
+ *  \brief  サイズ取得（単位にKB、MBを指定できる）
+ */
+static int64_t getSize(const Variant& value, const CoreString* unit)
+{
+    int64_t size = (int32_t)value;
+
+    if (unit->equals("KB"))
+        size *= 1024;
+
+    if (unit->equals("MB"))
+        size *= (1024 * 1024);
+
+    return size;
+}
+
 /*!
  *  \brief  アプリケーションクラス
  */
@@ -161,6 +177,13 @@ void Application::main(int argc, char** argv)
     String logOutputDir = "/var/log/slog";
     uint32_t size = 0;
     int32_t count = 0;
+    bool compress = false;
+    int32_t archiveDays = 0;
+    int32_t slowCallThreshold = 0;
+    int32_t slowCallMaxItems = 100000;
+    int64_t keepSize = 256 * 1024 * 1024;
+    int64_t connectionKeepSize = 32 * 1024 * 1024;
+    bool overloadControl = false;
     uint16_t webServerPort = 8080;
     uint16_t webServerPortSSL = 8443;
     uint16_t sequenceLogServerPort = 8081;
@@ -187,21 +210,35 @@ void Application::main(int argc, char** argv)
         if (key->equals("LOG_OUTPUT_DIR"))
             logOutputDir.copy(value1);
 
-        if (key->equals("MAX_FILE_SIZE"))
-        {
-            const CoreString* value2 = tokenizer.getValue("value2");
-            size = value1;
-
-            if (value2->equals("KB"))
-                size *= 1024;
+        const CoreString* value2 = tokenizer.getValue("value2");
 
-            if (value2->equals("MB"))
-                size *= (1024 * 1024);
-        }
+        if (key->equals("MAX_FILE_SIZE"))
+            size = (uint32_t)getSize(value1, value2);
 
         if (key->equals("MAX_FILE_COUNT"))
             count = value1;
 
+        if (key->equals("COMPRESS_LOG_FILE"))
+            compress = value1.mStr.equals("true");
+
+        if (key->equals("ARCHIVE_DAYS"))
+            archiveDays = value1;
+
+        if (key->equals("SLOW_CALL_THRESHOLD"))
+            slowCallThreshold = value1;
+
+        if (key->equals("SLOW_CALL_MAX_ITEMS"))
+            slowCallMaxItems = value1;
+
+        if (key->equals("MAX_KEEP_SIZE"))
+            keepSize = getSize(value1, value2);
+
+        if (key->equals("MAX_CONNECTION_KEEP_SIZE"))
+            connectionKeepSize = getSize(value1, value2);
+
+        if (key->equals("OVERLOAD_CONTROL"))
+            overloadControl = value1.mStr.equals("true");
+
         if (key->equals("WEB_SERVER_PORT"))
             webServerPort = value1;
 
@@ -249,6 +286,12 @@ void Application::main(int argc, char** argv)
         serviceMain.setLogFolderName(&logOutputDir);
         serviceMain.setMaxFileSize(size);
         serviceMain.setMaxFileCount(count);
+        serviceMain.setCompressLogFile(compress);
+        serviceMain.setArchiveDays(archiveDays);
+        serviceMain.setSlowCallThreshold(slowCallThreshold);
+        serviceMain.setSlowCallMaxItems(slowCallMaxItems);
+        serviceMain.setMaxKeepSize(keepSize, connectionKeepSize);
+        serviceMain.setOverloadControl(overloadControl);
         serviceMain.setWebServerPort(false, webServerPort);
         serviceMain.setWebServerPort(true,  webServerPortSSL);
         serviceMain.setSSLFileName(&certificate, &privateKey);
@@ -0,0 +1,171 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogArchive.h
+ * \brief   シーケンスログアーカイブクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/File.h"
+
+#include <vector>
+
+#pragma warning(disable:4251)
+
+namespace slog
+{
+class ByteBuffer;
+
+/*!
+ * \brief   シーケンスログアーカイブのグループ情報
+ */
+struct SequenceLogArchiveGroup
+{
+    int64_t                 position;       //!< アーカイブ内の位置
+    int64_t                 rawPosition;    //!< 展開後の位置
+    int32_t                 rawSize;        //!< 展開後のサイズ
+    int32_t                 count;          //!< レコード数
+    uint64_t                minDateTime;    //!< 最も古い日時
+    uint64_t                maxDateTime;    //!< 最も新しい日時
+    uint32_t                levels;         //!< メッセージのログレベル（レベル毎のビット）
+    std::vector<uint32_t>   threadIds;      //!< スレッドID
+    std::vector<int32_t>    sizes;          //!< カラム毎のサイズ（圧縮後）
+    std::vector<int32_t>    rawSizes;       //!< カラム毎のサイズ（圧縮前）
+};
+
+/*!
+ * \brief   シーケンスログアーカイブクラス
+ *
+ * \note    シーケンスログファイルのレコードをグループ（最大4096レコード）に分け、
+ *          グループ毎にカラム（シーケンス番号、日時、種別、スレッド、クラス名・関数名、ログレベル、メッセージ）を
+ *          別々に符号化してからLZ圧縮する。
+ *          グループ毎の日時の範囲、スレッド、ログレベルは末尾のディレクトリにまとめてあり、
+ *          カラムを読まずに検索対象のグループを絞り込める。
+ *          展開すると元のシーケンスログファイルと同じバイト列になる。
+ */
+class SLOG_API SequenceLogArchive
+{
+            /*!
+             * カラム
+             */
+public:     enum Column
+            {
+                SEQ_NO,         //!< シーケンス番号（前レコードとの差分）
+                DATE_TIME,      //!< 日時（差分の差分）
+                TYPE,           //!< 種別（２ビット）
+                THREAD,         //!< スレッド（辞書番号）
+                NAME,           //!< クラス名・関数名（辞書番号またはID）
+                LEVEL,          //!< ログレベル（４ビット）
+                MESSAGE,        //!< メッセージ
+                COLUMN_COUNT,
+            };
+
+            /*!
+             * ファイル
+             */
+private:    File mFile;
+
+            /*!
+             * 展開後のサイズ
+             */
+            int64_t mRawSize;
+
+            /*!
+             * ディレクトリ
+             */
+            ByteBuffer* mDirectory;
+
+            /*!
+             * スレッドIDの辞書
+             */
+            std::vector<uint32_t> mThreadIds;
+
+            /*!
+             * クラス名・関数名の辞書（ディレクトリ内の位置）
+             */
+            std::vector<int32_t> mNames;
+
+            /*!
+             * グループ情報
+             */
+            std::vector<SequenceLogArchiveGroup> mGroups;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogArchive();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogArchive();
+
+            /*!
+             * アーカイブ作成
+             */
+            static void create(const CoreString* logPath, const CoreString* archivePath) throw(Exception);
+
+            /*!
+             * アーカイブのパス取得
+             */
+            static void getArchivePath(CoreString* archivePath, const CoreString* logPath);
+
+            /*!
+             * アーカイブのファイル名かどうか調べる
+             */
+            static bool isArchiveFileName(const CoreString* fileName);
+
+            /*!
+             * オープン／クローズ
+             */
+            void open(const CoreString* fileName) throw(Exception);
+            void close();
+            bool isOpen() const;
+
+            /*!
+             * ファイルサイズ取得
+             */
+            int64_t getSize() const;
+
+            /*!
+             * 展開後のサイズ取得
+             */
+            int64_t getRawSize() const {return mRawSize;}
+
+            /*!
+             * グループ数取得
+             */
+            int32_t getGroupCount() const {return (int32_t)mGroups.size();}
+
+            /*!
+             * グループ情報取得
+             */
+            const SequenceLogArchiveGroup* getGroup(int32_t index) const {return &mGroups[index];}
+
+            /*!
+             * グループ読み込み（展開後のバイト列）
+             */
+            void readGroup(int32_t index, ByteBuffer* buffer) throw(Exception);
+
+            /*!
+             * ディレクトリ読み込み
+             */
+private:    void readDirectory() throw(Exception);
+};
+
+} // namespace slog
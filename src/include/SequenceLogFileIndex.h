@@ -0,0 +1,125 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/*!
+ * \file    SequenceLogFileIndex.h
+ * \brief   シーケンスログファイル索引クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/ByteBuffer.h"
+#include "slog/CoreString.h"
+
+#include <map>
+#include <vector>
+
+#pragma warning(disable:4251)
+
+namespace slog
+{
+
+/*!
+ * \brief   シーケンスログファイル索引クラス
+ *
+ * \note    シーケンスログファイルをブロック（レコード境界で区切った約64KB）に分け、
+ *          メッセージに含まれるトライグラム（連続する３バイト）毎に、
+ *          そのトライグラムを含むブロックの番号を記録する。
+ *          索引はシーケンスログファイルのフォルダにある index フォルダに拡張子 .idx を付けて保存する。
+ */
+class SLOG_API SequenceLogFileIndex
+{
+            /*!
+             * ブロックサイズの目安
+             */
+public:     enum
+            {
+                BLOCK_SIZE = 64 * 1024,
+            };
+
+            /*!
+             * 索引データ
+             */
+private:    ByteBuffer* mData;
+
+            /*!
+             * ブロックの開始位置（圧縮ファイルの場合は展開後の位置）
+             */
+            std::vector<int64_t> mBlockPositions;
+
+            /*!
+             * トライグラム毎のブロック番号リストの位置
+             */
+            std::map<uint32_t, int32_t> mPostings;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogFileIndex();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogFileIndex();
+
+            /*!
+             * 索引作成
+             */
+            static void build(const CoreString* logPath) throw(Exception);
+
+            /*!
+             * 索引読み込み
+             */
+            bool load(const CoreString* logPath);
+
+            /*!
+             * 索引削除
+             */
+            static void remove(const CoreString* logPath);
+
+            /*!
+             * 索引を作成できるシーケンスログファイルかどうか調べる
+             */
+            static bool isIndexable(const CoreString* logPath);
+
+            /*!
+             * ブロック数取得
+             */
+            int32_t getBlockCount() const {return (int32_t)mBlockPositions.size();}
+
+            /*!
+             * ブロックの開始位置取得
+             */
+            int64_t getBlockPosition(int32_t blockNo) const {return mBlockPositions[blockNo];}
+
+            /*!
+             * 文字列を含む可能性のあるブロックを取得
+             */
+            bool find(const CoreString* text, std::vector<bool>* blocks) const;
+
+            /*!
+             * 索引フォルダのパス取得
+             */
+private:    static void getIndexDirPath(CoreString* indexDirPath, const CoreString* logPath);
+
+            /*!
+             * 索引のパス取得
+             */
+            static void getIndexPath(CoreString* indexPath, const CoreString* logPath);
+};
+
+} // namespace slog
@@ -0,0 +1,119 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogFileReader.h
+ * \brief   シーケンスログファイル読み込みクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "SequenceLogItem.h"
+#include "slog/File.h"
+#include "slog/CompressedFile.h"
+
+namespace slog
+{
+
+/*!
+ * \brief   シーケンスログファイル読み込みクラス
+ *
+ * \note    バイナリ形式のシーケンスログファイル（.slog、.slogz、.sloga）からレコードを順に読み込む。
+ */
+class SLOG_API SequenceLogFileReader
+{
+            /*!
+             * ファイル
+             */
+            File mFile;
+
+            /*!
+             * 圧縮ファイル
+             */
+            CompressedFile mCompressedFile;
+
+            /*!
+             * 圧縮ファイルかどうか
+             */
+            bool mCompressed;
+
+            /*!
+             * 読み込みバッファ
+             */
+            ByteBuffer mBuffer;
+
+            /*!
+             * 読み込みバッファ内の次のレコードの位置
+             */
+            int32_t mOffset;
+
+            /*!
+             * 読み込みバッファ内の有効なデータの長さ
+             */
+            int32_t mLength;
+
+            /*!
+             * 次のレコードのファイル内の位置（圧縮ファイルの場合は展開後の位置）
+             */
+            int64_t mPosition;
+
+            /*!
+             * レコードバッファ
+             */
+            SequenceLogByteBuffer mRecord;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogFileReader();
+
+            /*!
+             * オープン
+             */
+            void open(const CoreString* fileName) throw(Exception);
+
+            /*!
+             * クローズ
+             */
+            void close();
+
+            /*!
+             * レコード読み込み
+             */
+            bool read(SequenceLogItem* item) throw(Exception);
+
+            /*!
+             * レコード読み込み（シーケンスログファイル上のバイト列のまま）
+             */
+            SequenceLogByteBuffer* readRecord() throw(Exception);
+
+            /*!
+             * 書き込み途中のレコード（ファイルの終端に達した時に読み込めなかったデータ）があるかどうか
+             */
+            bool hasPartialRecord() const {return (mOffset < mLength);}
+
+            /*!
+             * 次のレコードのファイル内の位置取得
+             */
+            int64_t getPosition() const {return mPosition;}
+
+            /*!
+             * 次のレコードのファイル内の位置設定（レコードの先頭を指定すること）
+             */
+            void setPosition(int64_t position) throw(Exception);
+};
+
+} // namespace slog
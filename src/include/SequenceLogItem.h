@@ -32,6 +32,64 @@ namespace slog
 
 static const unsigned short SERVICE_PORT = 59106;
 
+/*!
+ * \brief   シーケンスログサービスからクライアントへの制御メッセージ種別
+ *
+ * \note    LOG_LEVEL_CONTROL : [種別(4)][ログレベル(4)][条件数(4)] の後に、条件毎に
+ *          [ログレベル(4)][クラス名の長さ(4)][クラス名][関数名の長さ(4)][関数名] が続く。
+ *          クラス名と関数名にはワイルドカード '*' を使える。
+ */
+static const int32_t LOG_LEVEL_CONTROL = 1;
+
+/*!
+ * \brief   シーケンスログサービスからクライアントへの制御メッセージ種別（過負荷）
+ *
+ * \note    OVERLOAD_CONTROL : [種別(4)][縮退レベル(4)][サンプリング間隔(4)]
+ *          クライアントは縮退レベルに応じてアイテムを間引き、間引いた数をWARNメッセージで報告する。
+ */
+static const int32_t OVERLOAD_CONTROL = 2;
+
+/*!
+ * \brief   シーケンスログサービスからクライアントへの制御メッセージ種別（呼び出し箇所）
+ *
+ * \note    SITE_LIST_CONTROL : [種別(4)]
+ *          クライアントは登録済みの呼び出し箇所を SITE アイテムで報告し、以降は登録する毎に報告する。
+ *
+ *          SITE_ENABLE_CONTROL : [種別(4)][有効フラグ(4)][ID数(4)] の後に [呼び出し箇所ID(4)] が続く。
+ *          クライアントは呼び出し箇所の有効／無効を切り替え、変更後の状態を SITE アイテムで報告する。
+ */
+static const int32_t SITE_LIST_CONTROL =   3;
+static const int32_t SITE_ENABLE_CONTROL = 4;
+
+/*!
+ * \brief   シーケンスログサービスからクライアントへの制御メッセージ種別（コンパクト形式）
+ *
+ * \note    COMPACT_ENCODING_CONTROL : [種別(4)]
+ *          サービスがコンパクト形式のレコードを読めることを通知する。
+ *          クライアントは以降のシーケンスログアイテムをコンパクト形式で送信する。
+ */
+static const int32_t COMPACT_ENCODING_CONTROL = 5;
+
+/*!
+ * \brief   クライアントが対応している制御メッセージ
+ *
+ * \note    クライアントは接続時に送信するヘッダーのログレベルの後に [対応している制御メッセージ(4)] を付け、
+ *          サービスは対応している制御メッセージだけを送信する。付いていない（以前の）クライアントには送信しない。
+ */
+static const int32_t CLIENT_CAPABILITY_SITE_LIST = 0x01;    //!< SITE_LIST_CONTROL、SITE_ENABLE_CONTROL
+static const int32_t CLIENT_CAPABILITY_COMPACT =   0x02;    //!< COMPACT_ENCODING_CONTROL
+
+/*!
+ * \brief   過負荷時の縮退レベル（上位のレベルは下位のレベルの間引きも行う）
+ */
+enum OverloadLevel
+{
+    OVERLOAD_NONE = 0,      //!< 間引かない
+    OVERLOAD_DROP_DEBUG,    //!< DEBUGメッセージを送信しない
+    OVERLOAD_DROP_STEP,     //!< ステップイン／アウトを送信しない（メッセージは呼び出し中の関数のものとして扱われる）
+    OVERLOAD_SAMPLING,      //!< WARN未満のメッセージをサンプリング間隔毎に１件だけ送信する
+};
+
 #pragma pack(push, 4)
 /*!
  * \brief   シーケンスログアイテムクラス
@@ -43,6 +101,7 @@ public:     enum Type
                 STEP_IN,        //!< ステップイン
                 STEP_OUT,       //!< ステップアウト
                 MESSAGE,        //!< メッセージ
+                SITE,           //!< 呼び出し箇所（クライアントからの報告のみで、ファイルには書き込まない）
             };
 
             //
@@ -62,7 +121,7 @@ public:     uint32_t                    mClassId;           //!< クラスID
 public:     uint32_t                    mFuncId;            //!< メソッドID
 
             //
-            // MESSAGE
+            // MESSAGE（SITE の場合、mSeqNo は呼び出し箇所ID、mLevel はログレベル、mMessageId は有効フラグ）
             //
 //blic:     SequenceLogLevel            mLevel;
 public:     uint32_t                    mLevel;             //!< ログレベル
@@ -95,6 +154,7 @@ public:     SequenceLogItem();
             void init(uint32_t seq, uint32_t    classID,   uint32_t    funcID);
             void init(uint32_t seq);
             void init(uint32_t seq, SequenceLogLevel level);
+            void init(const SequenceLogSite* site);
 
             CoreString* getClassName() const;
             CoreString* getFuncName() const;
@@ -225,6 +285,26 @@ inline void SequenceLogItem::init(uint32_t seq, SequenceLogLevel level)
     mLevel =      level;
 }
 
+/*!
+ * \brief   初期化
+ *
+ * \param[in]   site        呼び出し箇所
+ *
+ * \return  なし
+ */
+inline void SequenceLogItem::init(const SequenceLogSite* site)
+{
+    if (this == nullptr)
+        return;
+
+    mSeqNo =      site->id;
+    mType =       SITE;
+    mLevel =      site->level;
+    mMessageId =  (site->disabled == 0);
+    mClassName.copy(site->className ? site->className : "(null)");
+    mFuncName. copy(site->funcName  ? site->funcName  : "(null)");
+}
+
 /*!
  * \brief   現在日時設定
  */
@@ -245,11 +325,37 @@ struct SLOG_SHM
 };
 #pragma pack(pop)
 
+/*!
+ * \brief   コンパクト形式の符号化状態（接続毎に送信側と受信側で持つ）
+ */
+struct SequenceLogCompactState
+{
+    uint32_t seqNo;     //!< 前のコンパクト形式レコードのシーケンス番号
+
+    SequenceLogCompactState() : seqNo(0) {}
+};
+
 /*!
  * \brief   シーケンスログバイトバッファクラス
+ *
+ * \note    通常の形式（ファイルと同じ形式）は
+ *          [レコード長(2)][シーケンス番号(4)][日時(8、ファイルのみ)][種別(1)][スレッドID(4)] に種別毎のデータが続く。
+ *
+ *          コンパクト形式（クライアントからサービスへの送信のみ）は
+ *          [COMPACT_MARKER(1)][種別(1)][シーケンス番号（前レコードとの差分）][スレッドID] に種別毎のデータが続き、
+ *          数値は可変長整数（７ビット単位）、符号付きの値はジグザグ符号化する。
+ *          レコード長は持たず、WebSocketのフレーム長をレコード長とする。
+ *          COMPACT_SIZE_LIMIT 以上になるレコードは通常の形式で送信するので、
+ *          先頭が COMPACT_MARKER でフレーム長が COMPACT_SIZE_LIMIT 未満であればコンパクト形式と判別できる。
  */
 class SLOG_API SequenceLogByteBuffer : public ByteBuffer
 {
+public:     enum
+            {
+                COMPACT_MARKER =     0xFF,      //!< コンパクト形式の先頭バイト
+                COMPACT_SIZE_LIMIT = 0xFF00,    //!< コンパクト形式のレコード長の上限
+            };
+
             /*!
              * コンストラクタ
              */
@@ -258,8 +364,18 @@ public:     SequenceLogByteBuffer(uint32_t capacity) : ByteBuffer(capacity) {}
             /*!
              * シーケンスログ読み込み／書き込み
              */
-            void     getSequenceLogItem(      SequenceLogItem* item) throw(Exception);
-            uint32_t putSequenceLogItem(const SequenceLogItem* item, bool isOutputDateTime = false);
+            void     getSequenceLogItem(      SequenceLogItem* item, bool isInputDateTime = false, SequenceLogCompactState* state = nullptr) throw(Exception);
+            uint32_t putSequenceLogItem(const SequenceLogItem* item, bool isOutputDateTime = false) throw(Exception);
+
+            /*!
+             * シーケンスログ書き込み（コンパクト形式）
+             */
+            uint32_t putCompactSequenceLogItem(const SequenceLogItem* item, SequenceLogCompactState* state) throw(Exception);
+
+            /*!
+             * シーケンスログ読み込み（コンパクト形式）
+             */
+private:    void getCompactSequenceLogItem(SequenceLogItem* item, SequenceLogCompactState* state) throw(Exception);
 };
 
 } // namespace slog
@@ -0,0 +1,102 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogMerger.h
+ * \brief   シーケンスログマージクラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "SequenceLogItem.h"
+
+#include <vector>
+
+#pragma warning(disable:4251)
+
+namespace slog
+{
+class SequenceLogMergeSource;
+
+/*!
+ * \brief   シーケンスログマージクラス
+ *
+ * \note    複数のシーケンスログファイル（.slog、.slogz、.sloga）のレコードを日時順に並べ、一つのストリームとして読み込む。
+ *          ファイル毎のスレッドでレコードを読み込んでバッチ（約128KB）単位で受け渡し、
+ *          各ファイルの先頭のレコードをヒープで比較して最も古いものから順に返す。
+ *          ファイル毎に先読みするバッチの数を制限するので、メモリ使用量はファイル数に比例する量に収まる。
+ *          日時が同じレコードは追加したファイルの順、ファイル内の順を保つ。
+ */
+class SLOG_API SequenceLogMerger
+{
+            /*!
+             * マージするファイル
+             */
+            std::vector<SequenceLogMergeSource*> mSources;
+
+            /*!
+             * 次のレコードがあるファイル（先頭のレコードの日時が最も古いものが先頭のヒープ）
+             */
+            std::vector<SequenceLogMergeSource*> mHeap;
+
+            /*!
+             * レコードバッファ
+             */
+            SequenceLogByteBuffer mRecord;
+
+            /*!
+             * 開始したかどうか
+             */
+            bool mStarted;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogMerger();
+
+            /*!
+             * デストラクタ
+             */
+            ~SequenceLogMerger();
+
+            /*!
+             * マージするファイルを追加
+             */
+            void add(const CoreString* path);
+
+            /*!
+             * マージするファイルの数を取得
+             */
+            int32_t getCount() const {return (int32_t)mSources.size();}
+
+            /*!
+             * 開始／停止
+             */
+            void start() throw(Exception);
+            void stop();
+
+            /*!
+             * レコード読み込み
+             */
+            bool read(SequenceLogItem* item, int32_t* index) throw(Exception);
+
+            /*!
+             * レコード読み込み（シーケンスログファイル上のバイト列のまま）
+             */
+            SequenceLogByteBuffer* readRecord(int32_t* index) throw(Exception);
+};
+
+} // namespace slog
@@ -0,0 +1,127 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    SequenceLogTraceConverter.h
+ * \brief   Chrome Trace Event形式変換クラス
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "SequenceLogFileReader.h"
+
+#include <map>
+#include <vector>
+
+#pragma warning(disable:4251)
+
+namespace slog
+{
+
+/*!
+ * \brief   Chrome Trace Event形式変換クラス
+ *
+ * \note    シーケンスログファイルを読み込みながら、Chrome Trace Event形式のJSON（chrome://tracing、Perfettoで表示できる）に変換する。
+ *          STEP_IN／STEP_OUTはスレッド毎のB／Eイベント、メッセージはインスタントイベントにする。
+ *          STEP_OUTがないまま別の関数のアイテムが来た場合は、そのアイテムの日時で呼び出し中の関数のEイベントを補う。
+ *          保持するのはスレッド毎の呼び出し中の関数だけなので、ファイルサイズによらず少ないメモリで変換できる。
+ *          時刻は先頭のレコードからの経過時間（マイクロ秒）。
+ */
+class SLOG_API SequenceLogTraceConverter
+{
+            /*!
+             * シーケンスログファイル読み込み
+             */
+            SequenceLogFileReader mReader;
+
+            /*!
+             * シーケンスログアイテム
+             */
+            SequenceLogItem mItem;
+
+            /*!
+             * プロセスID（ファイル名から取得、取得できなかった場合は0）
+             */
+            int32_t mProcessId;
+
+            /*!
+             * プロセス名（ファイル名の "名前" の部分）
+             */
+            String mProcessName;
+
+            /*!
+             * 先頭のレコードの日時（ミリ秒、-1は未設定）
+             */
+            int64_t mBaseTime;
+
+            /*!
+             * 最後のレコードの日時（ミリ秒）
+             */
+            int64_t mLastTime;
+
+            /*!
+             * 呼び出し中の関数のシーケンス番号（キーはスレッドID）
+             */
+            std::map<uint32_t, std::vector<uint32_t> > mStacks;
+
+            /*!
+             * 状態
+             */
+            enum class State
+            {
+                CLOSED,     //!< オープンしていない
+                HEADER,     //!< ヘッダーを出力していない
+                EVENTS,     //!< イベントを出力中
+                END,        //!< 全て出力した
+            };
+
+            State mState;
+
+            /*!
+             * 次のイベントの前に区切りが必要かどうか
+             */
+            bool mSeparator;
+
+            /*!
+             * コンストラクタ
+             */
+public:     SequenceLogTraceConverter();
+
+            /*!
+             * オープン／クローズ
+             */
+            void open(const CoreString* logPath) throw(Exception);
+            void close();
+
+            /*!
+             * 変換（JSONの続きを取得）
+             */
+            bool read(CoreString* json, int32_t size) throw(Exception);
+
+            /*!
+             * ファイルに変換
+             */
+            static void convert(const CoreString* logPath, const CoreString* tracePath) throw(Exception);
+
+            /*!
+             * イベント出力
+             */
+private:    void appendItem(CoreString* json) throw(Exception);
+            void appendEnd(CoreString* json, uint32_t threadId, int64_t time) throw(Exception);
+            void appendEvent(CoreString* json, const char* event) throw(Exception);
+};
+
+} // namespace slog
@@ -0,0 +1,75 @@
+﻿/*
+ * Copyright (C) 2015 printf.jp
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*!
+ * \file    StringKernel.h
+ * \brief   文字列検索カーネル
+ * \author  Copyright 2015 printf.jp
+ */
+#pragma once
+
+#include "slog/slog.h"
+
+namespace slog
+{
+
+/*!
+ * \brief   文字列検索カーネル
+ *
+ * \note    文字列の検索と、WebSocketのマスキングのようなバイト列の一括処理を行う。
+ *          x86ではCPUIDを調べて初回呼び出し時にAVX2版またはSSE2版を選び、
+ *          それ以外の環境ではスカラー版を使う。
+ *          いずれの関数も [p, end) の範囲だけを参照し、終端の '\0' には依存しない。
+ */
+class SLOG_API StringKernel
+{
+            /*!
+             * いずれかの文字を前方検索（setLenは8以下）
+             */
+public:     static const char* findAny(const char* p, const char* end, const char* set, int32_t setLen);
+
+            /*!
+             * 前方検索（見つかった位置の先頭を返す）
+             */
+            static const char* find(const char* p, const char* end, const char* pattern, int32_t patternLen);
+
+            /*!
+             * 後方検索（最後に見つかった位置の先頭を返す）
+             */
+            static const char* findLast(const char* p, const char* end, const char* pattern, int32_t patternLen);
+
+            /*!
+             * UTF-8の文字数（継続バイト以外のバイト数）を取得する
+             */
+            static int32_t countCharacters(const char* p, const char* end);
+
+            /*!
+             * マスキングキーでXORする（WebSocketのマスク／アンマスク）
+             */
+            static void mask(char* p, char* end, const char* key, uint64_t offset);
+
+            /*!
+             * 使用中のカーネル名（"avx2"、"sse2"、"scalar"）を取得する
+             */
+            static const char* getName();
+
+            /*!
+             * 使用するカーネルを名前で選ぶ（テスト用。nullptrで自動選択に戻す）
+             */
+            static bool select(const char* name);
+};
+
+} // namespace slog